@@ -0,0 +1,435 @@
+#include "batchprocessor.h"
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "complexnumber.h"
+#include "precision.h"
+
+namespace {
+
+/**
+ * @brief Operators understood in batch records.
+ */
+enum class BatchOp {
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Root,
+    Power,
+    Inverse,
+    Conjugate,
+    Absolute,
+    Invalid
+};
+
+/**
+ * @brief One parsed record together with its result.
+ */
+struct BatchRecord {
+    BatchOp op = BatchOp::Invalid;
+    double a = 0, b = 0, c = 0, d = 0;
+    double resultReal = 0, resultImaginary = 0;
+    const char *error = nullptr;
+};
+
+/**
+ * @brief Unit of work passed between the pipeline stages.
+ */
+struct BatchChunk {
+    std::vector<char> text;
+    std::vector<BatchRecord> records;
+    std::string output;
+    bool last = false;
+};
+
+/**
+ * @brief Small blocking queue connecting two pipeline stages.
+ */
+template<typename T>
+class StageQueue {
+public:
+    void push(T item)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.push_back(std::move(item));
+        }
+        ready.notify_one();
+    }
+
+    T pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !items.empty(); });
+        T item = std::move(items.front());
+        items.pop_front();
+        return item;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<T> items;
+};
+
+/**
+ * @brief Number of chunk buffers in flight - two per stage boundary.
+ */
+constexpr int ChunkBuffers = 4;
+
+/**
+ * @brief Number of operands each operator expects.
+ */
+int operandCount(BatchOp op)
+{
+    switch (op) {
+    case BatchOp::Add:
+    case BatchOp::Subtract:
+    case BatchOp::Multiply:
+    case BatchOp::Divide:
+        return 4;
+    case BatchOp::Invalid:
+        return 0;
+    default:
+        return 2;
+    }
+}
+
+/**
+ * @brief Maps an operator token to its BatchOp.
+ */
+BatchOp parseOp(const char *begin, const char *end)
+{
+    static const struct {
+        const char *name;
+        BatchOp op;
+    } names[] = {
+        {"add", BatchOp::Add},           {"+", BatchOp::Add},
+        {"subtract", BatchOp::Subtract}, {"-", BatchOp::Subtract},
+        {"multiply", BatchOp::Multiply}, {"*", BatchOp::Multiply},
+        {"divide", BatchOp::Divide},     {"/", BatchOp::Divide},
+        {"root", BatchOp::Root},         {"power", BatchOp::Power},
+        {"inverse", BatchOp::Inverse},   {"conjugate", BatchOp::Conjugate},
+        {"abs", BatchOp::Absolute},
+    };
+
+    const std::size_t length = end - begin;
+    for (const auto &entry : names) {
+        if (std::strlen(entry.name) == length && std::memcmp(entry.name, begin, length) == 0) {
+            return entry.op;
+        }
+    }
+    return BatchOp::Invalid;
+}
+
+/**
+ * @brief Parses one line into a record.
+ */
+BatchRecord parseLine(const char *p, const char *end)
+{
+    BatchRecord record;
+    auto skipSpace = [&] {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+    };
+
+    skipSpace();
+    const char *opBegin = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r') {
+        ++p;
+    }
+    record.op = parseOp(opBegin, p);
+    if (record.op == BatchOp::Invalid) {
+        record.error = "Unknown operator!";
+        return record;
+    }
+
+    double *operands[] = {&record.a, &record.b, &record.c, &record.d};
+    const int count = operandCount(record.op);
+    for (int i = 0; i < count; ++i) {
+        skipSpace();
+        auto parsed = std::from_chars(p, end, *operands[i]);
+        if (parsed.ec != std::errc()) {
+            record.op = BatchOp::Invalid;
+            record.error = "Malformed operand!";
+            return record;
+        }
+        p = parsed.ptr;
+    }
+
+    skipSpace();
+    if (p != end) {
+        record.op = BatchOp::Invalid;
+        record.error = "Too many operands!";
+    }
+    return record;
+}
+
+/**
+ * @brief Splits the chunk text into lines and parses them.
+ */
+void parseChunk(BatchChunk &chunk)
+{
+    chunk.records.clear();
+    const char *p = chunk.text.data();
+    const char *end = p + chunk.text.size();
+
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        const char *first = p;
+        while (first < lineEnd && (*first == ' ' || *first == '\t' || *first == '\r')) {
+            ++first;
+        }
+        if (first != lineEnd && *first != '#') {
+            chunk.records.push_back(parseLine(first, lineEnd));
+        }
+        p = lineEnd + 1;
+    }
+}
+
+/**
+ * @brief Evaluates every record of the chunk with scalar T.
+ */
+template<typename T>
+void computeChunk(BatchChunk &chunk)
+{
+    using Complex = BasicComplex<T>;
+
+    for (BatchRecord &record : chunk.records) {
+        if (record.op == BatchOp::Invalid) {
+            continue;
+        }
+
+        const Complex x(ComplexNumber(record.a, record.b));
+        const Complex y(ComplexNumber(record.c, record.d));
+        Complex result(0, 0);
+        ComplexStatus status = ComplexStatus::Ok;
+
+        switch (record.op) {
+        case BatchOp::Add:
+            result = x.add(y);
+            break;
+        case BatchOp::Subtract:
+            result = x.subtract(y);
+            break;
+        case BatchOp::Multiply:
+            result = x.multiply(y);
+            break;
+        case BatchOp::Divide:
+            result = x.tryDivide(y, status);
+            break;
+        case BatchOp::Root:
+            result = x.root();
+            break;
+        case BatchOp::Power:
+            result = x.multiply(x);
+            break;
+        case BatchOp::Inverse:
+            result = x.tryInverse(status);
+            break;
+        case BatchOp::Conjugate:
+            result = x.conjugate();
+            break;
+        case BatchOp::Absolute:
+            result = Complex(x.absoluteValue(), 0);
+            break;
+        case BatchOp::Invalid:
+            break;
+        }
+
+        if (status == ComplexStatus::DivisionByZero) {
+            record.error = "Division by zero!";
+            continue;
+        }
+
+        record.resultReal = static_cast<double>(result.getReal());
+        record.resultImaginary = static_cast<double>(result.getImaginary());
+    }
+}
+
+/**
+ * @brief Evaluates every record of the chunk in the given precision.
+ */
+void computeChunk(BatchChunk &chunk, Precision precision)
+{
+    withPrecision(precision, [&](auto zero) { computeChunk<decltype(zero)>(chunk); });
+}
+
+/**
+ * @brief Formats the results of the chunk into its output buffer.
+ *
+ * @return number of error lines written.
+ */
+std::size_t formatChunk(BatchChunk &chunk)
+{
+    std::size_t errors = 0;
+    chunk.output.clear();
+
+    char buffer[64];
+    for (const BatchRecord &record : chunk.records) {
+        if (record.error) {
+            chunk.output += "error: ";
+            chunk.output += record.error;
+            chunk.output += '\n';
+            ++errors;
+            continue;
+        }
+
+        char *p = std::to_chars(buffer, buffer + sizeof(buffer), record.resultReal).ptr;
+        *p++ = ' ';
+        p = std::to_chars(p, buffer + sizeof(buffer), record.resultImaginary).ptr;
+        *p++ = '\n';
+        chunk.output.append(buffer, p);
+    }
+    return errors;
+}
+
+} // namespace
+
+/**
+ * @brief Constructor.
+ *
+ * @param chunkSize number of input bytes read per chunk (std::size_t).
+ * @param precision precision the records are computed in (Precision).
+ */
+BatchProcessor::BatchProcessor(std::size_t chunkSize, Precision precision)
+    : chunkSize(chunkSize > 0 ? chunkSize : 1), precision(precision)
+{
+}
+
+/**
+ * @brief Evaluates every record from input and writes the results to output.
+ *
+ * @param input stream to read records from (std::FILE*).
+ * @param output stream to write results to (std::FILE*).
+ * @throws std::runtime_error If reading or writing fails.
+ * @return counters for the run (Stats).
+ */
+BatchProcessor::Stats BatchProcessor::run(std::FILE *input, std::FILE *output)
+{
+    std::unique_ptr<BatchChunk> buffers[ChunkBuffers];
+    StageQueue<BatchChunk *> freeQueue, computeQueue, writeQueue;
+    for (auto &buffer : buffers) {
+        buffer = std::make_unique<BatchChunk>();
+        buffer->text.reserve(chunkSize);
+        freeQueue.push(buffer.get());
+    }
+
+    std::exception_ptr readError, writeError;
+    Stats stats;
+
+    // Stage 1: read a block, keep a trailing partial line for the next chunk, parse.
+    // A line longer than a chunk is reported as an error and skipped up to its newline,
+    // so the carried partial line never exceeds chunkSize bytes.
+    std::thread reader([&] {
+        std::vector<char> carry;
+        bool skipping = false;
+        bool last = false;
+        while (!last) {
+            BatchChunk *chunk = freeQueue.pop();
+            try {
+                chunk->text.assign(carry.begin(), carry.end());
+                carry.clear();
+
+                const std::size_t start = chunk->text.size();
+                chunk->text.resize(start + chunkSize);
+                const std::size_t got = std::fread(chunk->text.data() + start, 1, chunkSize, input);
+                chunk->text.resize(start + got);
+                if (got < chunkSize) {
+                    if (std::ferror(input)) {
+                        throw std::runtime_error("Failed to read batch input!");
+                    }
+                    last = true;
+                }
+
+                if (skipping) {
+                    auto newline = std::find(chunk->text.begin(), chunk->text.end(), '\n');
+                    skipping = newline == chunk->text.end() && !last;
+                    chunk->text.erase(chunk->text.begin(),
+                                      newline == chunk->text.end() ? newline : newline + 1);
+                }
+
+                bool tooLong = false;
+                if (!last) {
+                    auto newline = std::find(chunk->text.rbegin(), chunk->text.rend(), '\n');
+                    if (static_cast<std::size_t>(newline - chunk->text.rbegin()) >= chunkSize) {
+                        tooLong = true;
+                        skipping = true;
+                    } else {
+                        carry.assign(newline.base(), chunk->text.end());
+                    }
+                    chunk->text.erase(newline.base(), chunk->text.end());
+                }
+                parseChunk(*chunk);
+                if (tooLong) {
+                    BatchRecord record;
+                    record.error = "Line too long!";
+                    chunk->records.push_back(record);
+                }
+            } catch (...) {
+                readError = std::current_exception();
+                chunk->records.clear();
+                last = true;
+            }
+            chunk->last = last;
+            computeQueue.push(chunk);
+        }
+    });
+
+    // Stage 3: format the results and write them out, then recycle the buffer.
+    std::thread writer([&] {
+        bool last = false;
+        while (!last) {
+            BatchChunk *chunk = writeQueue.pop();
+            last = chunk->last;
+            if (!writeError) {
+                stats.records += chunk->records.size();
+                stats.errors += formatChunk(*chunk);
+                if (std::fwrite(chunk->output.data(), 1, chunk->output.size(), output)
+                    != chunk->output.size()) {
+                    writeError = std::make_exception_ptr(
+                        std::runtime_error("Failed to write batch output!"));
+                }
+            }
+            freeQueue.push(chunk);
+        }
+    });
+
+    // Stage 2: compute on the calling thread.
+    bool last = false;
+    while (!last) {
+        BatchChunk *chunk = computeQueue.pop();
+        last = chunk->last;
+        computeChunk(*chunk, precision);
+        writeQueue.push(chunk);
+    }
+
+    reader.join();
+    writer.join();
+    std::fflush(output);
+
+    if (readError) {
+        std::rethrow_exception(readError);
+    }
+    if (writeError) {
+        std::rethrow_exception(writeError);
+    }
+    return stats;
+}
@@ -0,0 +1,69 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <cstddef>
+#include <cstdio>
+
+#include "precision.h"
+
+/**
+ * @brief Streaming evaluator for large batches of complex operations.
+ *
+ * Each input line holds one record: an operator followed by one or two operands,
+ * e.g. "divide 1 2 3 4" or "root -4 0". Every record produces one output line,
+ * either "<real> <imaginary>" or "error: <message>". Blank lines and lines
+ * starting with '#' are skipped. A line longer than the chunk size gives the error
+ * "Line too long!" and is skipped.
+ *
+ * Input is processed in fixed-size chunks which flow through three stages running
+ * on their own threads: read and parse, compute, format and write. A small fixed
+ * set of chunk buffers is recycled between the stages, so memory use is bounded by
+ * the chunk size no matter how large the input is.
+ *
+ * Operands are read as doubles and results written as doubles; in between the
+ * records are computed in the precision given to the constructor.
+ */
+class BatchProcessor {
+public:
+    /**
+     * @brief Counters describing a finished run.
+     */
+    struct Stats {
+        /** @brief Number of records evaluated. */
+        std::size_t records = 0;
+
+        /** @brief Number of records that produced an error line. */
+        std::size_t errors = 0;
+    };
+
+    /**
+     * @brief Constructor.
+     *
+     * @param chunkSize number of input bytes read per chunk (std::size_t).
+     * @param precision precision the records are computed in (Precision).
+     */
+    explicit BatchProcessor(std::size_t chunkSize = 1 << 20, Precision precision = Precision::Double);
+
+    /**
+     * @brief Evaluates every record from input and writes the results to output.
+     *
+     * @param input stream to read records from (std::FILE*).
+     * @param output stream to write results to (std::FILE*).
+     * @throws std::runtime_error If reading or writing fails.
+     * @return counters for the run (Stats).
+     */
+    Stats run(std::FILE *input, std::FILE *output);
+
+private:
+    /**
+     * @brief Number of input bytes read per chunk.
+     */
+    std::size_t chunkSize;
+
+    /**
+     * @brief Precision the records are computed in.
+     */
+    Precision precision;
+};
+
+#endif // BATCHPROCESSOR_H
@@ -0,0 +1,37 @@
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @brief Runs a callable several times and returns the fastest run in seconds.
+ *
+ * @param body code to be timed (Function).
+ * @param repetitions number of runs (int).
+ * @return best wall time in seconds (double).
+ */
+template<typename Function>
+double bestOf(Function body, int repetitions = 5)
+{
+    double best = 1e300;
+    for (int run = 0; run < repetitions; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+/**
+ * @brief Keeps the optimizer from discarding a computed value.
+ */
+template<typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif // BENCHUTIL_H
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+#include "benchutil.h"
+#include "calchistory.h"
+
+// Records 10M calculations into a journal, then reopens and replays it, reporting
+// the time per record and the resident memory along the way.
+
+namespace {
+
+constexpr std::size_t Count = 10000000;
+
+long residentKilobytes()
+{
+    long pages = 0, resident = 0;
+    if (FILE *statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(statm);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+double seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const std::string path = argc > 1 ? argv[1] : "/tmp/complexcalc_history_bench.journal";
+    std::remove(path.c_str());
+    std::printf("journal %s, %zu records, RSS at start %ld kB\n", path.c_str(), Count,
+                residentKilobytes());
+
+    {
+        CalcHistory ringOnly;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < Count; ++k) {
+            const ComplexNumber a(k, 1), b(2, k);
+            ringOnly.record(a, OpCode::Multiply, b, a * b);
+        }
+        std::printf("ring only:  record %6.1f ns, RSS %ld kB\n", seconds(start) * 1e9 / Count,
+                    residentKilobytes());
+    }
+
+    {
+        CalcHistory history;
+        history.openJournal(path);
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < Count; ++k) {
+            const ComplexNumber a(k, 1), b(2, k);
+            history.record(a, OpCode::Multiply, b, a * b);
+        }
+        std::printf("journaled:  record %6.1f ns, RSS %ld kB\n", seconds(start) * 1e9 / Count,
+                    residentKilobytes());
+    }
+
+    CalcHistory reopened;
+    auto start = std::chrono::steady_clock::now();
+    reopened.openJournal(path);
+    std::printf("reopen:     %.3f ms for %zu records\n", seconds(start) * 1e3, reopened.size());
+
+    start = std::chrono::steady_clock::now();
+    const HistoryRecord *records = reopened.journalRecords();
+    ComplexNumber sum;
+    for (std::size_t k = 0; k < reopened.size(); ++k) {
+        sum += records[k].result;
+    }
+    doNotOptimize(sum);
+    std::printf("replay:     %6.2f ns/record (cold), RSS %ld kB\n", seconds(start) * 1e9 / Count,
+                residentKilobytes());
+
+    const HistoryRecord &last = reopened.at(reopened.size() - 1);
+    const bool consistent = reopened.size() == Count
+                            && last.result == ComplexNumber(Count - 1, 1) * ComplexNumber(2, Count - 1);
+    std::printf("last record %s\n", consistent ? "matches" : "DOES NOT MATCH");
+    std::remove(path.c_str());
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include <QApplication>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <unistd.h>
+
+#include "button.h"
+#include "calculator.h"
+
+// Drives a real Calculator through 100k consecutive additions, clicking its buttons
+// and letting the chart repaint after each one, and checks that resident memory and
+// the time per update stay flat over the run.
+
+namespace {
+
+constexpr int Operations = 100000;
+constexpr int Window = 10000;
+
+/**
+ * @brief Resident set size of this process in kilobytes.
+ */
+long residentKilobytes()
+{
+    long pages = 0, resident = 0;
+    if (FILE *statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(statm);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * @brief Value at the given fraction of sorted samples.
+ */
+double percentile(std::vector<double> samples, double fraction)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<std::size_t>(fraction * (samples.size() - 1))];
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    Calculator calculator;
+    calculator.show();
+    QApplication::processEvents();
+
+    auto button = [&](const QString &text) {
+        for (Button *candidate : calculator.findChildren<Button *>()) {
+            if (candidate->text() == text) {
+                return candidate;
+            }
+        }
+        std::fprintf(stderr, "no button %s\n", text.toStdString().c_str());
+        std::exit(2);
+    };
+    Button *clearAll = button("Clear All");
+    Button *plus = button("+");
+    Button *equals = button("=");
+    Button *digits[10];
+    for (int d = 0; d < 10; ++d) {
+        digits[d] = button(QString::number(d));
+    }
+
+    std::printf("%10s %12s %12s %12s\n", "operations", "median us", "p99 us", "RSS kB");
+    std::vector<double> latencies;
+    std::vector<double> medians;
+    std::vector<long> residents;
+    QElapsedTimer timer;
+    for (int op = 1; op <= Operations; ++op) {
+        timer.start();
+        clearAll->click();
+        digits[op % 9 + 1]->click();
+        plus->click();
+        digits[op / 9 % 10]->click();
+        equals->click();
+        QApplication::processEvents();
+        latencies.push_back(timer.nsecsElapsed() / 1e3);
+
+        if (op % Window == 0) {
+            medians.push_back(percentile(latencies, 0.5));
+            residents.push_back(residentKilobytes());
+            std::printf("%10d %12.1f %12.1f %12ld\n", op, medians.back(),
+                        percentile(latencies, 0.99), residents.back());
+            latencies.clear();
+        }
+    }
+
+    // The first window includes warm-up, so compare the second against the last.
+    const double latencyGrowth = medians.back() / medians[1];
+    const long memoryGrowth = residents.back() - residents[1];
+    const bool flat = latencyGrowth < 1.5 && memoryGrowth < 4096;
+    std::printf("median latency x%.2f, RSS %+ld kB from window 2 to %zu: %s\n", latencyGrowth,
+                memoryGrowth, medians.size(), flat ? "flat" : "GROWING");
+    return flat ? 0 : 1;
+}
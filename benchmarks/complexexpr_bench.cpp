@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <random>
+
+#include "benchutil.h"
+#include "complexexpr.h"
+
+// Compares chained ComplexArray methods against one fused expression-template loop
+// for r = a * b + c / d.
+
+namespace {
+
+ComplexArray randomArray(std::size_t count, unsigned seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+    ComplexArray values(count);
+    for (std::size_t k = 0; k < count; ++k) {
+        values.set(k, ComplexNumber(distribution(generator), distribution(generator) + 20.0));
+    }
+    return values;
+}
+
+void report(std::size_t count)
+{
+    const ComplexArray a = randomArray(count, 1), b = randomArray(count, 2);
+    const ComplexArray c = randomArray(count, 3), d = randomArray(count, 4);
+    const int repetitions = count < (1 << 16) ? 200 : 5;
+
+    ComplexArray chainedResult;
+    const double chained = bestOf([&] {
+        chainedResult = a.multiply(b).add(c.divide(d));
+        doNotOptimize(chainedResult);
+    }, repetitions);
+
+    ComplexArray fusedResult;
+    ErrorMask errors;
+    const double fused = bestOf([&] {
+        evaluate(a * b + c / d, fusedResult, errors);
+        doNotOptimize(fusedResult);
+    }, repetitions);
+
+    std::size_t mismatches = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+        mismatches += !(chainedResult.get(k) == fusedResult.get(k));
+    }
+
+    // Every array element is 16 bytes. Chained: three kernels each read two arrays and
+    // write one new one (three temporaries, one of them the result). Fused: four reads,
+    // one write.
+    const double chainedBytes = 9.0 * 16 * count, fusedBytes = 5.0 * 16 * count;
+    std::printf("%9zu elements  chained %6.2f ns/element %6.1f MB   fused %6.2f ns/element %6.1f MB"
+                "   %zu mismatches\n",
+                count, chained * 1e9 / count, chainedBytes / 1e6, fused * 1e9 / count,
+                fusedBytes / 1e6, mismatches);
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("r = a * b + c / d, kernels: %s\n", ComplexArray::simdLevel());
+    for (std::size_t count : {std::size_t(1) << 12, std::size_t(1) << 16, std::size_t(1) << 22}) {
+        report(count);
+    }
+    return 0;
+}
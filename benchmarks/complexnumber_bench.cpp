@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexnumber.h"
+#include "legacycomplex.h"
+
+// Compares the header-inline ComplexNumber against the previous out-of-line layout.
+
+static_assert(!std::is_trivially_copyable<LegacyComplexNumber>::value,
+              "the baseline is expected to be non-trivially copyable");
+
+namespace {
+
+constexpr std::size_t Count = 1 << 20;
+
+template<typename Complex>
+std::vector<Complex> randomNumbers(unsigned seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+    std::vector<Complex> values;
+    values.reserve(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        values.emplace_back(distribution(generator), distribution(generator) + 20.0);
+    }
+    return values;
+}
+
+template<typename Complex>
+void report(const char *name)
+{
+    const auto a = randomNumbers<Complex>(1), b = randomNumbers<Complex>(2);
+    const auto c = randomNumbers<Complex>(3);
+    std::vector<Complex> out(Count);
+
+    const double fused = bestOf([&] {
+        for (std::size_t k = 0; k < Count; ++k) {
+            out[k] = a[k].multiply(b[k]).add(c[k]);
+        }
+        doNotOptimize(out);
+    });
+    const double division = bestOf([&] {
+        for (std::size_t k = 0; k < Count; ++k) {
+            out[k] = a[k].divide(b[k]);
+        }
+        doNotOptimize(out);
+    });
+    const double copy = bestOf([&] {
+        std::vector<Complex> duplicate(a);
+        doNotOptimize(duplicate);
+    });
+
+    std::printf("%-24s  a*b+c %6.2f ns/op   a/b %6.2f ns/op   copy %6.2f ns/element\n", name,
+                fused * 1e9 / Count, division * 1e9 / Count, copy * 1e9 / Count);
+}
+
+} // namespace
+
+int main()
+{
+    report<LegacyComplexNumber>("out-of-line (legacy)");
+    report<ComplexNumber>("header-inline constexpr");
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexkernels.h"
+#include "deepzoom.h"
+#include "fractalrenderer.h"
+
+// Deep zoom into the Mandelbrot set.
+//
+// First checks accuracy at a 1e-8 wide view, where plain double iteration is already
+// unreliable: iteration counts of perturbation and of the double kernel are compared
+// with a direct fixed-point iteration of the same pixels.
+//
+// Then zooms automatically from 1e-3 to 1e-100: at every step a small image is
+// rendered and the view moves to its slowest-escaping pixel. At some depths a
+// 480x270 image is rendered through FractalRenderer and the cost per iteration is
+// compared with the plain double kernels at a shallow view.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const double StartReal = -0.743643887037151, StartImaginary = 0.131825904205330;
+
+/**
+ * @brief Iteration count of one point computed entirely in fixed point.
+ */
+unsigned exactIterations(const FixedPoint &cReal, const FixedPoint &cImaginary, unsigned maxIterations)
+{
+    FixedPoint zr = FixedPoint().withFractionLimbs(cReal.fractionLimbs()), zi = zr;
+    for (unsigned n = 0; n < maxIterations; ++n) {
+        const double real = zr.toDouble(), imaginary = zi.toDouble();
+        if (real * real + imaginary * imaginary >= EscapeRadiusSquared) {
+            return n;
+        }
+        const FixedPoint product = zr * zi;
+        zr = zr * zr - zi * zi + cReal;
+        zi = product + product + cImaginary;
+    }
+    return maxIterations;
+}
+
+unsigned iterationsFor(double width)
+{
+    return 1000 + static_cast<unsigned>(100 * std::max(0.0, -std::log10(width)));
+}
+
+/**
+ * @brief Offsets of the corners of a width x height view centred on the reference.
+ */
+std::vector<ComplexNumber> corners(double halfWidth, double halfHeight)
+{
+    return {ComplexNumber(-halfWidth, halfHeight), ComplexNumber(halfWidth, halfHeight),
+            ComplexNumber(-halfWidth, -halfHeight), ComplexNumber(halfWidth, -halfHeight)};
+}
+
+void checkAccuracy()
+{
+    const int size = 200;
+    const double width = 1e-8, pixel = width / size;
+    const unsigned maxIterations = 2000;
+    const std::size_t limbs = FixedPoint::fractionLimbsFor(pixel);
+    const FixedPoint cReal = FixedPoint::fromDouble(StartReal, limbs);
+    const FixedPoint cImaginary = FixedPoint::fromDouble(StartImaginary, limbs);
+    const ReferenceOrbit orbit = referenceOrbit(cReal, cImaginary, maxIterations);
+    const SeriesApproximation series =
+        seriesApproximation(orbit, std::hypot(width / 2, width / 2), corners(width / 2, width / 2));
+
+    int checked = 0, perturbationRight = 0, doubleRight = 0;
+    std::vector<double> perturbed(size), perturbedModulus(size), plain(size), plainModulus(size);
+    for (int y = 0; y < size; y += 10) {
+        const double offsetImaginary = width / 2 - y * pixel;
+        const EscapeRow relative = {-width / 2, pixel, offsetImaginary, false, 0, 0, maxIterations};
+        perturbRow(orbit, series, relative, size, perturbed.data(), perturbedModulus.data());
+        const EscapeRow absolute = {StartReal - width / 2, pixel, StartImaginary + offsetImaginary, false, 0, 0,
+                                    maxIterations};
+        activeKernels().escapeTime(absolute, size, plain.data(), plainModulus.data());
+        for (int x = 0; x < size; x += 10) {
+            const unsigned exact =
+                exactIterations(cReal + FixedPoint::fromDouble(-width / 2 + x * pixel, limbs),
+                                cImaginary + FixedPoint::fromDouble(offsetImaginary, limbs), maxIterations);
+            ++checked;
+            perturbationRight += perturbed[x] == exact;
+            doubleRight += plain[x] == exact;
+        }
+    }
+    std::printf("1e-8 wide view, %d pixels against fixed-point iteration: perturbation %d right, "
+                "double %d right (series skips %u iterations)\n\n",
+                checked, perturbationRight, doubleRight, series.skip);
+}
+
+/**
+ * @brief Renders a view through FractalRenderer and returns the time to the final image.
+ */
+double renderTime(FractalRenderer &renderer, std::mutex &mutex, std::condition_variable &changed, int &frames,
+                  const FractalView &view)
+{
+    const Clock::time_point start = Clock::now();
+    renderer.render(view);
+    FractalFrame frame;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        changed.wait(lock, [&] { return frames > 0; });
+        frames = 0;
+        lock.unlock();
+        const bool done = renderer.latestFrame(frame) && frame.view == view && frame.step == 1;
+        lock.lock();
+        if (done) {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("%s kernels, %u hardware threads\n\n", activeKernels().name, std::thread::hardware_concurrency());
+    checkAccuracy();
+
+    // Cost per iteration of the double kernels, on a 480x270 view 1e-3 wide (away
+    // from the main cardioid, which the kernels skip without iterating).
+    const int width = 480, height = 270;
+    {
+        const double pixel = 1e-3 / width;
+        double total = 0;
+        std::vector<double> iterations(width), modulus(width);
+        for (const ComplexKernels *kernels : {&scalarKernels, &activeKernels()}) {
+            const double seconds = bestOf([&] {
+                total = 0;
+                for (int y = 0; y < height; ++y) {
+                    const EscapeRow row = {StartReal - 5e-4, pixel, StartImaginary + (height / 2 - y) * pixel,
+                                           false, 0, 0, 2000};
+                    kernels->escapeTime(row, width, iterations.data(), modulus.data());
+                    for (double count : iterations) {
+                        total += count;
+                    }
+                }
+            }, 3);
+            std::printf("double %-7s kernel: %.2f ns per iteration\n", kernels->name, seconds / total * 1e9);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    int frames = 0;
+    FractalRenderer renderer([&] {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++frames;
+        }
+        changed.notify_all();
+    });
+
+    std::printf("\n%8s %6s %10s %6s %12s %11s %11s %9s\n", "width", "limbs", "iterations", "skip", "orbit (ms)",
+                "image (ms)", "iter/pixel", "ns/iter");
+    FixedPoint centerReal = FixedPoint::fromDouble(StartReal, 2);
+    FixedPoint centerImaginary = FixedPoint::fromDouble(StartImaginary, 2);
+    const int probe = 64;
+    std::vector<double> iterations(probe), modulus(probe);
+    const int reports[] = {10, 25, 50, 75, 100};
+    std::size_t nextReport = 0;
+    for (int digits = 3; digits <= 100;) {
+        // Find the slowest-escaping pixel of a small image and move there.
+        const double span = std::pow(10.0, -digits), pixel = span / probe;
+        const unsigned maxIterations = iterationsFor(span);
+        const std::size_t limbs = FixedPoint::fractionLimbsFor(pixel);
+        centerReal = centerReal.withFractionLimbs(limbs);
+        centerImaginary = centerImaginary.withFractionLimbs(limbs);
+
+        const Clock::time_point orbitStart = Clock::now();
+        const ReferenceOrbit orbit = referenceOrbit(centerReal, centerImaginary, maxIterations);
+        const double orbitTime = std::chrono::duration<double>(Clock::now() - orbitStart).count();
+
+        if (nextReport < 5 && digits == reports[nextReport]) {
+            FractalView view;
+            view.kind = FractalKind::DeepMandelbrot;
+            view.centerReal = centerReal;
+            view.centerImaginary = centerImaginary;
+            view.pixelWidth = view.pixelHeight = span / width;
+            view.width = width;
+            view.height = height;
+            view.minReal = -span / 2;
+            view.maxImaginary = view.pixelHeight * height / 2;
+            view.maxIterations = maxIterations;
+
+            const SeriesApproximation series = seriesApproximation(
+                orbit, std::hypot(span / 2, view.maxImaginary), corners(span / 2, view.maxImaginary));
+            double total = 0;
+            for (int y = 0; y < height; y += 8) {
+                const EscapeRow row = {view.minReal, view.pixelWidth, view.maxImaginary - y * view.pixelHeight,
+                                       false, 0, 0, maxIterations};
+                std::vector<double> rowIterations(width), rowModulus(width);
+                perturbRow(orbit, series, row, width, rowIterations.data(), rowModulus.data());
+                for (double count : rowIterations) {
+                    total += count - series.skip;
+                }
+            }
+            const double perPixel = total / (width * ((height + 7) / 8));
+            const double image = renderTime(renderer, mutex, changed, frames, view);
+            std::printf("%8.0e %6zu %10u %6u %12.2f %11.1f %11.0f %9.2f\n", span, limbs, maxIterations,
+                        series.skip, orbitTime * 1e3, image * 1e3, perPixel,
+                        image / (perPixel * width * height) * 1e9);
+            ++nextReport;
+        }
+
+        const SeriesApproximation series =
+            seriesApproximation(orbit, std::hypot(span / 2, span / 2), corners(span / 2, span / 2));
+        double bestCount = -1, bestReal = 0, bestImaginary = 0;
+        for (int y = 0; y < probe; ++y) {
+            const EscapeRow row = {-span / 2, pixel, span / 2 - y * pixel, false, 0, 0, maxIterations};
+            perturbRow(orbit, series, row, probe, iterations.data(), modulus.data());
+            for (int x = 0; x < probe; ++x) {
+                if (iterations[x] < maxIterations && iterations[x] > bestCount) {
+                    bestCount = iterations[x];
+                    bestReal = -span / 2 + x * pixel;
+                    bestImaginary = span / 2 - y * pixel;
+                }
+            }
+        }
+        centerReal = centerReal + FixedPoint::fromDouble(bestReal, limbs);
+        centerImaginary = centerImaginary + FixedPoint::fromDouble(bestImaginary, limbs);
+        ++digits;
+    }
+    std::printf("\nfinal centre %s\n             %s\n", centerReal.toString(105).c_str(),
+                centerImaginary.toString(105).c_str());
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexarray.h"
+
+// A million-element divide with a handful of zero divisors, three ways.
+
+int main()
+{
+    constexpr std::size_t Count = 1 << 20;
+    constexpr std::size_t Zeros = 64;
+
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+    ComplexArray a(Count), b(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        a.set(k, ComplexNumber(distribution(generator), distribution(generator)));
+        b.set(k, ComplexNumber(distribution(generator), distribution(generator)));
+    }
+    for (std::size_t k = 0; k < Zeros; ++k) {
+        b.set(generator() % Count, ComplexNumber(0, 0));
+    }
+
+    std::vector<ComplexNumber> out(Count);
+    std::size_t failures = 0;
+
+    const double throwing = bestOf([&] {
+        failures = 0;
+        for (std::size_t k = 0; k < Count; ++k) {
+            try {
+                out[k] = a.get(k).divide(b.get(k));
+            } catch (const std::invalid_argument &) {
+                out[k] = ComplexNumber(0, 0);
+                ++failures;
+            }
+        }
+        doNotOptimize(out);
+    });
+    std::printf("divide + catch        %7.2f ns/op  (%zu errors)\n", throwing * 1e9 / Count, failures);
+
+    const double status = bestOf([&] {
+        failures = 0;
+        for (std::size_t k = 0; k < Count; ++k) {
+            ComplexStatus result;
+            out[k] = a.get(k).tryDivide(b.get(k), result);
+            failures += result != ComplexStatus::Ok;
+        }
+        doNotOptimize(out);
+    });
+    std::printf("tryDivide             %7.2f ns/op  (%zu errors)\n", status * 1e9 / Count, failures);
+
+    ErrorMask errors;
+    ComplexArray quotient;
+    const double bulk = bestOf([&] {
+        a.divide(b, quotient, errors);
+        doNotOptimize(quotient);
+    });
+    std::printf("ComplexArray (%s)  %7.2f ns/op  (%zu errors)\n", ComplexArray::simdLevel(),
+                bulk * 1e9 / Count, errors.count());
+    return 0;
+}
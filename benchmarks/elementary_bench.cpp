@@ -0,0 +1,290 @@
+#include <cfloat>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexarray.h"
+#include "complexkernels.h"
+
+// Accuracy and speed of the complex elementary functions.
+//
+// Every function is evaluated on three input sets: random points of a box around the
+// origin, random points with magnitudes from 1e-300 to 1e300 and a list of edge cases
+// (signed zeros, infinities, NaNs, huge and tiny parts, both sides of the branch cut
+// of log, the unit circle, multiples of pi / 2). Results are compared with
+// std::complex<long double>, whose 64-bit mantissa makes it exact enough to measure
+// double errors; errors are reported in ulps of each part of that reference.
+//
+// "std" is std::complex<double>, "ours" is ComplexNumber, whose methods run the scalar
+// kernels. The batch kernels of the active instruction set must give the same bits as
+// the scalar ones; results of the wrong class (finite against infinite or NaN) and
+// zeros of the wrong sign are counted separately. Run with COMPLEXCALC_SIMD=scalar,
+// sse2, avx2 or avx512 to time and check the other instruction sets.
+
+namespace {
+
+using Reference = std::complex<long double>;
+
+using UnaryKernel = void (*ComplexKernels::*)(const double *, const double *, double *, double *, std::size_t);
+
+struct Function {
+    const char *name;
+    UnaryKernel kernel;
+    ComplexNumber (ComplexNumber::*method)() const noexcept;
+    std::complex<double> (*standard)(const std::complex<double> &);
+    Reference (*reference)(const Reference &);
+};
+
+const Function functions[] = {
+    {"exp", &ComplexKernels::exponential, &ComplexNumber::exponential,
+     [](const std::complex<double> &z) { return std::exp(z); },
+     [](const Reference &z) { return std::exp(z); }},
+    {"log", &ComplexKernels::logarithm, &ComplexNumber::logarithm,
+     [](const std::complex<double> &z) { return std::log(z); },
+     [](const Reference &z) { return std::log(z); }},
+    {"sin", &ComplexKernels::sine, &ComplexNumber::sine,
+     [](const std::complex<double> &z) { return std::sin(z); },
+     [](const Reference &z) { return std::sin(z); }},
+    {"cos", &ComplexKernels::cosine, &ComplexNumber::cosine,
+     [](const std::complex<double> &z) { return std::cos(z); },
+     [](const Reference &z) { return std::cos(z); }},
+    {"tan", &ComplexKernels::tangent, &ComplexNumber::tangent,
+     [](const std::complex<double> &z) { return std::tan(z); },
+     [](const Reference &z) { return std::tan(z); }},
+    {"sinh", &ComplexKernels::hyperbolicSine, &ComplexNumber::hyperbolicSine,
+     [](const std::complex<double> &z) { return std::sinh(z); },
+     [](const Reference &z) { return std::sinh(z); }},
+    {"cosh", &ComplexKernels::hyperbolicCosine, &ComplexNumber::hyperbolicCosine,
+     [](const std::complex<double> &z) { return std::cosh(z); },
+     [](const Reference &z) { return std::cosh(z); }},
+    {"tanh", &ComplexKernels::hyperbolicTangent, &ComplexNumber::hyperbolicTangent,
+     [](const std::complex<double> &z) { return std::tanh(z); },
+     [](const Reference &z) { return std::tanh(z); }},
+};
+
+/**
+ * @brief Error statistics of one implementation on one input set.
+ */
+struct Errors {
+    double maxUlps = 0;
+    double sumUlps = 0;
+    std::size_t parts = 0;
+    std::size_t wrongClass = 0;
+    std::size_t wrongZeroSign = 0;
+
+    /**
+     * @brief Adds one part of a result.
+     */
+    void add(double value, long double exact)
+    {
+        const double rounded = static_cast<double>(exact);
+        if (std::isnan(rounded) || std::isinf(rounded) || std::isnan(value) || std::isinf(value)) {
+            const bool same = (std::isnan(rounded) && std::isnan(value)) || rounded == value;
+            wrongClass += same ? 0 : 1;
+            return;
+        }
+        if (value == 0 && rounded == 0 && std::signbit(value) != std::signbit(rounded)) {
+            ++wrongZeroSign;
+        }
+        // One ulp of the reference, at least the smallest subnormal.
+        const int exponent = rounded == 0 ? -1074 : std::max(std::ilogb(rounded) - 52, -1074);
+        const double ulps = static_cast<double>(std::fabs(value - exact) / std::ldexp(1.0L, exponent));
+        maxUlps = std::max(maxUlps, ulps);
+        sumUlps += ulps;
+        ++parts;
+    }
+
+    void add(const std::complex<double> &value, const Reference &exact)
+    {
+        add(value.real(), exact.real());
+        add(value.imag(), exact.imag());
+    }
+};
+
+/**
+ * @brief Prints one row of the accuracy table.
+ */
+void printErrors(const char *name, const char *set, const Errors &standard, const Errors &ours,
+                 std::size_t mismatches)
+{
+    std::printf("%-6s %-7s %11.3g %9.3g %5zu %5zu %11.3g %9.3g %5zu %5zu %9zu\n", name, set, standard.maxUlps,
+                standard.parts ? standard.sumUlps / standard.parts : 0.0, standard.wrongClass,
+                standard.wrongZeroSign, ours.maxUlps, ours.parts ? ours.sumUlps / ours.parts : 0.0, ours.wrongClass,
+                ours.wrongZeroSign, mismatches);
+}
+
+/**
+ * @brief Whether the batch kernel gave the same bits as the scalar one.
+ */
+bool sameBits(double a, double b)
+{
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+/**
+ * @brief Edge cases for the unary functions.
+ */
+std::vector<std::complex<double>> edgeCases(std::mt19937_64 &generator)
+{
+    const double inf = HUGE_VAL, nan = std::nan(""), tiny = DBL_MIN, denormal = 5e-324, huge = DBL_MAX;
+    const double parts[] = {0.0,  -0.0,     1.0,       -1.0,      0.5,    -2.0,   1e-300, -1e-300, tiny,
+                            denormal, -denormal, 1e300, -1e300, huge,   -huge,  700.0,  -700.0,  710.0,
+                            -745.0, 1e6,       -1e6,      1e17,   1.5707963267948966,   3.141592653589793,
+                            -3.141592653589793, 1e22, inf, -inf, nan};
+    std::vector<std::complex<double>> cases;
+    for (double x : parts) {
+        for (double y : parts) {
+            cases.emplace_back(x, y);
+        }
+    }
+    // The unit circle and its neighbourhood, where log|z| cancels.
+    std::uniform_real_distribution<double> angle(-3.2, 3.2), nudge(-1e-9, 1e-9);
+    for (int k = 0; k < 2000; ++k) {
+        const double t = angle(generator), r = 1 + (k % 2 ? nudge(generator) : 0.0);
+        cases.emplace_back(r * std::cos(t), r * std::sin(t));
+    }
+    // Both sides of the negative real axis.
+    for (int k = 0; k < 200; ++k) {
+        const double x = -std::ldexp(1.0, k % 60 - 30) * (1 + k * 1e-3);
+        cases.emplace_back(x, k % 2 ? 0.0 : -0.0);
+        cases.emplace_back(x, k % 2 ? 1e-200 : -1e-200);
+    }
+    // Multiples of pi / 2, where the reduced argument is smallest.
+    for (int k = -2000; k <= 2000; ++k) {
+        const double x = k * 1.5707963267948966;
+        cases.emplace_back(x, 0.0);
+        cases.emplace_back(std::nextafter(x, inf), 0.5);
+        cases.emplace_back(0.25, x);
+    }
+    return cases;
+}
+
+/**
+ * @brief Accuracy of one unary function on one input set, returns nothing but prints a row.
+ */
+void checkUnary(const Function &function, const char *set, const std::vector<std::complex<double>> &inputs)
+{
+    const std::size_t n = inputs.size();
+    ComplexArray arguments(n), scalar(n), batch(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        arguments.set(k, ComplexNumber(inputs[k].real(), inputs[k].imag()));
+    }
+    (scalarKernels.*function.kernel)(arguments.real(), arguments.imaginary(), scalar.real(), scalar.imaginary(), n);
+    (activeKernels().*function.kernel)(arguments.real(), arguments.imaginary(), batch.real(), batch.imaginary(), n);
+
+    Errors standard, ours;
+    std::size_t mismatches = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        const Reference exact = function.reference(Reference(inputs[k].real(), inputs[k].imag()));
+        standard.add(function.standard(inputs[k]), exact);
+        ours.add(std::complex<double>(scalar.real()[k], scalar.imaginary()[k]), exact);
+        mismatches += sameBits(scalar.real()[k], batch.real()[k]) && sameBits(scalar.imaginary()[k], batch.imaginary()[k])
+                          ? 0
+                          : 1;
+    }
+    printErrors(function.name, set, standard, ours, mismatches);
+}
+
+/**
+ * @brief Accuracy of pow on one input set.
+ */
+void checkPower(const char *set, const std::vector<std::complex<double>> &bases,
+                const std::vector<std::complex<double>> &exponents)
+{
+    const std::size_t n = bases.size();
+    ComplexArray a(n), b(n), scalar(n), batch(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        a.set(k, ComplexNumber(bases[k].real(), bases[k].imag()));
+        b.set(k, ComplexNumber(exponents[k].real(), exponents[k].imag()));
+    }
+    scalarKernels.power(a.real(), a.imaginary(), b.real(), b.imaginary(), scalar.real(), scalar.imaginary(), n);
+    activeKernels().power(a.real(), a.imaginary(), b.real(), b.imaginary(), batch.real(), batch.imaginary(), n);
+
+    Errors standard, ours;
+    std::size_t mismatches = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        const Reference exact = std::pow(Reference(bases[k].real(), bases[k].imag()),
+                                         Reference(exponents[k].real(), exponents[k].imag()));
+        standard.add(std::pow(bases[k], exponents[k]), exact);
+        ours.add(std::complex<double>(scalar.real()[k], scalar.imaginary()[k]), exact);
+        mismatches += sameBits(scalar.real()[k], batch.real()[k]) && sameBits(scalar.imaginary()[k], batch.imaginary()[k])
+                          ? 0
+                          : 1;
+    }
+    printErrors("pow", set, standard, ours, mismatches);
+}
+
+} // namespace
+
+int main()
+{
+    constexpr std::size_t Count = 1 << 16;
+    std::mt19937_64 generator(16);
+    std::uniform_real_distribution<double> box(-10.0, 10.0), decades(-300.0, 300.0), sign(-1.0, 1.0);
+
+    std::vector<std::complex<double>> boxed(Count), wide(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        boxed[k] = {box(generator), box(generator)};
+        wide[k] = {std::copysign(std::pow(10.0, decades(generator)), sign(generator)),
+                   std::copysign(std::pow(10.0, decades(generator)), sign(generator))};
+    }
+    const std::vector<std::complex<double>> edges = edgeCases(generator);
+
+    std::printf("%s kernels; errors in ulps of each part against std::complex<long double>\n\n",
+                activeKernels().name);
+    std::printf("%-6s %-7s %11s %9s %5s %5s %11s %9s %5s %5s %9s\n", "", "", "std max", "mean", "class", "zero",
+                "ours max", "mean", "class", "zero", "batch!=1");
+    for (const Function &function : functions) {
+        checkUnary(function, "box", boxed);
+        checkUnary(function, "wide", wide);
+        checkUnary(function, "edge", edges);
+    }
+    {
+        std::uniform_real_distribution<double> small(-4.0, 4.0);
+        std::vector<std::complex<double>> exponents(Count), edgeExponents(edges.size());
+        for (auto &exponent : exponents) {
+            exponent = {small(generator), small(generator)};
+        }
+        for (std::size_t k = 0; k < edges.size(); ++k) {
+            edgeExponents[k] = edges[(k * 7919) % edges.size()];
+        }
+        checkPower("box", boxed, exponents);
+        checkPower("edge", edges, edgeExponents);
+    }
+
+    // Speed on the box, where every element takes the fast path.
+    std::printf("\n%-6s %12s %12s %12s %9s\n", "", "std (ns)", "ours (ns)", "batch (ns)", "speedup");
+    ComplexArray input(Count), output(Count);
+    std::vector<ComplexNumber> numbers(Count), results(Count);
+    std::vector<std::complex<double>> standardResults(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        input.set(k, ComplexNumber(boxed[k].real(), boxed[k].imag()));
+        numbers[k] = input.get(k);
+    }
+    for (const Function &function : functions) {
+        const double standard = bestOf([&] {
+            for (std::size_t k = 0; k < Count; ++k) {
+                standardResults[k] = function.standard(boxed[k]);
+            }
+            doNotOptimize(standardResults);
+        });
+        const double ours = bestOf([&] {
+            for (std::size_t k = 0; k < Count; ++k) {
+                results[k] = (numbers[k].*function.method)();
+            }
+            doNotOptimize(results);
+        });
+        const double batch = bestOf([&] {
+            (activeKernels().*function.kernel)(input.real(), input.imaginary(), output.real(), output.imaginary(),
+                                               Count);
+            doNotOptimize(output);
+        });
+        std::printf("%-6s %12.2f %12.2f %12.2f %8.1fx\n", function.name, standard / Count * 1e9, ours / Count * 1e9,
+                    batch / Count * 1e9, standard / batch);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchutil.h"
+#include "expression.h"
+
+// Re-evaluates one compiled expression over a million variable bindings, then checks
+// the block VM against applyOperation() for powers of variables, where the target
+// register is also an operand.
+
+int main()
+{
+    constexpr std::size_t Count = 1 << 20;
+    const Expression expression("(3+2i)*(1-i)/sqrt(4i) + conj(z) * (z - 1/(z+2))");
+
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+    ComplexArray z(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        z.set(k, ComplexNumber(distribution(generator), distribution(generator)));
+    }
+
+    std::printf("%zu instructions after constant folding\n", expression.instructionCount());
+
+    ComplexArray scalarResult(Count);
+    const double scalar = bestOf([&] {
+        ComplexStatus status;
+        for (std::size_t k = 0; k < Count; ++k) {
+            const ComplexNumber binding = z.get(k);
+            scalarResult.set(k, expression.evaluate(&binding, status));
+        }
+        doNotOptimize(scalarResult);
+    });
+
+    ComplexArray blockResult;
+    ErrorMask errors;
+    const double block = bestOf([&] {
+        expression.evaluate({&z}, blockResult, errors);
+        doNotOptimize(blockResult);
+    });
+
+    const ComplexNumber constant = ComplexNumber(3, 2) * ComplexNumber(1, -1) / ComplexNumber(0, 4).root();
+    std::vector<ComplexNumber> nativeResult(Count);
+    const double native = bestOf([&] {
+        for (std::size_t k = 0; k < Count; ++k) {
+            const ComplexNumber v = z.get(k);
+            nativeResult[k] = constant + v.conjugate() * (v - ComplexNumber(1, 0) / (v + ComplexNumber(2, 0)));
+        }
+        doNotOptimize(nativeResult);
+    });
+
+    std::size_t mismatches = 0;
+    for (std::size_t k = 0; k < Count; ++k) {
+        mismatches += !(scalarResult.get(k) == blockResult.get(k) && blockResult.get(k) == nativeResult[k]);
+    }
+
+    std::printf("scalar VM           %7.2f ns/evaluation\n", scalar * 1e9 / Count);
+    std::printf("block VM (%s)    %7.2f ns/evaluation\n", ComplexArray::simdLevel(), block * 1e9 / Count);
+    std::printf("hand-written C++    %7.2f ns/evaluation\n", native * 1e9 / Count);
+    std::printf("%zu mismatching results\n", mismatches);
+
+    // Whole and fractional exponents, including the x=3, y=2 and x=2+i, y=3 cases.
+    const Expression power("x^y");
+    const std::size_t powerCount = 4096;
+    ComplexArray x(powerCount), y(powerCount);
+    x.set(0, ComplexNumber(3, 0));
+    y.set(0, ComplexNumber(2, 0));
+    x.set(1, ComplexNumber(2, 1));
+    y.set(1, ComplexNumber(3, 0));
+    std::uniform_int_distribution<int> whole(-4, 4);
+    for (std::size_t k = 2; k < powerCount; ++k) {
+        x.set(k, ComplexNumber(distribution(generator), distribution(generator)));
+        y.set(k, k % 2 == 0 ? ComplexNumber(whole(generator), 0)
+                            : ComplexNumber(distribution(generator) / 4, distribution(generator) / 4));
+    }
+    ComplexArray powerResult;
+    power.evaluate({&x, &y}, powerResult, errors);
+    std::size_t powerMismatches = 0;
+    for (std::size_t k = 0; k < powerCount; ++k) {
+        ComplexStatus status = ComplexStatus::Ok;
+        const ComplexNumber expected = applyOperation(OpCode::Power, x.get(k), y.get(k), status);
+        powerMismatches += !(powerResult.get(k) == expected || (errors.test(k) && status != ComplexStatus::Ok));
+    }
+    std::printf("%zu mismatching x^y results against applyOperation()\n", powerMismatches);
+    return mismatches + powerMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexkernels.h"
+#include "fft.h"
+
+// Times FftPlan on power-of-two, power-of-three, power-of-five, mixed and prime
+// sizes, checks it against a naive O(n^2) DFT built from ComplexNumber::multiply
+// and add, and checks that inverse(forward(x)) gives x back.
+//
+// FFT speed is reported in the usual nominal GFLOPS, 5 n log2(n) / time; the naive
+// DFT is reported with its real count of 8 n^2 flops (one multiply and one add per
+// term).
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+/**
+ * @brief Naive DFT over a precomputed table of the n-th roots of unity.
+ */
+void naiveDft(const std::vector<ComplexNumber> &input, const std::vector<ComplexNumber> &roots,
+              std::vector<ComplexNumber> &output)
+{
+    const std::size_t n = input.size();
+    for (std::size_t k = 0; k < n; ++k) {
+        ComplexNumber sum;
+        std::size_t index = 0; // j * k mod n
+        for (std::size_t j = 0; j < n; ++j) {
+            sum = sum.add(input[j].multiply(roots[index]));
+            index += k;
+            if (index >= n) {
+                index -= n;
+            }
+        }
+        output[k] = sum;
+    }
+}
+
+/**
+ * @brief Largest modulus of the difference, relative to the largest modulus of b.
+ */
+double relativeError(const ComplexArray &a, const ComplexArray &b)
+{
+    double error = 0, scale = 0;
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        error = std::max(error, a.get(k).subtract(b.get(k)).absoluteValue());
+        scale = std::max(scale, b.get(k).absoluteValue());
+    }
+    return error / scale;
+}
+
+} // namespace
+
+int main()
+{
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%s kernels, %u hardware threads\n\n", activeKernels().name, hardware);
+    std::printf("%9s %10s %11s %9s %9s %10s %11s %10s %9s\n", "size", "algorithm", "time (us)", "GFLOPS",
+                "threads", "GFLOPS", "naive (us)", "GFLOPS", "error");
+
+    std::mt19937_64 generator(13);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+    for (std::size_t n : {256u, 1000u, 1024u, 4096u, 10007u, 59049u, 65536u, 78125u, 1048576u}) {
+        ComplexArray input(n), output(n), back(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            input.set(k, ComplexNumber(uniform(generator), uniform(generator)));
+        }
+
+        const auto plan = FftPlan::cached(n);
+        const int repetitions = n > (1u << 18) ? 5 : 20;
+        const double nominal = 5.0 * n * std::log2(static_cast<double>(n));
+        const double single = bestOf([&] { plan->forward(input, output, 1); }, repetitions);
+        const double threaded = bestOf([&] { plan->forward(input, output, 0); }, repetitions);
+
+        // In place, through the same buffer.
+        back = output;
+        plan->inverse(back, back);
+        const double roundTrip = relativeError(back, input);
+
+        std::printf("%9zu %10s %11.1f %9.2f %9u %10.2f", n, plan->usesBluestein() ? "bluestein" : "stockham",
+                    single * 1e6, nominal / single * 1e-9, hardware, nominal / threaded * 1e-9);
+
+        if (n <= 10007) {
+            std::vector<ComplexNumber> x(n), roots(n), expected(n);
+            for (std::size_t k = 0; k < n; ++k) {
+                x[k] = input.get(k);
+                const double angle = -2 * Pi * static_cast<double>(k) / static_cast<double>(n);
+                roots[k] = ComplexNumber(std::cos(angle), std::sin(angle));
+            }
+            const double naive = bestOf([&] { naiveDft(x, roots, expected); }, n > 4096 ? 1 : 3);
+            const double error = relativeError(output, ComplexArray(expected));
+            std::printf(" %11.1f %10.2f %9.1e", naive * 1e6, 8.0 * n * n / naive * 1e-9, error);
+        } else {
+            std::printf(" %11s %10s %9s", "-", "-", "-");
+        }
+        std::printf("   round trip %.1e\n", roundTrip);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "complexkernels.h"
+#include "fractalrenderer.h"
+
+// Renders 1920x1080 Mandelbrot and Julia views through FractalRenderer and reports
+// the time from render() to the first (8x8 block) image and to the final image, for
+// one thread and for all hardware threads. The last test starts a second view while
+// the first is still rendering and reports how long the abandoned one delays it.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Collects the frame callbacks of a renderer.
+ */
+struct FrameWaiter {
+    std::mutex mutex;
+    std::condition_variable changed;
+    int frames = 0;
+
+    void notify()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++frames;
+        }
+        changed.notify_all();
+    }
+};
+
+/**
+ * @brief Waits until the renderer publishes an image of the view with the given step.
+ */
+double waitFor(FractalRenderer &renderer, FrameWaiter &waiter, const FractalView &view, int step,
+               Clock::time_point start)
+{
+    FractalFrame frame;
+    std::unique_lock<std::mutex> lock(waiter.mutex);
+    for (;;) {
+        waiter.changed.wait(lock, [&] { return waiter.frames > 0; });
+        waiter.frames = 0;
+        lock.unlock();
+        const bool done = renderer.latestFrame(frame) && frame.view == view && frame.step <= step;
+        lock.lock();
+        if (done) {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+    }
+}
+
+FractalView view1080(FractalKind kind, double centerReal, double centerImaginary, double width)
+{
+    FractalView view;
+    view.kind = kind;
+    view.width = 1920;
+    view.height = 1080;
+    view.pixelWidth = view.pixelHeight = width / view.width;
+    view.minReal = centerReal - width / 2;
+    view.maxImaginary = centerImaginary + view.pixelHeight * view.height / 2;
+    return view;
+}
+
+} // namespace
+
+int main()
+{
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("1920x1080, 256 iterations, %s kernels, %u hardware threads\n\n", activeKernels().name,
+                hardware);
+
+    struct Case {
+        const char *name;
+        FractalView view;
+    };
+    Case cases[] = {
+        {"mandelbrot, whole set", view1080(FractalKind::Mandelbrot, -0.75, 0, 4.0)},
+        {"mandelbrot, seahorse valley", view1080(FractalKind::Mandelbrot, -0.745, 0.113, 0.02)},
+        {"julia, c = -0.8+0.156i", view1080(FractalKind::Julia, 0, 0, 3.6)},
+    };
+    cases[2].view.c = ComplexNumber(-0.8, 0.156);
+
+    std::printf("%-30s %8s %12s %12s\n", "view", "threads", "first (ms)", "final (ms)");
+    for (unsigned threads : {1u, hardware}) {
+        FrameWaiter waiter;
+        FractalRenderer renderer([&waiter] { waiter.notify(); }, threads);
+        for (const Case &test : cases) {
+            double first = 1e300, last = 1e300;
+            for (int run = 0; run < 3; ++run) {
+                // Shift the view by a pixel so every run is a new request.
+                FractalView view = test.view;
+                view.minReal += run * view.pixelWidth;
+                const Clock::time_point start = Clock::now();
+                renderer.render(view);
+                first = std::min(first, waitFor(renderer, waiter, view, 8, start));
+                last = std::min(last, waitFor(renderer, waiter, view, 1, start));
+            }
+            std::printf("%-30s %8u %12.1f %12.1f\n", test.name, threads, first * 1e3, last * 1e3);
+        }
+        if (threads == hardware) {
+            break;
+        }
+    }
+
+    // Zoom while rendering: the second view is requested right after the first one.
+    FrameWaiter waiter;
+    FractalRenderer renderer([&waiter] { waiter.notify(); }, 0);
+    const FractalView alone = cases[1].view;
+    Clock::time_point start = Clock::now();
+    renderer.render(alone);
+    const double single = waitFor(renderer, waiter, alone, 1, start);
+
+    FractalView zoomed = alone;
+    zoomed.minReal += zoomed.pixelWidth;
+    renderer.render(cases[0].view);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    start = Clock::now();
+    renderer.render(zoomed);
+    const double afterCancel = waitFor(renderer, waiter, zoomed, 1, start);
+    std::printf("\nseahorse valley alone %.1f ms, after cancelling a render in flight %.1f ms\n", single * 1e3,
+                afterCancel * 1e3);
+    return 0;
+}
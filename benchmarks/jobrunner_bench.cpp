@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "jobrunner.h"
+#include "rootfinder.h"
+
+// What the calculator's GUI thread sees of a polynomial root search: run inline it
+// blocks for the whole search; run as a job the delivering thread only waits for
+// notifications, and the longest single call it makes into the runner (deliverNext,
+// pending, progress) is reported. Also measured: how long a cancelled search keeps its
+// thread busy, and the round trip of an empty job.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds(Clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+/**
+ * @brief Wakes the waiting "GUI" thread, the job-runner counterpart of a queued call.
+ */
+struct Notifier {
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool signalled = false;
+
+    void notify()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            signalled = true;
+        }
+        changed.notify_one();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait_for(lock, std::chrono::milliseconds(16), [this] { return signalled; });
+        signalled = false;
+    }
+};
+
+ComplexPolynomial randomPolynomial(std::size_t degree)
+{
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<ComplexNumber> coefficients;
+    for (std::size_t k = 0; k <= degree; ++k) {
+        coefficients.emplace_back(uniform(generator), uniform(generator));
+    }
+    return ComplexPolynomial(coefficients);
+}
+
+JobRunner::Work rootJob(const ComplexPolynomial &polynomial, std::size_t &found)
+{
+    return [&polynomial, &found](JobControl &control) -> JobRunner::Completion {
+        const PolynomialRoots roots = findRoots(polynomial, 200, 0, [&control](std::size_t done, std::size_t n) {
+            control.setProgress(static_cast<double>(done) / n);
+            return !control.cancelled();
+        });
+        const std::size_t count = roots.convergedCount();
+        return [&found, count] { found = count; };
+    };
+}
+
+} // namespace
+
+int main()
+{
+    constexpr std::size_t Degree = 3000;
+    const ComplexPolynomial polynomial = randomPolynomial(Degree);
+
+    Clock::time_point start = Clock::now();
+    const std::size_t inlineConverged = findRoots(polynomial).convergedCount();
+    const double inlineTime = milliseconds(Clock::now() - start);
+    std::printf("degree %zu roots inline: GUI blocked %.1f ms, %zu converged\n", Degree, inlineTime,
+                inlineConverged);
+
+    Notifier notifier;
+    {
+        JobRunner runner([&notifier] { notifier.notify(); }, 1);
+        std::size_t found = 0;
+        Clock::duration longest{};
+        int wakeups = 0;
+        start = Clock::now();
+        runner.submit(rootJob(polynomial, found));
+        while (found == 0) {
+            notifier.wait();
+            ++wakeups;
+            const Clock::time_point call = Clock::now();
+            while (runner.deliverNext()) {
+            }
+            runner.pending();
+            runner.progress();
+            longest = std::max(longest, Clock::now() - call);
+        }
+        std::printf("as a job: done after %.1f ms, %d wakeups, longest GUI call %.3f ms, %zu converged\n",
+                    milliseconds(Clock::now() - start), wakeups, milliseconds(longest), found);
+
+        // Cancel at 10%, then time an empty job queued behind the search on the same thread.
+        found = 0;
+        runner.submit(rootJob(polynomial, found));
+        while (runner.progress() < 10) {
+            notifier.wait();
+        }
+        bool emptyDone = false;
+        start = Clock::now();
+        runner.cancelAll();
+        runner.submit([&emptyDone](JobControl &) -> JobRunner::Completion {
+            return [&emptyDone] { emptyDone = true; };
+        });
+        while (!emptyDone) {
+            notifier.wait();
+            while (runner.deliverNext()) {
+            }
+        }
+        std::printf("cancel at 10%%: thread free again after %.2f ms, result %s\n",
+                    milliseconds(Clock::now() - start), found == 0 ? "dropped" : "DELIVERED");
+    }
+
+    {
+        constexpr int Jobs = 20000;
+        JobRunner runner([&notifier] { notifier.notify(); }, 2);
+        int delivered = 0;
+        start = Clock::now();
+        for (int k = 0; k < Jobs; ++k) {
+            runner.submit([&delivered](JobControl &) -> JobRunner::Completion {
+                return [&delivered] { ++delivered; };
+            });
+        }
+        while (delivered < Jobs) {
+            notifier.wait();
+            while (runner.deliverNext()) {
+            }
+        }
+        std::printf("empty jobs: %.2f us per submit + deliver\n",
+                    milliseconds(Clock::now() - start) * 1e3 / Jobs);
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include "legacycomplex.h"
+
+#include <stdexcept>
+
+LegacyComplexNumber::LegacyComplexNumber(double a, double b) : real(a), imaginary(b) {}
+
+LegacyComplexNumber::~LegacyComplexNumber() {}
+
+LegacyComplexNumber LegacyComplexNumber::add(const LegacyComplexNumber& other) const {
+    return LegacyComplexNumber(real + other.real, imaginary + other.imaginary);
+}
+
+LegacyComplexNumber LegacyComplexNumber::multiply(const LegacyComplexNumber& other) const {
+    return LegacyComplexNumber(real * other.real - imaginary * other.imaginary,
+                               real * other.imaginary + imaginary * other.real);
+}
+
+LegacyComplexNumber LegacyComplexNumber::divide(const LegacyComplexNumber& other) const {
+    if (other.real == 0 && other.imaginary == 0) {
+        throw std::invalid_argument("Division by zero!");
+    }
+
+    const double denominator = other.real * other.real + other.imaginary * other.imaginary;
+    return LegacyComplexNumber((real * other.real + imaginary * other.imaginary) / denominator,
+                               (imaginary * other.real - real * other.imaginary) / denominator);
+}
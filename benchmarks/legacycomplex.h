@@ -0,0 +1,27 @@
+#ifndef LEGACYCOMPLEX_H
+#define LEGACYCOMPLEX_H
+
+/**
+ * @brief The ComplexNumber layout before it became header-inline.
+ *
+ * User-provided destructor and out-of-line arithmetic, kept only as the
+ * baseline for complexnumber_bench.
+ */
+class LegacyComplexNumber {
+public:
+    LegacyComplexNumber(double a = 0, double b = 0);
+    ~LegacyComplexNumber();
+
+    double getReal() const { return real; }
+    double getImaginary() const { return imaginary; }
+
+    LegacyComplexNumber add(const LegacyComplexNumber& other) const;
+    LegacyComplexNumber multiply(const LegacyComplexNumber& other) const;
+    LegacyComplexNumber divide(const LegacyComplexNumber& other) const;
+
+private:
+    double real;
+    double imaginary;
+};
+
+#endif // LEGACYCOMPLEX_H
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "benchutil.h"
+#include "calcmemory.h"
+
+// Accumulates 16M values whose exact sum is known into memory, once with the old
+// plain running sum and once through the compensated registers, and checks that
+// the parallel range sum is identical for every thread count.
+
+int main()
+{
+    constexpr std::size_t Pairs = 1 << 23;
+    constexpr std::size_t Ones = 1000;
+
+    // Pairs +r, -r spanning nine orders of magnitude cancel exactly; the Ones
+    // values 1+1i make the exact sum Ones + Ones*i.
+    std::mt19937_64 generator(11);
+    std::uniform_real_distribution<double> exponent(-3.0, 6.0);
+    std::vector<ComplexNumber> values;
+    values.reserve(2 * Pairs + Ones);
+    for (std::size_t k = 0; k < Pairs; ++k) {
+        const ComplexNumber r(std::pow(10.0, exponent(generator)), std::pow(10.0, exponent(generator)));
+        values.push_back(r);
+        values.push_back(ComplexNumber(-r.getReal(), -r.getImaginary()));
+    }
+    values.insert(values.end(), Ones, ComplexNumber(1, 1));
+    std::shuffle(values.begin(), values.end(), generator);
+    const std::size_t count = values.size();
+
+    auto error = [](const ComplexNumber &sum) {
+        return std::hypot(sum.getReal() - Ones, sum.getImaginary() - Ones);
+    };
+
+    ComplexNumber naive;
+    const double naiveTime = bestOf([&] {
+        naive = ComplexNumber();
+        for (const ComplexNumber &value : values) {
+            naive = naive.add(value);
+        }
+        doNotOptimize(naive);
+    }, 3);
+
+    ComplexNumber single;
+    const double singleTime = bestOf([&] {
+        CalcMemory memory;
+        for (const ComplexNumber &value : values) {
+            memory.addToMemory(value);
+        }
+        single = memory.readMemory();
+        doNotOptimize(single);
+    }, 3);
+
+    std::printf("%zu values, exact sum %zu+%zui\n", count, Ones, Ones);
+    std::printf("%-26s %9.2f ns/value  error %.3g\n", "plain running sum", naiveTime * 1e9 / count,
+                error(naive));
+    std::printf("%-26s %9.2f ns/value  error %.3g\n", "addToMemory (Neumaier)", singleTime * 1e9 / count,
+                error(single));
+
+    ComplexNumber reference;
+    bool identical = true;
+    for (unsigned threads : {1u, 2u, 3u, 4u, 8u, 16u}) {
+        ComplexNumber sum;
+        const double time = bestOf([&] {
+            CalcMemory memory;
+            memory.addRangeToMemory(values.data(), count, "M1", threads);
+            sum = memory.readMemory("M1");
+            doNotOptimize(sum);
+        }, 3);
+        if (threads == 1) {
+            reference = sum;
+        }
+        identical = identical && std::memcmp(&sum, &reference, sizeof(sum)) == 0;
+        std::printf("addRangeToMemory %2u thr    %9.2f ns/value  error %.3g\n", threads,
+                    time * 1e9 / count, error(sum));
+    }
+    std::printf("results %s across thread counts\n", identical ? "bit-identical" : "DIFFER");
+    return identical ? 0 : 1;
+}
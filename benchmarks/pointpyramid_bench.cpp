@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchutil.h"
+#include "pointpyramid.h"
+
+// Plots a random-walk trajectory of 8M points at several zoom levels and compares
+// the level-of-detail selection with handing every visible point to the chart.
+
+int main()
+{
+    constexpr std::size_t Count = 1 << 23;
+    constexpr int Width = 800, Height = 600;
+    constexpr std::size_t MaxPoints = 50000;
+
+    std::mt19937_64 generator(9);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::vector<ComplexNumber> walk;
+    walk.reserve(Count);
+    ComplexNumber position;
+    for (std::size_t k = 0; k < Count; ++k) {
+        position += ComplexNumber(step(generator), step(generator));
+        walk.push_back(position);
+    }
+
+    PointPyramid pyramid;
+    const double build = bestOf([&] {
+        pyramid.clear();
+        for (const ComplexNumber &point : walk) {
+            pyramid.append(point);
+        }
+    }, 3);
+    std::printf("%zu points, append %.1f ns/point\n", pyramid.size(), build * 1e9 / Count);
+
+    const PointPyramid::Bounds all = pyramid.bounds();
+    const ComplexNumber centre = walk[Count / 2];
+    std::vector<ComplexNumber> out;
+    std::printf("%10s %12s %12s %12s %14s\n", "zoom", "select ms", "points", "covered", "full scan ms");
+    for (double zoom : {1.0, 10.0, 100.0, 1000.0, 10000.0}) {
+        const double halfWidth = (all.maxReal - all.minReal) / 2 / zoom;
+        const double halfHeight = (all.maxImaginary - all.minImaginary) / 2 / zoom;
+        const PointPyramid::Bounds view = {centre.getReal() - halfWidth, centre.getReal() + halfWidth,
+                                           centre.getImaginary() - halfHeight,
+                                           centre.getImaginary() + halfHeight};
+
+        std::size_t covered = 0;
+        const double select = bestOf([&] {
+            covered = pyramid.select(view, Width, Height, MaxPoints, out);
+            doNotOptimize(out);
+        });
+
+        std::vector<ComplexNumber> visible;
+        const double scan = bestOf([&] {
+            visible.clear();
+            for (const ComplexNumber &point : walk) {
+                if (view.minReal <= point.getReal() && point.getReal() <= view.maxReal
+                    && view.minImaginary <= point.getImaginary()
+                    && point.getImaginary() <= view.maxImaginary) {
+                    visible.push_back(point);
+                }
+            }
+            doNotOptimize(visible);
+        });
+
+        std::printf("%10g %12.3f %12zu %12zu %14.3f (%zu points)\n", zoom, select * 1e3, out.size(),
+                    covered, scan * 1e3, visible.size());
+    }
+    return 0;
+}
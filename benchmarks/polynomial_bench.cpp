@@ -0,0 +1,182 @@
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexkernels.h"
+#include "polynomial.h"
+
+// Integer powers: binary exponentiation against repeated multiplication and
+// std::pow, timed and checked against a long double reference. Polynomials: Horner
+// and Estrin over 4M points for several degrees, scalar, SIMD and threaded, with a
+// check that the SIMD kernels give the bits of the scalar ones for each scheme.
+
+namespace {
+
+constexpr std::size_t PowerCount = 1 << 16;
+constexpr std::size_t PointCount = 1 << 22;
+
+/**
+ * @brief Relative error of a against the reference, in units of double epsilon.
+ */
+double relativeError(const ComplexNumber &a, const std::complex<long double> &reference)
+{
+    const long double dr = a.getReal() - reference.real(), di = a.getImaginary() - reference.imag();
+    return static_cast<double>(std::sqrt(dr * dr + di * di) / std::abs(reference)) / 0x1p-52;
+}
+
+/**
+ * @brief z^n in long double through the polar form.
+ */
+std::complex<long double> referencePower(const ComplexNumber &z, int n)
+{
+    const std::complex<long double> w(z.getReal(), z.getImaginary());
+    return std::polar(std::pow(std::abs(w), static_cast<long double>(n)), n * std::arg(w));
+}
+
+void benchPowers()
+{
+    std::mt19937_64 generator(17);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI), modulus(0.99, 1.01);
+    std::vector<ComplexNumber> bases(PowerCount);
+    for (ComplexNumber &z : bases) {
+        const double r = modulus(generator), t = angle(generator);
+        z = ComplexNumber(r * std::cos(t), r * std::sin(t));
+    }
+
+    std::printf("integer powers of %zu numbers near the unit circle (ns per power, error in eps)\n",
+                PowerCount);
+    std::printf("%6s %10s %10s %10s %10s %10s %10s\n", "n", "binary", "repeated", "std::pow", "binary",
+                "repeated", "std::pow");
+    for (int n : {2, 5, 10, 50, 100, 1000, -50}) {
+        ComplexNumber sink;
+        const double binary = bestOf([&] {
+            for (const ComplexNumber &z : bases) {
+                sink = sink + z.power(n);
+            }
+            doNotOptimize(sink);
+        }, 3);
+        const double repeated = bestOf([&] {
+            for (const ComplexNumber &z : bases) {
+                const ComplexNumber base = n < 0 ? z.inverse() : z;
+                ComplexNumber p = base;
+                for (int k = 1; k < std::abs(n); ++k) {
+                    p = p * base;
+                }
+                sink = sink + p;
+            }
+            doNotOptimize(sink);
+        }, 3);
+        std::complex<double> stdSink;
+        const double library = bestOf([&] {
+            for (const ComplexNumber &z : bases) {
+                stdSink += std::pow(std::complex<double>(z.getReal(), z.getImaginary()), n);
+            }
+            doNotOptimize(stdSink);
+        }, 3);
+
+        double binaryError = 0, repeatedError = 0, libraryError = 0;
+        for (const ComplexNumber &z : bases) {
+            const std::complex<long double> reference = referencePower(z, n);
+            const ComplexNumber base = n < 0 ? z.inverse() : z;
+            ComplexNumber p = base;
+            for (int k = 1; k < std::abs(n); ++k) {
+                p = p * base;
+            }
+            const std::complex<double> s = std::pow(std::complex<double>(z.getReal(), z.getImaginary()), n);
+            binaryError = std::max(binaryError, relativeError(z.power(n), reference));
+            repeatedError = std::max(repeatedError, relativeError(p, reference));
+            libraryError = std::max(libraryError, relativeError(ComplexNumber(s.real(), s.imag()), reference));
+        }
+        std::printf("%6d %10.2f %10.2f %10.2f %10.1f %10.1f %10.1f\n", n, binary * 1e9 / PowerCount,
+                    repeated * 1e9 / PowerCount, library * 1e9 / PowerCount, binaryError, repeatedError,
+                    libraryError);
+    }
+}
+
+bool sameBits(const ComplexArray &a, const ComplexArray &b)
+{
+    return std::memcmp(a.real(), b.real(), a.size() * sizeof(double)) == 0
+           && std::memcmp(a.imaginary(), b.imaginary(), a.size() * sizeof(double)) == 0;
+}
+
+bool benchPolynomials()
+{
+    std::mt19937_64 generator(18);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    ComplexArray points(PointCount), result(PointCount), check(PointCount);
+    for (std::size_t k = 0; k < PointCount; ++k) {
+        points.set(k, ComplexNumber(uniform(generator), uniform(generator)));
+    }
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("\npolynomials at %zu points in the unit square, %s kernels, %u hardware threads\n",
+                PointCount, activeKernels().name, hardware);
+    std::printf("(ns per point; difference is the largest |Estrin - Horner| / sum |c_k z^k| in eps)\n");
+    std::printf("%6s %12s %12s %12s %12s %10s %10s\n", "degree", "scalar", "Horner", "Estrin",
+                "Estrin, all", "speedup", "difference");
+    bool identical = true;
+    for (std::size_t degree : {4, 8, 16, 32, 128}) {
+        std::vector<ComplexNumber> coefficients(degree + 1);
+        for (ComplexNumber &c : coefficients) {
+            c = ComplexNumber(uniform(generator), uniform(generator));
+        }
+        const ComplexPolynomial polynomial(coefficients);
+        std::vector<double> cr(degree + 1), ci(degree + 1);
+        for (std::size_t k = 0; k <= degree; ++k) {
+            cr[k] = coefficients[k].getReal();
+            ci[k] = coefficients[k].getImaginary();
+        }
+
+        const double scalar = bestOf([&] {
+            scalarKernels.polynomial(cr.data(), ci.data(), degree + 1, PolynomialScheme::Horner, points.real(),
+                                     points.imaginary(), check.real(), check.imaginary(), PointCount);
+        }, 3);
+        const double horner = bestOf([&] {
+            polynomial.evaluate(points, result, PolynomialScheme::Horner, 1);
+        }, 3);
+        identical = identical && sameBits(result, check);
+        const ComplexArray hornerValues = result;
+
+        const double estrin = bestOf([&] {
+            polynomial.evaluate(points, result, PolynomialScheme::Estrin, 1);
+        }, 3);
+        scalarKernels.polynomial(cr.data(), ci.data(), degree + 1, PolynomialScheme::Estrin, points.real(),
+                                 points.imaginary(), check.real(), check.imaginary(), PointCount);
+        identical = identical && sameBits(result, check);
+
+        const double threaded = bestOf([&] {
+            polynomial.evaluate(points, result, PolynomialScheme::Estrin, 0);
+        }, 3);
+        identical = identical && sameBits(result, check);
+
+        // Scaled by the size of the terms, as cancellation makes relative errors meaningless.
+        double difference = 0;
+        for (std::size_t k = 0; k < PointCount; ++k) {
+            const double r = points.get(k).absoluteValue();
+            double size = 0;
+            for (std::size_t j = degree + 1; j-- > 0;) {
+                size = size * r + coefficients[j].absoluteValue();
+            }
+            difference = std::max(difference, (result.get(k) - hornerValues.get(k)).absoluteValue() / size);
+        }
+        std::printf("%6zu %12.2f %12.2f %12.2f %12.2f %9.1fx %10.1f\n", degree, scalar * 1e9 / PointCount,
+                    horner * 1e9 / PointCount, estrin * 1e9 / PointCount, threaded * 1e9 / PointCount,
+                    scalar / threaded, difference / 0x1p-52);
+    }
+    std::printf("SIMD and threaded results %s the scalar kernels for each scheme\n",
+                identical ? "match" : "DIFFER from");
+    return identical;
+}
+
+} // namespace
+
+int main()
+{
+    benchPowers();
+    return benchPolynomials() ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexnumber.h"
+#include "precision.h"
+
+// Throughput against accuracy for each scalar of BasicComplex. Throughput: ns per
+// element for a multiply-add, a division, a square root and the exponential over
+// arrays of 1M numbers. Accuracy, against quad precision (long double where quad is
+// not available): the worst relative error of a division and of e^z, the correct
+// digits of (z - w)^8 evaluated from its expanded coefficients at distance 0.1 from its
+// eightfold root, and the number of steps of z -> z^2 - 1.9, a chaotic orbit, before
+// it is 1e-3 away from the reference. Where quad is available its row is the
+// reference itself.
+
+namespace {
+
+#ifdef COMPLEXCALC_HAS_FLOAT128
+using Reference = __float128;
+#else
+using Reference = long double;
+#endif
+
+constexpr std::size_t Count = 1 << 20;
+constexpr int Degree = 8;
+
+/**
+ * @brief |a - reference| / |reference|, both taken in the reference precision.
+ */
+template<typename T>
+double relativeError(const BasicComplex<T> &a, const BasicComplex<Reference> &reference)
+{
+    const BasicComplex<Reference> difference = BasicComplex<Reference>(a) - reference;
+    return static_cast<double>(difference.absoluteValue() / reference.absoluteValue());
+}
+
+/**
+ * @brief Expanded coefficients of (z - w)^Degree, lowest degree first, in precision T.
+ */
+template<typename T>
+std::vector<BasicComplex<T>> expandedPower(const ComplexNumber &w)
+{
+    std::vector<BasicComplex<Reference>> c(Degree + 1);
+    c[0] = BasicComplex<Reference>(1, 0);
+    const BasicComplex<Reference> root(w);
+    for (int n = 1; n <= Degree; ++n) {
+        // Multiply by (z - w): c_k <- c_(k-1) - w c_k.
+        for (int k = n; k >= 0; --k) {
+            c[k] = (k > 0 ? c[k - 1] : BasicComplex<Reference>()) - root * c[k];
+        }
+    }
+    std::vector<BasicComplex<T>> result;
+    for (const BasicComplex<Reference> &coefficient : c) {
+        result.emplace_back(coefficient);
+    }
+    return result;
+}
+
+template<typename T>
+void run(const char *name, int bits, const std::vector<ComplexNumber> &a, const std::vector<ComplexNumber> &b)
+{
+    using Complex = BasicComplex<T>;
+    std::vector<Complex> x(Count), y(Count), r(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        x[k] = Complex(a[k]);
+        y[k] = Complex(b[k]);
+    }
+
+    const double multiplyAdd = bestOf([&] {
+        for (std::size_t k = 0; k < Count; ++k) {
+            r[k] = r[k] * x[k] + y[k];
+        }
+        doNotOptimize(r);
+    });
+    const double divide = bestOf([&] {
+        for (std::size_t k = 0; k < Count; ++k) {
+            r[k] = x[k].divideUnchecked(y[k]);
+        }
+        doNotOptimize(r);
+    });
+    const double root = bestOf([&] {
+        for (std::size_t k = 0; k < Count; ++k) {
+            r[k] = x[k].root();
+        }
+        doNotOptimize(r);
+    });
+    const double exponential = bestOf([&] {
+        for (std::size_t k = 0; k < Count / 8; ++k) {
+            r[k] = x[k].exponential();
+        }
+        doNotOptimize(r);
+    }, 3) * 8;
+
+    // The accuracy checks take the reference precision, so they use a sample.
+    double divideError = 0, exponentialError = 0;
+    for (std::size_t k = 0; k < Count; k += 64) {
+        const BasicComplex<Reference> p(a[k]), q(b[k]);
+        divideError = std::max(divideError, relativeError(x[k].divideUnchecked(y[k]), p.divideUnchecked(q)));
+        exponentialError = std::max(exponentialError, relativeError(x[k].exponential(), p.exponential()));
+    }
+
+    const ComplexNumber w(0.7, 0.3);
+    const std::vector<Complex> c = expandedPower<T>(w);
+    double polynomialError = 0;
+    for (int k = 0; k < 16; ++k) {
+        const double angle = 2 * M_PI * k / 16;
+        const ComplexNumber z = w + ComplexNumber(0.1 * std::cos(angle), 0.1 * std::sin(angle));
+        Complex value = c[Degree];
+        for (int j = Degree; j-- > 0;) {
+            value = value * Complex(z) + c[j];
+        }
+        const BasicComplex<Reference> difference = BasicComplex<Reference>(z) - BasicComplex<Reference>(w);
+        polynomialError = std::max(polynomialError, relativeError(value, difference.power(Degree)));
+    }
+
+    int steps = 0;
+    Complex orbit;
+    BasicComplex<Reference> referenceOrbit;
+    const Complex shift(-1.9, 0);
+    const BasicComplex<Reference> referenceShift(ComplexNumber(-1.9, 0));
+    while (steps < 1000
+           && static_cast<double>((BasicComplex<Reference>(orbit) - referenceOrbit).absoluteValue()) < 1e-3) {
+        orbit = orbit * orbit + shift;
+        referenceOrbit = referenceOrbit * referenceOrbit + referenceShift;
+        ++steps;
+    }
+
+    std::printf("%-7s %4d %9.2f %9.2f %9.2f %9.2f %11.1e %11.1e %8.1f %7d\n", name, bits, multiplyAdd * 1e9 / Count, divide * 1e9 / Count,
+                root * 1e9 / Count, exponential * 1e9 / Count, divideError, exponentialError,
+                std::max(0.0, -std::log10(polynomialError)), steps);
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937_64 generator(19);
+    std::uniform_real_distribution<double> uniform(-2, 2);
+    std::vector<ComplexNumber> a(Count), b(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        a[k] = ComplexNumber(uniform(generator), uniform(generator));
+        b[k] = ComplexNumber(uniform(generator), uniform(generator));
+    }
+
+#ifdef COMPLEXCALC_HAS_FLOAT128
+    const char *reference = "quad precision";
+#else
+    const char *reference = "long double";
+#endif
+    std::printf("%zu elements; ns per element, errors relative to %s\n", Count, reference);
+    std::printf("%-7s %4s %9s %9s %9s %9s %11s %11s %8s %7s\n", "scalar", "bits", "mul-add", "divide", "root",
+                "exp", "divide err", "exp err", "digits", "steps");
+    run<float>("float", std::numeric_limits<float>::digits, a, b);
+    run<double>("double", std::numeric_limits<double>::digits, a, b);
+    run<long double>("long", std::numeric_limits<long double>::digits, a, b);
+#ifdef COMPLEXCALC_HAS_FLOAT128
+    run<__float128>("quad", __FLT128_MANT_DIG__, a, b);
+#endif
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#include "benchutil.h"
+#include "complexkernels.h"
+#include "reduction.h"
+
+// Runs every reduction over 16M random complex numbers with 1 to 32 threads,
+// compares with a plain serial loop and checks that the results are bit-identical
+// for every thread count and for the scalar and SIMD kernels.
+
+namespace {
+
+constexpr std::size_t Count = 1 << 24;
+
+template<typename T>
+bool same(const T &a, const T &b)
+{
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+struct Results {
+    ComplexNumber sum;
+    ScaledComplex product;
+    IndexedComplex min, max;
+    BoundingBox box;
+
+    bool operator==(const Results &other) const
+    {
+        return same(sum, other.sum) && same(product.mantissa, other.product.mantissa)
+               && product.exponent == other.product.exponent && min.index == other.min.index
+               && max.index == other.max.index && same(box, other.box);
+    }
+};
+
+} // namespace
+
+int main()
+{
+    std::mt19937_64 generator(5);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    ComplexArray values(Count);
+    for (std::size_t k = 0; k < Count; ++k) {
+        // Moduli around one, so the product of 16M factors is far outside double range.
+        values.set(k, ComplexNumber(1 + normal(generator) / 8, normal(generator) / 8));
+    }
+
+    std::printf("%zu elements, %s kernels, %u hardware threads\n", Count, activeKernels().name,
+                std::thread::hardware_concurrency());
+
+    double serialSum = 0, serialBox = 0;
+    {
+        const double *re = values.real(), *im = values.imaginary();
+        serialSum = bestOf([&] {
+            double sr = 0, si = 0;
+            for (std::size_t k = 0; k < Count; ++k) {
+                sr += re[k];
+                si += im[k];
+            }
+            doNotOptimize(sr);
+            doNotOptimize(si);
+        }, 3);
+        serialBox = bestOf([&] {
+            double lo = re[0], hi = re[0], loi = im[0], hii = im[0];
+            for (std::size_t k = 1; k < Count; ++k) {
+                lo = std::min(lo, re[k]);
+                hi = std::max(hi, re[k]);
+                loi = std::min(loi, im[k]);
+                hii = std::max(hii, im[k]);
+            }
+            doNotOptimize(lo);
+            doNotOptimize(hi);
+            doNotOptimize(loi);
+            doNotOptimize(hii);
+        }, 3);
+    }
+    std::printf("plain serial loops: sum %.2f ns/elt, bounding box %.2f ns/elt\n\n",
+                serialSum * 1e9 / Count, serialBox * 1e9 / Count);
+
+    std::printf("%7s %9s %9s %9s %9s %9s %9s\n", "threads", "sum", "product", "modulus", "box",
+                "centroid", "speedup");
+    Results reference;
+    double single = 0;
+    bool identical = true;
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        Results results;
+        const double sum = bestOf([&] { results.sum = reduceSum(values, threads).value(); }, 3);
+        const double product = bestOf([&] { results.product = reduceProduct(values, threads); }, 3);
+        const double modulus = bestOf([&] {
+            results.min = minModulus(values, threads);
+            results.max = maxModulus(values, threads);
+        }, 3);
+        const double box = bestOf([&] { results.box = boundingBox(values, threads); }, 3);
+        ComplexNumber mean;
+        const double mid = bestOf([&] { mean = centroid(values, threads); }, 3);
+        doNotOptimize(mean);
+
+        const double total = sum + product + modulus + box + mid;
+        if (threads == 1) {
+            reference = results;
+            single = total;
+        }
+        identical = identical && results == reference;
+        std::printf("%7u %9.2f %9.2f %9.2f %9.2f %9.2f %8.2fx\n", threads, sum * 1e9 / Count,
+                    product * 1e9 / Count, modulus * 1e9 / Count / 2, box * 1e9 / Count,
+                    mid * 1e9 / Count, single / total);
+    }
+    std::printf("(ns per element; modulus is per min or max search)\n");
+
+    std::printf("\nsum %.17g%+.17gi\n", reference.sum.getReal(), reference.sum.getImaginary());
+    std::printf("product: log|p| = %.12g (value() = %g%+gi)\n", reference.product.logAbs(),
+                reference.product.value().getReal(), reference.product.value().getImaginary());
+    std::printf("min |z| at %zu, max |z| at %zu\n", reference.min.index, reference.max.index);
+
+    // The kernels use the same lanes everywhere, so the scalar table must agree.
+    SumLanes simd = {}, scalar = {};
+    activeKernels().sum(values.real(), values.imaginary(), Count, simd);
+    scalarKernels.sum(values.real(), values.imaginary(), Count, scalar);
+    const bool kernelsAgree = same(simd, scalar);
+
+    std::printf("results %s across thread counts, scalar and %s kernels %s\n",
+                identical ? "bit-identical" : "DIFFER", activeKernels().name,
+                kernelsAgree ? "agree" : "DIFFER");
+    return identical && kernelsAgree ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchutil.h"
+#include "complexkernels.h"
+#include "rootfinder.h"
+
+// Aberth-Ehrlich on z^n - 1 and on polynomials with random coefficients, by degree
+// and thread count. Reports the time, the iterations, the converged roots, the
+// largest backward error |p(z)| / sum |c_k| |z|^k in units of n eps and, for
+// z^n - 1, the largest distance to the exact roots. Run with COMPLEXCALC_SIMD=scalar
+// to compare against the portable kernels.
+
+namespace {
+
+/**
+ * @brief Largest |p(z)| / sum |c_k| |z|^k over the roots, in units of degree * eps.
+ */
+double backwardError(const std::vector<ComplexNumber> &c, const PolynomialRoots &result)
+{
+    double worst = 0;
+    for (const ComplexNumber &z : result.roots) {
+        // Long double Horner, so the check is not limited by the rounding it measures.
+        long double real = 0, imaginary = 0, size = 0;
+        const long double x = z.getReal(), y = z.getImaginary(), modulus = std::hypot(x, y);
+        for (std::size_t k = c.size(); k-- > 0;) {
+            const long double nextReal = real * x - imaginary * y + c[k].getReal();
+            imaginary = real * y + imaginary * x + c[k].getImaginary();
+            real = nextReal;
+            size = size * modulus + c[k].absoluteValue();
+        }
+        worst = std::max(worst, static_cast<double>(std::hypot(real, imaginary) / size));
+    }
+    return worst / (static_cast<double>(c.size() - 1) * 0x1p-52);
+}
+
+/**
+ * @brief Largest distance of a root of z^n - 1 to the nearest n-th root of unity.
+ */
+double unityError(const PolynomialRoots &result)
+{
+    const double n = static_cast<double>(result.roots.size());
+    double worst = 0;
+    for (const ComplexNumber &z : result.roots) {
+        const double k = std::round(std::atan2(z.getImaginary(), z.getReal()) * n / (2 * M_PI));
+        const double angle = 2 * M_PI * k / n;
+        worst = std::max(worst, (z - ComplexNumber(std::cos(angle), std::sin(angle))).absoluteValue());
+    }
+    return worst;
+}
+
+void run(const char *name, const std::vector<ComplexNumber> &c, bool unity)
+{
+    const ComplexPolynomial polynomial(c);
+    double single = 0;
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        PolynomialRoots result;
+        const double time = bestOf([&] { result = findRoots(polynomial, 200, threads); }, 2);
+        if (threads == 1) {
+            single = time;
+        }
+        std::printf("%-8s %6zu %7u %10.2f %7.2fx %6u %9zu %10.2f", name, c.size() - 1, threads, time * 1e3,
+                    single / time, result.iterations, result.convergedCount(), backwardError(c, result));
+        if (unity) {
+            std::printf(" %10.2e", unityError(result));
+        }
+        std::printf("\n");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("%s kernels, %u hardware threads\n\n", activeKernels().name,
+                std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("%-8s %6s %7s %10s %8s %6s %9s %10s %10s\n", "poly", "degree", "threads", "ms", "speedup",
+                "iters", "converged", "backward", "distance");
+
+    std::mt19937_64 generator(19);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    for (std::size_t degree : {64, 256, 1024, 4096}) {
+        std::vector<ComplexNumber> unity(degree + 1);
+        unity[0] = ComplexNumber(-1, 0);
+        unity[degree] = ComplexNumber(1, 0);
+        run("z^n-1", unity, true);
+
+        std::vector<ComplexNumber> random(degree + 1);
+        for (ComplexNumber &c : random) {
+            c = ComplexNumber(normal(generator), normal(generator));
+        }
+        run("random", random, false);
+    }
+    return 0;
+}
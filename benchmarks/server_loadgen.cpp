@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "calcprotocol.h"
+#include "calcserver.h"
+#include "complexnumber.h"
+
+// Load generator for the calculation server. Each client thread opens its own
+// connection and keeps depth requests in flight: it sends depth requests, then sends
+// a new one for every response it reads. Latency is measured per request from send to
+// response; the table gives its median and 99th percentile with the request and
+// element throughput over all clients. Every result is checked against
+// ComplexNumber::multiply bit for bit.
+//
+// Usage: server_loadgen [socket-path] [--seconds <s>]. Without a path a server is
+// started in this process on a temporary socket.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    std::vector<double> latencies;
+    std::size_t requests = 0;
+    std::size_t elements = 0;
+    std::size_t mismatches = 0;
+};
+
+int connectTo(const std::string &path)
+{
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        std::perror("connect");
+        std::exit(1);
+    }
+    return fd;
+}
+
+void sendAll(int fd, const std::vector<char> &bytes)
+{
+    for (std::size_t sent = 0; sent < bytes.size();) {
+        const ssize_t n = send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            std::perror("send");
+            std::exit(1);
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+}
+
+void receiveAll(int fd, void *data, std::size_t size)
+{
+    char *out = static_cast<char *>(data);
+    for (std::size_t received = 0; received < size;) {
+        const ssize_t n = recv(fd, out + received, size - received, 0);
+        if (n <= 0) {
+            std::perror("recv");
+            std::exit(1);
+        }
+        received += static_cast<std::size_t>(n);
+    }
+}
+
+/**
+ * @brief Operands of element k of request id: a varies with both, b is fixed.
+ */
+ComplexNumber firstOperand(std::uint32_t id, std::uint32_t k)
+{
+    return ComplexNumber(1.0 + id * 1e-3 + k * 1e-6, 0.5 - id * 1e-4 + k * 1e-7);
+}
+
+const ComplexNumber SecondOperand(0.75, -1.25);
+
+void runClient(const std::string &path, std::uint32_t depth, std::uint32_t count, double seconds, Result &result)
+{
+    const int fd = connectTo(path);
+    std::unordered_map<std::uint32_t, Clock::time_point> inFlight;
+    std::vector<char> request;
+    std::vector<double> operands(count * 4);
+    std::vector<double> payload(count * 2);
+    std::uint32_t nextId = 0;
+
+    const auto sendOne = [&] {
+        const std::uint32_t id = nextId++;
+        for (std::uint32_t k = 0; k < count; ++k) {
+            const ComplexNumber a = firstOperand(id, k);
+            operands[4 * k] = a.getReal();
+            operands[4 * k + 1] = a.getImaginary();
+            operands[4 * k + 2] = SecondOperand.getReal();
+            operands[4 * k + 3] = SecondOperand.getImaginary();
+        }
+        request.clear();
+        appendRequest(request, id, ServerOp::Multiply, operands.data(), count);
+        inFlight.emplace(id, Clock::now());
+        sendAll(fd, request);
+    };
+
+    const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                                      std::chrono::duration<double>(seconds));
+    for (std::uint32_t k = 0; k < depth; ++k) {
+        sendOne();
+    }
+    while (!inFlight.empty()) {
+        FrameHeader header;
+        receiveAll(fd, &header, sizeof(header));
+        payload.resize(header.length / sizeof(double));
+        receiveAll(fd, payload.data(), header.length);
+        const Clock::time_point now = Clock::now();
+
+        const auto sent = inFlight.find(header.id);
+        if (sent == inFlight.end() || header.count != count) {
+            std::fprintf(stderr, "unexpected response %u\n", header.id);
+            std::exit(1);
+        }
+        result.latencies.push_back(std::chrono::duration<double, std::micro>(now - sent->second).count());
+        inFlight.erase(sent);
+        ++result.requests;
+        result.elements += count;
+        for (std::uint32_t k = 0; k < count; ++k) {
+            const ComplexNumber expected = firstOperand(header.id, k).multiply(SecondOperand);
+            const double bits[2] = {expected.getReal(), expected.getImaginary()};
+            result.mismatches += std::memcmp(bits, &payload[2 * k], sizeof(bits)) != 0;
+        }
+        if (now < end) {
+            sendOne();
+        }
+    }
+    close(fd);
+}
+
+void runConfiguration(const std::string &path, unsigned clients, std::uint32_t depth, std::uint32_t count,
+                      double seconds)
+{
+    std::vector<Result> results(clients);
+    std::vector<std::thread> threads;
+    const Clock::time_point start = Clock::now();
+    for (unsigned c = 0; c < clients; ++c) {
+        threads.emplace_back(runClient, path, depth, count, seconds, std::ref(results[c]));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Result total;
+    for (const Result &result : results) {
+        total.latencies.insert(total.latencies.end(), result.latencies.begin(), result.latencies.end());
+        total.requests += result.requests;
+        total.elements += result.elements;
+        total.mismatches += result.mismatches;
+    }
+    std::sort(total.latencies.begin(), total.latencies.end());
+    const auto percentile = [&](double p) {
+        return total.latencies[std::min(total.latencies.size() - 1,
+                                        static_cast<std::size_t>(p * total.latencies.size()))];
+    };
+    std::printf("%7u %5u %5u %10.1f %10.1f %12.0f %12.0f %s\n", clients, depth, count, percentile(0.5),
+                percentile(0.99), total.requests / elapsed, total.elements / elapsed,
+                total.mismatches == 0 ? "yes" : "NO");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string path;
+    double seconds = 1.0;
+    for (int k = 1; k < argc; ++k) {
+        if (std::strcmp(argv[k], "--seconds") == 0 && k + 1 < argc) {
+            seconds = std::atof(argv[++k]);
+        } else {
+            path = argv[k];
+        }
+    }
+
+    std::unique_ptr<CalcServer> server;
+    std::thread serverThread;
+    if (path.empty()) {
+        path = "/tmp/complexcalc-loadgen-" + std::to_string(getpid()) + ".sock";
+        ServerOptions options;
+        options.socketPath = path;
+        server = std::make_unique<CalcServer>(options);
+        serverThread = std::thread([&] {
+            const CalcServer::Stats stats = server->run();
+            std::printf("server: %zu connections, %zu requests, %zu elements in %zu batches\n",
+                        stats.connections, stats.requests, stats.elements, stats.batches);
+        });
+    }
+
+    std::printf("%zu hardware threads, multiply, %.1f s per row\n",
+                static_cast<std::size_t>(std::thread::hardware_concurrency()), seconds);
+    std::printf("%7s %5s %5s %10s %10s %12s %12s %s\n", "clients", "depth", "count", "p50 us", "p99 us",
+                "requests/s", "elements/s", "exact");
+    for (unsigned clients : {1u, 8u, 64u}) {
+        for (std::uint32_t depth : {1u, 32u}) {
+            runConfiguration(path, clients, depth, 1, seconds);
+        }
+    }
+    runConfiguration(path, 8, 4, 1024, seconds);
+
+    if (server) {
+        server->stop();
+        serverThread.join();
+    }
+    return 0;
+}
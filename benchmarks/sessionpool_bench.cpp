@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "benchutil.h"
+#include "calcmemory.h"
+#include "sessionpool.h"
+
+// Sessions for a multi-tenant server: RAM per session in the pool against one
+// CalcMemory per session, and the rate of create, destroy, create/destroy churn,
+// random access, eviction to disk and reading evicted sessions back. Every session
+// is checked to come back from disk with its register, last value and history.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const char *what, std::size_t count, double time)
+{
+    std::printf("%-28s %10.1f M/s %8.1f ns each\n", what, count / time * 1e-6, time / count * 1e9);
+}
+
+/**
+ * @brief Writes something recognizable to every part of a session.
+ */
+void fill(SessionState &state, std::size_t k)
+{
+    const ComplexNumber value(double(k), -double(k));
+    state.addToMemory(value);
+    state.updateValue(value);
+    state.setPending(value, OpCode::Add);
+    state.record(value, OpCode::Multiply, value, value.multiply(value));
+}
+
+bool intact(const SessionState &state, std::size_t k)
+{
+    const ComplexNumber value(double(k), -double(k));
+    return state.readMemory() == value && state.getLast() == value && state.getPendingOperation() == OpCode::Add
+           && state.historySize() == 1 && state.historyAt(0).result == value.multiply(value);
+}
+
+} // namespace
+
+int main()
+{
+    constexpr std::size_t Sessions = 250000;
+    const std::string spill = "/tmp/complexcalc-sessions-" + std::to_string(getpid()) + ".spill";
+    SessionPool pool(spill);
+    std::vector<SessionId> ids(Sessions);
+
+    Clock::time_point start = Clock::now();
+    for (SessionId &id : ids) {
+        id = pool.create();
+    }
+    report("create (growing)", Sessions, seconds(start));
+
+    std::printf("%zu sessions: %zu bytes per session (SessionState %zu)\n", pool.size(),
+                pool.memoryUsage() / pool.size(), sizeof(SessionState));
+    std::printf("CalcMemory per session: %zu bytes (object and default history ring)\n",
+                sizeof(CalcMemory) + CalcMemory().getHistory().capacity() * sizeof(HistoryRecord));
+
+    start = Clock::now();
+    for (SessionId id : ids) {
+        pool.destroy(id);
+    }
+    report("destroy", Sessions, seconds(start));
+
+    start = Clock::now();
+    for (SessionId &id : ids) {
+        id = pool.create();
+    }
+    report("create (warm)", Sessions, seconds(start));
+
+    std::mt19937_64 generator(5);
+    std::uniform_int_distribution<std::size_t> pick(0, Sessions - 1);
+    constexpr std::size_t Churn = 1 << 21;
+    start = Clock::now();
+    for (std::size_t k = 0; k < Churn; ++k) {
+        SessionId &id = ids[pick(generator)];
+        pool.destroy(id);
+        id = pool.create();
+    }
+    report("destroy + create, random", Churn, seconds(start));
+
+    for (std::size_t k = 0; k < Sessions; ++k) {
+        fill(pool.session(ids[k]), k);
+    }
+    constexpr std::size_t Accesses = 1 << 22;
+    start = Clock::now();
+    for (std::size_t k = 0; k < Accesses; ++k) {
+        pool.session(ids[pick(generator)]).addToMemory(ComplexNumber(0, 0), "X");
+    }
+    report("session() + addToMemory", Accesses, seconds(start));
+
+    start = Clock::now();
+    const std::size_t evicted = pool.evictIdle(Clock::duration::zero());
+    report("evict to disk", evicted, seconds(start));
+    std::printf("resident after eviction: %zu of %zu\n", pool.resident(), pool.size());
+
+    std::size_t damaged = 0;
+    start = Clock::now();
+    for (std::size_t k = 0; k < Sessions; ++k) {
+        damaged += !intact(pool.session(ids[k]), k);
+    }
+    report("read back from disk", Sessions, seconds(start));
+    std::printf("sessions intact after the round trip: %s\n", damaged == 0 ? "yes" : "NO");
+    return damaged == 0 ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+#include <QApplication>
+#include <QChartView>
+#include <QEvent>
+#include <QEventLoop>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "button.h"
+#include "calculator.h"
+
+// Time from process start to the first painted calculator window, measured over fresh
+// processes: the benchmark re-executes itself with the launch time in the environment,
+// and the child reports when it reached main(), had a QApplication, had constructed the
+// Calculator, and had finished the first paint of the window. The first plot is timed
+// as well, since that is where the chart is built now.
+//
+// Usage: startup_bench [runs] [--max-ms N]; with --max-ms the exit status is 1 if the
+// median time to first paint exceeds N milliseconds, so it can guard against
+// regressions in window-open latency.
+
+namespace {
+
+/**
+ * @brief Environment variable carrying the launch time to the child.
+ */
+const char *const LaunchVariable = "COMPLEXCALC_STARTUP_LAUNCH";
+
+/**
+ * @brief Stages reported by the child, in order.
+ */
+const char *const Stages[] = {"main()", "QApplication", "Calculator", "first paint", "first plot"};
+constexpr int StageCount = 5;
+
+std::int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Ends an event loop once a widget has been painted and the paint has finished.
+ */
+class PaintWaiter : public QObject
+{
+public:
+    explicit PaintWaiter(QEventLoop &loop)
+        : loop(loop)
+    {}
+
+    std::int64_t painted = 0;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint && painted == 0) {
+            // Queued, so the children painted in the same pass are included.
+            QTimer::singleShot(0, this, [this] {
+                painted = nowNs();
+                loop.quit();
+            });
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    QEventLoop &loop;
+};
+
+/**
+ * @brief Waits for the next finished paint of a widget.
+ */
+std::int64_t waitForPaint(QWidget *widget)
+{
+    QEventLoop loop;
+    PaintWaiter waiter(loop);
+    widget->installEventFilter(&waiter);
+    loop.exec();
+    widget->removeEventFilter(&waiter);
+    return waiter.painted;
+}
+
+/**
+ * @brief The child: opens the window, plots one result and prints the stage times.
+ */
+int runWindow(int argc, char *argv[], std::int64_t launched)
+{
+    const std::int64_t inMain = nowNs();
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    const std::int64_t appReady = nowNs();
+    Calculator calculator;
+    const std::int64_t constructed = nowNs();
+    calculator.show();
+    const std::int64_t firstPaint = waitForPaint(&calculator);
+
+    Button *equals = nullptr;
+    for (Button *candidate : calculator.findChildren<Button *>()) {
+        if (candidate->text() == "=") {
+            equals = candidate;
+        }
+    }
+    if (equals == nullptr) {
+        std::fprintf(stderr, "no = button\n");
+        return 2;
+    }
+    const std::int64_t clicked = nowNs();
+    equals->click();
+    QChartView *view = calculator.findChild<QChartView *>();
+    if (view == nullptr) {
+        std::fprintf(stderr, "no chart after the first result\n");
+        return 2;
+    }
+    const std::int64_t plotted = waitForPaint(view);
+
+    std::printf("%lld %lld %lld %lld %lld\n", static_cast<long long>(inMain - launched),
+                static_cast<long long>(appReady - launched), static_cast<long long>(constructed - launched),
+                static_cast<long long>(firstPaint - launched), static_cast<long long>(plotted - clicked));
+    return 0;
+}
+
+/**
+ * @brief Starts one child and reads its stage times in milliseconds.
+ */
+bool launch(char *argv[], double (&stages)[StageCount])
+{
+    int output[2];
+    if (pipe(output) != 0) {
+        return false;
+    }
+    const std::int64_t launched = nowNs();
+    setenv(LaunchVariable, std::to_string(launched).c_str(), 1);
+    const pid_t child = fork();
+    if (child == 0) {
+        dup2(output[1], STDOUT_FILENO);
+        close(output[0]);
+        close(output[1]);
+        execv("/proc/self/exe", argv);
+        _exit(127);
+    }
+    close(output[1]);
+    std::string text;
+    char buffer[256];
+    ssize_t got;
+    while ((got = read(output[0], buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, static_cast<std::size_t>(got));
+    }
+    close(output[0]);
+    int status = 0;
+    if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return false;
+    }
+    long long ns[StageCount];
+    if (std::sscanf(text.c_str(), "%lld %lld %lld %lld %lld", &ns[0], &ns[1], &ns[2], &ns[3], &ns[4])
+        != StageCount) {
+        return false;
+    }
+    for (int stage = 0; stage < StageCount; ++stage) {
+        stages[stage] = static_cast<double>(ns[stage]) / 1e6;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (const char *launched = std::getenv(LaunchVariable)) {
+        unsetenv(LaunchVariable);
+        return runWindow(argc, argv, std::strtoll(launched, nullptr, 10));
+    }
+
+    int runs = 10;
+    double limitMs = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-ms") == 0 && i + 1 < argc) {
+            limitMs = std::atof(argv[++i]);
+        } else {
+            runs = std::max(1, std::atoi(argv[i]));
+        }
+    }
+
+    std::vector<double> samples[StageCount];
+    for (int run = 0; run < runs; ++run) {
+        double stages[StageCount];
+        if (!launch(argv, stages)) {
+            std::fprintf(stderr, "run %d failed\n", run);
+            return 2;
+        }
+        for (int stage = 0; stage < StageCount; ++stage) {
+            samples[stage].push_back(stages[stage]);
+        }
+    }
+
+    std::printf("%-14s %10s %10s %10s   (%d processes, ms since launch; first plot ms since the click)\n",
+                "stage", "min", "median", "max", runs);
+    double medianPaint = 0;
+    for (int stage = 0; stage < StageCount; ++stage) {
+        std::vector<double> &values = samples[stage];
+        std::sort(values.begin(), values.end());
+        const double median = values[values.size() / 2];
+        std::printf("%-14s %10.1f %10.1f %10.1f\n", Stages[stage], values.front(), median, values.back());
+        if (stage == 3) {
+            medianPaint = median;
+        }
+    }
+    if (limitMs > 0 && medianPaint > limitMs) {
+        std::printf("first paint %.1f ms exceeds the limit of %.1f ms\n", medianPaint, limitMs);
+        return 1;
+    }
+    return 0;
+}
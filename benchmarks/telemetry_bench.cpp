@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchutil.h"
+#include "expression.h"
+#include "precision.h"
+#include "telemetry.h"
+
+// Cost of the telemetry: one timing scope on its own, the same from several threads
+// at once, and its share of the calculator's expression path without the widget and
+// chart updates (read the display, compile, evaluate, format), timed the way Calculator
+// times it. Finally the histogram's percentiles are checked against the exact ones of
+// a known sample.
+
+namespace {
+
+constexpr int Scopes = 2000000;
+
+/**
+ * @brief The non-Qt part of Calculator::evaluateExpression(), optionally with its timing scopes.
+ */
+template <bool Timed>
+double expressionAction(const std::string &real, const std::string &imaginary, const std::string &text)
+{
+    const auto maybeTimed = [](TelemetryOp op, auto &&function) {
+        if constexpr (Timed) {
+            return timed(op, function);
+        } else {
+            return function();
+        }
+    };
+    const ComplexNumber read(std::stod(real), std::stod(imaginary));
+    Expression expression = maybeTimed(TelemetryOp::Parse, [&] { return Expression(text); });
+    const ComplexNumber result = maybeTimed(TelemetryOp::Compute, [&] { return expression.evaluate(&read); });
+    return maybeTimed(TelemetryOp::DisplayUpdate, [&] {
+        return static_cast<double>(std::to_string(result.getReal()).size() + std::to_string(result.getImaginary()).size());
+    });
+}
+
+} // namespace
+
+int main()
+{
+    if (!TelemetryEnabled) {
+        std::printf("telemetry compiled out (COMPLEXCALC_TELEMETRY=OFF): scopes are empty\n");
+    }
+
+    const double bareClock = bestOf([] {
+        for (int i = 0; i < Scopes; ++i) {
+            const std::uint64_t start = telemetryTicks();
+            doNotOptimize(telemetryTicks() - start);
+        }
+    });
+    const double scope = bestOf([] {
+        for (int i = 0; i < Scopes; ++i) {
+            TelemetryScope timing(TelemetryOp::Compute);
+        }
+    });
+    std::printf("two clock reads %.1f ns, timing scope %.1f ns (recording %.1f ns)\n", bareClock / Scopes * 1e9,
+                scope / Scopes * 1e9, (scope - bareClock) / Scopes * 1e9);
+
+    constexpr int Threads = 4;
+    const double threaded = bestOf(
+        [] {
+            std::vector<std::thread> threads;
+            for (int t = 0; t < Threads; ++t) {
+                threads.emplace_back([] {
+                    for (int i = 0; i < Scopes; ++i) {
+                        TelemetryScope timing(TelemetryOp::Parse);
+                    }
+                });
+            }
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+        },
+        3);
+    std::printf("%d threads: %.1f ns per scope per thread (one core here, so not a scaling figure)\n", Threads,
+                threaded / Scopes / Threads * 1e9);
+
+    // The difference between the two variants is below the run-to-run noise of a shared
+    // machine, so the share is also estimated from the cost of a scope.
+    constexpr int Actions = 100000;
+    const std::string text = "x^2 + 3*x - sin(x) / (1 + abs(x))";
+    double sink = 0;
+    const double plain = bestOf([&] {
+        for (int i = 0; i < Actions; ++i) {
+            sink += expressionAction<false>("1.25", "-0.5", text);
+        }
+    });
+    const double withTiming = bestOf([&] {
+        for (int i = 0; i < Actions; ++i) {
+            sink += expressionAction<true>("1.25", "-0.5", text);
+        }
+    });
+    doNotOptimize(sink);
+    std::printf("expression action without Qt: %.2f us plain, %.2f us with 3 scopes; 3 scopes are %.1f%% of it\n",
+                plain / Actions * 1e6, withTiming / Actions * 1e6, 3 * (scope / Scopes) / (plain / Actions) * 100);
+
+    // Log-normal latencies around 50000 ticks, recorded directly.
+    std::mt19937_64 generator(11);
+    std::lognormal_distribution<double> latency(std::log(50000.0), 1.0);
+    std::vector<std::uint64_t> sample(1000000);
+    for (std::uint64_t &value : sample) {
+        value = static_cast<std::uint64_t>(latency(generator));
+        recordTicks(TelemetryOp::Job, 0, value);
+    }
+    std::sort(sample.begin(), sample.end());
+    const TelemetrySnapshot snapshot = telemetrySnapshot();
+    const LatencyHistogram &jobs = snapshot[TelemetryOp::Job];
+    std::printf("tick length %.4f ns\n", jobs.nanosecondsPerTick);
+    for (double fraction : {0.5, 0.9, 0.99, 0.999}) {
+        const std::uint64_t ticks = sample[static_cast<std::size_t>(fraction * sample.size()) - 1];
+        const double exact = static_cast<double>(jobs.nanoseconds(ticks));
+        const double estimate = static_cast<double>(jobs.percentile(fraction));
+        std::printf("p%-5g exact %9.0f ns, histogram %9.0f ns (%+.2f%%)\n", fraction * 100, exact, estimate,
+                    (estimate / exact - 1) * 100);
+    }
+    std::printf("snapshot: %zu thread blocks, %llu scopes counted\n", snapshot.threads,
+                static_cast<unsigned long long>(snapshot[TelemetryOp::Compute].count
+                                                + snapshot[TelemetryOp::Parse].count));
+    return 0;
+}
@@ -0,0 +1,375 @@
+#include "calchistory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief First 64 bytes of a journal file, followed by the records.
+ */
+struct JournalHeader {
+    char magic[8];
+    std::uint32_t recordSize;
+    std::uint32_t version;
+    std::uint64_t count;
+    unsigned char reserved[40];
+};
+
+static_assert(sizeof(JournalHeader) == sizeof(HistoryRecord), "records stay 64-byte aligned");
+
+constexpr char JournalMagic[8] = {'C', 'C', 'H', 'I', 'S', 'T', '\0', '\0'};
+constexpr std::uint32_t JournalVersion = 1;
+
+/**
+ * @brief Records per append window (1 MiB), to keep remapping rare.
+ */
+constexpr std::size_t WindowRecords = 1 << 14;
+
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+
+/**
+ * @brief File range mapped for the append window starting at record first.
+ *
+ * The offset is rounded down to a page, so the window may start inside the header.
+ */
+void windowRange(std::size_t first, off_t &offset, std::size_t &bytes)
+{
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t begin = sizeof(JournalHeader) + first * sizeof(HistoryRecord);
+    const std::size_t aligned = begin - begin % page;
+    offset = static_cast<off_t>(aligned);
+    bytes = begin - aligned + WindowRecords * sizeof(HistoryRecord);
+}
+
+/**
+ * @brief Unmaps the append window whose first record is window, at record first.
+ */
+void unmapWindow(HistoryRecord *window, std::size_t first)
+{
+    off_t offset;
+    std::size_t bytes;
+    windowRange(first, offset, bytes);
+    const std::size_t lead = sizeof(JournalHeader) + first * sizeof(HistoryRecord)
+                             - static_cast<std::size_t>(offset);
+    ::munmap(reinterpret_cast<unsigned char *>(window) - lead, bytes);
+}
+
+#endif
+
+} // namespace
+
+/**
+ * @brief Constructor.
+ *
+ * @param capacity number of records kept in RAM (std::size_t).
+ * @throws std::invalid_argument If capacity is zero.
+ */
+CalcHistory::CalcHistory(std::size_t capacity)
+    : ringCapacity(capacity)
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("History capacity must be positive!");
+    }
+    ring.reset(new HistoryRecord[capacity]);
+}
+
+/**
+ * @brief Destructor, closes the journal.
+ */
+CalcHistory::~CalcHistory()
+{
+    closeJournal();
+}
+
+/**
+ * @brief Opens or creates a journal and continues the history stored in it.
+ *
+ * @param path journal file (const std::string&).
+ * @throws std::runtime_error If the file cannot be opened, locked, mapped or is not a journal.
+ */
+void CalcHistory::openJournal(const std::string &path)
+{
+    closeJournal();
+#ifndef COMPLEXCALC_HAS_POSIX_IO
+    throw std::runtime_error("Cannot open journal " + path + ": not supported on this platform");
+#else
+
+    const int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file < 0) {
+        throw std::runtime_error("Cannot open journal " + path);
+    }
+    // Two writers would append over each other; the lock goes away with the descriptor.
+    if (::flock(file, LOCK_EX | LOCK_NB) != 0) {
+        ::close(file);
+        throw std::runtime_error("Journal " + path + " is in use by another instance");
+    }
+    struct stat status;
+    if (::fstat(file, &status) != 0) {
+        ::close(file);
+        throw std::runtime_error("Cannot open journal " + path);
+    }
+
+    const std::size_t fileBytes = static_cast<std::size_t>(status.st_size);
+    if (fileBytes != 0 && fileBytes < sizeof(JournalHeader)) {
+        ::close(file);
+        throw std::runtime_error(path + " is not a history journal");
+    }
+    if (fileBytes == 0 && ::ftruncate(file, sizeof(JournalHeader)) != 0) {
+        ::close(file);
+        throw std::runtime_error("Cannot grow journal " + path);
+    }
+
+    void *map = ::mmap(nullptr, sizeof(JournalHeader), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (map == MAP_FAILED) {
+        ::close(file);
+        throw std::runtime_error("Cannot map journal " + path);
+    }
+    journalFile = file;
+    header = static_cast<unsigned char *>(map);
+    total = 0;
+
+    JournalHeader fields;
+    if (fileBytes == 0) {
+        fields = {};
+        std::memcpy(fields.magic, JournalMagic, sizeof(JournalMagic));
+        fields.recordSize = sizeof(HistoryRecord);
+        fields.version = JournalVersion;
+        std::memcpy(header, &fields, sizeof(fields));
+    } else {
+        std::memcpy(&fields, header, sizeof(fields));
+        if (std::memcmp(fields.magic, JournalMagic, sizeof(JournalMagic)) != 0
+            || fields.recordSize != sizeof(HistoryRecord) || fields.version != JournalVersion) {
+            releaseJournal();
+            throw std::runtime_error(path + " is not a history journal");
+        }
+        // A crash can leave the count ahead of what made it into the file.
+        total = std::min<std::size_t>(fields.count,
+                                      (fileBytes - sizeof(JournalHeader)) / sizeof(HistoryRecord));
+    }
+
+    // Refill the ring with the newest records.
+    try {
+        const HistoryRecord *records = journalRecords();
+        for (std::size_t index = total - std::min(total, ringCapacity); index < total; ++index) {
+            ring[index % ringCapacity] = records[index];
+        }
+    } catch (...) {
+        releaseJournal();
+        total = 0;
+        throw;
+    }
+#endif
+}
+
+/**
+ * @brief Closes the journal, keeping the records in the ring.
+ *
+ * The file is truncated to the records actually written.
+ */
+void CalcHistory::closeJournal()
+{
+    if (journalFile < 0) {
+        return;
+    }
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+    // On failure the count in the header still marks the end, the tail is only wasted space.
+    const int truncated = ::ftruncate(journalFile, sizeof(JournalHeader) + total * sizeof(HistoryRecord));
+    static_cast<void>(truncated);
+#endif
+    releaseJournal();
+}
+
+/**
+ * @brief Unmaps everything and closes the file, without truncating it.
+ */
+void CalcHistory::releaseJournal()
+{
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+    if (window) {
+        unmapWindow(window, windowFirst);
+    }
+    if (readMap) {
+        ::munmap(const_cast<unsigned char *>(readMap),
+                 sizeof(JournalHeader) + readRecords * sizeof(HistoryRecord));
+    }
+    if (header) {
+        ::munmap(header, sizeof(JournalHeader));
+    }
+    ::close(journalFile);
+#endif
+    journalFile = -1;
+    header = nullptr;
+    window = nullptr;
+    windowFirst = 0;
+    readMap = nullptr;
+    readRecords = 0;
+}
+
+/**
+ * @brief Maps the append window holding record index, growing the file.
+ *
+ * The previous window is unmapped; its pages stay in the page cache and are written
+ * back by the OS, but no longer count against the process.
+ *
+ * @param index record that must be writable (std::size_t).
+ * @throws std::runtime_error If the file cannot be resized or mapped.
+ */
+void CalcHistory::moveWindow(std::size_t index)
+{
+#ifndef COMPLEXCALC_HAS_POSIX_IO
+    static_cast<void>(index);
+    throw std::runtime_error("Cannot map history journal");
+#else
+    const std::size_t first = index - index % WindowRecords;
+    off_t offset;
+    std::size_t bytes;
+    windowRange(first, offset, bytes);
+
+    struct stat status;
+    const std::size_t end = static_cast<std::size_t>(offset) + bytes;
+    if (::fstat(journalFile, &status) != 0
+        || (static_cast<std::size_t>(status.st_size) < end
+            && ::ftruncate(journalFile, static_cast<off_t>(end)) != 0)) {
+        throw std::runtime_error("Cannot grow history journal");
+    }
+    void *map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, journalFile, offset);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("Cannot map history journal");
+    }
+
+    if (window) {
+        unmapWindow(window, windowFirst);
+    }
+    const std::size_t lead = sizeof(JournalHeader) + first * sizeof(HistoryRecord)
+                             - static_cast<std::size_t>(offset);
+    window = reinterpret_cast<HistoryRecord *>(static_cast<unsigned char *>(map) + lead);
+    windowFirst = first;
+#endif
+}
+
+/**
+ * @brief Makes the first count journal records readable through readMap.
+ *
+ * The whole journal written so far is mapped read-only, so the mapping is only
+ * replaced when records beyond it are requested.
+ *
+ * @param count number of records needed (std::size_t).
+ * @throws std::runtime_error If the file cannot be mapped.
+ */
+void CalcHistory::mapReadable(std::size_t count) const
+{
+    if (count <= readRecords && readMap) {
+        return;
+    }
+#ifndef COMPLEXCALC_HAS_POSIX_IO
+    throw std::runtime_error("Cannot map history journal");
+#else
+    const std::size_t bytes = sizeof(JournalHeader) + total * sizeof(HistoryRecord);
+    void *map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, journalFile, 0);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("Cannot map history journal");
+    }
+    if (readMap) {
+        ::munmap(const_cast<unsigned char *>(readMap),
+                 sizeof(JournalHeader) + readRecords * sizeof(HistoryRecord));
+    }
+    readMap = static_cast<const unsigned char *>(map);
+    readRecords = total;
+#endif
+}
+
+/**
+ * @brief Appends a record, stamped with the current time.
+ *
+ * @param a first operand (const ComplexNumber&).
+ * @param op operation (OpCode).
+ * @param b second operand (const ComplexNumber&).
+ * @param result result (const ComplexNumber&).
+ */
+void CalcHistory::record(const ComplexNumber &a, OpCode op, const ComplexNumber &b,
+                         const ComplexNumber &result)
+{
+    HistoryRecord entry{};
+    entry.a = a;
+    entry.b = b;
+    entry.result = result;
+    entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+    entry.op = op;
+    record(entry);
+}
+
+/**
+ * @brief Appends a complete record.
+ *
+ * @param entry record to be appended (const HistoryRecord&).
+ */
+void CalcHistory::record(const HistoryRecord &entry)
+{
+    if (journalFile >= 0) {
+        if (!window || total - windowFirst >= WindowRecords) {
+            moveWindow(total);
+        }
+        std::memcpy(window + (total - windowFirst), &entry, sizeof(entry));
+        const std::uint64_t count = total + 1;
+        std::memcpy(header + offsetof(JournalHeader, count), &count, sizeof(count));
+    }
+    ring[total % ringCapacity] = entry;
+    ++total;
+}
+
+/**
+ * @brief Number of records available through at().
+ *
+ * @return record count (std::size_t).
+ */
+std::size_t CalcHistory::size() const
+{
+    return journalFile >= 0 ? total : std::min(total, ringCapacity);
+}
+
+/**
+ * @brief Reads a record, oldest first.
+ *
+ * Recent records come from the ring, older ones from the journal mapping.
+ *
+ * @param index position in [0, size()) (std::size_t).
+ * @return the record (const HistoryRecord&).
+ */
+const HistoryRecord &CalcHistory::at(std::size_t index) const
+{
+    const std::size_t position = total - size() + index;
+    if (position + ringCapacity >= total) {
+        return ring[position % ringCapacity];
+    }
+    mapReadable(position + 1);
+    return reinterpret_cast<const HistoryRecord *>(readMap + sizeof(JournalHeader))[position];
+}
+
+/**
+ * @brief All journaled records as one contiguous array, for fast replay.
+ *
+ * @return first record, or nullptr without a journal (const HistoryRecord*).
+ * @throws std::runtime_error If the journal cannot be mapped.
+ */
+const HistoryRecord *CalcHistory::journalRecords() const
+{
+    if (journalFile < 0) {
+        return nullptr;
+    }
+    mapReadable(total);
+    return reinterpret_cast<const HistoryRecord *>(readMap + sizeof(JournalHeader));
+}
@@ -0,0 +1,202 @@
+#ifndef CALCHISTORY_H
+#define CALCHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "complexnumber.h"
+#include "expression.h"
+
+/**
+ * @brief One finished calculation.
+ *
+ * The layout is fixed (64 bytes, no pointers), it is written to the journal as is.
+ */
+struct HistoryRecord {
+    /** @brief First operand. */
+    ComplexNumber a;
+
+    /** @brief Second operand, zero for unary operations. */
+    ComplexNumber b;
+
+    /** @brief Result. */
+    ComplexNumber result;
+
+    /** @brief Wall-clock time in nanoseconds since the Unix epoch. */
+    std::int64_t timestamp;
+
+    /** @brief Operation, None for calculations without an opcode (shapes, expressions). */
+    OpCode op;
+};
+
+static_assert(sizeof(HistoryRecord) == 64, "the journal format relies on 64-byte records");
+
+/**
+ * @brief History of calculations: a fixed ring buffer, optionally backed by a journal.
+ *
+ * The ring keeps the most recent records in a buffer allocated once, so recording
+ * never allocates and RAM use does not depend on the length of the history.
+ *
+ * When a journal is opened, every record is also appended to an append-only file
+ * that is memory-mapped. Older records are read straight from the mapping, so a
+ * history of any length can be reopened and replayed without parsing: opening only
+ * maps the file, and pages are loaded by the OS when they are first touched.
+ */
+class CalcHistory {
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param capacity number of records kept in RAM (std::size_t).
+     * @throws std::invalid_argument If capacity is zero.
+     */
+    explicit CalcHistory(std::size_t capacity = 1024);
+
+    CalcHistory(const CalcHistory &) = delete;
+    CalcHistory &operator=(const CalcHistory &) = delete;
+
+    /**
+     * @brief Destructor, closes the journal.
+     */
+    ~CalcHistory();
+
+    /**
+     * @brief Opens or creates a journal and continues the history stored in it.
+     *
+     * Records made before the call are discarded from the ring, which is refilled
+     * from the end of the journal. The file is locked while it is open, so a second
+     * instance gets an error and can carry on with the ring alone. Journals need POSIX
+     * file mapping (COMPLEXCALC_HAS_POSIX_IO); elsewhere opening always fails.
+     *
+     * @param path journal file (const std::string&).
+     * @throws std::runtime_error If the file cannot be opened, locked, mapped or is not a journal.
+     */
+    void openJournal(const std::string &path);
+
+    /**
+     * @brief Closes the journal, keeping the records in the ring.
+     */
+    void closeJournal();
+
+    /**
+     * @brief Whether a journal is open.
+     */
+    bool hasJournal() const { return journalFile >= 0; }
+
+    /**
+     * @brief Appends a record, stamped with the current time.
+     *
+     * @param a first operand (const ComplexNumber&).
+     * @param op operation (OpCode).
+     * @param b second operand (const ComplexNumber&).
+     * @param result result (const ComplexNumber&).
+     * @throws std::runtime_error If the journal cannot grow.
+     */
+    void record(const ComplexNumber &a, OpCode op, const ComplexNumber &b,
+                const ComplexNumber &result);
+
+    /**
+     * @brief Appends a complete record.
+     *
+     * @param entry record to be appended (const HistoryRecord&).
+     * @throws std::runtime_error If the journal cannot grow.
+     */
+    void record(const HistoryRecord &entry);
+
+    /**
+     * @brief Number of records available through at().
+     *
+     * All journaled records when a journal is open, otherwise at most capacity().
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Number of records kept in RAM.
+     */
+    std::size_t capacity() const { return ringCapacity; }
+
+    /**
+     * @brief Reads a record, oldest first.
+     *
+     * @param index position in [0, size()) (std::size_t).
+     * @return the record (const HistoryRecord&).
+     */
+    const HistoryRecord &at(std::size_t index) const;
+
+    /**
+     * @brief All journaled records as one contiguous array, for fast replay.
+     *
+     * The pointer stays valid until the next record() or journal change.
+     *
+     * @return first record, or nullptr without a journal (const HistoryRecord*).
+     */
+    const HistoryRecord *journalRecords() const;
+
+private:
+    /**
+     * @brief Maps the append window holding record index, growing the file.
+     */
+    void moveWindow(std::size_t index);
+
+    /**
+     * @brief Makes the first count journal records readable through readMap.
+     */
+    void mapReadable(std::size_t count) const;
+
+    /**
+     * @brief Unmaps everything and closes the file, without truncating it.
+     */
+    void releaseJournal();
+
+    /**
+     * @brief Ring buffer holding the newest records.
+     */
+    std::unique_ptr<HistoryRecord[]> ring;
+
+    /**
+     * @brief Number of slots in the ring.
+     */
+    std::size_t ringCapacity;
+
+    /**
+     * @brief Total number of records made (or loaded from the journal).
+     */
+    std::size_t total = 0;
+
+    /**
+     * @brief File descriptor of the journal, -1 if none.
+     */
+    int journalFile = -1;
+
+    /**
+     * @brief Mapping of the journal header page.
+     */
+    unsigned char *header = nullptr;
+
+    /**
+     * @brief Small writable mapping that new records are appended through.
+     *
+     * Only this window is mapped for writing, so the pages of older records are not
+     * kept resident by the process however long the journal grows.
+     */
+    HistoryRecord *window = nullptr;
+
+    /**
+     * @brief Index of the first record in the window.
+     */
+    std::size_t windowFirst = 0;
+
+    /**
+     * @brief Read-only mapping of the journal, created on demand for old records.
+     */
+    mutable const unsigned char *readMap = nullptr;
+
+    /**
+     * @brief Number of records covered by readMap.
+     */
+    mutable std::size_t readRecords = 0;
+};
+
+#endif // CALCHISTORY_H
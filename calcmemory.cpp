@@ -1,12 +1,12 @@
 #include "calcmemory.h"
 
+#include "reduction.h"
+
 
 /**
  * @brief Default constructor.
  */
-CalcMemory::CalcMemory() {
-    sumInMemory = ComplexNumber(0, 0);
-}
+CalcMemory::CalcMemory() {}
 
 /**
  * @brief Destructor.
@@ -14,12 +14,14 @@ CalcMemory::CalcMemory() {
 CalcMemory::~CalcMemory() {}
 
 /**
- * @brief Reads the current value stored in memory.
+ * @brief Reads the value stored in a register.
  *
- * @return sum of all values stored in memory (ComplexNumber).
+ * @param name register to be read (const std::string&).
+ * @return sum of all values stored in the register (ComplexNumber).
  */
-ComplexNumber CalcMemory::readMemory() {
-    return sumInMemory;
+ComplexNumber CalcMemory::readMemory(const std::string &name) const {
+    const auto found = registers.find(name);
+    return found == registers.end() ? ComplexNumber(0, 0) : found->second.value();
 }
 
 /**
@@ -32,10 +34,12 @@ ComplexNumber CalcMemory::getLast() {
 };
 
 /**
- * @brief Resets the memory to zero.
+ * @brief Resets a register to zero.
+ *
+ * @param name register to be cleared (const std::string&).
  */
-void CalcMemory::clearMemory() {
-    sumInMemory = ComplexNumber(0, 0);
+void CalcMemory::clearMemory(const std::string &name) {
+    registers.erase(name);
 };
 
 /**
@@ -48,19 +52,79 @@ void CalcMemory::updateValue(ComplexNumber read) {
 };
 
 /**
- * @brief Sets the value stored in memory.
+ * @brief Sets the value stored in a register.
  *
  * @param read to be stored in memory (ComplexNumber).
+ * @param name register to be set (const std::string&).
  */
-void CalcMemory::setMemory(ComplexNumber read) {
-    sumInMemory = read;
+void CalcMemory::setMemory(ComplexNumber read, const std::string &name) {
+    registers[name] = CompensatedSum(read);
 };
 
 /**
- * @brief Adds a value to the memory.
+ * @brief Adds a value to a register.
  *
  * @param read added to the memory (ComplexNumber).
+ * @param name register to be added to (const std::string&).
  */
-void CalcMemory::addToMemory(ComplexNumber read) {
-    sumInMemory = sumInMemory.add(read);
+void CalcMemory::addToMemory(ComplexNumber read, const std::string &name) {
+    registers[name].add(read);
 };
+
+/**
+ * @brief Adds a contiguous range of numbers to a register.
+ *
+ * @param values first number to be added (const ComplexNumber*).
+ * @param count number of values (std::size_t).
+ * @param name register to be added to (const std::string&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ */
+void CalcMemory::addRangeToMemory(const ComplexNumber *values, std::size_t count,
+                                  const std::string &name, unsigned threads) {
+    registers[name].add(reduceSum(values, count, threads));
+}
+
+/**
+ * @brief Names of the registers holding a value, in alphabetical order.
+ *
+ * @return register names (std::vector<std::string>).
+ */
+std::vector<std::string> CalcMemory::memoryRegisters() const {
+    std::vector<std::string> names;
+    names.reserve(registers.size());
+    for (const auto &entry : registers) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+/**
+ * @brief Records a finished calculation in the history.
+ *
+ * @param a first operand (const ComplexNumber&).
+ * @param op operation (OpCode).
+ * @param b second operand, zero for unary operations (const ComplexNumber&).
+ * @param result result (const ComplexNumber&).
+ */
+void CalcMemory::record(const ComplexNumber &a, OpCode op, const ComplexNumber &b,
+                        const ComplexNumber &result) {
+    history.record(a, op, b, result);
+}
+
+/**
+ * @brief Keeps the history in a journal file from now on.
+ *
+ * @param path journal file, created if missing (const std::string&).
+ */
+void CalcMemory::openJournal(const std::string &path) {
+    history.openJournal(path);
+}
+
+/**
+ * @brief Calculations recorded so far.
+ *
+ * @return the history (const CalcHistory&).
+ */
+const CalcHistory &CalcMemory::getHistory() const {
+    return history;
+}
@@ -1,6 +1,13 @@
 #ifndef CALCMEMORY_H
 #define CALCMEMORY_H
 
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "calchistory.h"
+#include "compensatedsum.h"
 #include "complexnumber.h"
 
 
@@ -8,6 +15,10 @@
  * @brief Class for managing memory operations in a calculator application.
  *
  * This class provides functionalities for storing, retrieving, and manipulating complex numbers in memory.
+ *
+ * Memory is organised in named registers. Each register accumulates with Neumaier
+ * compensation, so adding millions of values keeps the sum accurate. Registers
+ * that were never written read as zero; the unnamed operations use DefaultRegister.
  */
 class CalcMemory {
 public:
@@ -22,9 +33,17 @@ public:
     ~CalcMemory();
 
     /**
-   * @brief Reads the currently displayed value.
-   */
-    ComplexNumber readMemory();
+     * @brief Name of the register used when none is given.
+     */
+    static constexpr const char *DefaultRegister = "M";
+
+    /**
+     * @brief Reads the value stored in a register.
+     *
+     * @param name register to be read (const std::string&).
+     * @return value of the register, zero if it was never written (ComplexNumber).
+     */
+    ComplexNumber readMemory(const std::string &name = DefaultRegister) const;
 
     /**
    * @brief Gets last used value.
@@ -39,34 +58,91 @@ public:
     void updateValue(ComplexNumber read);
 
     /**
-     * @brief Sets memory to given value.
+     * @brief Sets a register to given value.
      *
      * @param read new value to set memory to (ComplexNumber).
+     * @param name register to be set (const std::string&).
     */
-    void setMemory(ComplexNumber read);
+    void setMemory(ComplexNumber read, const std::string &name = DefaultRegister);
 
     /**
-     * @brief Adds number to number contained in the memory.
+     * @brief Adds number to number contained in a register.
      *
      * @param read to be added (ComplexNumber).
+     * @param name register to be added to (const std::string&).
+    */
+    void addToMemory(ComplexNumber read, const std::string &name = DefaultRegister);
+
+    /**
+     * @brief Adds a contiguous range of numbers to a register.
+     *
+     * The range is summed on several threads by reduceSum(); the result does not
+     * depend on the number of threads.
+     *
+     * @param values first number to be added (const ComplexNumber*).
+     * @param count number of values (std::size_t).
+     * @param name register to be added to (const std::string&).
+     * @param threads threads to use, 0 for one per hardware thread (unsigned).
     */
-    void addToMemory(ComplexNumber read);
+    void addRangeToMemory(const ComplexNumber *values, std::size_t count,
+                          const std::string &name = DefaultRegister, unsigned threads = 0);
 
     /**
-     * @brief Clears the memory content.
+     * @brief Clears a register.
+     *
+     * @param name register to be cleared (const std::string&).
     */
-    void clearMemory();
+    void clearMemory(const std::string &name = DefaultRegister);
+
+    /**
+     * @brief Names of the registers holding a value, in alphabetical order.
+     *
+     * @return register names (std::vector<std::string>).
+    */
+    std::vector<std::string> memoryRegisters() const;
+
+    /**
+     * @brief Records a finished calculation in the history.
+     *
+     * @param a first operand (const ComplexNumber&).
+     * @param op operation (OpCode).
+     * @param b second operand, zero for unary operations (const ComplexNumber&).
+     * @param result result (const ComplexNumber&).
+     * @throws std::runtime_error If the journal cannot grow.
+     */
+    void record(const ComplexNumber &a, OpCode op, const ComplexNumber &b,
+                const ComplexNumber &result);
+
+    /**
+     * @brief Keeps the history in a journal file from now on.
+     *
+     * @param path journal file, created if missing (const std::string&).
+     * @throws std::runtime_error If the journal cannot be opened.
+     */
+    void openJournal(const std::string &path);
+
+    /**
+     * @brief Calculations recorded so far.
+     *
+     * @return the history (const CalcHistory&).
+     */
+    const CalcHistory &getHistory() const;
 
 private:
     /**
-   * @brief Sum of all values stored in memory.
+   * @brief Compensated sum of all values stored in each register.
    */
-    ComplexNumber sumInMemory = ComplexNumber(0, 0);
+    std::map<std::string, CompensatedSum> registers;
 
     /**
    * @brief Last read value.
    */
     ComplexNumber lastValue = ComplexNumber(0, 0);
+
+    /**
+     * @brief Recent calculations in a fixed ring, optionally journaled to disk.
+     */
+    CalcHistory history;
 };
 
 #endif // CALCMEMORY_H
@@ -0,0 +1,140 @@
+#ifndef CALCPROTOCOL_H
+#define CALCPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Wire format of the calculation server (see CalcServer).
+//
+// Every message is a FrameHeader followed by length bytes of payload, in the byte
+// order of the host (the server only listens on local sockets). A request carries
+// count elements; each element is re, im of the operand followed, for binary
+// operations, by re, im of the second operand, all as doubles. The response has the
+// id of its request and count results as re, im pairs. A single operation is simply
+// a request with count = 1.
+//
+// Requests on one connection may be pipelined: a client can send many before it
+// reads any response. Responses come back as soon as their batch is done, which is
+// not necessarily in request order, so clients match them by id.
+
+/**
+ * @brief Operations understood by the server.
+ */
+enum class ServerOp : std::uint8_t {
+    Add = 1,
+    Subtract,
+    Multiply,
+    Divide,
+    Power,
+    Root,
+    Inverse,
+    Conjugate,
+    Absolute,
+    Exponential,
+    Logarithm,
+    Sine,
+    Cosine,
+    Tangent,
+    HyperbolicSine,
+    HyperbolicCosine,
+    HyperbolicTangent
+};
+
+/**
+ * @brief One past the largest ServerOp value.
+ */
+constexpr std::size_t ServerOpLimit = static_cast<std::size_t>(ServerOp::HyperbolicTangent) + 1;
+
+/**
+ * @brief Outcome reported in the status of a response.
+ */
+enum class ServerStatus : std::uint8_t {
+    /** @brief Every element was computed. */
+    Ok,
+    /** @brief errors elements had a zero divisor; their results are NaN. */
+    DivisionByZero,
+    /** @brief Unknown operation or a payload that does not match the count; no results. */
+    BadRequest
+};
+
+/**
+ * @brief Header of every request and response.
+ */
+struct FrameHeader {
+    /** @brief Payload bytes after the header. */
+    std::uint32_t length;
+
+    /** @brief Chosen by the client, echoed in the response. */
+    std::uint32_t id;
+
+    /** @brief ServerOp of the request, echoed in the response. */
+    std::uint8_t op;
+
+    /** @brief ServerStatus of a response, zero in requests. */
+    std::uint8_t status;
+
+    /** @brief Zero. */
+    std::uint16_t reserved;
+
+    /** @brief Number of elements. */
+    std::uint32_t count;
+
+    /** @brief Elements with a zero divisor in a response, zero in requests. */
+    std::uint32_t errors;
+};
+
+static_assert(sizeof(FrameHeader) == 20, "FrameHeader must have no padding");
+
+/**
+ * @brief Largest number of elements in one frame.
+ */
+constexpr std::uint32_t MaxFrameElements = 1 << 22;
+
+/**
+ * @brief Whether a byte names a ServerOp.
+ *
+ * @param op operation byte (std::uint8_t).
+ * @return true for a known operation (bool).
+ */
+inline bool isServerOp(std::uint8_t op) noexcept
+{
+    return op >= static_cast<std::uint8_t>(ServerOp::Add) && op < ServerOpLimit;
+}
+
+/**
+ * @brief Doubles per request element: 4 for binary operations, 2 otherwise.
+ *
+ * @param op operation (ServerOp).
+ * @return operand doubles per element (std::size_t).
+ */
+inline std::size_t operandDoubles(ServerOp op) noexcept
+{
+    return op <= ServerOp::Power ? 4 : 2;
+}
+
+/**
+ * @brief Appends one request frame to a buffer.
+ *
+ * @param out buffer the frame is appended to (std::vector<char>&).
+ * @param id request id (std::uint32_t).
+ * @param op operation (ServerOp).
+ * @param operands count * operandDoubles(op) doubles (const double*).
+ * @param count number of elements (std::uint32_t).
+ */
+inline void appendRequest(std::vector<char> &out, std::uint32_t id, ServerOp op, const double *operands,
+                          std::uint32_t count)
+{
+    const std::size_t bytes = count * operandDoubles(op) * sizeof(double);
+    const FrameHeader header = {static_cast<std::uint32_t>(bytes), id, static_cast<std::uint8_t>(op), 0, 0,
+                                count, 0};
+    const std::size_t start = out.size();
+    out.resize(start + sizeof(header) + bytes);
+    std::memcpy(out.data() + start, &header, sizeof(header));
+    if (bytes != 0) {
+        std::memcpy(out.data() + start + sizeof(header), operands, bytes);
+    }
+}
+
+#endif // CALCPROTOCOL_H
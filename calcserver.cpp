@@ -0,0 +1,727 @@
+#include "calcserver.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "complexarray.h"
+#include "complexkernels.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+/**
+ * @brief Bytes requested from the socket per recv() call.
+ */
+constexpr std::size_t ReadSize = 1 << 16;
+
+/**
+ * @brief Bytes read from one client per turn of the loop, so one client cannot starve the others.
+ */
+constexpr std::size_t ReadBudget = 1 << 20;
+
+/**
+ * @brief A batch is handed to the workers as soon as it holds this many elements.
+ */
+constexpr std::size_t MaxBatchElements = 1 << 16;
+
+/**
+ * @brief Unsent response bytes at which a client is no longer read from.
+ */
+constexpr std::size_t MaxPendingOutput = 1 << 24;
+
+/**
+ * @brief One request inside a batch, and where its response frame ends up.
+ */
+struct Slot {
+    std::uint64_t connection;
+    std::uint32_t id;
+    std::size_t offset, count;
+    std::size_t frameBegin = 0, frameEnd = 0;
+};
+
+/**
+ * @brief Requests of one operation computed together.
+ */
+struct Batch {
+    ServerOp op;
+    std::vector<double> ar, ai, br, bi;
+    std::vector<Slot> slots;
+
+    /** @brief Response frames of every slot, filled by computeBatch(). */
+    std::vector<char> frames;
+
+    std::size_t size() const { return ar.size(); }
+};
+
+/**
+ * @brief Blocking queue feeding the workers; a null batch stops one worker.
+ */
+class BatchQueue {
+public:
+    void push(std::unique_ptr<Batch> batch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.push_back(std::move(batch));
+        }
+        ready.notify_one();
+    }
+
+    std::unique_ptr<Batch> pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !batches.empty(); });
+        std::unique_ptr<Batch> batch = std::move(batches.front());
+        batches.pop_front();
+        return batch;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::unique_ptr<Batch>> batches;
+};
+
+/**
+ * @brief State of one client connection, owned by the event loop.
+ */
+struct Connection {
+    int fd;
+    std::vector<char> input;
+    std::vector<char> output;
+    std::size_t sent = 0;
+
+    /** @brief Requests queued or being computed whose responses are not in output yet. */
+    std::size_t inFlight = 0;
+
+    /** @brief Whether the client has shut down its side; it still gets its responses. */
+    bool readClosed = false;
+
+    /** @brief Whether a read-closed connection has nothing left to send. */
+    bool drained() const { return readClosed && inFlight == 0 && sent == output.size(); }
+};
+
+/**
+ * @brief Runs a batch through the kernels and writes the response frame of every slot.
+ */
+void computeBatch(Batch &batch, const ComplexKernels &kernels)
+{
+    const std::size_t n = batch.size();
+    std::vector<double> rr(n), ri(n);
+    ErrorMask errors;
+    errors.reset(n);
+    const double *ar = batch.ar.data(), *ai = batch.ai.data(), *br = batch.br.data(), *bi = batch.bi.data();
+    double *r = rr.data(), *i = ri.data();
+
+    switch (batch.op) {
+    case ServerOp::Add:
+        kernels.add(ar, ai, br, bi, r, i, n);
+        break;
+    case ServerOp::Subtract:
+        kernels.subtract(ar, ai, br, bi, r, i, n);
+        break;
+    case ServerOp::Multiply:
+        kernels.multiply(ar, ai, br, bi, r, i, n);
+        break;
+    case ServerOp::Divide:
+        kernels.divide(ar, ai, br, bi, r, i, n, errors.data(), 0);
+        break;
+    case ServerOp::Power:
+        kernels.power(ar, ai, br, bi, r, i, n);
+        break;
+    case ServerOp::Root:
+        kernels.root(ar, ai, r, i, n);
+        break;
+    case ServerOp::Inverse:
+        kernels.inverse(ar, ai, r, i, n, errors.data(), 0);
+        break;
+    case ServerOp::Conjugate:
+        kernels.conjugate(ar, ai, r, i, n);
+        break;
+    case ServerOp::Absolute:
+        kernels.absoluteValue(ar, ai, r, n);
+        break;
+    case ServerOp::Exponential:
+        kernels.exponential(ar, ai, r, i, n);
+        break;
+    case ServerOp::Logarithm:
+        kernels.logarithm(ar, ai, r, i, n);
+        break;
+    case ServerOp::Sine:
+        kernels.sine(ar, ai, r, i, n);
+        break;
+    case ServerOp::Cosine:
+        kernels.cosine(ar, ai, r, i, n);
+        break;
+    case ServerOp::Tangent:
+        kernels.tangent(ar, ai, r, i, n);
+        break;
+    case ServerOp::HyperbolicSine:
+        kernels.hyperbolicSine(ar, ai, r, i, n);
+        break;
+    case ServerOp::HyperbolicCosine:
+        kernels.hyperbolicCosine(ar, ai, r, i, n);
+        break;
+    case ServerOp::HyperbolicTangent:
+        kernels.hyperbolicTangent(ar, ai, r, i, n);
+        break;
+    }
+    errors.recount();
+
+    batch.frames.resize(batch.slots.size() * sizeof(FrameHeader) + n * 2 * sizeof(double));
+    char *out = batch.frames.data();
+    for (Slot &slot : batch.slots) {
+        std::uint32_t failed = 0;
+        if (errors.any()) {
+            for (std::size_t k = slot.offset; k < slot.offset + slot.count; ++k) {
+                failed += errors.test(k);
+            }
+        }
+        const FrameHeader header = {static_cast<std::uint32_t>(slot.count * 2 * sizeof(double)), slot.id,
+                                    static_cast<std::uint8_t>(batch.op),
+                                    static_cast<std::uint8_t>(failed ? ServerStatus::DivisionByZero
+                                                                     : ServerStatus::Ok),
+                                    0, static_cast<std::uint32_t>(slot.count), failed};
+        slot.frameBegin = static_cast<std::size_t>(out - batch.frames.data());
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        for (std::size_t k = slot.offset; k < slot.offset + slot.count; ++k) {
+            const double pair[2] = {rr[k], ri[k]};
+            std::memcpy(out, pair, sizeof(pair));
+            out += sizeof(pair);
+        }
+        slot.frameEnd = static_cast<std::size_t>(out - batch.frames.data());
+    }
+}
+
+/**
+ * @brief Makes a descriptor non-blocking and close-on-exec.
+ */
+void makeNonBlocking(int fd)
+{
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+/**
+ * @brief Error for a failed system call.
+ */
+std::runtime_error systemError(const std::string &what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/**
+ * @brief Sends as much pending output as the socket takes.
+ *
+ * @return false if the connection failed.
+ */
+bool flushOutput(Connection &connection)
+{
+    while (connection.sent < connection.output.size()) {
+        const ssize_t n = send(connection.fd, connection.output.data() + connection.sent,
+                               connection.output.size() - connection.sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.sent += static_cast<std::size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (connection.sent == connection.output.size()) {
+        connection.output.clear();
+        connection.sent = 0;
+    } else if (connection.sent > connection.output.size() / 2) {
+        connection.output.erase(connection.output.begin(),
+                                connection.output.begin() + static_cast<std::ptrdiff_t>(connection.sent));
+        connection.sent = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads what the socket has, up to ReadBudget bytes.
+ *
+ * End of input only marks the connection read-closed, so a client that half-closes
+ * after its requests still receives the responses.
+ *
+ * @return false if the connection failed.
+ */
+bool readInput(Connection &connection)
+{
+    for (std::size_t total = 0; total < ReadBudget;) {
+        const std::size_t old = connection.input.size();
+        connection.input.resize(old + ReadSize);
+        const ssize_t n = recv(connection.fd, connection.input.data() + old, ReadSize, 0);
+        connection.input.resize(old + static_cast<std::size_t>(std::max<ssize_t>(n, 0)));
+        if (n > 0) {
+            total += static_cast<std::size_t>(n);
+        } else if (n == 0) {
+            connection.readClosed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Server whose signal handlers stop it.
+ */
+std::atomic<CalcServer *> signalTarget{nullptr};
+
+extern "C" void stopOnSignal(int)
+{
+    if (CalcServer *server = signalTarget.load()) {
+        server->stop();
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Opens the listening sockets.
+ *
+ * @param options sockets and threads (const ServerOptions&).
+ * @throws std::invalid_argument If no socket is requested.
+ * @throws std::runtime_error If a socket cannot be opened.
+ */
+CalcServer::CalcServer(const ServerOptions &options)
+    : options(options)
+{
+    if (options.socketPath.empty() && options.tcpPort < 0) {
+        throw std::invalid_argument("The server needs a socket path or a TCP port!");
+    }
+
+    try {
+        int pipeEnds[2];
+        if (pipe(pipeEnds) != 0) {
+            throw systemError("pipe");
+        }
+        wakeRead = pipeEnds[0];
+        wakeWrite = pipeEnds[1];
+        makeNonBlocking(wakeRead);
+        makeNonBlocking(wakeWrite);
+
+        if (!options.socketPath.empty()) {
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            if (options.socketPath.size() >= sizeof(address.sun_path)) {
+                throw std::invalid_argument("Socket path too long: " + options.socketPath);
+            }
+            std::memcpy(address.sun_path, options.socketPath.c_str(), options.socketPath.size() + 1);
+
+            struct stat existing;
+            if (lstat(options.socketPath.c_str(), &existing) == 0) {
+                if (!S_ISSOCK(existing.st_mode)) {
+                    throw std::runtime_error(options.socketPath + " exists and is not a socket");
+                }
+                unlink(options.socketPath.c_str());
+            }
+            unixListener = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (unixListener < 0) {
+                throw systemError("socket");
+            }
+            if (bind(unixListener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0
+                || listen(unixListener, SOMAXCONN) != 0) {
+                throw systemError("Cannot listen on " + options.socketPath);
+            }
+            makeNonBlocking(unixListener);
+        }
+
+        if (options.tcpPort >= 0) {
+            if (options.tcpPort > 65535) {
+                throw std::invalid_argument("Invalid TCP port: " + std::to_string(options.tcpPort));
+            }
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<std::uint16_t>(options.tcpPort));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            tcpListener = socket(AF_INET, SOCK_STREAM, 0);
+            if (tcpListener < 0) {
+                throw systemError("socket");
+            }
+            const int reuse = 1;
+            setsockopt(tcpListener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            if (bind(tcpListener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0
+                || listen(tcpListener, SOMAXCONN) != 0) {
+                throw systemError("Cannot listen on port " + std::to_string(options.tcpPort));
+            }
+            socklen_t length = sizeof(address);
+            getsockname(tcpListener, reinterpret_cast<sockaddr *>(&address), &length);
+            boundPort = ntohs(address.sin_port);
+            makeNonBlocking(tcpListener);
+        }
+    } catch (...) {
+        closeSockets();
+        throw;
+    }
+}
+
+/**
+ * @brief Closes the listening sockets and removes the socket file.
+ */
+CalcServer::~CalcServer()
+{
+    closeSockets();
+}
+
+/**
+ * @brief Closes whatever sockets and pipe ends are open.
+ */
+void CalcServer::closeSockets() noexcept
+{
+    if (unixListener >= 0) {
+        close(unixListener);
+        unlink(options.socketPath.c_str());
+        unixListener = -1;
+    }
+    for (int *fd : {&tcpListener, &wakeRead, &wakeWrite}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+/**
+ * @brief Makes run() return; safe to call from any thread and from a signal handler.
+ */
+void CalcServer::stop() noexcept
+{
+    stopping.store(true);
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t written = write(wakeWrite, &byte, 1);
+}
+
+/**
+ * @brief Serves clients until stop() is called.
+ *
+ * @throws std::runtime_error If the event loop fails.
+ * @return counters for the run (Stats).
+ */
+CalcServer::Stats CalcServer::run()
+{
+    Stats stats;
+    const ComplexKernels &kernels = activeKernels();
+    const unsigned threads = options.threads != 0 ? options.threads
+                                                  : std::max(1u, std::thread::hardware_concurrency());
+
+    BatchQueue jobs;
+    std::mutex doneMutex;
+    std::vector<std::unique_ptr<Batch>> done, finished;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            while (std::unique_ptr<Batch> batch = jobs.pop()) {
+                computeBatch(*batch, kernels);
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    done.push_back(std::move(batch));
+                }
+                const char byte = 0;
+                [[maybe_unused]] const ssize_t written = write(wakeWrite, &byte, 1);
+            }
+        });
+    }
+
+    std::unordered_map<std::uint64_t, Connection> connections;
+    std::uint64_t nextConnection = 1;
+    std::unique_ptr<Batch> pending[ServerOpLimit];
+    std::vector<pollfd> fds;
+    std::vector<std::uint64_t> owners;
+
+    const auto closeConnection = [&](std::uint64_t id) {
+        close(connections.at(id).fd);
+        connections.erase(id);
+    };
+
+    // Splits the input of a connection into frames and queues the requests.
+    const auto parseFrames = [&](std::uint64_t id, Connection &connection) {
+        std::size_t position = 0;
+        while (connection.input.size() - position >= sizeof(FrameHeader)) {
+            FrameHeader header;
+            std::memcpy(&header, connection.input.data() + position, sizeof(header));
+            if (header.length > std::size_t(MaxFrameElements) * 4 * sizeof(double)) {
+                return false;
+            }
+            if (connection.input.size() - position < sizeof(header) + header.length) {
+                break;
+            }
+            const char *payload = connection.input.data() + position + sizeof(header);
+            position += sizeof(header) + header.length;
+
+            const ServerOp op = static_cast<ServerOp>(header.op);
+            if (!isServerOp(header.op) || header.count > MaxFrameElements
+                || header.length != header.count * operandDoubles(op) * sizeof(double)) {
+                const FrameHeader response = {0, header.id, header.op,
+                                              static_cast<std::uint8_t>(ServerStatus::BadRequest), 0, 0, 0};
+                const char *bytes = reinterpret_cast<const char *>(&response);
+                connection.output.insert(connection.output.end(), bytes, bytes + sizeof(response));
+                ++stats.requests;
+                continue;
+            }
+
+            std::unique_ptr<Batch> &batch = pending[header.op];
+            if (!batch) {
+                batch = std::make_unique<Batch>();
+                batch->op = op;
+            }
+            batch->slots.push_back(Slot{id, header.id, batch->size(), header.count});
+            ++connection.inFlight;
+            const bool binary = operandDoubles(op) == 4;
+            for (std::uint32_t k = 0; k < header.count; ++k) {
+                double element[4];
+                std::memcpy(element, payload + k * operandDoubles(op) * sizeof(double),
+                            operandDoubles(op) * sizeof(double));
+                batch->ar.push_back(element[0]);
+                batch->ai.push_back(element[1]);
+                if (binary) {
+                    batch->br.push_back(element[2]);
+                    batch->bi.push_back(element[3]);
+                }
+            }
+            if (batch->size() >= MaxBatchElements) {
+                jobs.push(std::move(batch));
+            }
+        }
+        connection.input.erase(connection.input.begin(),
+                               connection.input.begin() + static_cast<std::ptrdiff_t>(position));
+        return true;
+    };
+
+    const auto acceptAll = [&](int listener, bool tcp) {
+        for (;;) {
+            const int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            makeNonBlocking(fd);
+            if (tcp) {
+                const int noDelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            }
+            connections.emplace(nextConnection++, Connection{fd, {}, {}});
+            ++stats.connections;
+        }
+    };
+
+    const auto shutdown = [&] {
+        for (std::size_t t = 0; t < workers.size(); ++t) {
+            jobs.push(nullptr);
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        for (auto &entry : connections) {
+            close(entry.second.fd);
+        }
+        connections.clear();
+    };
+
+    try {
+        while (!stopping.load()) {
+            fds.clear();
+            owners.clear();
+            fds.push_back(pollfd{wakeRead, POLLIN, 0});
+            fds.push_back(pollfd{unixListener, POLLIN, 0});
+            fds.push_back(pollfd{tcpListener, POLLIN, 0});
+            for (const auto &entry : connections) {
+                const Connection &connection = entry.second;
+                short events = 0;
+                if (!connection.readClosed && connection.output.size() - connection.sent < MaxPendingOutput) {
+                    events |= POLLIN;
+                }
+                if (connection.sent < connection.output.size()) {
+                    events |= POLLOUT;
+                }
+                fds.push_back(pollfd{connection.fd, events, 0});
+                owners.push_back(entry.first);
+            }
+
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw systemError("poll");
+            }
+
+            if (fds[0].revents != 0) {
+                char drain[256];
+                while (read(wakeRead, drain, sizeof(drain)) > 0) {
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                finished.swap(done);
+            }
+            for (const std::unique_ptr<Batch> &batch : finished) {
+                ++stats.batches;
+                for (const Slot &slot : batch->slots) {
+                    ++stats.requests;
+                    stats.elements += slot.count;
+                    auto found = connections.find(slot.connection);
+                    if (found != connections.end()) {
+                        --found->second.inFlight;
+                        found->second.output.insert(found->second.output.end(),
+                                                    batch->frames.begin() + static_cast<std::ptrdiff_t>(slot.frameBegin),
+                                                    batch->frames.begin() + static_cast<std::ptrdiff_t>(slot.frameEnd));
+                    }
+                }
+            }
+            finished.clear();
+
+            if (fds[1].revents != 0) {
+                acceptAll(unixListener, false);
+            }
+            if (fds[2].revents != 0) {
+                acceptAll(tcpListener, true);
+            }
+
+            for (std::size_t k = 3; k < fds.size(); ++k) {
+                const std::uint64_t id = owners[k - 3];
+                Connection &connection = connections.at(id);
+                bool open = true;
+                if (connection.readClosed) {
+                    // A hang-up now means the client is gone in both directions.
+                    open = !(fds[k].revents & (POLLHUP | POLLERR));
+                } else if (fds[k].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    open = readInput(connection);
+                    open = parseFrames(id, connection) && open;
+                }
+                if (open) {
+                    open = flushOutput(connection);
+                }
+                if (!open) {
+                    closeConnection(id);
+                }
+            }
+            // Responses from batches finished above go out without waiting for POLLOUT;
+            // half-closed clients are closed once all of theirs are out.
+            for (auto &entry : connections) {
+                Connection &connection = entry.second;
+                if ((connection.sent < connection.output.size() && !flushOutput(connection))
+                    || connection.drained()) {
+                    close(connection.fd);
+                    connection.fd = -1;
+                }
+            }
+            for (auto it = connections.begin(); it != connections.end();) {
+                it = it->second.fd < 0 ? connections.erase(it) : std::next(it);
+            }
+
+            // Everything read in this turn goes to the workers, one batch per operation.
+            for (std::unique_ptr<Batch> &batch : pending) {
+                if (batch) {
+                    jobs.push(std::move(batch));
+                }
+            }
+        }
+    } catch (...) {
+        shutdown();
+        throw;
+    }
+    shutdown();
+    return stats;
+}
+
+/**
+ * @brief Runs the server for the command line: "<socket-path> [--tcp <port>] [--threads <n>]".
+ *
+ * @param argc number of arguments after "--serve" (int).
+ * @param argv the arguments (char**).
+ * @throws std::invalid_argument If the arguments are malformed.
+ * @throws std::runtime_error If the server cannot start.
+ * @return process exit code (int).
+ */
+int serveFromCommandLine(int argc, char *argv[])
+{
+    ServerOptions options;
+    for (int k = 0; k < argc; ++k) {
+        const std::string argument = argv[k];
+        if ((argument == "--tcp" || argument == "--threads") && k + 1 < argc) {
+            std::size_t used = 0;
+            const std::string value = argv[++k];
+            const int number = std::stoi(value, &used);
+            if (used != value.size() || number < 0) {
+                throw std::invalid_argument("Not a valid number: " + value);
+            }
+            if (argument == "--tcp") {
+                options.tcpPort = number;
+            } else {
+                options.threads = static_cast<unsigned>(number);
+            }
+        } else if (argument.rfind("--", 0) != 0 && options.socketPath.empty()) {
+            options.socketPath = argument;
+        } else {
+            throw std::invalid_argument("Unexpected server argument: " + argument);
+        }
+    }
+
+    CalcServer server(options);
+    if (!options.socketPath.empty()) {
+        std::cerr << "listening on " << options.socketPath << '\n';
+    }
+    if (server.tcpPort() >= 0) {
+        std::cerr << "listening on 127.0.0.1:" << server.tcpPort() << '\n';
+    }
+
+    signalTarget.store(&server);
+    struct sigaction action = {};
+    action.sa_handler = stopOnSignal;
+    sigemptyset(&action.sa_mask);
+    struct sigaction previousInterrupt, previousTerminate;
+    sigaction(SIGINT, &action, &previousInterrupt);
+    sigaction(SIGTERM, &action, &previousTerminate);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    CalcServer::Stats stats;
+    try {
+        stats = server.run();
+    } catch (...) {
+        signalTarget.store(nullptr);
+        sigaction(SIGINT, &previousInterrupt, nullptr);
+        sigaction(SIGTERM, &previousTerminate, nullptr);
+        throw;
+    }
+    signalTarget.store(nullptr);
+    sigaction(SIGINT, &previousInterrupt, nullptr);
+    sigaction(SIGTERM, &previousTerminate, nullptr);
+
+    std::cerr << stats.connections << " connections, " << stats.requests << " requests, " << stats.elements
+              << " elements in " << stats.batches << " batches\n";
+    return 0;
+}
@@ -0,0 +1,145 @@
+#ifndef CALCSERVER_H
+#define CALCSERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "calcprotocol.h"
+
+/**
+ * @brief Where and how the calculation server runs.
+ */
+struct ServerOptions {
+    /** @brief Path of the Unix domain socket; empty for none. */
+    std::string socketPath;
+
+    /** @brief Port on 127.0.0.1 to listen on, 0 for any free port, -1 for none. */
+    int tcpPort = -1;
+
+    /** @brief Worker threads, 0 for one per hardware thread. */
+    unsigned threads = 0;
+};
+
+/**
+ * @brief Local calculation server speaking the framed protocol of calcprotocol.h.
+ *
+ * One event loop thread (the one calling run()) accepts connections, reads requests
+ * from every client without blocking and writes responses back. Requests of the same
+ * operation that arrive in one turn of the loop, from any number of clients, are
+ * coalesced into one batch: their operands are laid out in split arrays and the
+ * batch runs through the kernels of activeKernels() on a pool of worker threads.
+ * Finished batches are handed back to the loop, which sends each request its
+ * slice of the results. The results are those of the ComplexNumber methods of the
+ * same names.
+ *
+ * A client whose unsent responses pass a limit is not read from until it catches
+ * up, so a client that does not read cannot make the server buffer without bound.
+ * A malformed header closes the connection; a well-formed request that cannot be
+ * served gets a BadRequest response.
+ */
+class CalcServer {
+public:
+    /**
+     * @brief Counters describing a finished run.
+     */
+    struct Stats {
+        /** @brief Connections accepted. */
+        std::size_t connections = 0;
+
+        /** @brief Requests answered. */
+        std::size_t requests = 0;
+
+        /** @brief Elements computed. */
+        std::size_t elements = 0;
+
+        /** @brief Batches run by the workers. */
+        std::size_t batches = 0;
+    };
+
+    /**
+     * @brief Opens the listening sockets.
+     *
+     * A stale socket file at the path is replaced.
+     *
+     * @param options sockets and threads (const ServerOptions&).
+     * @throws std::invalid_argument If no socket is requested.
+     * @throws std::runtime_error If a socket cannot be opened.
+     */
+    explicit CalcServer(const ServerOptions &options);
+
+    /**
+     * @brief Closes the listening sockets and removes the socket file.
+     */
+    ~CalcServer();
+
+    CalcServer(const CalcServer &) = delete;
+    CalcServer &operator=(const CalcServer &) = delete;
+
+    /**
+     * @brief Port the TCP socket listens on.
+     *
+     * @return port, -1 without a TCP socket (int).
+     */
+    int tcpPort() const { return boundPort; }
+
+    /**
+     * @brief Serves clients until stop() is called.
+     *
+     * @throws std::runtime_error If the event loop fails.
+     * @return counters for the run (Stats).
+     */
+    Stats run();
+
+    /**
+     * @brief Makes run() return; safe to call from any thread and from a signal handler.
+     */
+    void stop() noexcept;
+
+private:
+    /**
+     * @brief Closes whatever sockets and pipe ends are open.
+     */
+    void closeSockets() noexcept;
+
+    /**
+     * @brief The options the server was opened with.
+     */
+    ServerOptions options;
+
+    /**
+     * @brief Listening sockets, -1 when not open.
+     */
+    int unixListener = -1, tcpListener = -1;
+
+    /**
+     * @brief Port bound by the TCP socket.
+     */
+    int boundPort = -1;
+
+    /**
+     * @brief Self-pipe waking the event loop: read end, write end.
+     */
+    int wakeRead = -1, wakeWrite = -1;
+
+    /**
+     * @brief Set by stop().
+     */
+    std::atomic<bool> stopping{false};
+};
+
+/**
+ * @brief Runs the server for the command line: "<socket-path> [--tcp <port>] [--threads <n>]".
+ *
+ * Stops on SIGINT or SIGTERM and prints the counters to stderr.
+ *
+ * @param argc number of arguments after "--serve" (int).
+ * @param argv the arguments (char**).
+ * @throws std::invalid_argument If the arguments are malformed.
+ * @throws std::runtime_error If the server cannot start.
+ * @return process exit code (int).
+ */
+int serveFromCommandLine(int argc, char *argv[]);
+
+#endif // CALCSERVER_H
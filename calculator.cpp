@@ -1,6 +1,11 @@
 ﻿#include "calculator.h"
 #include "button.h"
+#include "precision.h"
+#include "reduction.h"
+#include "rootfinder.h"
+#include "telemetry.h"
 
+#include <QComboBox>
 #include <QGridLayout>
 #include <QLineEdit>
 #include <QtMath>
@@ -10,18 +15,125 @@
 #include <QScatterSeries>
 #include <QMargins>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QGraphicsPixmapItem>
+#include <QGraphicsRectItem>
+#include <QImage>
+#include <QLabel>
+#include <QPixmap>
+#include <QProgressBar>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDir>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Position of a complex number on the chart.
+ */
+QPointF toPoint(const ComplexNumber &z)
+{
+    return QPointF(z.getReal(), z.getImaginary());
+}
+
+/**
+ * @brief Upper bound on history points handed to the chart per redraw.
+ */
+constexpr std::size_t MaxHistoryPoints = 20000;
+
+/**
+ * @brief Time deliverJobs() may spend before yielding to the event loop, half a frame.
+ */
+constexpr qint64 DeliveryBudgetMs = 8;
+
+/**
+ * @brief Threads running background jobs; the jobs themselves may use more.
+ */
+constexpr unsigned JobThreads = 2;
+
+/**
+ * @brief Whether both parts of a number are finite, i.e. it can be plotted.
+ */
+bool isFinite(const ComplexNumber &value)
+{
+    return std::isfinite(value.getReal()) && std::isfinite(value.getImaginary());
+}
+
+/**
+ * @brief Appends the results of a batch output file ("real imaginary" per line).
+ *
+ * Error lines, results that are not finite and anything else that is not two
+ * numbers are skipped. Progress is
+ * reported by the share of the file read; a cancelled job stops reading.
+ *
+ * @return number of points read (std::size_t).
+ */
+std::size_t readResults(const std::string &path, PointPyramid &history, JobControl &control)
+{
+    std::ifstream input(path, std::ios::ate);
+    if (!input) {
+        throw std::invalid_argument("Cannot open " + path + "!");
+    }
+    const double size = static_cast<double>(input.tellg());
+    input.seekg(0);
+    std::size_t count = 0, lines = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (++lines % (1 << 16) == 0) {
+            if (control.cancelled()) {
+                break;
+            }
+            control.setProgress(static_cast<double>(input.tellg()) / size);
+        }
+        const char *end = line.data() + line.size();
+        double real, imaginary;
+        auto [next, error] = std::from_chars(line.data(), end, real);
+        if (error != std::errc() || next == end || *next != ' ') {
+            continue;
+        }
+        auto [last, secondError] = std::from_chars(next + 1, end, imaginary);
+        if (secondError != std::errc() || last != end) {
+            continue;
+        }
+        // from_chars accepts "inf" and "nan", which --batch writes for overflows.
+        if (!std::isfinite(real) || !std::isfinite(imaginary)) {
+            continue;
+        }
+        history.append(ComplexNumber(real, imaginary));
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
 
 Calculator::Calculator(QWidget *parent)
     : QWidget(parent),
     realPart(true),
-    operation("none")
+    operation(OpCode::None)
 {
     /**
      * @brief Constructor for the Calculator class.
      * @param parent The parent widget of the calculator.
      */
-    // Create calculator memory object
-    CalcMemory calcMemory;
+    // Keep the calculation history across sessions; without a writable data
+    // directory, or while another instance holds the journal, it lives only in
+    // the in-memory ring.
+    const QString dataDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (QDir().mkpath(dataDirectory)) {
+        try {
+            calcMemory.openJournal((dataDirectory + "/history.journal").toStdString());
+        } catch (const std::runtime_error&) {
+        }
+    }
 
     // Set color palette.
     palette_active.setColor(QPalette::Base,Qt::green);
@@ -50,9 +162,13 @@ Calculator::Calculator(QWidget *parent)
     font_i.setPointSize(font_i.pointSize() + 8);
     display_i->setFont(font_i);
 
-    chartView = new QChartView();
-    chart = new QChart;
-
+    // The chart is built on the first plot; until then a plain label holds its place,
+    // so opening the window does not wait for Qt Charts.
+    chartPlaceholder = new QLabel(tr("Results are plotted here"));
+    chartPlaceholder->setAlignment(Qt::AlignCenter);
+    historyRefreshPending = false;
+    fractalRefreshPending = false;
+    deepZoom = false;
 
     // Pointers to buttons executing calculator functions.
     for (int i = 0; i < NumDigitButtons; ++i)
@@ -78,7 +194,7 @@ Calculator::Calculator(QWidget *parent)
     Button *realButton = createButton(tr("Real"), &Calculator::realClicked);
     Button *imgButton = createButton(tr("Imaginary"), &Calculator::imgClicked);
 
-    Button *powerButton = createButton(tr("x\302\262"), &Calculator::power);
+    Button *powerButton = createButton(tr("x\312\270"), &Calculator::power);
     Button *rootButton = createButton(("\u221A"), &Calculator::root);
     Button *conjButton = createButton(tr("x*"), &Calculator::conjugate);
     Button *invButton = createButton(tr("1/x"), &Calculator::inverse);
@@ -92,6 +208,46 @@ Calculator::Calculator(QWidget *parent)
 
     Button *equalButton = createButton(tr("="), &Calculator::equals);
 
+    // Free-form expression input, compiled and evaluated on Enter.
+    expressionInput = new QLineEdit;
+    expressionInput->setPlaceholderText(tr("Expression, e.g. (3+2i)*x/sqrt(4i) + conj(m)"));
+    connect(expressionInput, &QLineEdit::returnPressed, this, &Calculator::evaluateExpression);
+
+    // Register used by MC, MR, MS, M+ and the expression variable m; new names can be typed.
+    memoryRegister = new QComboBox;
+    memoryRegister->setEditable(true);
+    memoryRegister->addItems({CalcMemory::DefaultRegister, "M1", "M2", "M3"});
+    memoryRegister->setToolTip(tr("Memory register"));
+
+    // Fractal drawn in the chart; the Julia set is the one of the displayed number.
+    fractalMode = new QComboBox;
+    fractalMode->addItems({tr("No Fractal"), tr("Mandelbrot Set"), tr("Julia Set of Display"),
+                           tr("Mandelbrot Deep Zoom")});
+    connect(fractalMode, &QComboBox::currentIndexChanged, this, &Calculator::scheduleFractalRefresh);
+    connect(display, &QLineEdit::textChanged, this, &Calculator::scheduleFractalRefresh);
+    connect(display_i, &QLineEdit::textChanged, this, &Calculator::scheduleFractalRefresh);
+
+    // Precision the keypad operations are computed in, listed in the order of Precision.
+    precisionBox = new QComboBox;
+    precisionBox->addItems({tr("Float"), tr("Double"), tr("Long Double")});
+    if (precisionAvailable(Precision::Quad)) {
+        precisionBox->addItem(tr("Quad"));
+    }
+    precisionBox->setCurrentIndex(static_cast<int>(Precision::Double));
+    precisionBox->setToolTip(tr("Precision of the keypad operations"));
+
+    Button *plotFileButton = createButton(tr("Plot Results File"), &Calculator::plotResultsFile);
+    Button *clearHistoryButton = createButton(tr("Clear History"), &Calculator::clearHistory);
+    Button *rootsButton = createButton(tr("Poly Roots"), &Calculator::findPolynomialRoots);
+
+    // Results files and polynomial roots are computed by background jobs.
+    jobProgress = new QProgressBar;
+    jobProgress->setRange(0, 100);
+    jobProgress->setValue(0);
+    jobProgress->setEnabled(false);
+    cancelButton = createButton(tr("Cancel"), &Calculator::cancelJobs);
+    cancelButton->setEnabled(false);
+
     // GUI setup.
     mainLayout = new QGridLayout;
 
@@ -139,12 +295,20 @@ Calculator::Calculator(QWidget *parent)
     mainLayout->addWidget(cCircButton, 8, 0, 1, 3);
     mainLayout->addWidget(tCircButton, 8, 3, 1, 3);
 
+    mainLayout->addWidget(expressionInput, 9, 0, 1, 5);
+    mainLayout->addWidget(memoryRegister, 9, 5);
+    mainLayout->addWidget(plotFileButton, 10, 0, 1, 2);
+    mainLayout->addWidget(clearHistoryButton, 10, 2, 1, 2);
+    mainLayout->addWidget(rootsButton, 10, 4, 1, 2);
+    mainLayout->addWidget(fractalMode, 11, 0, 1, 4);
+    mainLayout->addWidget(precisionBox, 11, 4, 1, 2);
+    mainLayout->addWidget(jobProgress, 12, 0, 1, 4);
+    mainLayout->addWidget(cancelButton, 12, 4, 1, 2);
+
 
     // Chart for plotting the results.
-    chartView->setChart(chart);
-    mainLayout->addWidget(chartView, 0, 7, 9, 5);
-    chartView->setMinimumSize(QSize(400, 300));
-    chart->createDefaultAxes();
+    mainLayout->addWidget(chartPlaceholder, 0, 7, 13, 5);
+    chartPlaceholder->setMinimumSize(QSize(400, 300));
 
     setLayout(mainLayout);
     setWindowTitle(tr("Calculator"));
@@ -198,6 +362,7 @@ QLineEdit* Calculator::getActiveDisplay()
  */
 void Calculator::displayNumber(ComplexNumber a)
 {
+    TelemetryScope scope(TelemetryOp::DisplayUpdate);
     double real = a.getReal();
     double imaginary = a.getImaginary();
 
@@ -227,6 +392,16 @@ ComplexNumber Calculator::readNumber() {
     return ComplexNumber(real, imaginary);
 }
 
+/**
+ * @brief Precision picked for the keypad operations.
+ *
+ * @return precision (Precision).
+ */
+Precision Calculator::selectedPrecision() const
+{
+    return static_cast<Precision>(precisionBox->currentIndex());
+}
+
 /**
  * @brief Updates the displayed values on both displays.
  */
@@ -290,7 +465,7 @@ void Calculator::pointClicked()
 void Calculator::add()
 {
     updateValue();
-    operation = "addition";
+    operation = OpCode::Add;
 }
 
 /**
@@ -299,7 +474,7 @@ void Calculator::add()
 void Calculator::subtract()
 {
     updateValue();
-    operation = "subtraction";
+    operation = OpCode::Subtract;
 }
 
 /**
@@ -308,7 +483,7 @@ void Calculator::subtract()
 void Calculator::multiply()
 {
     updateValue();
-    operation = "multiplication";
+    operation = OpCode::Multiply;
 }
 
 /**
@@ -317,37 +492,31 @@ void Calculator::multiply()
 void Calculator::divide()
 {
     updateValue();
-    operation = "division";
+    operation = OpCode::Divide;
 }
 
 /**
  * @brief Performs the operation, displays numeric result and plots it.
  *
- * @throws std::invalid_argument If division by zero occurs.
+ * Division by zero is reported in a message box.
  */
 void Calculator::equals()
 {
     bool newPlot = true;
     ComplexNumber read = readNumber();
-    ComplexNumber result(0, 0);
     ComplexNumber lastValue = calcMemory.getLast();
-    if (operation == "addition") {
-        result = read.add(lastValue);
-    } else if (operation == "subtraction") {
-        result = lastValue.subtract(read);
-    }else if (operation == "multiplication") {
-        result = read.multiply(lastValue);
-    }else if (operation == "division") {
-        try {
-            result = lastValue.divide(read);
-        } catch (std::invalid_argument) {
-            result = ComplexNumber(0.0, 0.0);
-            QMessageBox::critical(this, "Division error", "Cannot divide by zero!");
-            newPlot = false;
-        }
+    ComplexStatus status = ComplexStatus::Ok;
+    ComplexNumber result = timed(TelemetryOp::Compute, [&] {
+        return applyOperation(selectedPrecision(), operation, lastValue, read, status);
+    });
+    if (status == ComplexStatus::DivisionByZero) {
+        result = ComplexNumber(0.0, 0.0);
+        QMessageBox::critical(this, "Division error", "Cannot divide by zero!");
+        newPlot = false;
     }
     displayNumber(result);
     if (newPlot) {
+        recordHistory(lastValue, operation, read, result);
         updatePlot(lastValue, read, result);
     }
 }
@@ -358,22 +527,25 @@ void Calculator::equals()
 void Calculator::root()
 {
     ComplexNumber read = readNumber();
-    ComplexNumber output = read.root();
+    ComplexStatus status = ComplexStatus::Ok;
+    ComplexNumber output = timed(TelemetryOp::Compute, [&] {
+        return applyUnary(selectedPrecision(), OpCode::Root, read, status);
+    });
 
     displayNumber(output);
+    recordHistory(read, OpCode::Root, ComplexNumber(), output);
     updatePlot(read, output);
 }
 
 /**
- * @brief Calculates the second power of the number, displays it and plots it.
+ * @brief Starts raising the number to the power entered next and updates the calculator's state.
+ *
+ * Whole exponents use binary exponentiation, so x^50 takes a few multiplications.
  */
 void Calculator::power()
 {
-    ComplexNumber read = readNumber();
-    ComplexNumber output = read.multiply(read);
-
-    displayNumber(output);
-    updatePlot(read, output);
+    updateValue();
+    operation = OpCode::Power;
 }
 
 /**
@@ -382,32 +554,39 @@ void Calculator::power()
 void Calculator::absolute()
 {
     ComplexNumber read = readNumber();
-    ComplexNumber output(read.absoluteValue(), 0.0);
+    ComplexStatus status = ComplexStatus::Ok;
+    ComplexNumber output = timed(TelemetryOp::Compute, [&] {
+        return applyUnary(selectedPrecision(), OpCode::Absolute, read, status);
+    });
 
     displayNumber(output);
+    recordHistory(read, OpCode::Absolute, ComplexNumber(), output);
     updatePlot(read, output);
 }
 
 /**
  * @brief Calculates the inverse, displays it and plots it.
  *
- * @throws std::invalid_argument If attempting to take the inverse of zero.
+ * Inverse of zero is reported in a message box.
  */
 void Calculator::inverse()
 {
     bool newPlot = true;
     ComplexNumber read = readNumber();
-    ComplexNumber result(0.0, 0.0);
+    ComplexStatus status = ComplexStatus::Ok;
+    ComplexNumber result = timed(TelemetryOp::Compute, [&] {
+        return applyUnary(selectedPrecision(), OpCode::Inverse, read, status);
+    });
 
-    try {
-        result = read.inverse();
-    } catch (std::invalid_argument) {
+    if (status == ComplexStatus::DivisionByZero) {
+        result = ComplexNumber(0.0, 0.0);
         QMessageBox::critical(this, "Inverse error", "Cannot divide by zero!");
         newPlot = false;
     }
 
     displayNumber(result);
     if (newPlot) {
+        recordHistory(read, OpCode::Inverse, ComplexNumber(), result);
         updatePlot(read, result);
     }
 
@@ -422,9 +601,46 @@ void Calculator::conjugate()
     ComplexNumber output = read.conjugate();
 
     displayNumber(output);
+    recordHistory(read, OpCode::Conjugate, ComplexNumber(), output);
     updatePlot(read, output);
 }
 
+/**
+ * @brief Compiles the typed expression, evaluates it, displays it and plots it.
+ *
+ * Variables: x is the displayed number, m the selected memory register and last the
+ * last value.
+ */
+void Calculator::evaluateExpression()
+{
+    try {
+        Expression expression = timed(TelemetryOp::Parse, [&] {
+            return Expression(expressionInput->text().toStdString());
+        });
+
+        const ComplexNumber read = readNumber();
+        std::vector<ComplexNumber> bindings;
+        for (const std::string &name : expression.variables()) {
+            if (name == "x") {
+                bindings.push_back(read);
+            } else if (name == "m") {
+                bindings.push_back(calcMemory.readMemory(currentRegister()));
+            } else if (name == "last") {
+                bindings.push_back(calcMemory.getLast());
+            } else {
+                throw std::invalid_argument("Unknown variable " + name + " (use x, m or last)!");
+            }
+        }
+
+        ComplexNumber result = timed(TelemetryOp::Compute, [&] { return expression.evaluate(bindings.data()); });
+        displayNumber(result);
+        recordHistory(read, OpCode::None, ComplexNumber(), result);
+        updatePlot(read, result);
+    } catch (const std::invalid_argument& e) {
+        QMessageBox::critical(this, "Expression error", e.what());
+    }
+}
+
 /**
  * @brief Calculates the circle area, displays it and plots it.
  */
@@ -441,6 +657,7 @@ void Calculator::calculateCircleArea() {
         double area = circle.calculateArea();
         ComplexNumber output(area, 0);
         displayNumber(output);
+        recordHistory(input, OpCode::None, ComplexNumber(), output);
         updatePlot(input, output);
     } catch (const std::invalid_argument& e) {
         QMessageBox::critical(this, "Area Error - accepts only positive real numbers!", e.what());
@@ -463,6 +680,7 @@ void Calculator::calculateCircleCircumference() {
         double circ = circle.calculateCircumference();
         ComplexNumber output(circ, 0);
         displayNumber(output);
+        recordHistory(input, OpCode::None, ComplexNumber(), output);
         updatePlot(input, output);  // Update plot after successful calculation
     } catch (const std::invalid_argument& e) {
         QMessageBox::critical(this, "Area Error - accepts only positive real numbers!", e.what());
@@ -485,6 +703,7 @@ void Calculator::calculateTriangleArea() {
         double area = triangle.calculateArea();
         ComplexNumber output(area, 0);
         displayNumber(output);
+        recordHistory(input, OpCode::None, ComplexNumber(), output);
         updatePlot(input, output);
     } catch (const std::invalid_argument& e) {
         QMessageBox::critical(this, "Area Error - accepts only positive real numbers!", e.what());
@@ -507,6 +726,7 @@ void Calculator::calculateTriangleCircumference() {
         double circ = triangle.calculateCircumference();
         ComplexNumber output(circ, 0);
         displayNumber(output);
+        recordHistory(input, OpCode::None, ComplexNumber(), output);
         updatePlot(input, output);  // Update plot after successful calculation
     } catch (const std::invalid_argument& e) {
         QMessageBox::critical(this, "Area Error - accepts only positive real numbers!", e.what());
@@ -546,12 +766,24 @@ void Calculator::clearAll()
     display_i->setText("0");
 }
 
+/**
+ * @brief Name of the selected memory register.
+ *
+ * @return register name, the default register if the box is empty (std::string).
+ */
+std::string Calculator::currentRegister() const
+{
+    const QString name = memoryRegister->currentText().trimmed();
+    return name.isEmpty() ? std::string(CalcMemory::DefaultRegister) : name.toStdString();
+}
+
 /**
  * @brief Clears the calculator's memory.
  */
 void Calculator::clearMemory()
 {
-    calcMemory.clearMemory();
+    TelemetryScope scope(TelemetryOp::Memory);
+    calcMemory.clearMemory(currentRegister());
 }
 
 /**
@@ -559,7 +791,7 @@ void Calculator::clearMemory()
  */
 void Calculator::readMemory()
 {
-    ComplexNumber sumInMemory = calcMemory.readMemory();
+    ComplexNumber sumInMemory = timed(TelemetryOp::Memory, [&] { return calcMemory.readMemory(currentRegister()); });
     display->setText(QString::number(sumInMemory.getReal()));
     display_i->setText(QString::number(sumInMemory.getImaginary()));
 }
@@ -569,7 +801,9 @@ void Calculator::readMemory()
  */
 void Calculator::setMemory()
 {
-    calcMemory.setMemory(readNumber());
+    const ComplexNumber read = readNumber();
+    TelemetryScope scope(TelemetryOp::Memory);
+    calcMemory.setMemory(read, currentRegister());
 }
 
 /**
@@ -577,49 +811,166 @@ void Calculator::setMemory()
  */
 void Calculator::addToMemory()
 {
-    calcMemory.addToMemory(readNumber());
+    const ComplexNumber read = readNumber();
+    TelemetryScope scope(TelemetryOp::Memory);
+    calcMemory.addToMemory(read, currentRegister());
+}
+
+/**
+ * @brief Builds the chart in place of the placeholder, unless it exists already.
+ *
+ * One chart serves the whole session; its series and axes are updated in place.
+ */
+void Calculator::ensureChart()
+{
+    if (chart) {
+        return;
+    }
+    chart = new QChart;
+    seriesA = new QScatterSeries;
+    seriesB = new QScatterSeries;
+    seriesR = new QScatterSeries;
+    seriesA->setName("First Value");
+    seriesB->setName("Second Value");
+    seriesR->setName("Result");
+
+    // Every result of the session, drawn first so the latest operation stays on top.
+    historySeries = new QScatterSeries;
+    historySeries->setName("History");
+    historySeries->setMarkerSize(3);
+    historySeries->setUseOpenGL(true);
+
+    // Roots of the last polynomial, possibly thousands of them.
+    rootSeries = new QScatterSeries;
+    rootSeries->setName("Roots");
+    rootSeries->setMarkerSize(5);
+    rootSeries->setUseOpenGL(true);
+
+    axisX = new QValueAxis;
+    axisY = new QValueAxis;
+    axisX->setTitleText("Real Axis");
+    axisY->setTitleText("Imaginary Axis");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+
+    for (QScatterSeries *series : {historySeries, rootSeries, seriesA, seriesB, seriesR}) {
+        chart->addSeries(series);
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    }
+
+    chartView = new QChartView(chart);
+    chartView->setRubberBand(QChartView::RectangleRubberBand);
+    chartView->setMinimumSize(QSize(400, 300));
+
+    // Zooming re-selects the history points at the new level of detail.
+    connect(axisX, &QValueAxis::rangeChanged, this, &Calculator::scheduleHistoryRefresh);
+    connect(axisY, &QValueAxis::rangeChanged, this, &Calculator::scheduleHistoryRefresh);
+
+    // Escape-time fractal behind the points, clipped to the plot area. Its z value puts
+    // it above the plot area background and below the grid, axes and series.
+    fractalClip = new QGraphicsRectItem(chart);
+    fractalClip->setFlag(QGraphicsItem::ItemClipsChildrenToShape);
+    fractalClip->setPen(Qt::NoPen);
+    fractalClip->setZValue(0.5);
+    fractalItem = new QGraphicsPixmapItem(fractalClip);
+    fractalItem->hide();
+    connect(axisX, &QValueAxis::rangeChanged, this, &Calculator::scheduleFractalRefresh);
+    connect(axisY, &QValueAxis::rangeChanged, this, &Calculator::scheduleFractalRefresh);
+    connect(chart, &QChart::plotAreaChanged, this, &Calculator::scheduleFractalRefresh);
+
+    mainLayout->replaceWidget(chartPlaceholder, chartView);
+    chartPlaceholder->deleteLater();
+    chartPlaceholder = nullptr;
 }
 
 /**
  * @brief Updates the plot for a three-value calculation.
  *
- * This method creates a scatter plot with three data points.
+ * Moves the points of the persistent scatter series to the three values.
  *
  * @param a first number to be plotted.
  * @param b second number to be plotted.
  * @param r result number to be plotted.
  */
 void Calculator::updatePlot(ComplexNumber a, ComplexNumber b, ComplexNumber r) {
-    QScatterSeries *seriesA = new QScatterSeries;
-    QScatterSeries *seriesB = new QScatterSeries;
-    QScatterSeries *seriesR = new QScatterSeries;
-    seriesA->setName("First Value");
-    seriesB->setName("Second Value");
-    seriesR->setName("Result");
+    TelemetryScope scope(TelemetryOp::PlotUpdate);
+    ensureChart();
+    if (seriesA->name() != "First Value") {
+        seriesA->setName("First Value");
+    }
+    seriesA->replace(QList<QPointF>{toPoint(a)});
+    seriesB->replace(QList<QPointF>{toPoint(b)});
+    seriesR->replace(QList<QPointF>{toPoint(r)});
+    if (isFinite(r)) {
+        history.append(r);
+    }
 
-    seriesA->append(a.getReal(), a.getImaginary());
-    seriesB->append(b.getReal(), b.getImaginary());
-    seriesR->append(r.getReal(), r.getImaginary());
+    fitAxes({a, b, r});
+    scheduleHistoryRefresh();
+}
 
-    chart = new QChart;
-    chartView = new QChartView(chart);
-    mainLayout->addWidget(chartView, 0, 7, 9, 5);
-    chartView->setMinimumSize(QSize(400, 300));
-    chart->createDefaultAxes();
-    chart->addSeries(seriesA);
-    chart->addSeries(seriesB);
-    chart->addSeries(seriesR);
+/**
+ * @brief Updates the plot for a two-value calculation.
+ *
+ * Moves the points of the persistent scatter series to the two values.
+ *
+ * @param a first number to be plotted.
+ * @param r result number to be plotted.
+ */
+void Calculator::updatePlot(ComplexNumber a, ComplexNumber r) {
+    TelemetryScope scope(TelemetryOp::PlotUpdate);
+    ensureChart();
+    if (seriesA->name() != "Value") {
+        seriesA->setName("Value");
+    }
+    seriesA->replace(QList<QPointF>{toPoint(a)});
+    seriesB->clear();
+    seriesR->replace(QList<QPointF>{toPoint(r)});
+    if (isFinite(r)) {
+        history.append(r);
+    }
 
-    double minReal = std::min({a.getReal(), b.getReal(), r.getReal()});
-    double maxReal = std::max({a.getReal(), b.getReal(), r.getReal()});
-    double minImag = std::min({a.getImaginary(), b.getImaginary(), r.getImaginary()});
-    double maxImag = std::max({a.getImaginary(), b.getImaginary(), r.getImaginary()});
+    fitAxes({a, r});
+    scheduleHistoryRefresh();
+}
 
-    double realRange = maxReal - minReal;
-    double imagRange = maxImag - minImag;
+/**
+ * @brief Fits the axes around the plotted numbers and the history with a 10% margin.
+ *
+ * The axes are only touched when their range actually changes; numbers that are
+ * not finite are left out.
+ *
+ * @param points numbers currently plotted (std::initializer_list<ComplexNumber>).
+ */
+void Calculator::fitAxes(std::initializer_list<ComplexNumber> points) {
+    if (deepZoom) {
+        // The axes show offsets from the deep-zoom centre; leave the exploration alone.
+        return;
+    }
+    BoundingBox box;
+    for (const ComplexNumber &point : points) {
+        // An overflowed result would stretch the axes to infinity.
+        if (isFinite(point)) {
+            box.include({point.getReal(), point.getReal(), point.getImaginary(), point.getImaginary()});
+        }
+    }
+    if (!history.empty()) {
+        const PointPyramid::Bounds plotted = history.bounds();
+        box.include({plotted.minReal, plotted.maxReal, plotted.minImaginary, plotted.maxImaginary});
+    }
+    for (const PointPyramid &file : resultFiles) {
+        const PointPyramid::Bounds plotted = file.bounds();
+        box.include({plotted.minReal, plotted.maxReal, plotted.minImaginary, plotted.maxImaginary});
+    }
+    if (box.empty()) {
+        return;
+    }
+    const double minReal = box.minReal, maxReal = box.maxReal;
+    const double minImag = box.minImaginary, maxImag = box.maxImaginary;
 
-    double realMargin = realRange * 0.1;
-    double imagMargin = imagRange * 0.1;
+    double realMargin = (maxReal - minReal) * 0.1;
+    double imagMargin = (maxImag - minImag) * 0.1;
 
     if (realMargin == 0) {
         realMargin = 0.1;
@@ -628,61 +979,451 @@ void Calculator::updatePlot(ComplexNumber a, ComplexNumber b, ComplexNumber r) {
         imagMargin = 0.1;
     }
 
-    chart->createDefaultAxes();
-    chart->axes(Qt::Horizontal).back()->setRange(minReal - realMargin, maxReal + realMargin);
-    chart->axes(Qt::Vertical).back()->setRange(minImag - imagMargin, maxImag + imagMargin);
-    chart->axes(Qt::Horizontal).back()->setTitleText("Real Axis");
-    chart->axes(Qt::Vertical).back()->setTitleText("Imaginary Axis");
+    if (axisX->min() != minReal - realMargin || axisX->max() != maxReal + realMargin) {
+        axisX->setRange(minReal - realMargin, maxReal + realMargin);
+    }
+    if (axisY->min() != minImag - imagMargin || axisY->max() != maxImag + imagMargin) {
+        axisY->setRange(minImag - imagMargin, maxImag + imagMargin);
+    }
 }
 
 /**
- * @brief Updates the plot for a two-value calculation.
+ * @brief Puts the fractal image over the part of the plot area it was rendered for.
+ *
+ * A deep-zoom image is placed relative to its own centre, which may differ from the
+ * current one; images of the other coordinate system are hidden.
+ */
+void Calculator::placeFractal()
+{
+    const FractalView &view = fractalFrame.view;
+    if (fractalFrame.step == 0 || (view.kind == FractalKind::DeepMandelbrot) != deepZoom) {
+        fractalItem->hide();
+        return;
+    }
+    double shiftReal = 0, shiftImaginary = 0;
+    if (deepZoom) {
+        shiftReal = (view.centerReal - deepCenterReal).toDouble();
+        shiftImaginary = (view.centerImaginary - deepCenterImaginary).toDouble();
+    }
+    const double left = shiftReal + view.minReal, top = shiftImaginary + view.maxImaginary;
+    const QPointF topLeft = chart->mapToPosition(QPointF(left, top));
+    const QPointF bottomRight = chart->mapToPosition(QPointF(left + view.width * view.pixelWidth,
+                                                             top - view.height * view.pixelHeight));
+    fractalItem->setPos(topLeft);
+    fractalItem->setTransform(QTransform::fromScale((bottomRight.x() - topLeft.x()) / view.width,
+                                                    (bottomRight.y() - topLeft.y()) / view.height));
+    fractalItem->show();
+}
+
+/**
+ * @brief Switches the axes between plane coordinates and deep-zoom offsets.
  *
- * This method creates a scatter plot with two data points.
+ * Entering deep zoom takes the middle of the axes as the centre; leaving it puts the
+ * axes back around the same point in plane coordinates.
+ */
+void Calculator::setDeepZoom(bool enabled)
+{
+    const double middleReal = (axisX->min() + axisX->max()) / 2;
+    const double middleImaginary = (axisY->min() + axisY->max()) / 2;
+    const double halfWidth = (axisX->max() - axisX->min()) / 2;
+    const double halfHeight = (axisY->max() - axisY->min()) / 2;
+    deepZoom = enabled;
+    if (enabled) {
+        try {
+            deepCenterReal = FixedPoint::fromDouble(middleReal, 1);
+            deepCenterImaginary = FixedPoint::fromDouble(middleImaginary, 1);
+        } catch (const std::invalid_argument&) {
+            deepCenterReal = deepCenterImaginary = FixedPoint();
+        }
+        axisX->setLabelFormat("%.3g");
+        axisY->setLabelFormat("%.3g");
+        axisX->setRange(-halfWidth, halfWidth);
+        axisY->setRange(-halfHeight, halfHeight);
+    } else {
+        const double real = deepCenterReal.toDouble() + middleReal;
+        const double imaginary = deepCenterImaginary.toDouble() + middleImaginary;
+        axisX->setLabelFormat(QString());
+        axisY->setLabelFormat(QString());
+        chart->setTitle(QString());
+        axisX->setRange(real - halfWidth, real + halfWidth);
+        axisY->setRange(imaginary - halfHeight, imaginary + halfHeight);
+    }
+}
+
+/**
+ * @brief Records a calculation in the history kept by the calculator memory.
  *
- * @param a first number to be plotted.
- * @param r result number to be plotted.
+ * @param a first operand (const ComplexNumber&).
+ * @param op operation (OpCode).
+ * @param b second operand, zero for unary operations (const ComplexNumber&).
+ * @param result result (const ComplexNumber&).
  */
-void Calculator::updatePlot(ComplexNumber a, ComplexNumber r) {
-    QScatterSeries *seriesA = new QScatterSeries;
-    QScatterSeries *seriesR = new QScatterSeries;
-    seriesA->setName("Value");
-    seriesR->setName("Result");
+void Calculator::recordHistory(const ComplexNumber &a, OpCode op, const ComplexNumber &b,
+                               const ComplexNumber &result)
+{
+    try {
+        calcMemory.record(a, op, b, result);
+    } catch (const std::runtime_error& e) {
+        QMessageBox::critical(this, "History error", e.what());
+    }
+}
 
-    seriesA->append(a.getReal(), a.getImaginary());
-    seriesR->append(r.getReal(), r.getImaginary());
+/**
+ * @brief Redraws the history once control returns to the event loop.
+ *
+ * Several axis changes in a row (both axes, or a result followed by a fit) lead
+ * to a single re-selection.
+ */
+void Calculator::scheduleHistoryRefresh()
+{
+    if (!historyRefreshPending) {
+        historyRefreshPending = true;
+        QTimer::singleShot(0, this, &Calculator::refreshHistory);
+    }
+}
 
-    chart = new QChart;
-    chartView = new QChartView(chart);
-    mainLayout->addWidget(chartView, 0, 7, 9, 5);
-    chartView->setMinimumSize(QSize(400, 300));
-    chart->createDefaultAxes();
-    chart->addSeries(seriesA);
-    chart->addSeries(seriesR);
+/**
+ * @brief Hands the chart the history points for the current view and size.
+ */
+void Calculator::refreshHistory()
+{
+    TelemetryScope scope(TelemetryOp::PlotUpdate);
+    historyRefreshPending = false;
+
+    const PointPyramid::Bounds view = {axisX->min(), axisX->max(), axisY->min(), axisY->max()};
+    const QRectF area = chart->plotArea();
+    const std::size_t budget = MaxHistoryPoints / (1 + resultFiles.size());
+    history.select(view, static_cast<int>(area.width()), static_cast<int>(area.height()), budget,
+                   historyPoints);
+    for (const PointPyramid &file : resultFiles) {
+        file.select(view, static_cast<int>(area.width()), static_cast<int>(area.height()), budget, filePoints);
+        historyPoints.insert(historyPoints.end(), filePoints.begin(), filePoints.end());
+    }
+
+    QList<QPointF> points;
+    points.reserve(static_cast<int>(historyPoints.size()));
+    for (const ComplexNumber &point : historyPoints) {
+        points.append(toPoint(point));
+    }
+    historySeries->replace(points);
+}
 
-    double minReal = std::min({a.getReal(), r.getReal()});
-    double maxReal = std::max({a.getReal(), r.getReal()});
-    double minImag = std::min({a.getImaginary(), r.getImaginary()});
-    double maxImag = std::max({a.getImaginary(), r.getImaginary()});
+/**
+ * @brief Re-renders the fractal once control returns to the event loop.
+ *
+ * Both axes changing, the plot area moving and the display changing in one go lead
+ * to a single request.
+ */
+void Calculator::scheduleFractalRefresh()
+{
+    // Typing into the display must not build the chart just to draw no fractal.
+    if (!chart && fractalMode->currentIndex() <= 0) {
+        return;
+    }
+    if (!fractalRefreshPending) {
+        fractalRefreshPending = true;
+        QTimer::singleShot(0, this, &Calculator::refreshFractal);
+    }
+}
 
-    double realRange = maxReal - minReal;
-    double imagRange = maxImag - minImag;
+/**
+ * @brief Requests the fractal for the current mode, axes, plot size and display.
+ */
+void Calculator::refreshFractal()
+{
+    fractalRefreshPending = false;
+
+    ensureChart();
+    const QRectF area = chart->plotArea();
+    fractalClip->setRect(area);
+    const int mode = fractalMode->currentIndex();
+    if ((mode == 3) != deepZoom) {
+        setDeepZoom(mode == 3);
+    }
+    if (mode <= 0 || area.width() < 1 || area.height() < 1) {
+        if (fractalRenderer) {
+            fractalRenderer->cancel();
+        }
+        fractalItem->hide();
+        fractalView = FractalView();
+        return;
+    }
 
-    double realMargin = realRange * 0.1;
-    double imagMargin = imagRange * 0.1;
+    FractalView view;
+    view.kind = mode == 3 ? FractalKind::DeepMandelbrot : mode == 2 ? FractalKind::Julia : FractalKind::Mandelbrot;
+    if (view.kind == FractalKind::DeepMandelbrot) {
+        // Keep the reference point in the middle of the view: zooming or panning moves
+        // the centre by the offset of the new middle, at the precision of the pixels.
+        const double middleReal = (axisX->min() + axisX->max()) / 2;
+        const double middleImaginary = (axisY->min() + axisY->max()) / 2;
+        if (middleReal != 0 || middleImaginary != 0) {
+            const double halfWidth = (axisX->max() - axisX->min()) / 2;
+            const double halfHeight = (axisY->max() - axisY->min()) / 2;
+            const std::size_t limbs = FixedPoint::fractionLimbsFor(std::min(halfWidth, halfHeight) / area.width());
+            deepCenterReal = deepCenterReal + FixedPoint::fromDouble(middleReal, limbs);
+            deepCenterImaginary = deepCenterImaginary + FixedPoint::fromDouble(middleImaginary, limbs);
+            axisX->setRange(-halfWidth, halfWidth);
+            axisY->setRange(-halfHeight, halfHeight);
+        }
+        view.centerReal = deepCenterReal;
+        view.centerImaginary = deepCenterImaginary;
+
+        // Deeper views need more iterations to show their detail.
+        const double depth = std::max(0.0, -std::log10(axisX->max() - axisX->min()));
+        view.maxIterations = 1000 + static_cast<unsigned>(100 * depth);
+        const int digits = std::min(120, static_cast<int>(depth) + 4);
+        std::string imaginary = deepCenterImaginary.toString(digits);
+        const bool below = imaginary.front() == '-';
+        if (below) {
+            imaginary.erase(0, 1);
+        }
+        chart->setTitle(tr("Centre %1 %2 %3i")
+                            .arg(QString::fromStdString(deepCenterReal.toString(digits)))
+                            .arg(below ? "-" : "+")
+                            .arg(QString::fromStdString(imaginary)));
+    } else if (view.kind == FractalKind::Julia) {
+        try {
+            view.c = readNumber();
+        } catch (const std::logic_error&) {
+            // Half-typed number: keep the previous constant.
+            view.c = fractalView.c;
+        }
+    }
+    view.width = static_cast<int>(area.width());
+    view.height = static_cast<int>(area.height());
+    view.minReal = axisX->min();
+    view.maxImaginary = axisY->max();
+    view.pixelWidth = (axisX->max() - axisX->min()) / view.width;
+    view.pixelHeight = (axisY->max() - axisY->min()) / view.height;
+    if (view == fractalView) {
+        return;
+    }
 
-    if (realMargin == 0) {
-        realMargin = 0.1;
+    if (!fractalRenderer) {
+        fractalRenderer = std::make_unique<FractalRenderer>([this] {
+            QMetaObject::invokeMethod(this, &Calculator::showFractalFrame, Qt::QueuedConnection);
+        });
     }
-    if (imagMargin == 0) {
-        imagMargin = 0.1;
+    try {
+        fractalRenderer->render(view);
+    } catch (const std::invalid_argument&) {
+        // Degenerate axis range; nothing to draw until it changes.
+        return;
+    }
+    fractalView = view;
+    placeFractal();
+}
+
+/**
+ * @brief Takes the latest image from the renderer and shows it.
+ */
+void Calculator::showFractalFrame()
+{
+    TelemetryScope scope(TelemetryOp::PlotUpdate);
+    if (!fractalRenderer || fractalMode->currentIndex() <= 0 || !fractalRenderer->latestFrame(fractalFrame)) {
+        return;
     }
+    const FractalView &view = fractalFrame.view;
+    const QImage image(reinterpret_cast<const uchar *>(fractalFrame.pixels.data()), view.width, view.height,
+                       view.width * 4, QImage::Format_RGB32);
+    fractalItem->setPixmap(QPixmap::fromImage(image));
+    placeFractal();
+}
 
-    chart->createDefaultAxes();
-    chart->axes(Qt::Horizontal).back()->setRange(minReal - realMargin, maxReal + realMargin);
-    chart->axes(Qt::Vertical).back()->setRange(minImag - imagMargin, maxImag + imagMargin);
-    chart->axes(Qt::Horizontal).back()->setTitleText("Real Axis");
-    chart->axes(Qt::Vertical).back()->setTitleText("Imaginary Axis");
+/**
+ * @brief Adds the results of a batch output file to the history.
+ *
+ * The file is read by a job into a pyramid of its own, which is plotted once the
+ * whole file is in.
+ */
+void Calculator::plotResultsFile()
+{
+    const QString path = QFileDialog::getOpenFileName(this, tr("Plot Results File"));
+    if (path.isEmpty()) {
+        return;
+    }
+    const std::string file = path.toStdString();
+    submitJob([this, file](JobControl &control) -> JobRunner::Completion {
+        auto loaded = std::make_shared<PointPyramid>();
+        try {
+            if (readResults(file, *loaded, control) == 0) {
+                throw std::invalid_argument("No results found in " + file + "!");
+            }
+        } catch (const std::invalid_argument& e) {
+            const QString message = e.what();
+            return [this, message] { QMessageBox::critical(this, "File error", message); };
+        }
+        return [this, loaded] {
+            ensureChart();
+            resultFiles.push_back(std::move(*loaded));
+            const PointPyramid::Bounds box = resultFiles.back().bounds();
+            fitAxes({ComplexNumber(box.minReal, box.minImaginary),
+                     ComplexNumber(box.maxReal, box.maxImaginary)});
+            scheduleHistoryRefresh();
+        };
+    });
+}
+
+/**
+ * @brief Forgets all plotted results.
+ *
+ * Results files still being read are cancelled.
+ */
+void Calculator::clearHistory()
+{
+    cancelJobs();
+    history.clear();
+    resultFiles.clear();
+    if (chart) {
+        historySeries->clear();
+        rootSeries->clear();
+    }
+}
+
+/**
+ * @brief Asks for polynomial coefficients and plots all roots of the polynomial.
+ *
+ * Coefficients are comma-separated constant expressions, highest degree first, so
+ * "1, 0, 0, -1" is z^3 - 1. Bad input is reported in a message box. The roots are
+ * found by a job that replaces any root search still running.
+ */
+void Calculator::findPolynomialRoots()
+{
+    bool ok = false;
+    const QString text = QInputDialog::getText(this, tr("Polynomial Roots"),
+                                               tr("Coefficients, highest degree first, e.g. 1, 0, -2+i:"),
+                                               QLineEdit::Normal, polynomialText, &ok);
+    if (!ok || text.trimmed().isEmpty()) {
+        return;
+    }
+    polynomialText = text;
+
+    std::vector<ComplexNumber> coefficients;
+    try {
+        for (const QString &term : text.split(",")) {
+            const Expression coefficient(term.toStdString());
+            if (!coefficient.variables().empty()) {
+                throw std::invalid_argument("Coefficients must be constants!");
+            }
+            coefficients.push_back(coefficient.evaluate());
+        }
+    } catch (const std::invalid_argument& e) {
+        QMessageBox::critical(this, "Polynomial error", e.what());
+        return;
+    }
+    std::reverse(coefficients.begin(), coefficients.end());
+
+    if (rootsJob != 0 && jobRunner) {
+        jobRunner->cancel(rootsJob);
+    }
+    rootsJob = submitJob([this, coefficients](JobControl &control) -> JobRunner::Completion {
+        PolynomialRoots found;
+        try {
+            found = findRoots(ComplexPolynomial(coefficients), 200, 0,
+                              [&control](std::size_t converged, std::size_t degree) {
+                                  control.setProgress(static_cast<double>(converged) / degree);
+                                  return !control.cancelled();
+                              });
+        } catch (const std::invalid_argument& e) {
+            const QString message = e.what();
+            return [this, message] {
+                rootsJob = 0;
+                QMessageBox::critical(this, "Polynomial error", message);
+            };
+        }
+
+        // Everything but the chart calls is prepared here, off the GUI thread.
+        QList<QPointF> points;
+        points.reserve(static_cast<int>(found.roots.size()));
+        for (const ComplexNumber &root : found.roots) {
+            points.append(toPoint(root));
+        }
+        const BoundingBox box = boundingBox(found.roots.data(), found.roots.size());
+        const int count = static_cast<int>(found.roots.size());
+        const int converged = static_cast<int>(found.convergedCount());
+        const int iterations = static_cast<int>(found.iterations);
+        return [this, points, box, count, converged, iterations] {
+            rootsJob = 0;
+            ensureChart();
+            rootSeries->replace(points);
+            if (!box.empty()) {
+                fitAxes({ComplexNumber(box.minReal, box.minImaginary),
+                         ComplexNumber(box.maxReal, box.maxImaginary)});
+            }
+            chart->setTitle(tr("%1 roots, %2 converged after %3 iterations")
+                                .arg(count)
+                                .arg(converged)
+                                .arg(iterations));
+        };
+    });
+}
+
+/**
+ * @brief Runs work on the job threads; its completion runs later in deliverJobs().
+ *
+ * @param work the job (JobRunner::Work).
+ * @return id of the job (JobRunner::JobId).
+ */
+JobRunner::JobId Calculator::submitJob(JobRunner::Work work)
+{
+    if (!jobRunner) {
+        jobRunner = std::make_unique<JobRunner>([this] {
+            QMetaObject::invokeMethod(this, &Calculator::deliverJobs, Qt::QueuedConnection);
+        }, JobThreads);
+    }
+    const JobRunner::JobId id = jobRunner->submit(std::move(work));
+    updateJobProgress();
+    return id;
+}
+
+/**
+ * @brief Runs the completions of finished jobs and updates the progress bar.
+ */
+void Calculator::deliverJobs()
+{
+    if (!jobRunner) {
+        return;
+    }
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (;;) {
+        if (elapsed.elapsed() >= DeliveryBudgetMs) {
+            QMetaObject::invokeMethod(this, &Calculator::deliverJobs, Qt::QueuedConnection);
+            break;
+        }
+        try {
+            if (!jobRunner->deliverNext()) {
+                break;
+            }
+        } catch (const std::exception& e) {
+            QMessageBox::critical(this, "Job error", e.what());
+        }
+    }
+    updateJobProgress();
+}
+
+/**
+ * @brief Cancels every background job; their results are never shown.
+ */
+void Calculator::cancelJobs()
+{
+    if (jobRunner) {
+        jobRunner->cancelAll();
+    }
+    rootsJob = 0;
+    updateJobProgress();
+}
+
+/**
+ * @brief Shows the number and progress of the pending jobs.
+ */
+void Calculator::updateJobProgress()
+{
+    const std::size_t pending = jobRunner ? jobRunner->pending() : 0;
+    jobProgress->setEnabled(pending != 0);
+    cancelButton->setEnabled(pending != 0);
+    jobProgress->setValue(pending == 0 ? 0 : static_cast<int>(jobRunner->progress()));
+    jobProgress->setFormat(pending > 1 ? tr("%p% of %1 jobs").arg(static_cast<int>(pending)) : tr("%p%"));
 }
 
 /**
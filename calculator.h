@@ -6,11 +6,25 @@
 #include <QChartView>
 #include <QGridLayout>
 #include "complexnumber.h"
+#include "expression.h"
+#include "pointpyramid.h"
+#include "precision.h"
 #include "calcmemory.h"
+#include "fractalrenderer.h"
+#include "jobrunner.h"
 #include "shape.h"
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
+class QComboBox;
+class QGraphicsPixmapItem;
+class QGraphicsRectItem;
+class QLabel;
 class QLineEdit;
+class QProgressBar;
+class QScatterSeries;
+class QValueAxis;
 QT_END_NAMESPACE
 class Button;
 
@@ -100,7 +114,7 @@ private slots:
     /**
      * @brief Performs the operation, displays numeric result and plots it.
      *
-     * @throws std::invalid_argument If division by zero occurs.
+     * Division by zero is reported in a message box.
      */
     void equals();
 
@@ -110,7 +124,7 @@ private slots:
     void root();
 
     /**
-     * @brief Calculates the second power of the number, displays it and plots it.
+     * @brief Starts raising the number to the power entered next and updates the calculator's state.
      */
     void power();
 
@@ -122,7 +136,7 @@ private slots:
     /**
      * @brief Calculates the inverse, displays it and plots it.
      *
-     * @throws std::invalid_argument If attempting to take the inverse of zero.
+     * Inverse of zero is reported in a message box.
      */
     void inverse();
 
@@ -131,6 +145,11 @@ private slots:
      */
     void conjugate();
 
+    /**
+     * @brief Compiles the typed expression, evaluates it, displays it and plots it.
+     */
+    void evaluateExpression();
+
     /**
      * @brief Calculates the circle circumference, displays it and plots it.
      */
@@ -180,7 +199,7 @@ private slots:
     /**
      * @brief Updates the plot for a three-value calculation.
      *
-     * This method creates a scatter plot with three data points.
+     * Moves the points of the persistent scatter series to the three values.
      *
      * @param a first number to be plotted.
      * @param b second number to be plotted.
@@ -191,13 +210,75 @@ private slots:
     /**
      * @brief Updates the plot for a two-value calculation.
      *
-     * This method creates a scatter plot with two data points.
+     * Moves the points of the persistent scatter series to the two values.
      *
      * @param a first number to be plotted.
      * @param r result number to be plotted.
     */
     void updatePlot(ComplexNumber a, ComplexNumber r);
 
+    /**
+     * @brief Redraws the history once control returns to the event loop.
+     */
+    void scheduleHistoryRefresh();
+
+    /**
+     * @brief Hands the chart the history points for the current view and size.
+     *
+     * The points come from the level-of-detail pyramid, so the work depends on
+     * the chart size in pixels rather than on the length of the history.
+     */
+    void refreshHistory();
+
+    /**
+     * @brief Adds the results of a batch output file to the history.
+     *
+     * Reads files written by complexcalc-cli --batch; error lines are skipped.
+     */
+    void plotResultsFile();
+
+    /**
+     * @brief Forgets all plotted results.
+     */
+    void clearHistory();
+
+    /**
+     * @brief Asks for polynomial coefficients and plots all roots of the polynomial.
+     */
+    void findPolynomialRoots();
+
+    /**
+     * @brief Re-renders the fractal once control returns to the event loop.
+     */
+    void scheduleFractalRefresh();
+
+    /**
+     * @brief Requests the fractal for the current mode, axes, plot size and display.
+     *
+     * A request for a new view cancels the tiles still rendering the old one. The
+     * last image is moved to the new axes at once, so zooming shows a stretched
+     * preview until the first coarse pass of the new view arrives.
+     */
+    void refreshFractal();
+
+    /**
+     * @brief Takes the latest image from the renderer and shows it.
+     */
+    void showFractalFrame();
+
+    /**
+     * @brief Runs the completions of finished jobs and updates the progress bar.
+     *
+     * Completions run until about half a frame has passed; the rest are left for the
+     * next pass of the event loop, so a burst of finished jobs does not stall the GUI.
+     */
+    void deliverJobs();
+
+    /**
+     * @brief Cancels every background job; their results are never shown.
+     */
+    void cancelJobs();
+
     /**
      * @brief Get the currently active display.
      *
@@ -220,6 +301,72 @@ private slots:
     ComplexNumber readNumber();
 
 private:
+    /**
+     * @brief Precision picked for the keypad operations.
+     *
+     * @return precision (Precision).
+     */
+    Precision selectedPrecision() const;
+
+    /**
+     * @brief Records a calculation in the history kept by the calculator memory.
+     *
+     * A journal that cannot grow is reported in a message box.
+     *
+     * @param a first operand (const ComplexNumber&).
+     * @param op operation (OpCode).
+     * @param b second operand, zero for unary operations (const ComplexNumber&).
+     * @param result result (const ComplexNumber&).
+     */
+    void recordHistory(const ComplexNumber &a, OpCode op, const ComplexNumber &b,
+                       const ComplexNumber &result);
+
+    /**
+     * @brief Name of the selected memory register.
+     *
+     * @return register name, the default register if the box is empty (std::string).
+     */
+    std::string currentRegister() const;
+
+    /**
+     * @brief Runs work on the job threads; its completion runs later in deliverJobs().
+     *
+     * @param work the job (JobRunner::Work).
+     * @return id of the job (JobRunner::JobId).
+     */
+    JobRunner::JobId submitJob(JobRunner::Work work);
+
+    /**
+     * @brief Shows the number and progress of the pending jobs.
+     */
+    void updateJobProgress();
+
+    /**
+     * @brief Builds the chart in place of the placeholder, unless it exists already.
+     */
+    void ensureChart();
+
+    /**
+     * @brief Fits the axes around the plotted numbers and the history with a 10% margin.
+     *
+     * The axes are only touched when their range actually changes.
+     *
+     * @param points numbers currently plotted (std::initializer_list<ComplexNumber>).
+     */
+    void fitAxes(std::initializer_list<ComplexNumber> points);
+
+    /**
+     * @brief Puts the fractal image over the part of the plot area it was rendered for.
+     */
+    void placeFractal();
+
+    /**
+     * @brief Switches the axes between plane coordinates and deep-zoom offsets.
+     *
+     * @param enabled whether the axes should show offsets from the deep-zoom centre (bool).
+     */
+    void setDeepZoom(bool enabled);
+
     /**
      * @brief Make a new Button object remember the function clicked.
      *
@@ -254,9 +401,9 @@ private:
     bool realPart;
 
     /**
-     * @brief The current pending operator (stored as a string).
+     * @brief The current pending operator.
      */
-    std::string operation;
+    OpCode operation;
 
     /**
      * @brief QLineEdits for displaying the real and imaginary parts of a complex number.
@@ -265,6 +412,16 @@ private:
      */
     QLineEdit *display, *display_i;
 
+    /**
+     * @brief Input line for free-form expressions.
+     */
+    QLineEdit *expressionInput;
+
+    /**
+     * @brief Selects (or names) the memory register used by the memory buttons.
+     */
+    QComboBox *memoryRegister;
+
     /**
      * @brief Palettes for active and inactive display elements.
      *
@@ -274,13 +431,145 @@ private:
 
     /**
      * @brief QChart object for visualizing complex number calculations.
+     *
+     * Created by ensureChart() on the first plot, nullptr before; its series and axes
+     * are updated in place for every result. The series, axes and fractal items below
+     * exist only once the chart does.
+     */
+    QChart *chart = nullptr;
+
+    /**
+     * @brief Stands in for the chart view until the chart is built.
      */
-    QChart *chart;
+    QLabel *chartPlaceholder = nullptr;
 
     /**
      * @brief QChartView object for displaying the chart visualization.
      */
-    QChartView *chartView;
+    QChartView *chartView = nullptr;
+
+    /**
+     * @brief Scatter series for the first operand, second operand and result.
+     */
+    QScatterSeries *seriesA = nullptr, *seriesB = nullptr, *seriesR = nullptr;
+
+    /**
+     * @brief Real (horizontal) and imaginary (vertical) axes of the chart.
+     */
+    QValueAxis *axisX = nullptr, *axisY = nullptr;
+
+    /**
+     * @brief Every result of the session, indexed for level-of-detail plotting.
+     */
+    PointPyramid history;
+
+    /**
+     * @brief Points of the results files plotted so far, one pyramid per file.
+     *
+     * Each is built by a job and moved in when it completes, so loading millions of
+     * points costs the GUI thread nothing.
+     */
+    std::vector<PointPyramid> resultFiles;
+
+    /**
+     * @brief Scatter series showing the selected history points.
+     */
+    QScatterSeries *historySeries = nullptr;
+
+    /**
+     * @brief Scatter series showing the roots found by findPolynomialRoots().
+     */
+    QScatterSeries *rootSeries = nullptr;
+
+    /**
+     * @brief Coefficients last entered for findPolynomialRoots().
+     */
+    QString polynomialText;
+
+    /**
+     * @brief Reused buffers for the selected history points.
+     */
+    std::vector<ComplexNumber> historyPoints, filePoints;
+
+    /**
+     * @brief Whether refreshHistory() is already queued.
+     */
+    bool historyRefreshPending;
+
+    /**
+     * @brief Selects the escape-time fractal drawn behind the points, if any.
+     */
+    QComboBox *fractalMode;
+
+    /**
+     * @brief Selects the precision the keypad operations are computed in.
+     */
+    QComboBox *precisionBox;
+
+    /**
+     * @brief Clips the fractal image to the plot area.
+     */
+    QGraphicsRectItem *fractalClip = nullptr;
+
+    /**
+     * @brief Fractal image, drawn above the plot area background and below the grid.
+     */
+    QGraphicsPixmapItem *fractalItem = nullptr;
+
+    /**
+     * @brief Renders the fractal in the background; created when first needed.
+     */
+    std::unique_ptr<FractalRenderer> fractalRenderer;
+
+    /**
+     * @brief Last view requested from the renderer.
+     */
+    FractalView fractalView;
+
+    /**
+     * @brief Reused buffer for the image being shown.
+     */
+    FractalFrame fractalFrame;
+
+    /**
+     * @brief Runs the slow calculations (results files, polynomial roots) off the GUI
+     *        thread; created when first needed.
+     */
+    std::unique_ptr<JobRunner> jobRunner;
+
+    /**
+     * @brief Root finding job whose result is still awaited, 0 if none.
+     */
+    JobRunner::JobId rootsJob = 0;
+
+    /**
+     * @brief Progress of the background jobs.
+     */
+    QProgressBar *jobProgress;
+
+    /**
+     * @brief Cancels the background jobs.
+     */
+    Button *cancelButton;
+
+    /**
+     * @brief Whether the axes show offsets from the deep-zoom centre.
+     *
+     * Doubles cannot place a view 1e-100 wide, so in deep-zoom mode the point under
+     * the middle of the chart is kept in fixed point and the axes only span the
+     * small offsets around it.
+     */
+    bool deepZoom;
+
+    /**
+     * @brief Deep-zoom centre, meaningful while deepZoom is set.
+     */
+    FixedPoint deepCenterReal, deepCenterImaginary;
+
+    /**
+     * @brief Whether refreshFractal() is already queued.
+     */
+    bool fractalRefreshPending;
 
     /**
      * @brief QGridLayout object for managing GUI.
@@ -6,7 +6,6 @@ HEADERS       = button.h \
                 calcmemory.h
 SOURCES       = button.cpp \
                 calculator.cpp \
-                complexnumber.cpp \
                 calcmemory.cpp \
                 main.cpp
 
@@ -0,0 +1,261 @@
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "batchprocessor.h"
+#ifdef COMPLEXCALC_HAS_SERVER
+#include "calcserver.h"
+#endif
+#include "complexnumber.h"
+#include "expression.h"
+#include "precision.h"
+#include "shape.h"
+
+/**
+ * @brief Prints the command line usage.
+ *
+ * @param out stream to print to (std::ostream&).
+ */
+static void printUsage(std::ostream &out)
+{
+    out << "Usage:\n"
+        << "  complexcalc-cli <add|subtract|multiply|divide> <re> <im> <re> <im>\n"
+        << "  complexcalc-cli <root|power|inverse|conjugate|abs> <re> <im>\n"
+        << "  complexcalc-cli <circle-area|circle-circumference|"
+           "triangle-area|triangle-circumference> <value>\n"
+        << "  complexcalc-cli --eval <expression> [name=<re>,<im> ...]\n"
+        << "  complexcalc-cli --batch [--precision <float|double|long|quad>] [file]\n"
+        << "                  (one \"<op> <re> <im> [<re> <im>]\" per line)\n";
+#ifdef COMPLEXCALC_HAS_SERVER
+    out << "  complexcalc-cli --serve [<socket-path>] [--tcp <port>] [--threads <n>]\n";
+#endif
+}
+
+/**
+ * @brief Parses a double from a command line argument.
+ *
+ * @param text argument to be parsed (const char*).
+ * @throws std::invalid_argument If the argument is not a number.
+ * @return parsed value (double).
+ */
+static double parseNumber(const char *text)
+{
+    std::size_t used = 0;
+    double value = std::stod(text, &used);
+    if (used != std::strlen(text)) {
+        throw std::invalid_argument(std::string("Not a number: ") + text);
+    }
+    return value;
+}
+
+/**
+ * @brief Prints a complex number as "<real> <imaginary>".
+ *
+ * @param a number to be printed (ComplexNumber).
+ */
+static void printNumber(const ComplexNumber &a)
+{
+    std::cout << a.getReal() << ' ' << a.getImaginary() << '\n';
+}
+
+/**
+ * @brief Streams a batch of records from a file or stdin to stdout.
+ *
+ * @param path input file, or "-" for stdin (const char*).
+ * @param precision precision the records are computed in (Precision).
+ * @return process exit code (int).
+ */
+static int runBatch(const char *path, Precision precision)
+{
+    std::FILE *input = stdin;
+    if (std::strcmp(path, "-") != 0) {
+        input = std::fopen(path, "rb");
+        if (!input) {
+            throw std::runtime_error(std::string("Cannot open ") + path);
+        }
+    }
+
+    BatchProcessor processor(1 << 20, precision);
+    BatchProcessor::Stats stats;
+    try {
+        stats = processor.run(input, stdout);
+    } catch (...) {
+        if (input != stdin) {
+            std::fclose(input);
+        }
+        throw;
+    }
+    if (input != stdin) {
+        std::fclose(input);
+    }
+
+    std::cerr << stats.records << " records, " << stats.errors << " errors\n";
+    return 0;
+}
+
+/**
+ * @brief Compiles and evaluates one expression.
+ *
+ * @param argc number of arguments after "--eval" (int).
+ * @param argv expression followed by "name=re,im" variable bindings (char**).
+ * @throws std::invalid_argument If the expression or a binding is malformed.
+ * @return process exit code (int).
+ */
+static int runExpression(int argc, char *argv[])
+{
+    Expression expression(argv[0]);
+    std::vector<ComplexNumber> bindings(expression.variables().size());
+    std::vector<bool> bound(bindings.size(), false);
+
+    for (int k = 1; k < argc; ++k) {
+        const std::string binding = argv[k];
+        const std::size_t equals = binding.find('=');
+        const std::size_t comma = binding.find(',', equals);
+        if (equals == std::string::npos || comma == std::string::npos) {
+            throw std::invalid_argument("Expected name=re,im but got " + binding);
+        }
+        const int index = expression.variableIndex(binding.substr(0, equals));
+        if (index < 0) {
+            continue;
+        }
+        bindings[index] = ComplexNumber(
+            parseNumber(binding.substr(equals + 1, comma - equals - 1).c_str()),
+            parseNumber(binding.substr(comma + 1).c_str()));
+        bound[index] = true;
+    }
+
+    for (std::size_t k = 0; k < bound.size(); ++k) {
+        if (!bound[k]) {
+            throw std::invalid_argument("No value for variable " + expression.variables()[k]);
+        }
+    }
+
+    printNumber(expression.evaluate(bindings.data()));
+    return 0;
+}
+
+/**
+ * @brief Runs a single calculation described by the arguments.
+ *
+ * @return process exit code (int).
+ */
+static int run(int argc, char *argv[])
+{
+    const std::string op = argv[1];
+    const int operands = argc - 2;
+
+    if (op == "--eval") {
+        if (operands < 1) {
+            printUsage(std::cerr);
+            return 2;
+        }
+        return runExpression(operands, argv + 2);
+    }
+
+    if (op == "--batch") {
+        Precision precision = Precision::Double;
+        int first = 2;
+        if (operands >= 1 && std::strcmp(argv[2], "--precision") == 0) {
+            if (operands < 2) {
+                printUsage(std::cerr);
+                return 2;
+            }
+            precision = parsePrecision(argv[3]);
+            first = 4;
+        }
+        if (argc - first > 1) {
+            printUsage(std::cerr);
+            return 2;
+        }
+        return runBatch(argc - first == 1 ? argv[first] : "-", precision);
+    }
+
+#ifdef COMPLEXCALC_HAS_SERVER
+    if (op == "--serve") {
+        return serveFromCommandLine(operands, argv + 2);
+    }
+#endif
+
+    if (op == "add" || op == "subtract" || op == "multiply" || op == "divide") {
+        if (operands != 4) {
+            printUsage(std::cerr);
+            return 2;
+        }
+        ComplexNumber a(parseNumber(argv[2]), parseNumber(argv[3]));
+        ComplexNumber b(parseNumber(argv[4]), parseNumber(argv[5]));
+        if (op == "add") {
+            printNumber(a.add(b));
+        } else if (op == "subtract") {
+            printNumber(a.subtract(b));
+        } else if (op == "multiply") {
+            printNumber(a.multiply(b));
+        } else {
+            printNumber(a.divide(b));
+        }
+        return 0;
+    }
+
+    if (op == "root" || op == "power" || op == "inverse" || op == "conjugate" || op == "abs") {
+        if (operands != 2) {
+            printUsage(std::cerr);
+            return 2;
+        }
+        ComplexNumber a(parseNumber(argv[2]), parseNumber(argv[3]));
+        if (op == "root") {
+            printNumber(a.root());
+        } else if (op == "power") {
+            printNumber(a.multiply(a));
+        } else if (op == "inverse") {
+            printNumber(a.inverse());
+        } else if (op == "conjugate") {
+            printNumber(a.conjugate());
+        } else {
+            printNumber(ComplexNumber(a.absoluteValue(), 0.0));
+        }
+        return 0;
+    }
+
+    if (op == "circle-area" || op == "circle-circumference"
+        || op == "triangle-area" || op == "triangle-circumference") {
+        if (operands != 1) {
+            printUsage(std::cerr);
+            return 2;
+        }
+        double value = parseNumber(argv[2]);
+        if (op == "circle-area") {
+            std::cout << Circle(value).calculateArea() << '\n';
+        } else if (op == "circle-circumference") {
+            std::cout << Circle(value).calculateCircumference() << '\n';
+        } else if (op == "triangle-area") {
+            std::cout << Triangle(value).calculateArea() << '\n';
+        } else {
+            std::cout << Triangle(value).calculateCircumference() << '\n';
+        }
+        return 0;
+    }
+
+    printUsage(std::cerr);
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    // Headless entry point - no Qt is loaded here.
+    if (argc < 2 || std::strcmp(argv[1], "--help") == 0) {
+        printUsage(argc < 2 ? std::cerr : std::cout);
+        return argc < 2 ? 2 : 0;
+    }
+
+    std::cout << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    try {
+        return run(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << "error: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef COMPENSATEDSUM_H
+#define COMPENSATEDSUM_H
+
+#include <cmath>
+
+#include "complexnumber.h"
+
+/**
+ * @brief Running sum of complex numbers with Neumaier compensation.
+ *
+ * Every addition also accumulates the rounding error it made, separately for the
+ * real and imaginary parts, and value() adds it back. The error of the result no
+ * longer grows with the number of terms: it stays around one rounding of the exact
+ * sum, where a plain running sum loses accuracy linearly with the count.
+ */
+class CompensatedSum {
+public:
+    /**
+     * @brief Creates a sum starting at the given value.
+     *
+     * @param start initial value (const ComplexNumber&).
+     */
+    explicit CompensatedSum(const ComplexNumber &start = ComplexNumber()) noexcept
+        : sumReal(start.getReal()), sumImaginary(start.getImaginary())
+    {}
+
+    /**
+     * @brief Creates a sum from a running sum and the rounding error it accumulated.
+     *
+     * @param sum uncompensated sum (const ComplexNumber&).
+     * @param error accumulated compensation (const ComplexNumber&).
+     */
+    CompensatedSum(const ComplexNumber &sum, const ComplexNumber &error) noexcept
+        : sumReal(sum.getReal()), sumImaginary(sum.getImaginary()),
+          errorReal(error.getReal()), errorImaginary(error.getImaginary())
+    {}
+
+    /**
+     * @brief Adds one number.
+     *
+     * @param value number to be added (const ComplexNumber&).
+     */
+    void add(const ComplexNumber &value) noexcept
+    {
+        accumulate(sumReal, errorReal, value.getReal());
+        accumulate(sumImaginary, errorImaginary, value.getImaginary());
+    }
+
+    /**
+     * @brief Adds another sum, keeping both compensations.
+     *
+     * @param other sum to be added (const CompensatedSum&).
+     */
+    void add(const CompensatedSum &other) noexcept
+    {
+        accumulate(sumReal, errorReal, other.sumReal);
+        accumulate(sumImaginary, errorImaginary, other.sumImaginary);
+        errorReal += other.errorReal;
+        errorImaginary += other.errorImaginary;
+    }
+
+    /**
+     * @brief The compensated sum.
+     *
+     * Once a part overflows or becomes NaN its compensation is meaningless and is
+     * ignored, so the result matches what a plain sum would give.
+     *
+     * @return sum of all added numbers (ComplexNumber).
+     */
+    ComplexNumber value() const noexcept
+    {
+        return ComplexNumber(std::isfinite(sumReal) ? sumReal + errorReal : sumReal,
+                             std::isfinite(sumImaginary) ? sumImaginary + errorImaginary : sumImaginary);
+    }
+
+private:
+    /**
+     * @brief One Neumaier step: sum += value, the rounding error goes to error.
+     */
+    static void accumulate(double &sum, double &error, double value) noexcept
+    {
+        const double next = sum + value;
+        error += std::fabs(sum) >= std::fabs(value) ? (sum - next) + value : (value - next) + sum;
+        sum = next;
+    }
+
+    double sumReal;
+    double sumImaginary;
+    double errorReal = 0;
+    double errorImaginary = 0;
+};
+
+#endif // COMPENSATEDSUM_H
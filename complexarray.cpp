@@ -0,0 +1,414 @@
+#include "complexarray.h"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "complexkernels.h"
+
+namespace {
+
+/**
+ * @brief Allocates an aligned buffer, optionally filled with zeros.
+ */
+double *allocateBuffer(std::size_t count, bool zero)
+{
+    if (count == 0) {
+        return nullptr;
+    }
+    double *buffer = static_cast<double *>(
+        ::operator new(count * sizeof(double), std::align_val_t(ComplexArray::Alignment)));
+    if (zero) {
+        std::fill(buffer, buffer + count, 0.0);
+    }
+    return buffer;
+}
+
+/**
+ * @brief Releases a buffer from allocateBuffer().
+ */
+void freeBuffer(double *buffer)
+{
+    if (buffer) {
+        ::operator delete(buffer, std::align_val_t(ComplexArray::Alignment));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Creates an array of zeros.
+ *
+ * @param size number of elements (std::size_t).
+ */
+ComplexArray::ComplexArray(std::size_t size)
+    : count(size), re(allocateBuffer(size, true)), im(nullptr)
+{
+    try {
+        im = allocateBuffer(size, true);
+    } catch (...) {
+        freeBuffer(re);
+        throw;
+    }
+}
+
+/**
+ * @brief Creates an array whose contents are about to be overwritten.
+ *
+ * @param size number of elements (std::size_t).
+ */
+ComplexArray::ComplexArray(std::size_t size, Uninitialized)
+    : count(size), re(allocateBuffer(size, false)), im(nullptr)
+{
+    try {
+        im = allocateBuffer(size, false);
+    } catch (...) {
+        freeBuffer(re);
+        throw;
+    }
+}
+
+/**
+ * @brief Creates an array holding copies of the given numbers.
+ *
+ * @param values numbers to be stored (const std::vector<ComplexNumber>&).
+ */
+ComplexArray::ComplexArray(const std::vector<ComplexNumber> &values)
+    : ComplexArray(values.size())
+{
+    for (std::size_t k = 0; k < count; ++k) {
+        set(k, values[k]);
+    }
+}
+
+/**
+ * @brief Copy constructor.
+ */
+ComplexArray::ComplexArray(const ComplexArray &other)
+    : ComplexArray(other.count, Uninitialized())
+{
+    std::copy(other.re, other.re + count, re);
+    std::copy(other.im, other.im + count, im);
+}
+
+/**
+ * @brief Move constructor.
+ */
+ComplexArray::ComplexArray(ComplexArray &&other) noexcept
+    : count(std::exchange(other.count, 0)),
+    re(std::exchange(other.re, nullptr)),
+    im(std::exchange(other.im, nullptr))
+{
+}
+
+/**
+ * @brief Copy assignment.
+ */
+ComplexArray &ComplexArray::operator=(const ComplexArray &other)
+{
+    if (this != &other) {
+        ComplexArray copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment.
+ */
+ComplexArray &ComplexArray::operator=(ComplexArray &&other) noexcept
+{
+    std::swap(count, other.count);
+    std::swap(re, other.re);
+    std::swap(im, other.im);
+    return *this;
+}
+
+/**
+ * @brief Destructor.
+ */
+ComplexArray::~ComplexArray()
+{
+    freeBuffer(re);
+    freeBuffer(im);
+}
+
+/**
+ * @brief Throws if other does not have the same number of elements.
+ *
+ * @param other array to compare with (const ComplexArray&).
+ * @throws std::invalid_argument If the sizes differ.
+ */
+void ComplexArray::checkSize(const ComplexArray &other) const
+{
+    if (other.count != count) {
+        throw std::invalid_argument("Array sizes differ!");
+    }
+}
+
+/**
+ * @brief Element-wise addition.
+ *
+ * @param other numbers to be added (const ComplexArray&).
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::add(const ComplexArray &other) const
+{
+    checkSize(other);
+    ComplexArray result(count, Uninitialized());
+    activeKernels().add(re, im, other.re, other.im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise subtraction.
+ *
+ * @param other numbers to be subtracted (const ComplexArray&).
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::subtract(const ComplexArray &other) const
+{
+    checkSize(other);
+    ComplexArray result(count, Uninitialized());
+    activeKernels().subtract(re, im, other.re, other.im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise multiplication.
+ *
+ * @param other numbers to be multiplied (const ComplexArray&).
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::multiply(const ComplexArray &other) const
+{
+    checkSize(other);
+    ComplexArray result(count, Uninitialized());
+    activeKernels().multiply(re, im, other.re, other.im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise division.
+ *
+ * @param other divisors (const ComplexArray&).
+ * @throws std::invalid_argument If any divisor is zero.
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::divide(const ComplexArray &other) const
+{
+    checkSize(other);
+    ComplexArray result(count, Uninitialized());
+    if (activeKernels().divide(re, im, other.re, other.im, result.re, result.im, count,
+                               nullptr, 0) != 0) {
+        throw std::invalid_argument("Division by zero!");
+    }
+    return result;
+}
+
+/**
+ * @brief Element-wise division that never throws.
+ *
+ * @param other divisors (const ComplexArray&).
+ * @param result quotients (ComplexArray&).
+ * @param errors mask of zero divisors (ErrorMask&).
+ */
+void ComplexArray::divide(const ComplexArray &other, ComplexArray &result, ErrorMask &errors) const
+{
+    checkSize(other);
+    if (result.count != count) {
+        result = ComplexArray(count, Uninitialized());
+    }
+    errors.reset(count);
+    errors.errors = activeKernels().divide(re, im, other.re, other.im, result.re, result.im,
+                                           count, errors.words.data(), 0);
+}
+
+/**
+ * @brief Element-wise conjugate.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::conjugate() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().conjugate(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise inverse.
+ *
+ * @throws std::invalid_argument If any element is zero.
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::inverse() const
+{
+    ComplexArray result(count, Uninitialized());
+    if (activeKernels().inverse(re, im, result.re, result.im, count, nullptr, 0) != 0) {
+        throw std::invalid_argument("Division by zero!");
+    }
+    return result;
+}
+
+/**
+ * @brief Element-wise inverse that never throws.
+ *
+ * @param result inverses (ComplexArray&).
+ * @param errors mask of zero elements (ErrorMask&).
+ */
+void ComplexArray::inverse(ComplexArray &result, ErrorMask &errors) const
+{
+    if (result.count != count) {
+        result = ComplexArray(count, Uninitialized());
+    }
+    errors.reset(count);
+    errors.errors = activeKernels().inverse(re, im, result.re, result.im, count,
+                                            errors.words.data(), 0);
+}
+
+/**
+ * @brief Element-wise absolute value.
+ *
+ * @return moduli of all elements (std::vector<double>).
+ */
+std::vector<double> ComplexArray::absoluteValue() const
+{
+    std::vector<double> result(count);
+    activeKernels().absoluteValue(re, im, result.data(), count);
+    return result;
+}
+
+/**
+ * @brief Element-wise principal square root.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::root() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().root(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise exponential.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::exponential() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().exponential(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise principal logarithm.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::logarithm() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().logarithm(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise principal power exp(exponent * log(z)).
+ *
+ * @param exponent exponents, one per element (const ComplexArray&).
+ * @throws std::invalid_argument If the sizes differ.
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::power(const ComplexArray &exponent) const
+{
+    checkSize(exponent);
+    ComplexArray result(count, Uninitialized());
+    activeKernels().power(re, im, exponent.re, exponent.im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise sine.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::sine() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().sine(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise cosine.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::cosine() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().cosine(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise tangent.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::tangent() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().tangent(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise hyperbolic sine.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::hyperbolicSine() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().hyperbolicSine(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise hyperbolic cosine.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::hyperbolicCosine() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().hyperbolicCosine(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Element-wise hyperbolic tangent.
+ *
+ * @return result (ComplexArray).
+ */
+ComplexArray ComplexArray::hyperbolicTangent() const
+{
+    ComplexArray result(count, Uninitialized());
+    activeKernels().hyperbolicTangent(re, im, result.re, result.im, count);
+    return result;
+}
+
+/**
+ * @brief Name of the instruction set used by the kernels.
+ *
+ * @return "scalar", "sse2", "avx2" or "avx512" (const char*).
+ */
+const char *ComplexArray::simdLevel()
+{
+    return activeKernels().name;
+}
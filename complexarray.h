@@ -0,0 +1,323 @@
+#ifndef COMPLEXARRAY_H
+#define COMPLEXARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "complexnumber.h"
+
+/**
+ * @brief One bit per element, set where a bulk operation hit a zero divisor.
+ */
+class ErrorMask {
+public:
+    /**
+     * @brief Clears the mask and sizes it for count elements.
+     *
+     * @param count number of elements (std::size_t).
+     */
+    void reset(std::size_t count)
+    {
+        words.assign((count + 63) / 64, 0);
+        elements = count;
+        errors = 0;
+    }
+
+    /** @brief Whether the element at index failed. */
+    bool test(std::size_t index) const { return (words[index / 64] >> (index % 64)) & 1; }
+
+    /** @brief Number of failed elements. */
+    std::size_t count() const { return errors; }
+
+    /** @brief Whether any element failed. */
+    bool any() const { return errors != 0; }
+
+    /** @brief Number of elements covered by the mask. */
+    std::size_t size() const { return elements; }
+
+    /** @brief Raw 64-bit words, element k is bit k % 64 of word k / 64. */
+    const std::uint64_t *data() const { return words.data(); }
+    std::uint64_t *data() { return words.data(); }
+
+    /**
+     * @brief Recomputes count() after bits were set through data().
+     */
+    void recount()
+    {
+        errors = 0;
+        for (std::uint64_t word : words) {
+            for (; word != 0; word &= word - 1) {
+                ++errors;
+            }
+        }
+    }
+
+private:
+    friend class ComplexArray;
+
+    std::vector<std::uint64_t> words;
+    std::size_t elements = 0;
+    std::size_t errors = 0;
+};
+
+/**
+ * @brief Array of complex numbers stored as separate real and imaginary buffers.
+ *
+ * This structure-of-arrays layout lets the element-wise operations run on SIMD
+ * registers. The operations mirror the ComplexNumber methods and produce results
+ * bit-for-bit identical to calling them element by element. The instruction set
+ * (scalar, SSE2, AVX2 or AVX-512) is chosen once at runtime.
+ */
+class ComplexArray {
+public:
+    /**
+     * @brief Buffer alignment in bytes (one cache line, one AVX-512 register).
+     */
+    static constexpr std::size_t Alignment = 64;
+
+    /**
+     * @brief Creates an array of zeros.
+     *
+     * @param size number of elements (std::size_t).
+     */
+    explicit ComplexArray(std::size_t size = 0);
+
+    /**
+     * @brief Creates an array holding copies of the given numbers.
+     *
+     * @param values numbers to be stored (const std::vector<ComplexNumber>&).
+     */
+    explicit ComplexArray(const std::vector<ComplexNumber> &values);
+
+    ComplexArray(const ComplexArray &other);
+    ComplexArray(ComplexArray &&other) noexcept;
+    ComplexArray &operator=(const ComplexArray &other);
+    ComplexArray &operator=(ComplexArray &&other) noexcept;
+    ~ComplexArray();
+
+    /** @brief Number of elements. */
+    std::size_t size() const { return count; }
+
+    /** @brief Real parts of all elements. */
+    double *real() { return re; }
+    const double *real() const { return re; }
+
+    /** @brief Imaginary parts of all elements. */
+    double *imaginary() { return im; }
+    const double *imaginary() const { return im; }
+
+    /**
+     * @brief Reads one element.
+     *
+     * @param index position of the element (std::size_t).
+     * @return the element (ComplexNumber).
+     */
+    ComplexNumber get(std::size_t index) const { return ComplexNumber(re[index], im[index]); }
+
+    /**
+     * @brief Overwrites one element.
+     *
+     * @param index position of the element (std::size_t).
+     * @param value new value (const ComplexNumber&).
+     */
+    void set(std::size_t index, const ComplexNumber &value)
+    {
+        re[index] = value.getReal();
+        im[index] = value.getImaginary();
+    }
+
+    /**
+     * @brief Element-wise addition.
+     *
+     * @param other numbers to be added (const ComplexArray&).
+     * @throws std::invalid_argument If the sizes differ.
+     * @return result (ComplexArray).
+     */
+    ComplexArray add(const ComplexArray &other) const;
+
+    /**
+     * @brief Element-wise subtraction.
+     *
+     * @param other numbers to be subtracted (const ComplexArray&).
+     * @throws std::invalid_argument If the sizes differ.
+     * @return result (ComplexArray).
+     */
+    ComplexArray subtract(const ComplexArray &other) const;
+
+    /**
+     * @brief Element-wise multiplication.
+     *
+     * @param other numbers to be multiplied (const ComplexArray&).
+     * @throws std::invalid_argument If the sizes differ.
+     * @return result (ComplexArray).
+     */
+    ComplexArray multiply(const ComplexArray &other) const;
+
+    /**
+     * @brief Element-wise division.
+     *
+     * @param other divisors (const ComplexArray&).
+     * @throws std::invalid_argument If the sizes differ or any divisor is zero.
+     * @return result (ComplexArray).
+     */
+    ComplexArray divide(const ComplexArray &other) const;
+
+    /**
+     * @brief Element-wise division that never throws.
+     *
+     * Zero divisors give NaN parts and set their bit in errors. The result array is
+     * reused when it already has the right size, so repeated calls do not allocate.
+     *
+     * @param other divisors (const ComplexArray&).
+     * @param result quotients (ComplexArray&).
+     * @param errors mask of zero divisors, resized to this array (ErrorMask&).
+     * @throws std::invalid_argument If the sizes differ.
+     */
+    void divide(const ComplexArray &other, ComplexArray &result, ErrorMask &errors) const;
+
+    /**
+     * @brief Element-wise conjugate.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray conjugate() const;
+
+    /**
+     * @brief Element-wise inverse.
+     *
+     * @throws std::invalid_argument If any element is zero.
+     * @return result (ComplexArray).
+     */
+    ComplexArray inverse() const;
+
+    /**
+     * @brief Element-wise inverse that never throws.
+     *
+     * Zero elements give NaN parts and set their bit in errors. The result array is
+     * reused when it already has the right size.
+     *
+     * @param result inverses (ComplexArray&).
+     * @param errors mask of zero elements, resized to this array (ErrorMask&).
+     */
+    void inverse(ComplexArray &result, ErrorMask &errors) const;
+
+    /**
+     * @brief Element-wise absolute value.
+     *
+     * @return moduli of all elements (std::vector<double>).
+     */
+    std::vector<double> absoluteValue() const;
+
+    /**
+     * @brief Element-wise principal square root.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray root() const;
+
+    /**
+     * @brief Element-wise exponential.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray exponential() const;
+
+    /**
+     * @brief Element-wise principal logarithm.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray logarithm() const;
+
+    /**
+     * @brief Element-wise principal power exp(exponent * log(z)).
+     *
+     * @param exponent exponents, one per element (const ComplexArray&).
+     * @throws std::invalid_argument If the sizes differ.
+     * @return result (ComplexArray).
+     */
+    ComplexArray power(const ComplexArray &exponent) const;
+
+    /**
+     * @brief Element-wise sine.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray sine() const;
+
+    /**
+     * @brief Element-wise cosine.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray cosine() const;
+
+    /**
+     * @brief Element-wise tangent.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray tangent() const;
+
+    /**
+     * @brief Element-wise hyperbolic sine.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray hyperbolicSine() const;
+
+    /**
+     * @brief Element-wise hyperbolic cosine.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray hyperbolicCosine() const;
+
+    /**
+     * @brief Element-wise hyperbolic tangent.
+     *
+     * @return result (ComplexArray).
+     */
+    ComplexArray hyperbolicTangent() const;
+
+    /**
+     * @brief Name of the instruction set used by the kernels.
+     *
+     * @return "scalar", "sse2", "avx2" or "avx512" (const char*).
+     */
+    static const char *simdLevel();
+
+private:
+    /**
+     * @brief Tag selecting the constructor that skips zero-filling.
+     */
+    struct Uninitialized {};
+
+    /**
+     * @brief Creates an array whose contents are about to be overwritten.
+     */
+    ComplexArray(std::size_t size, Uninitialized);
+
+    /**
+     * @brief Throws if other does not have the same number of elements.
+     */
+    void checkSize(const ComplexArray &other) const;
+
+    /**
+     * @brief Number of elements.
+     */
+    std::size_t count;
+
+    /**
+     * @brief Aligned buffer of real parts.
+     */
+    double *re;
+
+    /**
+     * @brief Aligned buffer of imaginary parts.
+     */
+    double *im;
+};
+
+#endif // COMPLEXARRAY_H
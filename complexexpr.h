@@ -0,0 +1,356 @@
+#ifndef COMPLEXEXPR_H
+#define COMPLEXEXPR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "complexarray.h"
+#include "complexnumber.h"
+
+/**
+ * @brief Lazy element-wise arithmetic on ComplexArray, evaluated in one fused loop.
+ *
+ * Chaining the ComplexArray methods, e.g. a.multiply(b).add(c.divide(d)), allocates
+ * and streams a full temporary array for every intermediate result. With this header
+ * the same computation is written with operators,
+ *
+ *     ComplexArray r = evaluate(a * b + c / d);
+ *
+ * which only builds a small expression tree at compile time. evaluate() then walks
+ * the elements once, reading each input and writing the result a single time, with
+ * no temporary arrays. ComplexNumber operands are broadcast to every element, and
+ * the element results are bit-for-bit identical to the ComplexNumber methods.
+ *
+ * Expression nodes hold array views, not copies, so an expression must be evaluated
+ * while its arrays are alive (do not keep one in an auto variable past them). The
+ * result may be one of the operands.
+ */
+
+/**
+ * @brief Compiles the fused loop once per instruction set and picks one at load time.
+ *
+ * Expressions are instantiated in the caller's translation unit, which is built for
+ * the baseline instruction set, so the per-ISA kernels of ComplexArray do not apply.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__ELF__)
+#define COMPLEXEXPR_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define COMPLEXEXPR_TARGET_CLONES
+#endif
+
+/**
+ * @brief Base of all expression nodes (CRTP).
+ *
+ * Every node E provides size() (Broadcast for scalars) and
+ * ComplexNumber at(std::size_t k, double &zero), which computes element k and sets
+ * zero to 1 when a division in it hit a zero divisor. The flag is a double rather
+ * than a bool so that the element loop, which is all doubles, vectorizes.
+ */
+template<typename E>
+struct ComplexExpr {
+    /** @brief Size of operands that match any array size. */
+    static constexpr std::size_t Broadcast = SIZE_MAX;
+
+    const E &self() const { return static_cast<const E &>(*this); }
+};
+
+/**
+ * @brief Leaf reading one element of an array.
+ */
+class ArrayTerm : public ComplexExpr<ArrayTerm> {
+public:
+    explicit ArrayTerm(const ComplexArray &array)
+        : re(array.real()), im(array.imaginary()), count(array.size())
+    {
+    }
+
+    std::size_t size() const { return count; }
+
+    ComplexNumber at(std::size_t k, double &) const { return ComplexNumber(re[k], im[k]); }
+
+private:
+    const double *re;
+    const double *im;
+    std::size_t count;
+};
+
+/**
+ * @brief Leaf broadcasting one number to every element.
+ */
+class ScalarTerm : public ComplexExpr<ScalarTerm> {
+public:
+    constexpr explicit ScalarTerm(const ComplexNumber &value) : value(value) {}
+
+    std::size_t size() const { return Broadcast; }
+
+    ComplexNumber at(std::size_t, double &) const { return value; }
+
+private:
+    ComplexNumber value;
+};
+
+/**
+ * @brief Element operations of the inner nodes.
+ */
+struct AddOp {
+    static ComplexNumber apply(const ComplexNumber &a, const ComplexNumber &b, double &)
+    {
+        return a.add(b);
+    }
+};
+
+struct SubtractOp {
+    static ComplexNumber apply(const ComplexNumber &a, const ComplexNumber &b, double &)
+    {
+        return a.subtract(b);
+    }
+};
+
+struct MultiplyOp {
+    static ComplexNumber apply(const ComplexNumber &a, const ComplexNumber &b, double &)
+    {
+        return a.multiply(b);
+    }
+};
+
+struct DivideOp {
+    static ComplexNumber apply(const ComplexNumber &a, const ComplexNumber &b, double &zero)
+    {
+        zero = b.getReal() == 0 && b.getImaginary() == 0 ? 1.0 : zero;
+        return a.divideUnchecked(b);
+    }
+};
+
+struct NegateOp {
+    static ComplexNumber apply(const ComplexNumber &a, double &) { return -a; }
+};
+
+struct ConjugateOp {
+    static ComplexNumber apply(const ComplexNumber &a, double &) { return a.conjugate(); }
+};
+
+struct InverseOp {
+    static ComplexNumber apply(const ComplexNumber &a, double &zero)
+    {
+        zero = a.getReal() == 0 && a.getImaginary() == 0 ? 1.0 : zero;
+        return a.inverseUnchecked();
+    }
+};
+
+struct RootOp {
+    static ComplexNumber apply(const ComplexNumber &a, double &) { return a.root(); }
+};
+
+/**
+ * @brief Inner node combining two sub-expressions element by element.
+ */
+template<typename Op, typename L, typename R>
+class BinaryExpr : public ComplexExpr<BinaryExpr<Op, L, R>> {
+public:
+    BinaryExpr(const L &left, const R &right) : left(left), right(right)
+    {
+        if (left.size() != right.size() && left.size() != this->Broadcast
+            && right.size() != this->Broadcast) {
+            throw std::invalid_argument("Array sizes differ!");
+        }
+    }
+
+    std::size_t size() const { return left.size() < right.size() ? left.size() : right.size(); }
+
+    ComplexNumber at(std::size_t k, double &zero) const
+    {
+        return Op::apply(left.at(k, zero), right.at(k, zero), zero);
+    }
+
+private:
+    L left;
+    R right;
+};
+
+/**
+ * @brief Inner node transforming one sub-expression element by element.
+ */
+template<typename Op, typename A>
+class UnaryExpr : public ComplexExpr<UnaryExpr<Op, A>> {
+public:
+    explicit UnaryExpr(const A &argument) : argument(argument) {}
+
+    std::size_t size() const { return argument.size(); }
+
+    ComplexNumber at(std::size_t k, double &zero) const
+    {
+        return Op::apply(argument.at(k, zero), zero);
+    }
+
+private:
+    A argument;
+};
+
+/**
+ * @brief Maps an operand type to the node stored in the tree.
+ */
+template<typename T>
+struct ExprTerm;
+
+template<typename E>
+struct ExprTerm<ComplexExpr<E>> {
+    using Type = E;
+    static const E &make(const ComplexExpr<E> &expr) { return expr.self(); }
+};
+
+template<>
+struct ExprTerm<ComplexArray> {
+    using Type = ArrayTerm;
+    static ArrayTerm make(const ComplexArray &array) { return ArrayTerm(array); }
+};
+
+template<>
+struct ExprTerm<ComplexNumber> {
+    using Type = ScalarTerm;
+    static ScalarTerm make(const ComplexNumber &value) { return ScalarTerm(value); }
+};
+
+/**
+ * @brief Selects the ExprTerm specialization for an operand, or none.
+ */
+template<typename E>
+ComplexExpr<E> exprBase(const ComplexExpr<E> *);
+ComplexArray exprBase(const ComplexArray *);
+ComplexNumber exprBase(const ComplexNumber *);
+
+template<typename T>
+using ExprTermOf = ExprTerm<decltype(exprBase(static_cast<const std::decay_t<T> *>(nullptr)))>;
+
+/**
+ * @brief Whether an operand is an array or an expression. The operators require at
+ * least one, leaving ComplexNumber arithmetic to the ComplexNumber operators.
+ */
+template<typename T>
+constexpr bool isArrayOperand = !std::is_same<std::decay_t<T>, ComplexNumber>::value;
+
+template<typename L, typename R>
+using BinaryOperands = std::enable_if_t<isArrayOperand<L> || isArrayOperand<R>,
+                                        decltype(exprBase(static_cast<const std::decay_t<L> *>(nullptr)),
+                                                 exprBase(static_cast<const std::decay_t<R> *>(nullptr)),
+                                                 0)>;
+
+template<typename A>
+using UnaryOperand = std::enable_if_t<isArrayOperand<A>,
+                                      decltype(exprBase(static_cast<const std::decay_t<A> *>(nullptr)), 0)>;
+
+template<typename Op, typename L, typename R>
+BinaryExpr<Op, typename ExprTermOf<L>::Type, typename ExprTermOf<R>::Type>
+makeBinary(const L &left, const R &right)
+{
+    return {ExprTermOf<L>::make(left), ExprTermOf<R>::make(right)};
+}
+
+template<typename Op, typename A>
+UnaryExpr<Op, typename ExprTermOf<A>::Type> makeUnary(const A &argument)
+{
+    return UnaryExpr<Op, typename ExprTermOf<A>::Type>(ExprTermOf<A>::make(argument));
+}
+
+template<typename L, typename R, BinaryOperands<L, R> = 0>
+auto operator+(const L &left, const R &right) { return makeBinary<AddOp>(left, right); }
+
+template<typename L, typename R, BinaryOperands<L, R> = 0>
+auto operator-(const L &left, const R &right) { return makeBinary<SubtractOp>(left, right); }
+
+template<typename L, typename R, BinaryOperands<L, R> = 0>
+auto operator*(const L &left, const R &right) { return makeBinary<MultiplyOp>(left, right); }
+
+template<typename L, typename R, BinaryOperands<L, R> = 0>
+auto operator/(const L &left, const R &right) { return makeBinary<DivideOp>(left, right); }
+
+template<typename A, UnaryOperand<A> = 0>
+auto operator-(const A &argument) { return makeUnary<NegateOp>(argument); }
+
+/**
+ * @brief Lazy element-wise conjugate.
+ */
+template<typename A, UnaryOperand<A> = 0>
+auto conj(const A &argument) { return makeUnary<ConjugateOp>(argument); }
+
+/**
+ * @brief Lazy element-wise inverse, zero elements are reported like zero divisors.
+ */
+template<typename A, UnaryOperand<A> = 0>
+auto inv(const A &argument) { return makeUnary<InverseOp>(argument); }
+
+/**
+ * @brief Lazy element-wise principal square root.
+ */
+template<typename A, UnaryOperand<A> = 0>
+auto sqrt(const A &argument) { return makeUnary<RootOp>(argument); }
+
+/**
+ * @brief Evaluates an expression into an array without throwing on zero divisors.
+ *
+ * Elements whose computation divided by zero get NaN parts and their bit set in
+ * errors. The result is reused when it already has the right size, so repeated
+ * evaluation does not allocate.
+ *
+ * @param expr expression to be evaluated (const ComplexExpr<E>&).
+ * @param result values (ComplexArray&).
+ * @param errors mask of failed elements, resized to the result (ErrorMask&).
+ */
+template<typename E>
+COMPLEXEXPR_TARGET_CLONES
+void evaluate(const ComplexExpr<E> &expr, ComplexArray &result, ErrorMask &errors)
+{
+    const E tree = expr.self();
+    const std::size_t count = tree.size();
+    if (result.size() != count) {
+        result = ComplexArray(count);
+    }
+    errors.reset(count);
+
+    double *re = result.real();
+    double *im = result.imaginary();
+    std::uint64_t *words = errors.data();
+    for (std::size_t start = 0; start < count; start += 64) {
+        // Each block of 64 elements is computed into local buffers, which cannot
+        // alias the operands, so the element loop is free to vectorize.
+        const std::size_t n = count - start < 64 ? count - start : 64;
+        double blockRe[64], blockIm[64], zeros[64];
+        for (std::size_t j = 0; j < n; ++j) {
+            double zero = 0;
+            const ComplexNumber value = tree.at(start + j, zero);
+            blockRe[j] = value.getReal();
+            blockIm[j] = value.getImaginary();
+            zeros[j] = zero;
+        }
+        std::uint64_t word = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            re[start + j] = blockRe[j];
+            im[start + j] = blockIm[j];
+            word |= std::uint64_t(zeros[j] != 0) << j;
+        }
+        words[start / 64] = word;
+    }
+    errors.recount();
+}
+
+/**
+ * @brief Evaluates an expression into a new array.
+ *
+ * @param expr expression to be evaluated (const ComplexExpr<E>&).
+ * @throws std::invalid_argument If a division by zero occurs.
+ * @return result (ComplexArray).
+ */
+template<typename E>
+ComplexArray evaluate(const ComplexExpr<E> &expr)
+{
+    ComplexArray result;
+    ErrorMask errors;
+    evaluate(expr, result, errors);
+    if (errors.any()) {
+        throw std::invalid_argument("Division by zero!");
+    }
+    return result;
+}
+
+#endif // COMPLEXEXPR_H
@@ -0,0 +1,310 @@
+#include "complexnumber.h"
+
+#include <cmath>
+#include <complex>
+
+#include "complexkernels.h"
+
+// The elementary functions of ComplexNumber run the scalar kernels on one element, so
+// they give the same bits as the batch kernels on every instruction set. The other
+// precisions of BasicComplex are instantiated at the end of this file.
+
+/**
+ * @brief One element of an elementary function outside the fast domain of the kernels.
+ *
+ * @param function function to be evaluated (ElementaryFunction).
+ * @param ar real part of the argument (double).
+ * @param ai imaginary part of the argument (double).
+ * @param br real part of the exponent, only used by Power (double).
+ * @param bi imaginary part of the exponent, only used by Power (double).
+ * @param rr receives the real part of the result (double&).
+ * @param ri receives the imaginary part of the result (double&).
+ */
+void elementaryFallback(ElementaryFunction function, double ar, double ai, double br, double bi, double &rr,
+                        double &ri)
+{
+    const std::complex<double> a(ar, ai);
+    std::complex<double> result;
+    switch (function) {
+    case ElementaryFunction::Exponential:
+        result = std::exp(a);
+        break;
+    case ElementaryFunction::Logarithm:
+        result = std::log(a);
+        break;
+    case ElementaryFunction::Power:
+        result = std::pow(a, std::complex<double>(br, bi));
+        break;
+    case ElementaryFunction::Sine:
+        result = std::sin(a);
+        break;
+    case ElementaryFunction::Cosine:
+        result = std::cos(a);
+        break;
+    case ElementaryFunction::Tangent:
+        result = std::tan(a);
+        break;
+    case ElementaryFunction::HyperbolicSine:
+        result = std::sinh(a);
+        break;
+    case ElementaryFunction::HyperbolicCosine:
+        result = std::cosh(a);
+        break;
+    case ElementaryFunction::HyperbolicTangent:
+        result = std::tanh(a);
+        break;
+    }
+    rr = result.real();
+    ri = result.imag();
+}
+
+namespace {
+
+/**
+ * @brief Runs a unary scalar kernel on one number.
+ */
+ComplexNumber applyKernel(void (*kernel)(const double *, const double *, double *, double *, std::size_t),
+                          const ComplexNumber &z) noexcept
+{
+    const double real = z.getReal(), imaginary = z.getImaginary();
+    double resultReal, resultImaginary;
+    kernel(&real, &imaginary, &resultReal, &resultImaginary, 1);
+    return ComplexNumber(resultReal, resultImaginary);
+}
+
+/**
+ * @brief One elementary function in double precision, through the scalar kernels.
+ */
+ComplexNumber evaluate(ElementaryFunction function, const ComplexNumber &a, const ComplexNumber &b) noexcept
+{
+    switch (function) {
+    case ElementaryFunction::Exponential:
+        return applyKernel(scalarKernels.exponential, a);
+    case ElementaryFunction::Logarithm:
+        return applyKernel(scalarKernels.logarithm, a);
+    case ElementaryFunction::Power: {
+        const double ar = a.getReal(), ai = a.getImaginary(), br = b.getReal(), bi = b.getImaginary();
+        double resultReal, resultImaginary;
+        scalarKernels.power(&ar, &ai, &br, &bi, &resultReal, &resultImaginary, 1);
+        return ComplexNumber(resultReal, resultImaginary);
+    }
+    case ElementaryFunction::Sine:
+        return applyKernel(scalarKernels.sine, a);
+    case ElementaryFunction::Cosine:
+        return applyKernel(scalarKernels.cosine, a);
+    case ElementaryFunction::Tangent:
+        return applyKernel(scalarKernels.tangent, a);
+    case ElementaryFunction::HyperbolicSine:
+        return applyKernel(scalarKernels.hyperbolicSine, a);
+    case ElementaryFunction::HyperbolicCosine:
+        return applyKernel(scalarKernels.hyperbolicCosine, a);
+    case ElementaryFunction::HyperbolicTangent:
+        return applyKernel(scalarKernels.hyperbolicTangent, a);
+    }
+    return a;
+}
+
+/**
+ * @brief One elementary function in float: the double result rounded once.
+ */
+BasicComplex<float> evaluate(ElementaryFunction function, const BasicComplex<float> &a,
+                             const BasicComplex<float> &b) noexcept
+{
+    return BasicComplex<float>(evaluate(function, ComplexNumber(a), ComplexNumber(b)));
+}
+
+/**
+ * @brief One elementary function in long double, through std::complex.
+ */
+BasicComplex<long double> evaluate(ElementaryFunction function, const BasicComplex<long double> &a,
+                                   const BasicComplex<long double> &b) noexcept
+{
+    const std::complex<long double> z(a.getReal(), a.getImaginary());
+    std::complex<long double> result;
+    switch (function) {
+    case ElementaryFunction::Exponential:
+        result = std::exp(z);
+        break;
+    case ElementaryFunction::Logarithm:
+        result = std::log(z);
+        break;
+    case ElementaryFunction::Power:
+        result = std::pow(z, std::complex<long double>(b.getReal(), b.getImaginary()));
+        break;
+    case ElementaryFunction::Sine:
+        result = std::sin(z);
+        break;
+    case ElementaryFunction::Cosine:
+        result = std::cos(z);
+        break;
+    case ElementaryFunction::Tangent:
+        result = std::tan(z);
+        break;
+    case ElementaryFunction::HyperbolicSine:
+        result = std::sinh(z);
+        break;
+    case ElementaryFunction::HyperbolicCosine:
+        result = std::cosh(z);
+        break;
+    case ElementaryFunction::HyperbolicTangent:
+        result = std::tanh(z);
+        break;
+    }
+    return BasicComplex<long double>(result.real(), result.imag());
+}
+
+#ifdef COMPLEXCALC_HAS_FLOAT128
+/**
+ * @brief One elementary function in __float128, from the real quad precision functions.
+ *
+ * std::complex does not support __float128, so these are the textbook formulas;
+ * tan and tanh use the double angle form, which stays finite for large imaginary
+ * (real) parts only up to the overflow of cosh.
+ */
+BasicComplex<__float128> evaluate(ElementaryFunction function, const BasicComplex<__float128> &a,
+                                  const BasicComplex<__float128> &b) noexcept
+{
+    using Quad = BasicComplex<__float128>;
+    const __float128 x = a.getReal(), y = a.getImaginary();
+    switch (function) {
+    case ElementaryFunction::Exponential: {
+        const __float128 modulus = expf128(x);
+        return Quad(modulus * cosf128(y), modulus * sinf128(y));
+    }
+    case ElementaryFunction::Logarithm:
+        return Quad(logf128(hypotf128(x, y)), atan2f128(y, x));
+    case ElementaryFunction::Power:
+        if (x == 0 && y == 0) {
+            return Quad(0, 0);
+        }
+        return evaluate(ElementaryFunction::Exponential,
+                        b * evaluate(ElementaryFunction::Logarithm, a, b), b);
+    case ElementaryFunction::Sine:
+        return Quad(sinf128(x) * coshf128(y), cosf128(x) * sinhf128(y));
+    case ElementaryFunction::Cosine:
+        return Quad(cosf128(x) * coshf128(y), -sinf128(x) * sinhf128(y));
+    case ElementaryFunction::Tangent: {
+        const __float128 denominator = cosf128(2 * x) + coshf128(2 * y);
+        return Quad(sinf128(2 * x) / denominator, sinhf128(2 * y) / denominator);
+    }
+    case ElementaryFunction::HyperbolicSine:
+        return Quad(sinhf128(x) * cosf128(y), coshf128(x) * sinf128(y));
+    case ElementaryFunction::HyperbolicCosine:
+        return Quad(coshf128(x) * cosf128(y), sinhf128(x) * sinf128(y));
+    case ElementaryFunction::HyperbolicTangent: {
+        const __float128 denominator = coshf128(2 * x) + cosf128(2 * y);
+        return Quad(sinhf128(2 * x) / denominator, sinf128(2 * y) / denominator);
+    }
+    }
+    return a;
+}
+#endif
+
+} // namespace
+
+/**
+ * @brief Complex exponential e^z.
+ *
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::exponential() const noexcept
+{
+    return evaluate(ElementaryFunction::Exponential, *this, *this);
+}
+
+/**
+ * @brief Principal natural logarithm.
+ *
+ * @return result, imaginary part in [-pi, pi] (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::logarithm() const noexcept
+{
+    return evaluate(ElementaryFunction::Logarithm, *this, *this);
+}
+
+/**
+ * @brief Principal value of the power e^(exponent log z).
+ *
+ * @param exponent exponent (const BasicComplex&).
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::power(const BasicComplex &exponent) const noexcept
+{
+    return evaluate(ElementaryFunction::Power, *this, exponent);
+}
+
+/**
+ * @brief Complex sine.
+ *
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::sine() const noexcept
+{
+    return evaluate(ElementaryFunction::Sine, *this, *this);
+}
+
+/**
+ * @brief Complex cosine.
+ *
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::cosine() const noexcept
+{
+    return evaluate(ElementaryFunction::Cosine, *this, *this);
+}
+
+/**
+ * @brief Complex tangent.
+ *
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::tangent() const noexcept
+{
+    return evaluate(ElementaryFunction::Tangent, *this, *this);
+}
+
+/**
+ * @brief Complex hyperbolic sine.
+ *
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::hyperbolicSine() const noexcept
+{
+    return evaluate(ElementaryFunction::HyperbolicSine, *this, *this);
+}
+
+/**
+ * @brief Complex hyperbolic cosine.
+ *
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::hyperbolicCosine() const noexcept
+{
+    return evaluate(ElementaryFunction::HyperbolicCosine, *this, *this);
+}
+
+/**
+ * @brief Complex hyperbolic tangent.
+ *
+ * @return result (BasicComplex).
+ */
+template<typename T>
+BasicComplex<T> BasicComplex<T>::hyperbolicTangent() const noexcept
+{
+    return evaluate(ElementaryFunction::HyperbolicTangent, *this, *this);
+}
+
+template class BasicComplex<float>;
+template class BasicComplex<double>;
+template class BasicComplex<long double>;
+#ifdef COMPLEXCALC_HAS_FLOAT128
+template class BasicComplex<__float128>;
+#endif
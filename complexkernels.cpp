@@ -0,0 +1,240 @@
+#include "complexkernels.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// The scalar kernels spell out the same expressions as the ComplexNumber methods.
+
+void addScalar(const double *ar, const double *ai, const double *br, const double *bi,
+               double *rr, double *ri, std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        rr[k] = ar[k] + br[k];
+        ri[k] = ai[k] + bi[k];
+    }
+}
+
+void subtractScalar(const double *ar, const double *ai, const double *br, const double *bi,
+                    double *rr, double *ri, std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        rr[k] = ar[k] - br[k];
+        ri[k] = ai[k] - bi[k];
+    }
+}
+
+void multiplyScalar(const double *ar, const double *ai, const double *br, const double *bi,
+                    double *rr, double *ri, std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        const double a = ar[k], b = ai[k], c = br[k], d = bi[k];
+        rr[k] = a * c - b * d;
+        ri[k] = a * d + b * c;
+    }
+}
+
+/**
+ * @brief Records a zero divisor at element index of the mask.
+ */
+void markZero(std::uint64_t *mask, std::size_t index)
+{
+    if (mask) {
+        mask[index / 64] |= std::uint64_t(1) << (index % 64);
+    }
+}
+
+std::size_t divideScalar(const double *ar, const double *ai, const double *br, const double *bi,
+                         double *rr, double *ri, std::size_t n,
+                         std::uint64_t *mask, std::size_t maskBase)
+{
+    std::size_t zeros = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        const double a = ar[k], b = ai[k], c = br[k], d = bi[k];
+        if (c == 0 && d == 0) {
+            ++zeros;
+            markZero(mask, maskBase + k);
+        }
+        const double denominator = c * c + d * d;
+        rr[k] = (a * c + b * d) / denominator;
+        ri[k] = (b * c - a * d) / denominator;
+    }
+    return zeros;
+}
+
+void conjugateScalar(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        rr[k] = ar[k];
+        ri[k] = -ai[k];
+    }
+}
+
+std::size_t inverseScalar(const double *ar, const double *ai, double *rr, double *ri, std::size_t n,
+                          std::uint64_t *mask, std::size_t maskBase)
+{
+    std::size_t zeros = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        const double a = ar[k], b = ai[k];
+        const double denominator = a * a + b * b;
+        if (denominator == 0) {
+            ++zeros;
+            markZero(mask, maskBase + k);
+        }
+        rr[k] = a / denominator;
+        ri[k] = -b / denominator;
+    }
+    return zeros;
+}
+
+void absoluteValueScalar(const double *ar, const double *ai, double *out, std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        out[k] = std::sqrt(ar[k] * ar[k] + ai[k] * ai[k]);
+    }
+}
+
+void rootScalar(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        const double a = ar[k], b = ai[k];
+        const double absValue = std::sqrt(a * a + b * b);
+        const double norm = (b < 0) ? -1 : 1;
+        rr[k] = std::sqrt((absValue + a) / 2);
+        ri[k] = norm * std::sqrt((absValue - a) / 2);
+    }
+}
+
+// Reduction kernels: element k goes to lane k % ReductionLanes, with the same
+// comparisons as the vector versions (false for NaN).
+
+void sumScalar(const double *ar, const double *ai, std::size_t n, SumLanes &lanes)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t lane = k % ReductionLanes;
+        const double nextReal = lanes.real[lane] + ar[k];
+        lanes.realError[lane] += std::fabs(lanes.real[lane]) < std::fabs(ar[k])
+                                     ? (ar[k] - nextReal) + lanes.real[lane]
+                                     : (lanes.real[lane] - nextReal) + ar[k];
+        lanes.real[lane] = nextReal;
+
+        const double nextImaginary = lanes.imaginary[lane] + ai[k];
+        lanes.imaginaryError[lane] += std::fabs(lanes.imaginary[lane]) < std::fabs(ai[k])
+                                          ? (ai[k] - nextImaginary) + lanes.imaginary[lane]
+                                          : (lanes.imaginary[lane] - nextImaginary) + ai[k];
+        lanes.imaginary[lane] = nextImaginary;
+    }
+}
+
+void modulusExtremesScalar(const double *ar, const double *ai, std::size_t n, double first,
+                           ModulusLanes &lanes)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t lane = k % ReductionLanes;
+        const double modulus = ar[k] * ar[k] + ai[k] * ai[k];
+        if (modulus < lanes.min[lane]) {
+            lanes.min[lane] = modulus;
+            lanes.minIndex[lane] = first + static_cast<double>(k);
+        }
+        if (lanes.max[lane] < modulus) {
+            lanes.max[lane] = modulus;
+            lanes.maxIndex[lane] = first + static_cast<double>(k);
+        }
+    }
+}
+
+void boundsScalar(const double *ar, const double *ai, std::size_t n, BoundsLanes &lanes)
+{
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t lane = k % ReductionLanes;
+        lanes.minReal[lane] = ar[k] < lanes.minReal[lane] ? ar[k] : lanes.minReal[lane];
+        lanes.maxReal[lane] = lanes.maxReal[lane] < ar[k] ? ar[k] : lanes.maxReal[lane];
+        lanes.minImaginary[lane] = ai[k] < lanes.minImaginary[lane] ? ai[k] : lanes.minImaginary[lane];
+        lanes.maxImaginary[lane] = lanes.maxImaginary[lane] < ai[k] ? ai[k] : lanes.maxImaginary[lane];
+    }
+}
+
+// The FFT pass, the escape-time kernel and the elementary functions are generic
+// enough to share: instantiate them with one double per lane.
+#include "complexkernels_impl.h"
+
+/**
+ * @brief Detects the best kernel table for this CPU.
+ */
+const ComplexKernels &detectKernels()
+{
+#ifdef COMPLEXCALC_X86_KERNELS
+    __builtin_cpu_init();
+
+    const char *forced = std::getenv("COMPLEXCALC_SIMD");
+    if (forced) {
+        if (std::strcmp(forced, "scalar") == 0) {
+            return scalarKernels;
+        }
+        if (std::strcmp(forced, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+            return sse2Kernels;
+        }
+        if (std::strcmp(forced, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+            return avx2Kernels;
+        }
+        if (std::strcmp(forced, "avx512") == 0 && __builtin_cpu_supports("avx512f")) {
+            return avx512Kernels;
+        }
+    }
+
+    if (__builtin_cpu_supports("avx512f")) {
+        return avx512Kernels;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return avx2Kernels;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return sse2Kernels;
+    }
+#endif
+    return scalarKernels;
+}
+
+} // namespace
+
+const ComplexKernels scalarKernels = {
+    "scalar",
+    addScalar,
+    subtractScalar,
+    multiplyScalar,
+    divideScalar,
+    conjugateScalar,
+    inverseScalar,
+    absoluteValueScalar,
+    rootScalar,
+    sumScalar,
+    modulusExtremesScalar,
+    boundsScalar,
+    fftPassKernel<ScalarLane>,
+    escapeTimeKernel<ScalarLane>,
+    exponentialKernel<ScalarLane>,
+    logarithmKernel<ScalarLane>,
+    powerKernel<ScalarLane>,
+    sineKernel<ScalarLane>,
+    cosineKernel<ScalarLane>,
+    tangentKernel<ScalarLane>,
+    hyperbolicSineKernel<ScalarLane>,
+    hyperbolicCosineKernel<ScalarLane>,
+    hyperbolicTangentKernel<ScalarLane>,
+    polynomialKernel<ScalarLane>,
+    aberthSumKernel<ScalarLane>,
+    gemmTileKernel<ScalarLane>,
+};
+
+/**
+ * @brief Kernels for the best instruction set supported by the CPU.
+ *
+ * @return kernel table (const ComplexKernels&).
+ */
+const ComplexKernels &activeKernels()
+{
+    static const ComplexKernels &kernels = detectKernels();
+    return kernels;
+}
@@ -0,0 +1,307 @@
+#ifndef COMPLEXKERNELS_H
+#define COMPLEXKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Number of independent accumulators kept by the reduction kernels.
+ *
+ * Element k of a reduction call goes to lane k % ReductionLanes. The count is the
+ * same for every instruction set, so reductions give the same bits whichever
+ * kernels run.
+ */
+constexpr std::size_t ReductionLanes = 8;
+
+/**
+ * @brief State of the sum kernel: one Neumaier-compensated sum per lane and part.
+ */
+struct SumLanes {
+    double real[ReductionLanes];
+    double realError[ReductionLanes];
+    double imaginary[ReductionLanes];
+    double imaginaryError[ReductionLanes];
+};
+
+/**
+ * @brief State of the modulus kernel: smallest and largest squared modulus per lane.
+ *
+ * Indices are stored as doubles (exact below 2^53) so they can live in vector
+ * registers; -1 marks a lane that has not seen an ordered value.
+ */
+struct ModulusLanes {
+    double min[ReductionLanes];
+    double minIndex[ReductionLanes];
+    double max[ReductionLanes];
+    double maxIndex[ReductionLanes];
+};
+
+/**
+ * @brief State of the bounds kernel: bounding box per lane, NaN parts are ignored.
+ */
+struct BoundsLanes {
+    double minReal[ReductionLanes];
+    double maxReal[ReductionLanes];
+    double minImaginary[ReductionLanes];
+    double maxImaginary[ReductionLanes];
+};
+
+/**
+ * @brief One radix pass of a Stockham FFT (see FftPlan).
+ *
+ * For p in [0, m) and q in [0, stride) the pass reads the radix inputs
+ * x[q + stride * (p + j * m)], takes their DFT and writes output k, multiplied by
+ * the twiddle factor of (p, k), to y[q + stride * (radix * p + k)].
+ */
+struct FftPass {
+    /** @brief 2, 3, 4 or 5. */
+    std::size_t radix;
+
+    /** @brief Length of the sub-transforms after this pass. */
+    std::size_t m;
+
+    /** @brief Distance between the elements of one sub-transform. */
+    std::size_t stride;
+
+    /** @brief Twiddle factors, (radix - 1) per p, for k = 1 .. radix - 1. */
+    const double *twiddleReal;
+    const double *twiddleImaginary;
+};
+
+/**
+ * @brief Squared modulus at which an escape-time iteration stops.
+ *
+ * A radius of 16 rather than the minimal 2 makes the continuous iteration count
+ * used for colouring smooth.
+ */
+constexpr double EscapeRadiusSquared = 256;
+
+/**
+ * @brief One row of points for the escape-time kernel (see FractalRenderer).
+ *
+ * Point k is (real + k * step, imaginary). For the Mandelbrot set the point is c and
+ * z starts at zero; for a Julia set z starts at the point and c is fixed.
+ */
+struct EscapeRow {
+    double real;
+    double step;
+    double imaginary;
+
+    /** @brief Whether to iterate the Julia set of (cReal, cImaginary). */
+    bool julia;
+    double cReal;
+    double cImaginary;
+
+    unsigned maxIterations;
+};
+
+/**
+ * @brief Complex elementary functions with a batch kernel.
+ */
+enum class ElementaryFunction {
+    Exponential,
+    Logarithm,
+    Power,
+    Sine,
+    Cosine,
+    Tangent,
+    HyperbolicSine,
+    HyperbolicCosine,
+    HyperbolicTangent
+};
+
+/**
+ * @brief One element of an elementary function outside the fast domain of the kernels.
+ *
+ * Computed with std::complex, which follows C99 Annex G for infinities, NaNs, signed
+ * zeros and arguments too large for the kernel range reductions.
+ *
+ * @param function function to be evaluated (ElementaryFunction).
+ * @param ar real part of the argument (double).
+ * @param ai imaginary part of the argument (double).
+ * @param br real part of the exponent, only used by Power (double).
+ * @param bi imaginary part of the exponent, only used by Power (double).
+ * @param rr receives the real part of the result (double&).
+ * @param ri receives the imaginary part of the result (double&).
+ */
+void elementaryFallback(ElementaryFunction function, double ar, double ai, double br, double bi, double &rr,
+                        double &ri);
+
+/**
+ * @brief Evaluation order of the polynomial kernel.
+ */
+enum class PolynomialScheme {
+    /** @brief c0 + z (c1 + z (c2 + ...)), one dependent multiply-add per coefficient. */
+    Horner,
+
+    /**
+     * @brief Horner in z^4 over blocks (c0 + c1 z) + (c2 + c3 z) z^2 of four coefficients.
+     *
+     * The blocks do not depend on each other, so they overlap with the chain, which
+     * is a quarter as long as Horner's.
+     */
+    Estrin
+};
+
+/**
+ * @brief Rows of the tile of C updated by one gemmTile call.
+ */
+constexpr std::size_t GemmTileRows = 4;
+
+/**
+ * @brief Columns of the tile of C updated by one gemmTile call, a multiple of every vector width.
+ */
+constexpr std::size_t GemmTileColumns = 8;
+
+/**
+ * @brief Table of element-wise kernels over split real/imaginary arrays.
+ *
+ * Every kernel works on n elements. Arguments named *r hold real parts, *i imaginary
+ * parts. Each instruction set provides one table; activeKernels() picks the best one
+ * the CPU supports at runtime.
+ *
+ * divide and inverse never throw: a zero divisor gives NaN parts (IEEE semantics),
+ * is counted in the return value and, when mask is not null, sets bit
+ * (maskBase + k) of the mask for element k. The mask must be zeroed by the caller.
+ *
+ * The reduction kernels (sum, modulusExtremes, bounds) fold n elements into lane
+ * state supplied by the caller, so long arrays can be reduced chunk by chunk.
+ *
+ * The elementary function kernels (exponential to hyperbolicTangent) evaluate their
+ * own polynomial approximations of exp, log, sin, cos and atan on a fast domain of
+ * finite arguments of moderate size, within a few ulps of the exact result; lanes
+ * outside it go through elementaryFallback(). The ComplexNumber methods of the same
+ * names run the scalar kernels.
+ *
+ * polynomial evaluates one polynomial at many points. Each scheme gives the same bits
+ * with every instruction set, but the two schemes round differently.
+ *
+ * gemmTile is the inner loop of the matrix product: it keeps one tile of C in
+ * registers while it streams packed panels of A and B.
+ *
+ * The kernels perform exactly the same floating-point operations, in the same order,
+ * as the corresponding ComplexNumber methods, so results are bit-for-bit identical to
+ * the scalar code (the library is built with -ffp-contract=off to keep it that way).
+ */
+struct ComplexKernels {
+    /** @brief Name of the instruction set ("scalar", "sse2", "avx2", "avx512"). */
+    const char *name;
+
+    void (*add)(const double *ar, const double *ai, const double *br, const double *bi,
+                double *rr, double *ri, std::size_t n);
+    void (*subtract)(const double *ar, const double *ai, const double *br, const double *bi,
+                     double *rr, double *ri, std::size_t n);
+    void (*multiply)(const double *ar, const double *ai, const double *br, const double *bi,
+                     double *rr, double *ri, std::size_t n);
+
+    /** @brief Divides a by b, returns the number of zero divisors. */
+    std::size_t (*divide)(const double *ar, const double *ai, const double *br, const double *bi,
+                          double *rr, double *ri, std::size_t n,
+                          std::uint64_t *mask, std::size_t maskBase);
+
+    void (*conjugate)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+
+    /** @brief Inverts a, returns the number of elements with a zero modulus. */
+    std::size_t (*inverse)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n,
+                           std::uint64_t *mask, std::size_t maskBase);
+
+    void (*absoluteValue)(const double *ar, const double *ai, double *out, std::size_t n);
+    void (*root)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+
+    /** @brief Adds a to the compensated lane sums. */
+    void (*sum)(const double *ar, const double *ai, std::size_t n, SumLanes &lanes);
+
+    /**
+     * @brief Tracks the first elements of smallest and largest squared modulus.
+     *
+     * first is the index reported for element 0 of a.
+     */
+    void (*modulusExtremes)(const double *ar, const double *ai, std::size_t n, double first,
+                            ModulusLanes &lanes);
+
+    /** @brief Widens the lane bounding boxes to cover a. */
+    void (*bounds)(const double *ar, const double *ai, std::size_t n, BoundsLanes &lanes);
+
+    /**
+     * @brief Runs the part p in [pBegin, pEnd), q in [qBegin, qEnd) of a forward FFT pass.
+     *
+     * Vectorized over q. x and y must not overlap.
+     */
+    void (*fftPass)(const FftPass &pass, const double *xr, const double *xi, double *yr, double *yi,
+                    std::size_t pBegin, std::size_t pEnd, std::size_t qBegin, std::size_t qEnd);
+
+    /**
+     * @brief Iterates z = z^2 + c for n points of a row until |z|^2 >= EscapeRadiusSquared.
+     *
+     * Writes the number of iterations done (maxIterations for points that did not
+     * escape) and the final squared modulus of z.
+     */
+    void (*escapeTime)(const EscapeRow &row, std::size_t n, double *iterations, double *modulus2);
+
+    /** @brief e^a. */
+    void (*exponential)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+
+    /** @brief Principal logarithm of a, imaginary part in [-pi, pi]. */
+    void (*logarithm)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+
+    /** @brief Principal value of a^b = e^(b log a). */
+    void (*power)(const double *ar, const double *ai, const double *br, const double *bi,
+                  double *rr, double *ri, std::size_t n);
+
+    void (*sine)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+    void (*cosine)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+    void (*tangent)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+    void (*hyperbolicSine)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+    void (*hyperbolicCosine)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+    void (*hyperbolicTangent)(const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+
+    /**
+     * @brief Evaluates c[0] + c[1] a + ... + c[terms - 1] a^(terms - 1), terms > 0.
+     *
+     * The outputs may alias a.
+     */
+    void (*polynomial)(const double *cr, const double *ci, std::size_t terms, PolynomialScheme scheme,
+                       const double *ar, const double *ai, double *rr, double *ri, std::size_t n);
+
+    /**
+     * @brief Aberth sums r[k] = sum over j < m of 1 / (a[k] - b[j]), for k < n.
+     *
+     * Terms with a[k] = b[j] are left out, so b may contain the points a.
+     */
+    void (*aberthSum)(const double *ar, const double *ai, std::size_t n, const double *br, const double *bi,
+                      std::size_t m, double *rr, double *ri);
+    /**
+     * @brief C += A B for one GemmTileRows x GemmTileColumns tile of C (see ComplexMatrix).
+     *
+     * For each p < depth, a holds the GemmTileRows real parts of column p of A followed
+     * by their imaginary parts, and b the GemmTileColumns real parts of row p of B
+     * followed by their imaginary parts. Row i of the tile starts at cr + i * stride
+     * and ci + i * stride. Every element adds its products in order of p, each rounded
+     * as by ComplexNumber::multiply and added as by ComplexNumber::add.
+     */
+    void (*gemmTile)(std::size_t depth, const double *a, const double *b, double *cr, double *ci,
+                     std::size_t stride);
+};
+
+/**
+ * @brief Portable kernels, also used for the tails of the vectorized ones.
+ */
+extern const ComplexKernels scalarKernels;
+
+#ifdef COMPLEXCALC_X86_KERNELS
+extern const ComplexKernels sse2Kernels;
+extern const ComplexKernels avx2Kernels;
+extern const ComplexKernels avx512Kernels;
+#endif
+
+/**
+ * @brief Kernels for the best instruction set supported by the CPU.
+ *
+ * The choice can be forced with the COMPLEXCALC_SIMD environment variable
+ * (scalar, sse2, avx2 or avx512); unsupported requests fall back to detection.
+ *
+ * @return kernel table (const ComplexKernels&).
+ */
+const ComplexKernels &activeKernels();
+
+#endif // COMPLEXKERNELS_H
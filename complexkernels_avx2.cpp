@@ -0,0 +1,78 @@
+#include "complexkernels.h"
+
+#include <immintrin.h>
+
+namespace {
+
+/**
+ * @brief AVX2 trait - four doubles per register.
+ */
+struct Avx2 {
+    using T = __m256d;
+    static constexpr std::size_t width = 4;
+
+    static T load(const double *p) { return _mm256_loadu_pd(p); }
+    static void store(double *p, T a) { _mm256_storeu_pd(p, a); }
+    static T set1(double a) { return _mm256_set1_pd(a); }
+    static T add(T a, T b) { return _mm256_add_pd(a, b); }
+    static T sub(T a, T b) { return _mm256_sub_pd(a, b); }
+    static T mul(T a, T b) { return _mm256_mul_pd(a, b); }
+    static T div(T a, T b) { return _mm256_div_pd(a, b); }
+    static T sqrt(T a) { return _mm256_sqrt_pd(a); }
+    static T neg(T a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+    static T abs(T a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+    static T lessSelect(T x, T y, T a, T b)
+    {
+        return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, y, _CMP_LT_OQ));
+    }
+
+    static T signFactor(T a)
+    {
+        const T negative = _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_LT_OQ);
+        return _mm256_blendv_pd(_mm256_set1_pd(1.0), _mm256_set1_pd(-1.0), negative);
+    }
+
+    static unsigned zeroMask(T a)
+    {
+        return static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_EQ_OQ)));
+    }
+
+    static unsigned bothZeroMask(T a, T b)
+    {
+        const T zero = _mm256_setzero_pd();
+        return static_cast<unsigned>(_mm256_movemask_pd(
+            _mm256_and_pd(_mm256_cmp_pd(a, zero, _CMP_EQ_OQ), _mm256_cmp_pd(b, zero, _CMP_EQ_OQ))));
+    }
+
+    static T copySign(T a, T b)
+    {
+        const T sign = _mm256_set1_pd(-0.0);
+        return _mm256_or_pd(_mm256_andnot_pd(sign, a), _mm256_and_pd(sign, b));
+    }
+
+    static T scale(T a, T k)
+    {
+        // As in Sse2::scale.
+        const __m256i bits = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(0x1.8p52)));
+        return _mm256_mul_pd(
+            a, _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52)));
+    }
+
+    static T splitExponent(T a, T &exponent)
+    {
+        const __m256i bits = _mm256_castpd_si256(a);
+        const T biased = _mm256_castsi256_pd(
+            _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x4330000000000000)));
+        exponent = _mm256_sub_pd(biased, _mm256_set1_pd(0x1p52 + 1023));
+        const T fraction = _mm256_castsi256_pd(_mm256_set1_epi64x(0x000fffffffffffff));
+        return _mm256_or_pd(_mm256_and_pd(a, fraction), _mm256_set1_pd(1.0));
+    }
+};
+
+#include "complexkernels_impl.h"
+
+} // namespace
+
+extern const ComplexKernels avx2Kernels = makeKernels<Avx2>("avx2");
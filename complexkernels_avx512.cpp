@@ -0,0 +1,74 @@
+#include "complexkernels.h"
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace {
+
+/**
+ * @brief AVX-512 trait - eight doubles per register.
+ */
+struct Avx512 {
+    using T = __m512d;
+    static constexpr std::size_t width = 8;
+
+    static T load(const double *p) { return _mm512_loadu_pd(p); }
+    static void store(double *p, T a) { _mm512_storeu_pd(p, a); }
+    static T set1(double a) { return _mm512_set1_pd(a); }
+    static T add(T a, T b) { return _mm512_add_pd(a, b); }
+    static T sub(T a, T b) { return _mm512_sub_pd(a, b); }
+    static T mul(T a, T b) { return _mm512_mul_pd(a, b); }
+    static T div(T a, T b) { return _mm512_div_pd(a, b); }
+    static T sqrt(T a) { return _mm512_sqrt_pd(a); }
+
+    static T neg(T a)
+    {
+        return _mm512_castsi512_pd(
+            _mm512_xor_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(INT64_MIN)));
+    }
+
+    static T abs(T a) { return _mm512_abs_pd(a); }
+
+    static T lessSelect(T x, T y, T a, T b)
+    {
+        return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, y, _CMP_LT_OQ), b, a);
+    }
+
+    static T signFactor(T a)
+    {
+        const __mmask8 negative = _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_LT_OQ);
+        return _mm512_mask_blend_pd(negative, _mm512_set1_pd(1.0), _mm512_set1_pd(-1.0));
+    }
+
+    static unsigned zeroMask(T a)
+    {
+        return _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_EQ_OQ);
+    }
+
+    static unsigned bothZeroMask(T a, T b)
+    {
+        const T zero = _mm512_setzero_pd();
+        return _mm512_cmp_pd_mask(a, zero, _CMP_EQ_OQ) & _mm512_cmp_pd_mask(b, zero, _CMP_EQ_OQ);
+    }
+
+    static T copySign(T a, T b)
+    {
+        const __m512i sign = _mm512_set1_epi64(INT64_MIN);
+        return _mm512_castsi512_pd(_mm512_or_si512(_mm512_andnot_si512(sign, _mm512_castpd_si512(a)),
+                                                   _mm512_and_si512(sign, _mm512_castpd_si512(b))));
+    }
+
+    static T scale(T a, T k) { return _mm512_scalef_pd(a, k); }
+
+    static T splitExponent(T a, T &exponent)
+    {
+        exponent = _mm512_getexp_pd(a);
+        return _mm512_getmant_pd(a, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero);
+    }
+};
+
+#include "complexkernels_impl.h"
+
+} // namespace
+
+extern const ComplexKernels avx512Kernels = makeKernels<Avx512>("avx512");
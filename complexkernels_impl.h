@@ -0,0 +1,1261 @@
+// Generic vector kernels, parameterized on an instruction-set trait V.
+//
+// This file is included inside an anonymous namespace by each complexkernels_<isa>.cpp
+// translation unit, after the trait has been defined, so every instantiation gets
+// internal linkage and code built with wider instruction sets never leaks into the
+// rest of the program. Do not include standard headers from here.
+//
+// The trait provides: type T, width, load, store, set1, add, sub, mul, div, sqrt, neg,
+// abs, signFactor (±1 from the sign of the imaginary part, as in ComplexNumber::root),
+// lessSelect(x, y, a, b) (x < y ? a : b per lane, false for NaN), zeroMask(a) and
+// bothZeroMask(a, b) (lane bitmasks), copySign(a, b), scale(a, k) (a * 2^k for an
+// integral k in [-1022, 1023]) and splitExponent(a, exponent) (the mantissa in [1, 2)
+// of a positive normal a, its exponent stored as a double).
+//
+// Only whole vectors are processed; the remaining elements go through scalarKernels.
+// The FFT pass, the escape-time kernel, the elementary functions, the polynomial
+// kernel and the Aberth sums instead handle their tails with ScalarLane below, which is also the trait the scalar table
+// instantiates them with. The GEMM tile has no tails.
+
+/**
+ * @brief Trait with one double per "register", for tails and the scalar kernel table.
+ */
+struct ScalarLane {
+    using T = double;
+    static constexpr std::size_t width = 1;
+
+    static T load(const double *p) { return *p; }
+    static void store(double *p, T a) { *p = a; }
+    static T set1(double a) { return a; }
+    static T add(T a, T b) { return a + b; }
+    static T sub(T a, T b) { return a - b; }
+    static T mul(T a, T b) { return a * b; }
+    static T div(T a, T b) { return a / b; }
+    static T neg(T a) { return -a; }
+    static T abs(T a) { return __builtin_fabs(a); }
+    static T lessSelect(T x, T y, T a, T b) { return x < y ? a : b; }
+    static unsigned zeroMask(T a) { return a == 0 ? 1u : 0u; }
+    static T copySign(T a, T b) { return __builtin_copysign(a, b); }
+    static T scale(T a, T k) { return __builtin_ldexp(a, static_cast<int>(k)); }
+
+    static T splitExponent(T a, T &exponent)
+    {
+        int power;
+        const T mantissa = __builtin_frexp(a, &power);
+        exponent = power - 1;
+        return 2 * mantissa;
+    }
+};
+
+/**
+ * @brief Adds the lane bits of one vector to the error mask, returns the lane count.
+ */
+inline std::size_t recordZeros(unsigned lanes, std::uint64_t *mask, std::size_t index)
+{
+    std::size_t zeros = 0;
+    for (; lanes != 0; lanes &= lanes - 1) {
+        const std::size_t bit = index + __builtin_ctz(lanes);
+        if (mask) {
+            mask[bit / 64] |= std::uint64_t(1) << (bit % 64);
+        }
+        ++zeros;
+    }
+    return zeros;
+}
+
+template<typename V>
+void addKernel(const double *ar, const double *ai, const double *br, const double *bi,
+               double *rr, double *ri, std::size_t n)
+{
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        V::store(rr + k, V::add(V::load(ar + k), V::load(br + k)));
+        V::store(ri + k, V::add(V::load(ai + k), V::load(bi + k)));
+    }
+    scalarKernels.add(ar + k, ai + k, br + k, bi + k, rr + k, ri + k, n - k);
+}
+
+template<typename V>
+void subtractKernel(const double *ar, const double *ai, const double *br, const double *bi,
+                    double *rr, double *ri, std::size_t n)
+{
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        V::store(rr + k, V::sub(V::load(ar + k), V::load(br + k)));
+        V::store(ri + k, V::sub(V::load(ai + k), V::load(bi + k)));
+    }
+    scalarKernels.subtract(ar + k, ai + k, br + k, bi + k, rr + k, ri + k, n - k);
+}
+
+template<typename V>
+void multiplyKernel(const double *ar, const double *ai, const double *br, const double *bi,
+                    double *rr, double *ri, std::size_t n)
+{
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        const typename V::T a = V::load(ar + k), b = V::load(ai + k);
+        const typename V::T c = V::load(br + k), d = V::load(bi + k);
+        V::store(rr + k, V::sub(V::mul(a, c), V::mul(b, d)));
+        V::store(ri + k, V::add(V::mul(a, d), V::mul(b, c)));
+    }
+    scalarKernels.multiply(ar + k, ai + k, br + k, bi + k, rr + k, ri + k, n - k);
+}
+
+template<typename V>
+std::size_t divideKernel(const double *ar, const double *ai, const double *br, const double *bi,
+                         double *rr, double *ri, std::size_t n,
+                         std::uint64_t *mask, std::size_t maskBase)
+{
+    std::size_t zeros = 0;
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        const typename V::T a = V::load(ar + k), b = V::load(ai + k);
+        const typename V::T c = V::load(br + k), d = V::load(bi + k);
+        const unsigned lanes = V::bothZeroMask(c, d);
+        if (lanes != 0) {
+            zeros += recordZeros(lanes, mask, maskBase + k);
+        }
+        const typename V::T denominator = V::add(V::mul(c, c), V::mul(d, d));
+        V::store(rr + k, V::div(V::add(V::mul(a, c), V::mul(b, d)), denominator));
+        V::store(ri + k, V::div(V::sub(V::mul(b, c), V::mul(a, d)), denominator));
+    }
+    return zeros + scalarKernels.divide(ar + k, ai + k, br + k, bi + k, rr + k, ri + k, n - k,
+                                        mask, maskBase + k);
+}
+
+template<typename V>
+void conjugateKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        V::store(rr + k, V::load(ar + k));
+        V::store(ri + k, V::neg(V::load(ai + k)));
+    }
+    scalarKernels.conjugate(ar + k, ai + k, rr + k, ri + k, n - k);
+}
+
+template<typename V>
+std::size_t inverseKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n,
+                          std::uint64_t *mask, std::size_t maskBase)
+{
+    std::size_t zeros = 0;
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        const typename V::T a = V::load(ar + k), b = V::load(ai + k);
+        const typename V::T denominator = V::add(V::mul(a, a), V::mul(b, b));
+        const unsigned lanes = V::zeroMask(denominator);
+        if (lanes != 0) {
+            zeros += recordZeros(lanes, mask, maskBase + k);
+        }
+        V::store(rr + k, V::div(a, denominator));
+        V::store(ri + k, V::div(V::neg(b), denominator));
+    }
+    return zeros + scalarKernels.inverse(ar + k, ai + k, rr + k, ri + k, n - k, mask, maskBase + k);
+}
+
+template<typename V>
+void absoluteValueKernel(const double *ar, const double *ai, double *out, std::size_t n)
+{
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        const typename V::T a = V::load(ar + k), b = V::load(ai + k);
+        V::store(out + k, V::sqrt(V::add(V::mul(a, a), V::mul(b, b))));
+    }
+    scalarKernels.absoluteValue(ar + k, ai + k, out + k, n - k);
+}
+
+template<typename V>
+void rootKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const typename V::T two = V::set1(2.0);
+    std::size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        const typename V::T a = V::load(ar + k), b = V::load(ai + k);
+        const typename V::T absValue = V::sqrt(V::add(V::mul(a, a), V::mul(b, b)));
+        V::store(rr + k, V::sqrt(V::div(V::add(absValue, a), two)));
+        V::store(ri + k, V::mul(V::signFactor(b), V::sqrt(V::div(V::sub(absValue, a), two))));
+    }
+    scalarKernels.root(ar + k, ai + k, rr + k, ri + k, n - k);
+}
+
+/**
+ * @brief One Neumaier step per lane, the same expression as in the scalar sum kernel.
+ */
+template<typename V>
+inline void accumulateLanes(typename V::T &sum, typename V::T &error, typename V::T value)
+{
+    const typename V::T next = V::add(sum, value);
+    error = V::add(error, V::lessSelect(V::abs(sum), V::abs(value), V::add(V::sub(value, next), sum),
+                                        V::add(V::sub(sum, next), value)));
+    sum = next;
+}
+
+// The reduction kernels keep ReductionLanes / width vectors of state in registers.
+
+template<typename V>
+void sumKernel(const double *ar, const double *ai, std::size_t n, SumLanes &lanes)
+{
+    constexpr std::size_t vectors = ReductionLanes / V::width;
+    typename V::T real[vectors], realError[vectors], imaginary[vectors], imaginaryError[vectors];
+    for (std::size_t j = 0; j < vectors; ++j) {
+        real[j] = V::load(lanes.real + j * V::width);
+        realError[j] = V::load(lanes.realError + j * V::width);
+        imaginary[j] = V::load(lanes.imaginary + j * V::width);
+        imaginaryError[j] = V::load(lanes.imaginaryError + j * V::width);
+    }
+    std::size_t k = 0;
+    for (; k + ReductionLanes <= n; k += ReductionLanes) {
+        for (std::size_t j = 0; j < vectors; ++j) {
+            accumulateLanes<V>(real[j], realError[j], V::load(ar + k + j * V::width));
+            accumulateLanes<V>(imaginary[j], imaginaryError[j], V::load(ai + k + j * V::width));
+        }
+    }
+    for (std::size_t j = 0; j < vectors; ++j) {
+        V::store(lanes.real + j * V::width, real[j]);
+        V::store(lanes.realError + j * V::width, realError[j]);
+        V::store(lanes.imaginary + j * V::width, imaginary[j]);
+        V::store(lanes.imaginaryError + j * V::width, imaginaryError[j]);
+    }
+    scalarKernels.sum(ar + k, ai + k, n - k, lanes);
+}
+
+template<typename V>
+void modulusExtremesKernel(const double *ar, const double *ai, std::size_t n, double first,
+                           ModulusLanes &lanes)
+{
+    constexpr std::size_t vectors = ReductionLanes / V::width;
+    const double start[ReductionLanes] = {first,     first + 1, first + 2, first + 3,
+                                          first + 4, first + 5, first + 6, first + 7};
+    const typename V::T step = V::set1(static_cast<double>(ReductionLanes));
+    typename V::T min[vectors], minIndex[vectors], max[vectors], maxIndex[vectors], position[vectors];
+    for (std::size_t j = 0; j < vectors; ++j) {
+        min[j] = V::load(lanes.min + j * V::width);
+        minIndex[j] = V::load(lanes.minIndex + j * V::width);
+        max[j] = V::load(lanes.max + j * V::width);
+        maxIndex[j] = V::load(lanes.maxIndex + j * V::width);
+        position[j] = V::load(start + j * V::width);
+    }
+    std::size_t k = 0;
+    for (; k + ReductionLanes <= n; k += ReductionLanes) {
+        for (std::size_t j = 0; j < vectors; ++j) {
+            const typename V::T a = V::load(ar + k + j * V::width), b = V::load(ai + k + j * V::width);
+            const typename V::T modulus = V::add(V::mul(a, a), V::mul(b, b));
+            minIndex[j] = V::lessSelect(modulus, min[j], position[j], minIndex[j]);
+            min[j] = V::lessSelect(modulus, min[j], modulus, min[j]);
+            maxIndex[j] = V::lessSelect(max[j], modulus, position[j], maxIndex[j]);
+            max[j] = V::lessSelect(max[j], modulus, modulus, max[j]);
+            position[j] = V::add(position[j], step);
+        }
+    }
+    for (std::size_t j = 0; j < vectors; ++j) {
+        V::store(lanes.min + j * V::width, min[j]);
+        V::store(lanes.minIndex + j * V::width, minIndex[j]);
+        V::store(lanes.max + j * V::width, max[j]);
+        V::store(lanes.maxIndex + j * V::width, maxIndex[j]);
+    }
+    scalarKernels.modulusExtremes(ar + k, ai + k, n - k, first + static_cast<double>(k), lanes);
+}
+
+template<typename V>
+void boundsKernel(const double *ar, const double *ai, std::size_t n, BoundsLanes &lanes)
+{
+    constexpr std::size_t vectors = ReductionLanes / V::width;
+    typename V::T minReal[vectors], maxReal[vectors], minImaginary[vectors], maxImaginary[vectors];
+    for (std::size_t j = 0; j < vectors; ++j) {
+        minReal[j] = V::load(lanes.minReal + j * V::width);
+        maxReal[j] = V::load(lanes.maxReal + j * V::width);
+        minImaginary[j] = V::load(lanes.minImaginary + j * V::width);
+        maxImaginary[j] = V::load(lanes.maxImaginary + j * V::width);
+    }
+    std::size_t k = 0;
+    for (; k + ReductionLanes <= n; k += ReductionLanes) {
+        for (std::size_t j = 0; j < vectors; ++j) {
+            const typename V::T a = V::load(ar + k + j * V::width), b = V::load(ai + k + j * V::width);
+            minReal[j] = V::lessSelect(a, minReal[j], a, minReal[j]);
+            maxReal[j] = V::lessSelect(maxReal[j], a, a, maxReal[j]);
+            minImaginary[j] = V::lessSelect(b, minImaginary[j], b, minImaginary[j]);
+            maxImaginary[j] = V::lessSelect(maxImaginary[j], b, b, maxImaginary[j]);
+        }
+    }
+    for (std::size_t j = 0; j < vectors; ++j) {
+        V::store(lanes.minReal + j * V::width, minReal[j]);
+        V::store(lanes.maxReal + j * V::width, maxReal[j]);
+        V::store(lanes.minImaginary + j * V::width, minImaginary[j]);
+        V::store(lanes.maxImaginary + j * V::width, maxImaginary[j]);
+    }
+    scalarKernels.bounds(ar + k, ai + k, n - k, lanes);
+}
+
+/**
+ * @brief One radix-R butterfly of a forward FFT pass, on width(O) consecutive q.
+ *
+ * Inputs j are read at in + j * inStep, outputs k written at out + k * outStep; the
+ * outputs k > 0 are multiplied by the twiddle factors w[k - 1].
+ */
+template<typename O, std::size_t R>
+inline void fftButterfly(const double *xr, const double *xi, double *yr, double *yi, std::size_t in,
+                         std::size_t inStep, std::size_t out, std::size_t outStep,
+                         const typename O::T *wr, const typename O::T *wi)
+{
+    using T = typename O::T;
+    T ar[R], ai[R];
+    for (std::size_t j = 0; j < R; ++j) {
+        ar[j] = O::load(xr + in + j * inStep);
+        ai[j] = O::load(xi + in + j * inStep);
+    }
+
+    // DFT of length R with the forward root exp(-2 pi i / R).
+    T br[R], bi[R];
+    if constexpr (R == 2) {
+        br[0] = O::add(ar[0], ar[1]);
+        bi[0] = O::add(ai[0], ai[1]);
+        br[1] = O::sub(ar[0], ar[1]);
+        bi[1] = O::sub(ai[0], ai[1]);
+    } else if constexpr (R == 3) {
+        const T half = O::set1(0.5), sine = O::set1(0.86602540378443864676);
+        const T sr = O::add(ar[1], ar[2]), si = O::add(ai[1], ai[2]);
+        const T dr = O::mul(sine, O::sub(ar[1], ar[2])), di = O::mul(sine, O::sub(ai[1], ai[2]));
+        const T mr = O::sub(ar[0], O::mul(half, sr)), mi = O::sub(ai[0], O::mul(half, si));
+        br[0] = O::add(ar[0], sr);
+        bi[0] = O::add(ai[0], si);
+        br[1] = O::add(mr, di);
+        bi[1] = O::sub(mi, dr);
+        br[2] = O::sub(mr, di);
+        bi[2] = O::add(mi, dr);
+    } else if constexpr (R == 4) {
+        const T t0r = O::add(ar[0], ar[2]), t0i = O::add(ai[0], ai[2]);
+        const T t1r = O::sub(ar[0], ar[2]), t1i = O::sub(ai[0], ai[2]);
+        const T t2r = O::add(ar[1], ar[3]), t2i = O::add(ai[1], ai[3]);
+        // (a1 - a3) * -i
+        const T t3r = O::sub(ai[1], ai[3]), t3i = O::sub(ar[3], ar[1]);
+        br[0] = O::add(t0r, t2r);
+        bi[0] = O::add(t0i, t2i);
+        br[1] = O::add(t1r, t3r);
+        bi[1] = O::add(t1i, t3i);
+        br[2] = O::sub(t0r, t2r);
+        bi[2] = O::sub(t0i, t2i);
+        br[3] = O::sub(t1r, t3r);
+        bi[3] = O::sub(t1i, t3i);
+    } else {
+        static_assert(R == 5, "radix must be 2, 3, 4 or 5");
+        const T c1 = O::set1(0.30901699437494742410), c2 = O::set1(-0.80901699437494742410);
+        const T s1 = O::set1(0.95105651629515357212), s2 = O::set1(0.58778525229247312917);
+        const T t1r = O::add(ar[1], ar[4]), t1i = O::add(ai[1], ai[4]);
+        const T t2r = O::add(ar[2], ar[3]), t2i = O::add(ai[2], ai[3]);
+        const T t3r = O::sub(ar[1], ar[4]), t3i = O::sub(ai[1], ai[4]);
+        const T t4r = O::sub(ar[2], ar[3]), t4i = O::sub(ai[2], ai[3]);
+        const T m1r = O::add(ar[0], O::add(O::mul(c1, t1r), O::mul(c2, t2r)));
+        const T m1i = O::add(ai[0], O::add(O::mul(c1, t1i), O::mul(c2, t2i)));
+        const T m2r = O::add(ar[0], O::add(O::mul(c2, t1r), O::mul(c1, t2r)));
+        const T m2i = O::add(ai[0], O::add(O::mul(c2, t1i), O::mul(c1, t2i)));
+        const T n1r = O::add(O::mul(s1, t3r), O::mul(s2, t4r));
+        const T n1i = O::add(O::mul(s1, t3i), O::mul(s2, t4i));
+        const T n2r = O::sub(O::mul(s2, t3r), O::mul(s1, t4r));
+        const T n2i = O::sub(O::mul(s2, t3i), O::mul(s1, t4i));
+        br[0] = O::add(ar[0], O::add(t1r, t2r));
+        bi[0] = O::add(ai[0], O::add(t1i, t2i));
+        // b1 = m1 - i n1, b4 = m1 + i n1, b2 = m2 - i n2, b3 = m2 + i n2
+        br[1] = O::add(m1r, n1i);
+        bi[1] = O::sub(m1i, n1r);
+        br[4] = O::sub(m1r, n1i);
+        bi[4] = O::add(m1i, n1r);
+        br[2] = O::add(m2r, n2i);
+        bi[2] = O::sub(m2i, n2r);
+        br[3] = O::sub(m2r, n2i);
+        bi[3] = O::add(m2i, n2r);
+    }
+
+    O::store(yr + out, br[0]);
+    O::store(yi + out, bi[0]);
+    for (std::size_t k = 1; k < R; ++k) {
+        const T w = wr[k - 1], v = wi[k - 1];
+        O::store(yr + out + k * outStep, O::sub(O::mul(br[k], w), O::mul(bi[k], v)));
+        O::store(yi + out + k * outStep, O::add(O::mul(br[k], v), O::mul(bi[k], w)));
+    }
+}
+
+template<typename V, std::size_t R>
+void fftRadixKernel(const FftPass &pass, const double *xr, const double *xi, double *yr, double *yi,
+                    std::size_t pBegin, std::size_t pEnd, std::size_t qBegin, std::size_t qEnd)
+{
+    const std::size_t m = pass.m, s = pass.stride;
+    for (std::size_t p = pBegin; p < pEnd; ++p) {
+        double scalarReal[R - 1], scalarImaginary[R - 1];
+        typename V::T twiddleReal[R - 1], twiddleImaginary[R - 1];
+        for (std::size_t k = 0; k + 1 < R; ++k) {
+            scalarReal[k] = pass.twiddleReal[p * (R - 1) + k];
+            scalarImaginary[k] = pass.twiddleImaginary[p * (R - 1) + k];
+            twiddleReal[k] = V::set1(scalarReal[k]);
+            twiddleImaginary[k] = V::set1(scalarImaginary[k]);
+        }
+        std::size_t q = qBegin;
+        for (; q + V::width <= qEnd; q += V::width) {
+            fftButterfly<V, R>(xr, xi, yr, yi, q + s * p, s * m, q + s * R * p, s, twiddleReal,
+                               twiddleImaginary);
+        }
+        for (; q < qEnd; ++q) {
+            fftButterfly<ScalarLane, R>(xr, xi, yr, yi, q + s * p, s * m, q + s * R * p, s, scalarReal,
+                                        scalarImaginary);
+        }
+    }
+}
+
+template<typename V>
+void fftPassKernel(const FftPass &pass, const double *xr, const double *xi, double *yr, double *yi,
+                   std::size_t pBegin, std::size_t pEnd, std::size_t qBegin, std::size_t qEnd)
+{
+    switch (pass.radix) {
+    case 2:
+        fftRadixKernel<V, 2>(pass, xr, xi, yr, yi, pBegin, pEnd, qBegin, qEnd);
+        break;
+    case 3:
+        fftRadixKernel<V, 3>(pass, xr, xi, yr, yi, pBegin, pEnd, qBegin, qEnd);
+        break;
+    case 4:
+        fftRadixKernel<V, 4>(pass, xr, xi, yr, yi, pBegin, pEnd, qBegin, qEnd);
+        break;
+    default:
+        fftRadixKernel<V, 5>(pass, xr, xi, yr, yi, pBegin, pEnd, qBegin, qEnd);
+        break;
+    }
+}
+
+/**
+ * @brief Whether every point of the vector lies in the main cardioid or the period-2
+ * bulb of the Mandelbrot set, which never escape.
+ */
+template<typename V>
+bool insideMainBulbs(typename V::T real, typename V::T imaginary)
+{
+    using T = typename V::T;
+    const T zero = V::set1(0.0), one = V::set1(1.0);
+    const T x = V::sub(real, V::set1(0.25)), y2 = V::mul(imaginary, imaginary);
+    const T q = V::add(V::mul(x, x), y2);
+    const T outsideCardioid = V::lessSelect(V::mul(q, V::add(q, x)), V::mul(V::set1(0.25), y2), zero, one);
+    const T shifted = V::add(real, one);
+    const T outsideBulb = V::lessSelect(V::add(V::mul(shifted, shifted), y2), V::set1(0.0625), zero, one);
+    return V::zeroMask(V::mul(outsideCardioid, outsideBulb)) == (1u << V::width) - 1;
+}
+
+/**
+ * @brief Escape-time iteration of the points [k, n) in whole vectors, returns where it stopped.
+ *
+ * Lanes that escaped keep their z and count while the others go on; the vector stops
+ * once all lanes escaped, checked every fourth iteration.
+ */
+template<typename V>
+std::size_t escapeVectors(const EscapeRow &row, std::size_t k, std::size_t n, double *iterations,
+                          double *modulus2)
+{
+    using T = typename V::T;
+    const T zero = V::set1(0.0), one = V::set1(1.0), bailout = V::set1(EscapeRadiusSquared);
+    const unsigned allLanes = (1u << V::width) - 1;
+
+    double lanes[V::width];
+    for (std::size_t j = 0; j < V::width; ++j) {
+        lanes[j] = static_cast<double>(j);
+    }
+    const T lane = V::load(lanes);
+    const T imaginary = V::set1(row.imaginary);
+
+    for (; k + V::width <= n; k += V::width) {
+        const T real = V::add(V::set1(row.real),
+                              V::mul(V::add(V::set1(static_cast<double>(k)), lane), V::set1(row.step)));
+        T zr = zero, zi = zero, cr = real, ci = imaginary;
+        if (row.julia) {
+            zr = real;
+            zi = imaginary;
+            cr = V::set1(row.cReal);
+            ci = V::set1(row.cImaginary);
+        } else if (insideMainBulbs<V>(real, imaginary)) {
+            V::store(iterations + k, V::set1(static_cast<double>(row.maxIterations)));
+            V::store(modulus2 + k, zero);
+            continue;
+        }
+
+        T count = zero;
+        T r2 = V::add(V::mul(zr, zr), V::mul(zi, zi));
+        for (unsigned step = 0; step < row.maxIterations; ++step) {
+            const T nextReal = V::add(V::sub(V::mul(zr, zr), V::mul(zi, zi)), cr);
+            const T nextImaginary = V::add(V::mul(V::add(zr, zr), zi), ci);
+            zr = V::lessSelect(r2, bailout, nextReal, zr);
+            zi = V::lessSelect(r2, bailout, nextImaginary, zi);
+            count = V::lessSelect(r2, bailout, V::add(count, one), count);
+            r2 = V::add(V::mul(zr, zr), V::mul(zi, zi));
+            if ((step & 3) == 3 && V::zeroMask(V::lessSelect(r2, bailout, one, zero)) == allLanes) {
+                break;
+            }
+        }
+        V::store(iterations + k, count);
+        V::store(modulus2 + k, r2);
+    }
+    return k;
+}
+
+template<typename V>
+void escapeTimeKernel(const EscapeRow &row, std::size_t n, double *iterations, double *modulus2)
+{
+    const std::size_t k = escapeVectors<V>(row, 0, n, iterations, modulus2);
+    escapeVectors<ScalarLane>(row, k, n, iterations, modulus2);
+}
+
+// Elementary functions.
+//
+// Every complex function is built from the real exp, log, sin/cos, sinh/cosh and atan
+// cores below, which are polynomial approximations after an exact or nearly exact
+// argument reduction. They are valid on a fast domain of finite arguments of moderate
+// size; each complex function reports the lanes inside it, and the kernel recomputes
+// the others with elementaryFallback(). Apart from the fallback, only trait
+// operations are used, in a fixed order, so every instruction set gives the same bits.
+
+/** @brief ln 2 in two parts; the high one has 32 bits, so k * Ln2High is exact. */
+constexpr double Ln2High = 6.93147180369123816490e-01;
+constexpr double Ln2Low = 1.90821492927058770002e-10;
+
+/** @brief pi / 2 in three parts of 33 bits each and a tail, for Cody-Waite reduction. */
+constexpr double PiHalf1 = 1.57079632673412561417e+00;
+constexpr double PiHalf2 = 6.07710050630396597660e-11;
+constexpr double PiHalf3 = 2.02226624871116645580e-21;
+constexpr double PiHalf3Tail = 8.47842766036889956997e-32;
+
+/** @brief pi / 2 and pi as double plus correction. */
+constexpr double PiHalfHigh = 1.5707963267948966;
+constexpr double PiHalfLow = 6.123233995736766e-17;
+constexpr double PiHigh = 3.141592653589793;
+constexpr double PiLow = 1.2246467991473532e-16;
+
+/** @brief e^r = sum of r^k / k! for k = 0 .. 13, enough for |r| <= ln(2) / 2. */
+constexpr double ExpCoefficients[] = {1.0,
+                                      1.0,
+                                      1.0 / 2,
+                                      1.0 / 6,
+                                      1.0 / 24,
+                                      1.0 / 120,
+                                      1.0 / 720,
+                                      1.0 / 5040,
+                                      1.0 / 40320,
+                                      1.0 / 362880,
+                                      1.0 / 3628800,
+                                      1.0 / 39916800,
+                                      1.0 / 479001600,
+                                      1.0 / 6227020800};
+
+/** @brief (sin r - r) / r^3 as a polynomial in r^2, to r^17, for |r| <= pi / 4. */
+constexpr double SineCoefficients[] = {-1.0 / 6,
+                                       1.0 / 120,
+                                       -1.0 / 5040,
+                                       1.0 / 362880,
+                                       -1.0 / 39916800,
+                                       1.0 / 6227020800,
+                                       -1.0 / 1307674368000,
+                                       1.0 / 355687428096000};
+
+/** @brief (cos r - 1) / r^2 as a polynomial in r^2, to r^16, for |r| <= pi / 4. */
+constexpr double CosineCoefficients[] = {-1.0 / 2,
+                                         1.0 / 24,
+                                         -1.0 / 720,
+                                         1.0 / 40320,
+                                         -1.0 / 3628800,
+                                         1.0 / 479001600,
+                                         -1.0 / 87178291200,
+                                         1.0 / 20922789888000};
+
+/** @brief (sinh r - r) / r^3 as a polynomial in r^2, to r^17, for |r| < 1. */
+constexpr double SinhCoefficients[] = {1.0 / 6,
+                                       1.0 / 120,
+                                       1.0 / 5040,
+                                       1.0 / 362880,
+                                       1.0 / 39916800,
+                                       1.0 / 6227020800,
+                                       1.0 / 1307674368000,
+                                       1.0 / 355687428096000};
+
+/** @brief (2 atanh(s) - 2 s) / s^3 = 2/3 + 2/5 s^2 + ..., to s^23, for |s| <= 0.172. */
+constexpr double LogCoefficients[] = {2.0 / 3,  2.0 / 5,  2.0 / 7,  2.0 / 9,  2.0 / 11, 2.0 / 13,
+                                      2.0 / 15, 2.0 / 17, 2.0 / 19, 2.0 / 21, 2.0 / 23};
+
+/** @brief (atan u - u) / u^3 as a polynomial in u^2, to u^17, for |u| <= 1/8. */
+constexpr double AtanCoefficients[] = {-1.0 / 3, 1.0 / 5,  -1.0 / 7,  1.0 / 9,
+                                       -1.0 / 11, 1.0 / 13, -1.0 / 15, 1.0 / 17};
+
+/** @brief Centres t of the atan reduction with atan(t) as double plus correction. */
+constexpr double AtanCentres[][3] = {{0.25, 0.24497866312686414, 1.0698755618734451e-17},
+                                     {0.5, 0.4636476090008061, 2.2698777452961687e-17},
+                                     {0.75, 0.6435011087932844, 1.5834785051444286e-17},
+                                     {1.0, 0.7853981633974483, 3.061616997868383e-17}};
+
+/**
+ * @brief Rounds to the nearest integer, ties to even, for |a| < 2^51.
+ */
+template<typename V>
+inline typename V::T roundNearest(typename V::T a)
+{
+    const typename V::T shifter = V::set1(0x1.8p52);
+    return V::sub(V::add(a, shifter), shifter);
+}
+
+/**
+ * @brief Horner evaluation of c[0] + c[1] x + ... + c[N - 1] x^(N - 1).
+ */
+template<typename V, std::size_t N>
+inline typename V::T polynomial(typename V::T x, const double (&c)[N])
+{
+    typename V::T result = V::set1(c[N - 1]);
+    for (std::size_t k = N - 1; k-- > 0;) {
+        result = V::add(V::mul(result, x), V::set1(c[k]));
+    }
+    return result;
+}
+
+/**
+ * @brief Lane bits where |a| is not in [lo, hi), set for NaN.
+ */
+template<typename V>
+inline unsigned outsideRange(typename V::T a, double lo, double hi)
+{
+    const typename V::T zero = V::set1(0.0), magnitude = V::abs(a);
+    return V::zeroMask(V::lessSelect(magnitude, V::set1(hi), V::lessSelect(magnitude, V::set1(lo), zero, V::set1(1.0)),
+                                     zero));
+}
+
+/**
+ * @brief e^x for |x| < 709.
+ *
+ * x = k ln 2 + r with |r| <= ln(2) / 2, so e^x = 2^k e^r.
+ */
+template<typename V>
+inline typename V::T expCore(typename V::T x)
+{
+    using T = typename V::T;
+    const T k = roundNearest<V>(V::mul(x, V::set1(1.4426950408889634)));
+    const T r = V::sub(V::sub(x, V::mul(k, V::set1(Ln2High))), V::mul(k, V::set1(Ln2Low)));
+    return V::scale(polynomial<V>(r, ExpCoefficients), k);
+}
+
+/**
+ * @brief Natural logarithm of a positive normal x.
+ *
+ * x = 2^e m with m in [sqrt(1/2), sqrt(2)). With f = m - 1 (exact) and
+ * s = f / (2 + f), log(m) = 2 atanh(s) = f - s (f - R) where R = 2 s^2 / 3 + ...
+ */
+template<typename V>
+inline typename V::T logCore(typename V::T x)
+{
+    using T = typename V::T;
+    const T one = V::set1(1.0), zero = V::set1(0.0), root2 = V::set1(1.4142135623730951);
+    T exponent;
+    T m = V::splitExponent(x, exponent);
+    exponent = V::add(exponent, V::lessSelect(root2, m, one, zero));
+    m = V::mul(m, V::lessSelect(root2, m, V::set1(0.5), one));
+    const T f = V::sub(m, one);
+    const T s = V::div(f, V::add(V::set1(2.0), f));
+    const T z = V::mul(s, s);
+    const T r = V::mul(z, polynomial<V>(z, LogCoefficients));
+    const T logM = V::sub(f, V::sub(V::mul(s, V::sub(f, r)), V::mul(exponent, V::set1(Ln2Low))));
+    return V::add(V::mul(exponent, V::set1(Ln2High)), logM);
+}
+
+/**
+ * @brief log(1 + u) for u in (-1/2, 1], correcting the rounding of 1 + u.
+ */
+template<typename V>
+inline typename V::T log1pCore(typename V::T u)
+{
+    using T = typename V::T;
+    const T one = V::set1(1.0);
+    const T w = V::add(one, u);
+    // w - 1 is exact, so u - (w - 1) is the rounding error of w.
+    return V::add(logCore<V>(w), V::div(V::sub(u, V::sub(w, one)), w));
+}
+
+/**
+ * @brief sin x and cos x for |x| < 2^19.
+ *
+ * x = k pi / 2 + r with |r| <= pi / 4; k * PiHalf1 .. k * PiHalf3 are exact in
+ * this range, and the tail keeps r accurate next to multiples of pi / 2. The
+ * quadrant k mod 4 picks and negates the series of r.
+ */
+template<typename V>
+inline void sinCosCore(typename V::T x, typename V::T &sine, typename V::T &cosine)
+{
+    using T = typename V::T;
+    const T one = V::set1(1.0), minusOne = V::set1(-1.0);
+    const T k = roundNearest<V>(V::mul(x, V::set1(0.63661977236758134)));
+    T r = V::sub(x, V::mul(k, V::set1(PiHalf1)));
+    r = V::sub(r, V::mul(k, V::set1(PiHalf2)));
+    r = V::sub(r, V::mul(k, V::set1(PiHalf3)));
+    r = V::sub(r, V::mul(k, V::set1(PiHalf3Tail)));
+    const T z = V::mul(r, r);
+    // sin r has the sign of r, also for r = -0.
+    const T s = V::copySign(V::add(r, V::mul(V::mul(r, z), polynomial<V>(z, SineCoefficients))), r);
+    const T c = V::add(one, V::mul(z, polynomial<V>(z, CosineCoefficients)));
+
+    // k mod 4 as a quarter: 0, 0.25, 0.5 or 0.75 for (s, c), (c, -s), (-s, -c), (-c, s).
+    const T quarter = V::mul(k, V::set1(0.25));
+    const T q = V::sub(quarter, roundNearest<V>(V::sub(quarter, V::set1(0.375))));
+    const T odd = V::abs(V::sub(V::abs(V::sub(q, V::set1(0.5))), V::set1(0.25)));
+    const T eighth = V::set1(0.125);
+    sine = V::mul(V::lessSelect(odd, eighth, c, s), V::lessSelect(q, V::set1(0.5), one, minusOne));
+    cosine = V::mul(V::lessSelect(odd, eighth, s, c),
+                    V::lessSelect(V::abs(V::sub(q, V::set1(0.375))), V::set1(0.25), minusOne, one));
+}
+
+/**
+ * @brief sinh x and cosh x for |x| < 709, by the series of sinh below 1.
+ */
+template<typename V>
+inline void sinhCoshCore(typename V::T x, typename V::T &sinh, typename V::T &cosh)
+{
+    using T = typename V::T;
+    const T one = V::set1(1.0), half = V::set1(0.5);
+    const T magnitude = V::abs(x);
+    const T e = expCore<V>(magnitude), inverse = V::div(one, e);
+    cosh = V::mul(half, V::add(e, inverse));
+    const T z = V::mul(x, x);
+    const T series = V::add(x, V::mul(V::mul(x, z), polynomial<V>(z, SinhCoefficients)));
+    sinh = V::lessSelect(magnitude, one, series, V::copySign(V::mul(half, V::sub(e, inverse)), x));
+}
+
+/**
+ * @brief atan t for t in [0, 1].
+ *
+ * atan t = atan c + atan u with c the nearest of 0, 1/4, 1/2, 3/4, 1 and
+ * u = (t - c) / (1 + t c), so |u| <= 1/8.
+ */
+template<typename V>
+inline typename V::T atanCore(typename V::T t)
+{
+    using T = typename V::T;
+    const T zero = V::set1(0.0);
+    T centre = zero, high = zero, low = zero;
+    for (const auto &entry : AtanCentres) {
+        const T threshold = V::set1(entry[0] - 0.125);
+        centre = V::lessSelect(t, threshold, centre, V::set1(entry[0]));
+        high = V::lessSelect(t, threshold, high, V::set1(entry[1]));
+        low = V::lessSelect(t, threshold, low, V::set1(entry[2]));
+    }
+    const T u = V::div(V::sub(t, centre), V::add(V::set1(1.0), V::mul(t, centre)));
+    const T z = V::mul(u, u);
+    return V::add(high, V::add(low, V::add(u, V::mul(V::mul(u, z), polynomial<V>(z, AtanCoefficients)))));
+}
+
+/**
+ * @brief atan2(y, x) for finite x and y, not both zero.
+ */
+template<typename V>
+inline typename V::T atan2Core(typename V::T y, typename V::T x)
+{
+    using T = typename V::T;
+    const T ax = V::abs(x), ay = V::abs(y);
+    const T angle = atanCore<V>(V::div(V::lessSelect(ax, ay, ax, ay), V::lessSelect(ax, ay, ay, ax)));
+    const T upper = V::lessSelect(ax, ay, V::sub(V::set1(PiHalfHigh), V::sub(angle, V::set1(PiHalfLow))), angle);
+    const T left = V::lessSelect(x, V::set1(0.0), V::sub(V::set1(PiHigh), V::sub(upper, V::set1(PiLow))), upper);
+    return V::copySign(left, y);
+}
+
+/**
+ * @brief a + b as an exact sum sum + error (Knuth).
+ */
+template<typename V>
+inline void exactSum(typename V::T a, typename V::T b, typename V::T &sum, typename V::T &error)
+{
+    sum = V::add(a, b);
+    const typename V::T rounded = V::sub(sum, a);
+    error = V::add(V::sub(a, V::sub(sum, rounded)), V::sub(b, rounded));
+}
+
+/**
+ * @brief a * a as an exact sum high + low (Dekker), for |a| < 2^996.
+ */
+template<typename V>
+inline void exactSquare(typename V::T a, typename V::T &high, typename V::T &low)
+{
+    using T = typename V::T;
+    const T c = V::mul(V::set1(134217729.0), a);
+    const T top = V::sub(c, V::sub(c, a)), bottom = V::sub(a, top);
+    high = V::mul(a, a);
+    low = V::add(V::add(V::sub(V::mul(top, top), high), V::mul(V::add(top, top), bottom)), V::mul(bottom, bottom));
+}
+
+// The complex functions below write f(x + iy) and return the lanes outside their
+// fast domain, whose results the kernel replaces.
+
+template<typename V>
+unsigned exponentialVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    using T = typename V::T;
+    T sine, cosine;
+    sinCosCore<V>(y, sine, cosine);
+    const T e = expCore<V>(x);
+    rr = V::mul(e, cosine);
+    ri = V::mul(e, sine);
+    return outsideRange<V>(x, 0, 708) | outsideRange<V>(y, 0, 0x1p19);
+}
+
+/**
+ * @brief log|z| + i arg z.
+ *
+ * Near the unit circle log|z| = log1p(|z|^2 - 1) / 2, with |z|^2 - 1 summed from
+ * exact squares with exact additions; elsewhere log|z| = log a + log1p((b / a)^2) / 2
+ * with a = max(|x|, |y|).
+ */
+template<typename V>
+unsigned logarithmVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    using T = typename V::T;
+    const T one = V::set1(1.0), half = V::set1(0.5);
+    const T ax = V::abs(x), ay = V::abs(y);
+    const T a = V::lessSelect(ax, ay, ay, ax), b = V::lessSelect(ax, ay, ax, ay);
+
+    T a2, a2Low, b2, b2Low;
+    exactSquare<V>(a, a2, a2Low);
+    exactSquare<V>(b, b2, b2Low);
+    // The five terms cancel to far below their size, so every addition keeps its error.
+    T d, error, part;
+    exactSum<V>(a2, V::neg(one), d, error);
+    exactSum<V>(d, b2, d, part);
+    error = V::add(error, part);
+    exactSum<V>(d, a2Low, d, part);
+    error = V::add(error, part);
+    exactSum<V>(d, b2Low, d, part);
+    d = V::add(d, V::add(error, part));
+    const T nearUnit = V::mul(half, log1pCore<V>(d));
+
+    const T ratio = V::div(b, a);
+    const T far = V::add(logCore<V>(a), V::mul(half, log1pCore<V>(V::mul(ratio, ratio))));
+
+    rr = V::lessSelect(V::abs(d), half, nearUnit, far);
+    ri = atan2Core<V>(y, x);
+    return outsideRange<V>(a, 0x1p-500, 0x1p500);
+}
+
+template<typename V>
+unsigned powerVector(typename V::T x, typename V::T y, typename V::T u, typename V::T v, typename V::T &rr,
+                     typename V::T &ri)
+{
+    using T = typename V::T;
+    T logReal, logImaginary;
+    const unsigned outside = logarithmVector<V>(x, y, logReal, logImaginary);
+    const T wr = V::sub(V::mul(u, logReal), V::mul(v, logImaginary));
+    const T wi = V::add(V::mul(u, logImaginary), V::mul(v, logReal));
+    return outside | exponentialVector<V>(wr, wi, rr, ri);
+}
+
+/**
+ * @brief sin z = sin x cosh y + i cos x sinh y.
+ */
+template<typename V>
+unsigned sineVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    typename V::T sine, cosine, sinh, cosh;
+    sinCosCore<V>(x, sine, cosine);
+    sinhCoshCore<V>(y, sinh, cosh);
+    rr = V::mul(sine, cosh);
+    ri = V::mul(cosine, sinh);
+    return outsideRange<V>(x, 0, 0x1p19) | outsideRange<V>(y, 0, 709);
+}
+
+/**
+ * @brief cos z = cos x cosh y - i sin x sinh y.
+ */
+template<typename V>
+unsigned cosineVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    typename V::T sine, cosine, sinh, cosh;
+    sinCosCore<V>(x, sine, cosine);
+    sinhCoshCore<V>(y, sinh, cosh);
+    rr = V::mul(cosine, cosh);
+    ri = V::neg(V::mul(sine, sinh));
+    return outsideRange<V>(x, 0, 0x1p19) | outsideRange<V>(y, 0, 709);
+}
+
+/**
+ * @brief tan z = (sin x cos x + i sinh y cosh y) / (cos^2 x + sinh^2 y).
+ *
+ * The denominator is a sum of squares, so it does not cancel away from the poles.
+ */
+template<typename V>
+unsigned tangentVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    using T = typename V::T;
+    T sine, cosine, sinh, cosh;
+    sinCosCore<V>(x, sine, cosine);
+    sinhCoshCore<V>(y, sinh, cosh);
+    const T denominator = V::add(V::mul(cosine, cosine), V::mul(sinh, sinh));
+    rr = V::div(V::mul(sine, cosine), denominator);
+    ri = V::div(V::mul(sinh, cosh), denominator);
+    return outsideRange<V>(x, 0, 0x1p19) | outsideRange<V>(y, 0, 350);
+}
+
+/**
+ * @brief sinh z = sinh x cos y + i cosh x sin y.
+ */
+template<typename V>
+unsigned hyperbolicSineVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    typename V::T sine, cosine, sinh, cosh;
+    sinCosCore<V>(y, sine, cosine);
+    sinhCoshCore<V>(x, sinh, cosh);
+    rr = V::mul(sinh, cosine);
+    ri = V::mul(cosh, sine);
+    return outsideRange<V>(x, 0, 709) | outsideRange<V>(y, 0, 0x1p19);
+}
+
+/**
+ * @brief cosh z = cosh x cos y + i sinh x sin y.
+ */
+template<typename V>
+unsigned hyperbolicCosineVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    typename V::T sine, cosine, sinh, cosh;
+    sinCosCore<V>(y, sine, cosine);
+    sinhCoshCore<V>(x, sinh, cosh);
+    rr = V::mul(cosh, cosine);
+    ri = V::mul(sinh, sine);
+    return outsideRange<V>(x, 0, 709) | outsideRange<V>(y, 0, 0x1p19);
+}
+
+/**
+ * @brief tanh z = (sinh x cosh x + i sin y cos y) / (sinh^2 x + cos^2 y).
+ */
+template<typename V>
+unsigned hyperbolicTangentVector(typename V::T x, typename V::T y, typename V::T &rr, typename V::T &ri)
+{
+    using T = typename V::T;
+    T sine, cosine, sinh, cosh;
+    sinCosCore<V>(y, sine, cosine);
+    sinhCoshCore<V>(x, sinh, cosh);
+    const T denominator = V::add(V::mul(sinh, sinh), V::mul(cosine, cosine));
+    rr = V::div(V::mul(sinh, cosh), denominator);
+    ri = V::div(V::mul(sine, cosine), denominator);
+    return outsideRange<V>(x, 0, 350) | outsideRange<V>(y, 0, 0x1p19);
+}
+
+/**
+ * @brief Runs a complex function over the elements [k, n) in whole vectors of trait O,
+ *        returns where it stopped.
+ *
+ * function(O(), x, y, u, v, real, imaginary) evaluates one vector, u + iv being the
+ * second argument (only read when bi is not null). The inputs are read before the
+ * results are stored, so the outputs may alias the inputs.
+ */
+template<typename O, typename Function>
+std::size_t elementaryVectors(ElementaryFunction name, Function function, const double *ar, const double *ai,
+                              const double *br, const double *bi, double *rr, double *ri, std::size_t k,
+                              std::size_t n)
+{
+    using T = typename O::T;
+    for (; k + O::width <= n; k += O::width) {
+        const T x = O::load(ar + k), y = O::load(ai + k);
+        const T u = bi ? O::load(br + k) : x, v = bi ? O::load(bi + k) : y;
+        T real, imaginary;
+        const unsigned outside = function(O(), x, y, u, v, real, imaginary);
+        if (outside == 0) {
+            O::store(rr + k, real);
+            O::store(ri + k, imaginary);
+            continue;
+        }
+        double xs[O::width], ys[O::width], us[O::width], vs[O::width], reals[O::width], imaginaries[O::width];
+        O::store(xs, x);
+        O::store(ys, y);
+        O::store(us, u);
+        O::store(vs, v);
+        O::store(reals, real);
+        O::store(imaginaries, imaginary);
+        for (unsigned lanes = outside; lanes != 0; lanes &= lanes - 1) {
+            const unsigned j = __builtin_ctz(lanes);
+            elementaryFallback(name, xs[j], ys[j], us[j], vs[j], reals[j], imaginaries[j]);
+        }
+        for (std::size_t j = 0; j < O::width; ++j) {
+            rr[k + j] = reals[j];
+            ri[k + j] = imaginaries[j];
+        }
+    }
+    return k;
+}
+
+template<typename V, typename Function>
+void elementaryKernel(ElementaryFunction name, Function function, const double *ar, const double *ai,
+                      const double *br, const double *bi, double *rr, double *ri, std::size_t n)
+{
+    const std::size_t k = elementaryVectors<V>(name, function, ar, ai, br, bi, rr, ri, 0, n);
+    elementaryVectors<ScalarLane>(name, function, ar, ai, br, bi, rr, ri, k, n);
+}
+
+template<typename V>
+void exponentialKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return exponentialVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::Exponential, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+template<typename V>
+void logarithmKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return logarithmVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::Logarithm, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+template<typename V>
+void powerKernel(const double *ar, const double *ai, const double *br, const double *bi, double *rr, double *ri,
+                 std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto u, auto v, auto &real, auto &imaginary) {
+        return powerVector<decltype(trait)>(x, y, u, v, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::Power, function, ar, ai, br, bi, rr, ri, n);
+}
+
+template<typename V>
+void sineKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return sineVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::Sine, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+template<typename V>
+void cosineKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return cosineVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::Cosine, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+template<typename V>
+void tangentKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return tangentVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::Tangent, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+template<typename V>
+void hyperbolicSineKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return hyperbolicSineVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::HyperbolicSine, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+template<typename V>
+void hyperbolicCosineKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return hyperbolicCosineVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::HyperbolicCosine, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+template<typename V>
+void hyperbolicTangentKernel(const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const auto function = [](auto trait, auto x, auto y, auto, auto, auto &real, auto &imaginary) {
+        return hyperbolicTangentVector<decltype(trait)>(x, y, real, imaginary);
+    };
+    elementaryKernel<V>(ElementaryFunction::HyperbolicTangent, function, ar, ai, nullptr, nullptr, rr, ri, n);
+}
+
+/**
+ * @brief Horner evaluation of the terms [0, m) of a polynomial with complex coefficients.
+ */
+template<typename V>
+inline void hornerVector(const double *cr, const double *ci, std::size_t m, typename V::T x, typename V::T y,
+                         typename V::T &rr, typename V::T &ri)
+{
+    using T = typename V::T;
+    T real = V::set1(cr[m - 1]), imaginary = V::set1(ci[m - 1]);
+    for (std::size_t j = m - 1; j-- > 0;) {
+        const T nextReal = V::add(V::sub(V::mul(real, x), V::mul(imaginary, y)), V::set1(cr[j]));
+        imaginary = V::add(V::add(V::mul(real, y), V::mul(imaginary, x)), V::set1(ci[j]));
+        real = nextReal;
+    }
+    rr = real;
+    ri = imaginary;
+}
+
+/**
+ * @brief (c[0] + c[1] z) + (c[2] + c[3] z) z^2 for the block at c, z^2 = (x2, y2).
+ */
+template<typename V>
+inline void estrinBlock(const double *cr, const double *ci, typename V::T x, typename V::T y, typename V::T x2,
+                        typename V::T y2, typename V::T &rr, typename V::T &ri)
+{
+    using T = typename V::T;
+    const T c1r = V::set1(cr[1]), c1i = V::set1(ci[1]), c3r = V::set1(cr[3]), c3i = V::set1(ci[3]);
+    const T lowReal = V::add(V::sub(V::mul(c1r, x), V::mul(c1i, y)), V::set1(cr[0]));
+    const T lowImaginary = V::add(V::add(V::mul(c1r, y), V::mul(c1i, x)), V::set1(ci[0]));
+    const T highReal = V::add(V::sub(V::mul(c3r, x), V::mul(c3i, y)), V::set1(cr[2]));
+    const T highImaginary = V::add(V::add(V::mul(c3r, y), V::mul(c3i, x)), V::set1(ci[2]));
+    rr = V::add(V::sub(V::mul(highReal, x2), V::mul(highImaginary, y2)), lowReal);
+    ri = V::add(V::add(V::mul(highReal, y2), V::mul(highImaginary, x2)), lowImaginary);
+}
+
+/**
+ * @brief Evaluates a polynomial at the points [k, n) in whole vectors of trait O,
+ *        returns where it stopped.
+ */
+template<typename O>
+std::size_t polynomialVectors(const double *cr, const double *ci, std::size_t terms, PolynomialScheme scheme,
+                              const double *ar, const double *ai, double *rr, double *ri, std::size_t k,
+                              std::size_t n)
+{
+    using T = typename O::T;
+    if (scheme == PolynomialScheme::Horner) {
+        for (; k + O::width <= n; k += O::width) {
+            T real, imaginary;
+            hornerVector<O>(cr, ci, terms, O::load(ar + k), O::load(ai + k), real, imaginary);
+            O::store(rr + k, real);
+            O::store(ri + k, imaginary);
+        }
+        return k;
+    }
+
+    // The top block holds the 1 to 4 leading coefficients and starts the chain.
+    const std::size_t top = (terms - 1) / 4 * 4;
+    for (; k + O::width <= n; k += O::width) {
+        const T x = O::load(ar + k), y = O::load(ai + k);
+        const T x2 = O::sub(O::mul(x, x), O::mul(y, y)), y2 = O::add(O::mul(x, y), O::mul(x, y));
+        const T x4 = O::sub(O::mul(x2, x2), O::mul(y2, y2)), y4 = O::add(O::mul(x2, y2), O::mul(x2, y2));
+        T real, imaginary;
+        hornerVector<O>(cr + top, ci + top, terms - top, x, y, real, imaginary);
+        for (std::size_t j = top; j != 0;) {
+            j -= 4;
+            T blockReal, blockImaginary;
+            estrinBlock<O>(cr + j, ci + j, x, y, x2, y2, blockReal, blockImaginary);
+            const T nextReal = O::add(O::sub(O::mul(real, x4), O::mul(imaginary, y4)), blockReal);
+            imaginary = O::add(O::add(O::mul(real, y4), O::mul(imaginary, x4)), blockImaginary);
+            real = nextReal;
+        }
+        O::store(rr + k, real);
+        O::store(ri + k, imaginary);
+    }
+    return k;
+}
+
+template<typename V>
+void polynomialKernel(const double *cr, const double *ci, std::size_t terms, PolynomialScheme scheme,
+                      const double *ar, const double *ai, double *rr, double *ri, std::size_t n)
+{
+    const std::size_t k = polynomialVectors<V>(cr, ci, terms, scheme, ar, ai, rr, ri, 0, n);
+    polynomialVectors<ScalarLane>(cr, ci, terms, scheme, ar, ai, rr, ri, k, n);
+}
+
+/**
+ * @brief Aberth sums for the points [k, n) in whole vectors of trait O, returns where it stopped.
+ *
+ * Each lane adds the terms in order of j, so every trait gives the same bits. A zero
+ * or NaN squared distance is replaced by infinity, which makes its term zero.
+ */
+template<typename O>
+std::size_t aberthVectors(const double *ar, const double *ai, const double *br, const double *bi, std::size_t m,
+                          double *rr, double *ri, std::size_t k, std::size_t n)
+{
+    using T = typename O::T;
+    const T zero = O::set1(0.0), infinity = O::set1(__builtin_inf()), one = O::set1(1.0);
+    for (; k + O::width <= n; k += O::width) {
+        const T x = O::load(ar + k), y = O::load(ai + k);
+        T real = zero, imaginary = zero;
+        for (std::size_t j = 0; j < m; ++j) {
+            const T dx = O::sub(x, O::set1(br[j])), dy = O::sub(y, O::set1(bi[j]));
+            const T distance2 = O::add(O::mul(dx, dx), O::mul(dy, dy));
+            const T scale = O::div(one, O::lessSelect(zero, distance2, distance2, infinity));
+            real = O::add(real, O::mul(dx, scale));
+            imaginary = O::sub(imaginary, O::mul(dy, scale));
+        }
+        O::store(rr + k, real);
+        O::store(ri + k, imaginary);
+    }
+    return k;
+}
+
+template<typename V>
+void aberthSumKernel(const double *ar, const double *ai, std::size_t n, const double *br, const double *bi,
+                     std::size_t m, double *rr, double *ri)
+{
+    const std::size_t k = aberthVectors<V>(ar, ai, br, bi, m, rr, ri, 0, n);
+    aberthVectors<ScalarLane>(ar, ai, br, bi, m, rr, ri, k, n);
+}
+
+/**
+ * @brief C += A B for one tile, vectorized along the rows of the tile.
+ *
+ * The tile stays in registers; each step broadcasts one element of A per row and
+ * loads one row of B. No tails: every width divides GemmTileColumns.
+ */
+template<typename V>
+void gemmTileKernel(std::size_t depth, const double *a, const double *b, double *cr, double *ci,
+                    std::size_t stride)
+{
+    using T = typename V::T;
+    constexpr std::size_t vectors = GemmTileColumns / V::width;
+    T real[GemmTileRows][vectors], imaginary[GemmTileRows][vectors];
+    for (std::size_t i = 0; i < GemmTileRows; ++i) {
+        for (std::size_t v = 0; v < vectors; ++v) {
+            real[i][v] = V::load(cr + i * stride + v * V::width);
+            imaginary[i][v] = V::load(ci + i * stride + v * V::width);
+        }
+    }
+    for (std::size_t p = 0; p < depth; ++p) {
+        const double *ap = a + p * 2 * GemmTileRows, *bp = b + p * 2 * GemmTileColumns;
+        T br[vectors], bi[vectors];
+        for (std::size_t v = 0; v < vectors; ++v) {
+            br[v] = V::load(bp + v * V::width);
+            bi[v] = V::load(bp + GemmTileColumns + v * V::width);
+        }
+        for (std::size_t i = 0; i < GemmTileRows; ++i) {
+            const T ar = V::set1(ap[i]), ai = V::set1(ap[GemmTileRows + i]);
+            for (std::size_t v = 0; v < vectors; ++v) {
+                real[i][v] = V::add(real[i][v], V::sub(V::mul(ar, br[v]), V::mul(ai, bi[v])));
+                imaginary[i][v] = V::add(imaginary[i][v], V::add(V::mul(ar, bi[v]), V::mul(ai, br[v])));
+            }
+        }
+    }
+    for (std::size_t i = 0; i < GemmTileRows; ++i) {
+        for (std::size_t v = 0; v < vectors; ++v) {
+            V::store(cr + i * stride + v * V::width, real[i][v]);
+            V::store(ci + i * stride + v * V::width, imaginary[i][v]);
+        }
+    }
+}
+
+template<typename V>
+constexpr ComplexKernels makeKernels(const char *name)
+{
+    return ComplexKernels{
+        name,
+        addKernel<V>,
+        subtractKernel<V>,
+        multiplyKernel<V>,
+        divideKernel<V>,
+        conjugateKernel<V>,
+        inverseKernel<V>,
+        absoluteValueKernel<V>,
+        rootKernel<V>,
+        sumKernel<V>,
+        modulusExtremesKernel<V>,
+        boundsKernel<V>,
+        fftPassKernel<V>,
+        escapeTimeKernel<V>,
+        exponentialKernel<V>,
+        logarithmKernel<V>,
+        powerKernel<V>,
+        sineKernel<V>,
+        cosineKernel<V>,
+        tangentKernel<V>,
+        hyperbolicSineKernel<V>,
+        hyperbolicCosineKernel<V>,
+        hyperbolicTangentKernel<V>,
+        polynomialKernel<V>,
+        aberthSumKernel<V>,
+        gemmTileKernel<V>,
+    };
+}
@@ -0,0 +1,78 @@
+#include "complexkernels.h"
+
+#include <emmintrin.h>
+
+namespace {
+
+/**
+ * @brief SSE2 trait - two doubles per register.
+ */
+struct Sse2 {
+    using T = __m128d;
+    static constexpr std::size_t width = 2;
+
+    static T load(const double *p) { return _mm_loadu_pd(p); }
+    static void store(double *p, T a) { _mm_storeu_pd(p, a); }
+    static T set1(double a) { return _mm_set1_pd(a); }
+    static T add(T a, T b) { return _mm_add_pd(a, b); }
+    static T sub(T a, T b) { return _mm_sub_pd(a, b); }
+    static T mul(T a, T b) { return _mm_mul_pd(a, b); }
+    static T div(T a, T b) { return _mm_div_pd(a, b); }
+    static T sqrt(T a) { return _mm_sqrt_pd(a); }
+    static T neg(T a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+    static T abs(T a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+
+    static T lessSelect(T x, T y, T a, T b)
+    {
+        const T less = _mm_cmplt_pd(x, y);
+        return _mm_or_pd(_mm_and_pd(less, a), _mm_andnot_pd(less, b));
+    }
+
+    static T signFactor(T a)
+    {
+        const T negative = _mm_cmplt_pd(a, _mm_setzero_pd());
+        return _mm_or_pd(_mm_and_pd(negative, _mm_set1_pd(-1.0)),
+                         _mm_andnot_pd(negative, _mm_set1_pd(1.0)));
+    }
+
+    static unsigned zeroMask(T a)
+    {
+        return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, _mm_setzero_pd())));
+    }
+
+    static unsigned bothZeroMask(T a, T b)
+    {
+        const T zero = _mm_setzero_pd();
+        return static_cast<unsigned>(
+            _mm_movemask_pd(_mm_and_pd(_mm_cmpeq_pd(a, zero), _mm_cmpeq_pd(b, zero))));
+    }
+
+    static T copySign(T a, T b)
+    {
+        const T sign = _mm_set1_pd(-0.0);
+        return _mm_or_pd(_mm_andnot_pd(sign, a), _mm_and_pd(sign, b));
+    }
+
+    static T scale(T a, T k)
+    {
+        // k + 1.5 * 2^52 holds k in its low mantissa bits; shifting k + 1023 into the
+        // exponent field gives 2^k.
+        const __m128i bits = _mm_castpd_si128(_mm_add_pd(k, _mm_set1_pd(0x1.8p52)));
+        return _mm_mul_pd(a, _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(bits, _mm_set1_epi64x(1023)), 52)));
+    }
+
+    static T splitExponent(T a, T &exponent)
+    {
+        const __m128i bits = _mm_castpd_si128(a);
+        const T biased = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(bits, 52), _mm_set1_epi64x(0x4330000000000000)));
+        exponent = _mm_sub_pd(biased, _mm_set1_pd(0x1p52 + 1023));
+        const T fraction = _mm_castsi128_pd(_mm_set1_epi64x(0x000fffffffffffff));
+        return _mm_or_pd(_mm_and_pd(a, fraction), _mm_set1_pd(1.0));
+    }
+};
+
+#include "complexkernels_impl.h"
+
+} // namespace
+
+extern const ComplexKernels sse2Kernels = makeKernels<Sse2>("sse2");
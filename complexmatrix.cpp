@@ -0,0 +1,197 @@
+#include "complexmatrix.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "complexkernels.h"
+#include "reduction.h"
+
+namespace {
+
+/**
+ * @brief Inner dimension of one packed block of A and B.
+ */
+constexpr std::size_t GemmDepth = 256;
+
+/**
+ * @brief Rows of A packed by one chunk of work, a multiple of GemmTileRows.
+ */
+constexpr std::size_t GemmRows = 64;
+
+/**
+ * @brief Columns of B packed at once, a multiple of GemmTileColumns.
+ */
+constexpr std::size_t GemmColumns = 1024;
+
+/**
+ * @brief Products of fewer complex multiplications than this run on the calling thread.
+ */
+constexpr std::size_t ParallelWork = 1 << 18;
+
+/**
+ * @brief Packs depth x columns elements of B into panels of GemmTileColumns columns.
+ *
+ * Panel q holds, for each p, the real parts of row p then its imaginary parts;
+ * columns past the edge are zero.
+ */
+void packB(const MatrixBlock &b, std::size_t row, std::size_t column, std::size_t depth, std::size_t columns,
+           std::vector<double> &packed)
+{
+    const std::size_t panels = (columns + GemmTileColumns - 1) / GemmTileColumns;
+    packed.assign(panels * depth * 2 * GemmTileColumns, 0.0);
+    for (std::size_t q = 0; q < panels; ++q) {
+        const std::size_t width = std::min(GemmTileColumns, columns - q * GemmTileColumns);
+        for (std::size_t p = 0; p < depth; ++p) {
+            const std::size_t source = (row + p) * b.stride + column + q * GemmTileColumns;
+            double *target = packed.data() + (q * depth + p) * 2 * GemmTileColumns;
+            std::copy(b.real + source, b.real + source + width, target);
+            std::copy(b.imaginary + source, b.imaginary + source + width, target + GemmTileColumns);
+        }
+    }
+}
+
+/**
+ * @brief Packs rows x depth elements of A into panels of GemmTileRows rows, negated if asked.
+ *
+ * Panel q holds, for each p, the real parts of column p then its imaginary parts;
+ * rows past the edge are zero.
+ */
+void packA(const MatrixBlock &a, std::size_t row, std::size_t column, std::size_t rows, std::size_t depth,
+           bool negate, std::vector<double> &packed)
+{
+    const std::size_t panels = (rows + GemmTileRows - 1) / GemmTileRows;
+    packed.assign(panels * depth * 2 * GemmTileRows, 0.0);
+    const double sign = negate ? -1.0 : 1.0;
+    for (std::size_t q = 0; q < panels; ++q) {
+        const std::size_t height = std::min(GemmTileRows, rows - q * GemmTileRows);
+        for (std::size_t i = 0; i < height; ++i) {
+            const std::size_t source = (row + q * GemmTileRows + i) * a.stride + column;
+            double *target = packed.data() + q * depth * 2 * GemmTileRows + i;
+            for (std::size_t p = 0; p < depth; ++p) {
+                target[p * 2 * GemmTileRows] = sign * a.real[source + p];
+                target[p * 2 * GemmTileRows + GemmTileRows] = sign * a.imaginary[source + p];
+            }
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Creates a matrix of zeros.
+ *
+ * @param rows number of rows (std::size_t).
+ * @param columns number of columns (std::size_t).
+ */
+ComplexMatrix::ComplexMatrix(std::size_t rows, std::size_t columns)
+    : rowCount(rows), columnCount(columns), elements(rows * columns)
+{
+}
+
+/**
+ * @brief Identity matrix.
+ *
+ * @param size number of rows and columns (std::size_t).
+ * @return identity (ComplexMatrix).
+ */
+ComplexMatrix ComplexMatrix::identity(std::size_t size)
+{
+    ComplexMatrix result(size, size);
+    for (std::size_t k = 0; k < size; ++k) {
+        result.set(k, k, ComplexNumber(1, 0));
+    }
+    return result;
+}
+
+/**
+ * @brief Matrix product, see multiplyAdd().
+ *
+ * @param other right factor (const ComplexMatrix&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If columns() differs from other.rows().
+ * @return product (ComplexMatrix).
+ */
+ComplexMatrix ComplexMatrix::multiply(const ComplexMatrix &other, unsigned threads) const
+{
+    ComplexMatrix result(rowCount, other.columnCount);
+    multiplyAdd(block(0, 0, rowCount, columnCount), other.block(0, 0, other.rowCount, other.columnCount),
+                result.real(), result.imaginary(), result.columnCount, false, threads);
+    return result;
+}
+
+/**
+ * @brief C += A B, or C -= A B, by blocks of the gemmTile kernel.
+ *
+ * @param a left factor, rows x depth (const MatrixBlock&).
+ * @param b right factor, depth x columns; must not overlap C (const MatrixBlock&).
+ * @param cr real parts of C, a.rows x b.columns (double*).
+ * @param ci imaginary parts of C (double*).
+ * @param stride distance between the rows of C (std::size_t).
+ * @param subtract whether to subtract the product (bool).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If a.columns differs from b.rows.
+ */
+void multiplyAdd(const MatrixBlock &a, const MatrixBlock &b, double *cr, double *ci, std::size_t stride,
+                 bool subtract, unsigned threads)
+{
+    if (a.columns != b.rows) {
+        throw std::invalid_argument("Matrix dimensions do not match!");
+    }
+    const std::size_t rows = a.rows, columns = b.columns, depth = a.columns;
+    if (rows == 0 || columns == 0 || depth == 0) {
+        return;
+    }
+    if (rows * columns * depth < ParallelWork) {
+        threads = 1;
+    }
+
+    const ComplexKernels &kernels = activeKernels();
+    const std::size_t rowBlocks = (rows + GemmRows - 1) / GemmRows;
+    std::vector<double> packedB;
+    for (std::size_t jc = 0; jc < columns; jc += GemmColumns) {
+        const std::size_t nc = std::min(GemmColumns, columns - jc);
+        // The blocks of the inner index run in order, so every element adds its
+        // products in order of p.
+        for (std::size_t pc = 0; pc < depth; pc += GemmDepth) {
+            const std::size_t kc = std::min(GemmDepth, depth - pc);
+            packB(b, pc, jc, kc, nc, packedB);
+
+            parallelChunks(rowBlocks, threads, [&](std::size_t chunk) {
+                thread_local std::vector<double> packedA;
+                const std::size_t ic = chunk * GemmRows, mc = std::min(GemmRows, rows - ic);
+                packA(a, ic, pc, mc, kc, subtract, packedA);
+
+                for (std::size_t jr = 0; jr < nc; jr += GemmTileColumns) {
+                    const double *panelB = packedB.data() + jr / GemmTileColumns * kc * 2 * GemmTileColumns;
+                    const std::size_t width = std::min(GemmTileColumns, nc - jr);
+                    for (std::size_t ir = 0; ir < mc; ir += GemmTileRows) {
+                        const double *panelA = packedA.data() + ir / GemmTileRows * kc * 2 * GemmTileRows;
+                        const std::size_t height = std::min(GemmTileRows, mc - ir);
+                        const std::size_t offset = (ic + ir) * stride + jc + jr;
+                        if (height == GemmTileRows && width == GemmTileColumns) {
+                            kernels.gemmTile(kc, panelA, panelB, cr + offset, ci + offset, stride);
+                            continue;
+                        }
+                        // Edge tiles go through a full-size copy.
+                        double tileReal[GemmTileRows * GemmTileColumns] = {};
+                        double tileImaginary[GemmTileRows * GemmTileColumns] = {};
+                        for (std::size_t i = 0; i < height; ++i) {
+                            std::copy(cr + offset + i * stride, cr + offset + i * stride + width,
+                                      tileReal + i * GemmTileColumns);
+                            std::copy(ci + offset + i * stride, ci + offset + i * stride + width,
+                                      tileImaginary + i * GemmTileColumns);
+                        }
+                        kernels.gemmTile(kc, panelA, panelB, tileReal, tileImaginary, GemmTileColumns);
+                        for (std::size_t i = 0; i < height; ++i) {
+                            std::copy(tileReal + i * GemmTileColumns, tileReal + i * GemmTileColumns + width,
+                                      cr + offset + i * stride);
+                            std::copy(tileImaginary + i * GemmTileColumns,
+                                      tileImaginary + i * GemmTileColumns + width, ci + offset + i * stride);
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
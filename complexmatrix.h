@@ -0,0 +1,154 @@
+#ifndef COMPLEXMATRIX_H
+#define COMPLEXMATRIX_H
+
+#include <cstddef>
+
+#include "complexarray.h"
+#include "complexnumber.h"
+
+/**
+ * @brief Read-only rectangular block of a row-major matrix stored as split parts.
+ *
+ * Element (i, j) is real[i * stride + j] + imaginary[i * stride + j] i.
+ */
+struct MatrixBlock {
+    const double *real;
+    const double *imaginary;
+    std::size_t rows;
+    std::size_t columns;
+    std::size_t stride;
+};
+
+/**
+ * @brief Dense complex matrix, row-major, with separate real and imaginary buffers.
+ *
+ * The storage is one ComplexArray, so rows are contiguous and aligned like its
+ * buffers. Element (i, j) is at index i * columns() + j of real() and imaginary().
+ */
+class ComplexMatrix {
+public:
+    /**
+     * @brief Creates a matrix of zeros.
+     *
+     * @param rows number of rows (std::size_t).
+     * @param columns number of columns (std::size_t).
+     */
+    explicit ComplexMatrix(std::size_t rows = 0, std::size_t columns = 0);
+
+    /**
+     * @brief Identity matrix.
+     *
+     * @param size number of rows and columns (std::size_t).
+     * @return identity (ComplexMatrix).
+     */
+    static ComplexMatrix identity(std::size_t size);
+
+    /** @brief Number of rows. */
+    std::size_t rows() const { return rowCount; }
+
+    /** @brief Number of columns. */
+    std::size_t columns() const { return columnCount; }
+
+    /** @brief Real parts, row-major. */
+    double *real() { return elements.real(); }
+    const double *real() const { return elements.real(); }
+
+    /** @brief Imaginary parts, row-major. */
+    double *imaginary() { return elements.imaginary(); }
+    const double *imaginary() const { return elements.imaginary(); }
+
+    /**
+     * @brief Reads one element.
+     *
+     * @param row row (std::size_t).
+     * @param column column (std::size_t).
+     * @return element (ComplexNumber).
+     */
+    ComplexNumber get(std::size_t row, std::size_t column) const
+    {
+        return elements.get(row * columnCount + column);
+    }
+
+    /**
+     * @brief Writes one element.
+     *
+     * @param row row (std::size_t).
+     * @param column column (std::size_t).
+     * @param value new value (const ComplexNumber&).
+     */
+    void set(std::size_t row, std::size_t column, const ComplexNumber &value)
+    {
+        elements.set(row * columnCount + column, value);
+    }
+
+    /**
+     * @brief Block of the matrix.
+     *
+     * @param row first row (std::size_t).
+     * @param column first column (std::size_t).
+     * @param rows number of rows (std::size_t).
+     * @param columns number of columns (std::size_t).
+     * @return view of the block, valid while the matrix lives (MatrixBlock).
+     */
+    MatrixBlock block(std::size_t row, std::size_t column, std::size_t rows, std::size_t columns) const
+    {
+        const std::size_t offset = row * columnCount + column;
+        return MatrixBlock{real() + offset, imaginary() + offset, rows, columns, columnCount};
+    }
+
+    /**
+     * @brief Matrix product, see multiplyAdd().
+     *
+     * @param other right factor (const ComplexMatrix&).
+     * @param threads threads to use, 0 for one per hardware thread (unsigned).
+     * @throws std::invalid_argument If columns() differs from other.rows().
+     * @return product (ComplexMatrix).
+     */
+    ComplexMatrix multiply(const ComplexMatrix &other, unsigned threads = 0) const;
+
+    /** @throws std::invalid_argument If columns() differs from other.rows(). */
+    ComplexMatrix operator*(const ComplexMatrix &other) const { return multiply(other); }
+
+private:
+    /**
+     * @brief Number of rows.
+     */
+    std::size_t rowCount;
+
+    /**
+     * @brief Number of columns.
+     */
+    std::size_t columnCount;
+
+    /**
+     * @brief The elements, row-major.
+     */
+    ComplexArray elements;
+};
+
+/**
+ * @brief C += A B, or C -= A B, by blocks of the gemmTile kernel.
+ *
+ * Blocks of B of up to 256 x 1024 are packed once into panels of GemmTileColumns
+ * columns; blocks of 64 rows of A are packed into panels of GemmTileRows rows by the
+ * thread that multiplies them, so both stay in cache while gemmTile runs over every
+ * tile of C they meet. The blocks of rows of C are shared out by parallelChunks().
+ *
+ * Every element of C adds its products in order of the inner index, each rounded as
+ * by ComplexNumber::multiply, so the result is the same, bit for bit, as the naive
+ * loop c = c.add(a.multiply(b)) for any thread count and instruction set; subtract
+ * matches c = c.subtract(a.multiply(b)) up to the sign of zero elements.
+ *
+ * @param a left factor, rows x depth (const MatrixBlock&).
+ * @param b right factor, depth x columns; must not overlap C (const MatrixBlock&).
+ * @param cr real parts of C, a.rows x b.columns (double*).
+ * @param ci imaginary parts of C (double*).
+ * @param stride distance between the rows of C (std::size_t).
+ * @param subtract whether to subtract the product (bool).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If a.columns differs from b.rows.
+ */
+void multiplyAdd(const MatrixBlock &a, const MatrixBlock &b, double *cr, double *ci, std::size_t stride,
+                 bool subtract = false, unsigned threads = 0);
+
+#endif // COMPLEXMATRIX_H
@@ -1,97 +1,428 @@
 #ifndef COMPLEXNUMBER_H
 #define COMPLEXNUMBER_H
 
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @brief Outcome of a non-throwing operation.
+ */
+enum class ComplexStatus {
+    Ok,
+    DivisionByZero
+};
+
+/**
+ * @brief __float128 is usable as a scalar: GCC on glibc, which provides its libm functions.
+ */
+#if defined(__SIZEOF_FLOAT128__) && defined(__GLIBC__) && defined(__GNUC__) && !defined(__clang__)
+#define COMPLEXCALC_HAS_FLOAT128 1
+#endif
+
+namespace complexdetail {
+
+/**
+ * @brief Square root of a real scalar.
+ *
+ * @param x argument (T).
+ * @return result (T).
+ */
+template<typename T>
+inline T squareRoot(T x) noexcept
+{
+    return std::sqrt(x);
+}
+
+#ifdef COMPLEXCALC_HAS_FLOAT128
+/**
+ * @brief Square root of a quad precision scalar, which has no std::sqrt overload.
+ *
+ * @param x argument (__float128).
+ * @return result (__float128).
+ */
+inline __float128 squareRoot(__float128 x) noexcept
+{
+    return sqrtf128(x);
+}
+#endif
+
+} // namespace complexdetail
+
 /**
- * @brief Class representing a complex number.
+ * @brief Class representing a complex number over the real scalar T.
  *
  * This class provides functionalities for creating, manipulating, and performing
  * various operations on complex numbers.
+ *
+ * The arithmetic is defined inline in this header so it can be inlined and
+ * vectorized at every call site; it is constexpr, so expressions on constants fold
+ * at compile time. The elementary functions (exponential() to hyperbolicTangent())
+ * are defined in complexfunctions.cpp for float, double, long double and, where
+ * COMPLEXCALC_HAS_FLOAT128 is set, __float128. In double they share their code with
+ * the batch kernels; float rounds the double result once, long double uses
+ * std::complex and __float128 the textbook formulas on its real functions. The type
+ * is trivially copyable and standard layout (two T), so arrays of it can be copied
+ * with memcpy.
  */
-class ComplexNumber {
+template<typename T>
+class BasicComplex {
 public:
-    ComplexNumber(double a, double b);
-    ~ComplexNumber();
+    /**
+     * @brief Default constructor - zero.
+     */
+    constexpr BasicComplex() noexcept : real(0), imaginary(0) {}
 
-    /** @brief The imaginary part of the complex number. */
-    double getReal() const { return real; }
+    /**
+     * @brief Constructor.
+     *
+     * @param a real part (T).
+     * @param b imaginary part (T).
+     */
+    constexpr BasicComplex(T a, T b) noexcept : real(a), imaginary(b) {}
+
+    /**
+     * @brief Converts from another precision, rounding each part once.
+     *
+     * @param other number to be converted (const BasicComplex<U>&).
+     */
+    template<typename U>
+    constexpr explicit BasicComplex(const BasicComplex<U>& other) noexcept
+        : real(static_cast<T>(other.getReal())), imaginary(static_cast<T>(other.getImaginary()))
+    {
+    }
+
+    /** @brief The real part of the complex number. */
+    constexpr T getReal() const noexcept { return real; }
 
     /** @brief The imaginary part of the complex number. */
-    double getImaginary() const { return imaginary; }
+    constexpr T getImaginary() const noexcept { return imaginary; }
 
     /**
      * @brief Calculates the absolute value of the complex number.
      *
-     * @return result (double).
+     * @return result (T).
     */
-    double absoluteValue() const;
+    T absoluteValue() const noexcept
+    {
+        return complexdetail::squareRoot(real * real + imaginary * imaginary);
+    }
 
     /**
      * @brief Addition of complex numbers.
      *
-     * @param other number to be added (const ComplexNumber&).
-     * @return result (ComplexNumber).
+     * @param other number to be added (const BasicComplex&).
+     * @return result (BasicComplex).
     */
-    ComplexNumber add(const ComplexNumber& other) const;
+    constexpr BasicComplex add(const BasicComplex& other) const noexcept
+    {
+        return BasicComplex(real + other.real, imaginary + other.imaginary);
+    }
 
     /**
      * @brief Subtraction of complex numbers.
      *
-     * @param other number to be subtracted (const ComplexNumber&).
-     * @return result (ComplexNumber).
+     * @param other number to be subtracted (const BasicComplex&).
+     * @return result (BasicComplex).
     */
-    ComplexNumber subtract(const ComplexNumber& other) const;
+    constexpr BasicComplex subtract(const BasicComplex& other) const noexcept
+    {
+        return BasicComplex(real - other.real, imaginary - other.imaginary);
+    }
 
     /**
      * @brief Multiplication of complex numbers.
      *
-     * @param other number to be multiplied (const ComplexNumber&).
-     * @return result (ComplexNumber).
+     * @param other number to be multiplied (const BasicComplex&).
+     * @return result (BasicComplex).
     */
-    ComplexNumber multiply(const ComplexNumber& other) const;
+    constexpr BasicComplex multiply(const BasicComplex& other) const noexcept
+    {
+        return BasicComplex(real * other.real - imaginary * other.imaginary,
+                             real * other.imaginary + imaginary * other.real);
+    }
 
     /**
      * @brief Divides two complex numbers.
      *
-     * @param other complex number to be divided by (const ComplexNumber&).
+     * @param other complex number to be divided by (const BasicComplex&).
      * @throws std::invalid_argument If the divisor is zero.
-     * @return result (ComplexNumber).
+     * @return result (BasicComplex).
+    */
+    constexpr BasicComplex divide(const BasicComplex& other) const
+    {
+        if (other.real == 0 && other.imaginary == 0) {
+            throw std::invalid_argument("Division by zero!");
+        }
+        return divideUnchecked(other);
+    }
+
+    /**
+     * @brief Divides two complex numbers with IEEE semantics, never throws.
+     *
+     * A zero divisor yields NaN parts instead of an exception.
+     *
+     * @param other complex number to be divided by (const BasicComplex&).
+     * @return result (BasicComplex).
     */
-    ComplexNumber divide(const ComplexNumber& other) const;
+    constexpr BasicComplex divideUnchecked(const BasicComplex& other) const noexcept
+    {
+        const T denominator = other.real * other.real + other.imaginary * other.imaginary;
+        return BasicComplex((real * other.real + imaginary * other.imaginary) / denominator,
+                             (imaginary * other.real - real * other.imaginary) / denominator);
+    }
+
+    /**
+     * @brief Divides two complex numbers and reports a zero divisor as a status.
+     *
+     * @param other complex number to be divided by (const BasicComplex&).
+     * @param status set to DivisionByZero if the divisor is zero, Ok otherwise (ComplexStatus&).
+     * @return result, with NaN parts on a zero divisor (BasicComplex).
+    */
+    constexpr BasicComplex tryDivide(const BasicComplex& other, ComplexStatus& status) const noexcept
+    {
+        status = (other.real == 0 && other.imaginary == 0) ? ComplexStatus::DivisionByZero
+                                                           : ComplexStatus::Ok;
+        return divideUnchecked(other);
+    }
 
     /**
      * @brief Square root of the complex number.
      *
-     * @return result (ComplexNumber).
+     * @return result (BasicComplex).
      */
-    ComplexNumber root() const;
+    BasicComplex root() const noexcept
+    {
+        T absValue = absoluteValue();
+        T newReal = complexdetail::squareRoot((absValue + real) / 2);
+
+        T norm = (imaginary >= 0) ? 1 : ((imaginary < 0) ? -1 : 1);
+        T newImaginary = norm * complexdetail::squareRoot((absValue - real) / 2);
+
+        return BasicComplex(newReal, newImaginary);
+    }
 
     /**
      * @brief Inverse of a complex number.
      *
-     * @return root value of the complex number (ComplexNumber).
+     * @return inverse value of the complex number (BasicComplex).
      * @throws std::invalid_argument If the divisor is zero.
     */
-    ComplexNumber inverse() const;
+    constexpr BasicComplex inverse() const
+    {
+        T denominator = real * real + imaginary * imaginary;
+        if (denominator == 0) {
+            throw std::invalid_argument("Division by zero!");
+        }
+        return BasicComplex(real / denominator, -imaginary / denominator);
+    }
+
+    /**
+     * @brief Inverse of a complex number with IEEE semantics, never throws.
+     *
+     * Zero yields NaN parts instead of an exception.
+     *
+     * @return inverse value of the complex number (BasicComplex).
+    */
+    constexpr BasicComplex inverseUnchecked() const noexcept
+    {
+        T denominator = real * real + imaginary * imaginary;
+        return BasicComplex(real / denominator, -imaginary / denominator);
+    }
+
+    /**
+     * @brief Inverse of a complex number, reporting zero as a status.
+     *
+     * @param status set to DivisionByZero if the number is zero, Ok otherwise (ComplexStatus&).
+     * @return inverse value, with NaN parts for zero (BasicComplex).
+    */
+    constexpr BasicComplex tryInverse(ComplexStatus& status) const noexcept
+    {
+        T denominator = real * real + imaginary * imaginary;
+        status = (denominator == 0) ? ComplexStatus::DivisionByZero : ComplexStatus::Ok;
+        return BasicComplex(real / denominator, -imaginary / denominator);
+    }
+
+    /**
+     * @brief Integer power by binary exponentiation, reporting 0^-n as a status.
+     *
+     * Takes about 2 log2|exponent| multiplications; a negative exponent inverts the
+     * number first. The result equals repeated multiply() for exponents up to 3.
+     *
+     * @param exponent exponent, z^0 = 1 for every z (int).
+     * @param status set to DivisionByZero for zero and a negative exponent, Ok otherwise (ComplexStatus&).
+     * @return result, with NaN parts for 0^-n (BasicComplex).
+    */
+    constexpr BasicComplex tryPower(int exponent, ComplexStatus& status) const noexcept
+    {
+        BasicComplex base = exponent < 0 ? tryInverse(status) : *this;
+        if (exponent >= 0) {
+            status = ComplexStatus::Ok;
+        }
+        unsigned remaining = exponent < 0 ? 0u - static_cast<unsigned>(exponent)
+                                          : static_cast<unsigned>(exponent);
+        // The first factor is taken as is rather than multiplied into 1, which would
+        // turn infinite parts into NaN.
+        BasicComplex result(1, 0);
+        bool first = true;
+        while (remaining != 0) {
+            if (remaining & 1) {
+                result = first ? base : result.multiply(base);
+                first = false;
+            }
+            remaining >>= 1;
+            if (remaining != 0) {
+                base = base.multiply(base);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Integer power by binary exponentiation.
+     *
+     * @param exponent exponent, z^0 = 1 for every z (int).
+     * @return result (BasicComplex).
+     * @throws std::invalid_argument If the number is zero and the exponent negative.
+    */
+    constexpr BasicComplex power(int exponent) const
+    {
+        ComplexStatus status = ComplexStatus::Ok;
+        BasicComplex result = tryPower(exponent, status);
+        if (status != ComplexStatus::Ok) {
+            throw std::invalid_argument("Division by zero!");
+        }
+        return result;
+    }
+
+    /**
+     * @brief Complex exponential e^z.
+     *
+     * In double precision within a few ulps for |Re z| < 708 and |Im z| < 2^19;
+     * other arguments, infinities and NaNs follow std::exp.
+     *
+     * @return result (BasicComplex).
+     */
+    BasicComplex exponential() const noexcept;
+
+    /**
+     * @brief Principal natural logarithm.
+     *
+     * The branch cut is the negative real axis; the sign of a zero imaginary part
+     * picks its side, so log(-1 - 0i) = -pi i.
+     *
+     * @return result, imaginary part in [-pi, pi] (BasicComplex).
+     */
+    BasicComplex logarithm() const noexcept;
+
+    /**
+     * @brief Principal value of the power e^(exponent log z).
+     *
+     * @param exponent exponent (const BasicComplex&).
+     * @return result, zero for a zero base as with std::pow (BasicComplex).
+     */
+    BasicComplex power(const BasicComplex& exponent) const noexcept;
+
+    /**
+     * @brief Complex sine.
+     *
+     * @return result (BasicComplex).
+     */
+    BasicComplex sine() const noexcept;
+
+    /**
+     * @brief Complex cosine.
+     *
+     * @return result (BasicComplex).
+     */
+    BasicComplex cosine() const noexcept;
+
+    /**
+     * @brief Complex tangent.
+     *
+     * @return result (BasicComplex).
+     */
+    BasicComplex tangent() const noexcept;
+
+    /**
+     * @brief Complex hyperbolic sine.
+     *
+     * @return result (BasicComplex).
+     */
+    BasicComplex hyperbolicSine() const noexcept;
+
+    /**
+     * @brief Complex hyperbolic cosine.
+     *
+     * @return result (BasicComplex).
+     */
+    BasicComplex hyperbolicCosine() const noexcept;
+
+    /**
+     * @brief Complex hyperbolic tangent.
+     *
+     * @return result (BasicComplex).
+     */
+    BasicComplex hyperbolicTangent() const noexcept;
 
     /**
      * @brief Conjugate of a complex number.
      *
-     * @return result (ComplexNumber).
-     * @throws std::invalid_argument If the divisor is zero.
+     * @return result (BasicComplex).
     */
-    ComplexNumber conjugate() const;
+    constexpr BasicComplex conjugate() const noexcept
+    {
+        return BasicComplex(real, -imaginary);
+    }
+
+    constexpr BasicComplex operator+(const BasicComplex& other) const noexcept { return add(other); }
+    constexpr BasicComplex operator-(const BasicComplex& other) const noexcept { return subtract(other); }
+    constexpr BasicComplex operator*(const BasicComplex& other) const noexcept { return multiply(other); }
+
+    /** @throws std::invalid_argument If the divisor is zero. */
+    constexpr BasicComplex operator/(const BasicComplex& other) const { return divide(other); }
+
+    constexpr BasicComplex operator-() const noexcept { return BasicComplex(-real, -imaginary); }
+    constexpr BasicComplex operator+() const noexcept { return *this; }
+
+    constexpr BasicComplex& operator+=(const BasicComplex& other) noexcept { return *this = add(other); }
+    constexpr BasicComplex& operator-=(const BasicComplex& other) noexcept { return *this = subtract(other); }
+    constexpr BasicComplex& operator*=(const BasicComplex& other) noexcept { return *this = multiply(other); }
+
+    /** @throws std::invalid_argument If the divisor is zero. */
+    constexpr BasicComplex& operator/=(const BasicComplex& other) { return *this = divide(other); }
+
+    constexpr bool operator==(const BasicComplex& other) const noexcept
+    {
+        return real == other.real && imaginary == other.imaginary;
+    }
+
+    constexpr bool operator!=(const BasicComplex& other) const noexcept { return !(*this == other); }
 
 private:
     /**
-     * @brief Real part of a complex number (double).
+     * @brief Real part of a complex number (T).
      */
-    double real;
+    T real;
 
     /**
-     * @brief Imaginary part of a complex number (double).
+     * @brief Imaginary part of a complex number (T).
      */
-    double imaginary;
+    T imaginary;
 };
 
-#endif // COMPLEXNUMBER_H
+/**
+ * @brief The double precision complex number used throughout the calculator.
+ */
+using ComplexNumber = BasicComplex<double>;
+
+static_assert(std::is_trivially_copyable<ComplexNumber>::value,
+              "ComplexNumber must stay trivially copyable");
+static_assert(std::is_standard_layout<ComplexNumber>::value,
+              "ComplexNumber must stay standard layout");
+static_assert(sizeof(ComplexNumber) == 2 * sizeof(double),
+              "ComplexNumber must be exactly two doubles");
+static_assert((ComplexNumber(1, 2) * ComplexNumber(3, 4)) == ComplexNumber(-5, 10),
+              "ComplexNumber arithmetic must fold at compile time");
 
+#endif // COMPLEXNUMBER_H
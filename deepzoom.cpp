@@ -0,0 +1,184 @@
+#include "deepzoom.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Largest ratio |c| / |a| for which the series is extended.
+ */
+constexpr double SeriesTolerance = 0x1p-40;
+
+/**
+ * @brief Largest relative difference to plain perturbation accepted at a probe.
+ */
+constexpr double ProbeTolerance = 1e-6;
+
+/**
+ * @brief Squared modulus.
+ */
+double norm(const ComplexNumber &z)
+{
+    return z.getReal() * z.getReal() + z.getImaginary() * z.getImaginary();
+}
+
+/**
+ * @brief The series one iteration further.
+ *
+ * With dz_{n+1} = 2 Z_n dz_n + dz_n^2 + dc, the coefficients follow
+ * a' = 2 Z a + radius, b' = 2 Z b + a^2 and c' = 2 Z c + 2 a b.
+ */
+SeriesApproximation nextSeries(const SeriesApproximation &series, const ReferenceOrbit &orbit)
+{
+    const ComplexNumber twoZ(2 * orbit.real[series.skip], 2 * orbit.imaginary[series.skip]);
+    SeriesApproximation next = series;
+    next.a = twoZ * series.a + ComplexNumber(series.radius, 0);
+    next.b = twoZ * series.b + series.a * series.a;
+    next.c = twoZ * series.c + ComplexNumber(2, 0) * series.a * series.b;
+    ++next.skip;
+    return next;
+}
+
+} // namespace
+
+/**
+ * @brief Iterates the reference point in fixed point.
+ *
+ * @param cReal real part of the reference point (const FixedPoint&).
+ * @param cImaginary imaginary part of the reference point (const FixedPoint&).
+ * @param maxIterations iteration limit (unsigned).
+ * @return the orbit (ReferenceOrbit).
+ */
+ReferenceOrbit referenceOrbit(const FixedPoint &cReal, const FixedPoint &cImaginary, unsigned maxIterations)
+{
+    ReferenceOrbit orbit;
+    orbit.real.reserve(maxIterations + 1);
+    orbit.imaginary.reserve(maxIterations + 1);
+
+    const std::size_t limbs = std::max(cReal.fractionLimbs(), cImaginary.fractionLimbs());
+    FixedPoint zr = FixedPoint().withFractionLimbs(limbs), zi = zr;
+    for (unsigned n = 0;; ++n) {
+        const double real = zr.toDouble(), imaginary = zi.toDouble();
+        orbit.real.push_back(real);
+        orbit.imaginary.push_back(imaginary);
+        if (n == maxIterations || real * real + imaginary * imaginary >= EscapeRadiusSquared) {
+            return orbit;
+        }
+        const FixedPoint product = zr * zi;
+        zr = zr * zr - zi * zi + cReal;
+        zi = product + product + cImaginary;
+    }
+}
+
+/**
+ * @brief dz at iteration skip for one pixel.
+ *
+ * @param dc offset of the pixel from the reference point (const ComplexNumber&).
+ * @return dz_skip (ComplexNumber).
+ */
+ComplexNumber SeriesApproximation::evaluate(const ComplexNumber &dc) const
+{
+    const ComplexNumber u(dc.getReal() / radius, dc.getImaginary() / radius);
+    return ((c * u + b) * u + a) * u;
+}
+
+/**
+ * @brief Finds how many iterations a cubic series can skip for a view.
+ *
+ * @param orbit reference orbit (const ReferenceOrbit&).
+ * @param radius largest |dc| of the view, positive (double).
+ * @param probes offsets of the probe points (const std::vector<ComplexNumber>&).
+ * @return the series (SeriesApproximation).
+ */
+SeriesApproximation seriesApproximation(const ReferenceOrbit &orbit, double radius,
+                                        const std::vector<ComplexNumber> &probes)
+{
+    // Extend while the cubic term is negligible; the last orbit point may have
+    // escaped and is never stepped from.
+    const unsigned last = static_cast<unsigned>(orbit.real.size() - 1);
+    SeriesApproximation series;
+    series.radius = radius;
+    while (series.skip < last) {
+        const SeriesApproximation next = nextSeries(series, orbit);
+        if (!(norm(next.c) <= SeriesTolerance * SeriesTolerance * norm(next.a))) {
+            break;
+        }
+        series = next;
+    }
+
+    // Check against plain perturbation at the probes, halving the skip until they agree.
+    while (series.skip > 0) {
+        bool valid = true;
+        for (const ComplexNumber &dc : probes) {
+            ComplexNumber dz;
+            for (unsigned n = 0; n < series.skip; ++n) {
+                dz = (ComplexNumber(2 * orbit.real[n], 2 * orbit.imaginary[n]) + dz) * dz + dc;
+            }
+            const double error = norm(series.evaluate(dc) - dz);
+            if (!(error <= ProbeTolerance * ProbeTolerance * norm(dz))) {
+                valid = false;
+                break;
+            }
+        }
+        if (valid) {
+            break;
+        }
+        const unsigned shorter = series.skip / 2;
+        series = SeriesApproximation();
+        series.radius = radius;
+        while (series.skip < shorter) {
+            series = nextSeries(series, orbit);
+        }
+    }
+    return series;
+}
+
+/**
+ * @brief Escape-time iteration of a row of pixels by perturbation.
+ *
+ * @param orbit reference orbit (const ReferenceOrbit&).
+ * @param series series approximation for the view (const SeriesApproximation&).
+ * @param row pixel offsets and iteration limit (const EscapeRow&).
+ * @param n number of pixels (std::size_t).
+ * @param iterations iterations done per pixel, maxIterations if it did not escape (double*).
+ * @param modulus2 final squared modulus per pixel (double*).
+ */
+void perturbRow(const ReferenceOrbit &orbit, const SeriesApproximation &series, const EscapeRow &row,
+                std::size_t n, double *iterations, double *modulus2)
+{
+    const double *referenceReal = orbit.real.data(), *referenceImaginary = orbit.imaginary.data();
+    const std::size_t last = orbit.real.size() - 1;
+
+    for (std::size_t k = 0; k < n; ++k) {
+        const double dcReal = row.real + static_cast<double>(k) * row.step, dcImaginary = row.imaginary;
+        const ComplexNumber start = series.evaluate(ComplexNumber(dcReal, dcImaginary));
+        double dzReal = start.getReal(), dzImaginary = start.getImaginary();
+
+        unsigned count = series.skip;
+        std::size_t m = series.skip;
+        double r2;
+        for (;;) {
+            const double zReal = referenceReal[m] + dzReal, zImaginary = referenceImaginary[m] + dzImaginary;
+            r2 = zReal * zReal + zImaginary * zImaginary;
+            if (r2 >= EscapeRadiusSquared || count >= row.maxIterations) {
+                break;
+            }
+            // Rebase when z is closer to zero than the difference, or the orbit ran out.
+            if (m == last || r2 < dzReal * dzReal + dzImaginary * dzImaginary) {
+                dzReal = zReal;
+                dzImaginary = zImaginary;
+                m = 0;
+            }
+            const double twoZReal = 2 * referenceReal[m] + dzReal;
+            const double twoZImaginary = 2 * referenceImaginary[m] + dzImaginary;
+            const double nextReal = twoZReal * dzReal - twoZImaginary * dzImaginary + dcReal;
+            dzImaginary = twoZReal * dzImaginary + twoZImaginary * dzReal + dcImaginary;
+            dzReal = nextReal;
+            ++m;
+            ++count;
+        }
+        iterations[k] = count;
+        modulus2[k] = r2;
+    }
+}
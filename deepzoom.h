@@ -0,0 +1,101 @@
+#ifndef DEEPZOOM_H
+#define DEEPZOOM_H
+
+#include <cstddef>
+#include <vector>
+
+#include "complexkernels.h"
+#include "complexnumber.h"
+#include "fixedpoint.h"
+
+// Deep zooms into the Mandelbrot set by perturbation.
+//
+// One reference point C is iterated in fixed point, at the precision the zoom needs;
+// its orbit Z_n is kept as doubles. Every pixel C + dc is then iterated as the
+// difference dz_n to the reference orbit, in plain doubles:
+//
+//     dz_{n+1} = (2 Z_n + dz_n) dz_n + dc,   z_n = Z_n + dz_n.
+//
+// A cubic series in dc approximates dz_n for the first iterations of the whole
+// view at once, so pixels start at a later iteration. When |z_n| drops below |dz_n|
+// the difference has lost its precision (a glitch); the pixel is then rebased onto
+// the start of the reference orbit with dz = z_n, which needs no second reference.
+
+/**
+ * @brief Orbit of the reference point, rounded to double.
+ */
+struct ReferenceOrbit {
+    /** @brief Z_0 = 0 to the first escaped Z_n, or to Z_maxIterations. */
+    std::vector<double> real;
+    std::vector<double> imaginary;
+};
+
+/**
+ * @brief Iterates the reference point in fixed point.
+ *
+ * @param cReal real part of the reference point (const FixedPoint&).
+ * @param cImaginary imaginary part of the reference point (const FixedPoint&).
+ * @param maxIterations iteration limit (unsigned).
+ * @return the orbit (ReferenceOrbit).
+ */
+ReferenceOrbit referenceOrbit(const FixedPoint &cReal, const FixedPoint &cImaginary, unsigned maxIterations);
+
+/**
+ * @brief Series dz_skip = a u + b u^2 + c u^3 with u = dc / radius.
+ *
+ * The coefficients are stored scaled by powers of radius, so they stay in double
+ * range at any zoom depth.
+ */
+struct SeriesApproximation {
+    /** @brief Number of iterations the series replaces. */
+    unsigned skip = 0;
+
+    /** @brief Largest |dc| of the view. */
+    double radius = 1;
+
+    ComplexNumber a;
+    ComplexNumber b;
+    ComplexNumber c;
+
+    /**
+     * @brief dz at iteration skip for one pixel.
+     *
+     * @param dc offset of the pixel from the reference point (const ComplexNumber&).
+     * @return dz_skip (ComplexNumber).
+     */
+    ComplexNumber evaluate(const ComplexNumber &dc) const;
+};
+
+/**
+ * @brief Finds how many iterations a cubic series can skip for a view.
+ *
+ * The series is extended while its cubic term stays negligible against the linear
+ * one. It is then checked against plain perturbation at the probe points (usually
+ * the corners of the view) and shortened until it agrees.
+ *
+ * @param orbit reference orbit (const ReferenceOrbit&).
+ * @param radius largest |dc| of the view, positive (double).
+ * @param probes offsets of the probe points (const std::vector<ComplexNumber>&).
+ * @return the series (SeriesApproximation).
+ */
+SeriesApproximation seriesApproximation(const ReferenceOrbit &orbit, double radius,
+                                        const std::vector<ComplexNumber> &probes);
+
+/**
+ * @brief Escape-time iteration of a row of pixels by perturbation.
+ *
+ * Takes the same row description and gives the same results as the escapeTime
+ * kernel, except that the row coordinates are offsets from the reference point and
+ * row.julia is ignored.
+ *
+ * @param orbit reference orbit (const ReferenceOrbit&).
+ * @param series series approximation for the view (const SeriesApproximation&).
+ * @param row pixel offsets and iteration limit (const EscapeRow&).
+ * @param n number of pixels (std::size_t).
+ * @param iterations iterations done per pixel, maxIterations if it did not escape (double*).
+ * @param modulus2 final squared modulus per pixel (double*).
+ */
+void perturbRow(const ReferenceOrbit &orbit, const SeriesApproximation &series, const EscapeRow &row,
+                std::size_t n, double *iterations, double *modulus2);
+
+#endif // DEEPZOOM_H
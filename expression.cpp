@@ -0,0 +1,614 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "complexkernels.h"
+
+namespace {
+
+/**
+ * @brief Syntax tree node, only alive while compiling.
+ */
+struct Node {
+    OpCode op = OpCode::LoadConstant;
+    ComplexNumber value;
+    std::uint32_t index = 0;
+    int depth = 1;
+    std::unique_ptr<Node> left, right;
+
+    bool isConstant() const { return op == OpCode::LoadConstant; }
+};
+
+using NodePtr = std::unique_ptr<Node>;
+
+/**
+ * @brief Deepest nesting of parentheses, function calls, signs and exponents.
+ *
+ * The parser recurses once per level, so without a bound a long run of "(" or
+ * "sqrt(" overflows the stack before the register count is ever checked.
+ */
+constexpr int MaxNesting = 256;
+
+/**
+ * @brief Deepest syntax tree, reached by long chains such as x+x+...+x.
+ *
+ * Compiling and freeing the tree recurse along it, so its depth is bounded too.
+ */
+constexpr int MaxTreeDepth = 4096;
+
+/**
+ * @brief Number of registers needed to evaluate a subtree (Sethi-Ullman number).
+ */
+int registersNeeded(const Node &node)
+{
+    if (!node.left) {
+        return 1;
+    }
+    if (!node.right) {
+        return registersNeeded(*node.left);
+    }
+    const int left = registersNeeded(*node.left);
+    const int right = registersNeeded(*node.right);
+    return left == right ? left + 1 : std::max(left, right);
+}
+
+/**
+ * @brief Marks one element as failed.
+ */
+void setError(ErrorMask &errors, std::size_t index)
+{
+    errors.data()[index / 64] |= std::uint64_t(1) << (index % 64);
+}
+
+} // namespace
+
+/**
+ * @brief Recursive-descent parser producing Expression bytecode.
+ */
+class ExpressionCompiler {
+public:
+    ExpressionCompiler(const std::string &source, Expression &target)
+        : text(source), expression(target)
+    {
+    }
+
+    void compile()
+    {
+        NodePtr root = parseSum();
+        skipSpace();
+        if (position != text.size()) {
+            fail("Unexpected character");
+        }
+
+        const int needed = registersNeeded(*root);
+        if (needed > Expression::MaxRegisters) {
+            throw std::invalid_argument("Expression is nested too deeply!");
+        }
+        expression.registerCount = needed;
+        emit(*root, 0);
+    }
+
+private:
+    [[noreturn]] void fail(const char *message)
+    {
+        throw std::invalid_argument(std::string(message) + " at position "
+                                    + std::to_string(position + 1) + "!");
+    }
+
+    void skipSpace()
+    {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+            ++position;
+        }
+    }
+
+    bool accept(char c)
+    {
+        skipSpace();
+        if (position < text.size() && text[position] == c) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Builds a node, folding it when every operand is a constant.
+     */
+    NodePtr makeNode(OpCode op, NodePtr left, NodePtr right = nullptr)
+    {
+        const bool constant = left->isConstant() && (!right || right->isConstant());
+        if (constant) {
+            ComplexStatus status = ComplexStatus::Ok;
+            const ComplexNumber value = right ? applyOperation(op, left->value, right->value, status)
+                                              : applyUnary(op, left->value, status);
+            // Division by zero is left for run time so it gets reported there.
+            if (status == ComplexStatus::Ok) {
+                left->value = value;
+                return left;
+            }
+        }
+
+        NodePtr node = std::make_unique<Node>();
+        node->op = op;
+        node->depth = std::max(left->depth, right ? right->depth : 0) + 1;
+        if (node->depth > MaxTreeDepth) {
+            fail("Expression is too long");
+        }
+        node->left = std::move(left);
+        node->right = std::move(right);
+        return node;
+    }
+
+    NodePtr parseSum()
+    {
+        NodePtr node = parseProduct();
+        for (;;) {
+            if (accept('+')) {
+                node = makeNode(OpCode::Add, std::move(node), parseProduct());
+            } else if (accept('-')) {
+                node = makeNode(OpCode::Subtract, std::move(node), parseProduct());
+            } else {
+                return node;
+            }
+        }
+    }
+
+    NodePtr parseProduct()
+    {
+        NodePtr node = parseUnary();
+        for (;;) {
+            if (accept('*')) {
+                node = makeNode(OpCode::Multiply, std::move(node), parseUnary());
+            } else if (accept('/')) {
+                node = makeNode(OpCode::Divide, std::move(node), parseUnary());
+            } else {
+                return node;
+            }
+        }
+    }
+
+    NodePtr parseUnary()
+    {
+        // Every nested parenthesis, function argument, sign and exponent comes through here.
+        if (nesting == MaxNesting) {
+            fail("Expression is nested too deeply");
+        }
+        ++nesting;
+        NodePtr node;
+        if (accept('-')) {
+            node = makeNode(OpCode::Negate, parseUnary());
+        } else if (accept('+')) {
+            node = parseUnary();
+        } else {
+            node = parsePower();
+        }
+        --nesting;
+        return node;
+    }
+
+    NodePtr parsePower()
+    {
+        NodePtr node = parsePrimary();
+        if (!accept('^')) {
+            return node;
+        }
+        NodePtr exponent = parseUnary();
+        if (!exponent->isConstant() || !isIntegerExponent(exponent->value)) {
+            return makeNode(OpCode::Power, std::move(node), std::move(exponent));
+        }
+
+        // Whole constant exponents become an operand of a unary instruction.
+        const int n = static_cast<int>(exponent->value.getReal());
+        if (node->isConstant()) {
+            ComplexStatus status = ComplexStatus::Ok;
+            const ComplexNumber value = node->value.tryPower(n, status);
+            if (status == ComplexStatus::Ok) {
+                node->value = value;
+                return node;
+            }
+        }
+        // 0^-n is left for run time so it gets reported there.
+        NodePtr power = std::make_unique<Node>();
+        power->op = OpCode::IntegerPower;
+        power->depth = node->depth + 1;
+        if (power->depth > MaxTreeDepth) {
+            fail("Expression is too long");
+        }
+        power->left = std::move(node);
+        power->index = static_cast<std::uint32_t>(n);
+        return power;
+    }
+
+    NodePtr parsePrimary()
+    {
+        skipSpace();
+        if (position >= text.size()) {
+            fail("Unexpected end of expression");
+        }
+
+        if (accept('(')) {
+            NodePtr node = parseSum();
+            if (!accept(')')) {
+                fail("Missing ')'");
+            }
+            return node;
+        }
+
+        const char c = text[position];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            return parseNumber();
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            return parseName();
+        }
+        fail("Unexpected character");
+    }
+
+    NodePtr parseNumber()
+    {
+        // from_chars is locale independent, unlike strtod under QApplication.
+        const char *begin = text.c_str() + position;
+        double value = 0;
+        auto parsed = std::from_chars(begin, text.c_str() + text.size(), value);
+        if (parsed.ec != std::errc()) {
+            fail("Malformed number");
+        }
+        position += parsed.ptr - begin;
+
+        NodePtr node = std::make_unique<Node>();
+        if (position < text.size() && text[position] == 'i'
+            && !(position + 1 < text.size()
+                 && (std::isalnum(static_cast<unsigned char>(text[position + 1]))
+                     || text[position + 1] == '_'))) {
+            ++position;
+            node->value = ComplexNumber(0, value);
+        } else {
+            node->value = ComplexNumber(value, 0);
+        }
+        return node;
+    }
+
+    NodePtr parseName()
+    {
+        const std::size_t start = position;
+        while (position < text.size()
+               && (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_')) {
+            ++position;
+        }
+        const std::string name = text.substr(start, position - start);
+
+        static const struct {
+            const char *name;
+            OpCode op;
+        } functions[] = {
+            {"sqrt", OpCode::Root},
+            {"conj", OpCode::Conjugate},
+            {"inv", OpCode::Inverse},
+            {"abs", OpCode::Absolute},
+            {"exp", OpCode::Exponential},
+            {"log", OpCode::Logarithm},
+            {"sin", OpCode::Sine},
+            {"cos", OpCode::Cosine},
+            {"tan", OpCode::Tangent},
+            {"sinh", OpCode::HyperbolicSine},
+            {"cosh", OpCode::HyperbolicCosine},
+            {"tanh", OpCode::HyperbolicTangent},
+        };
+        for (const auto &function : functions) {
+            if (name == function.name) {
+                if (!accept('(')) {
+                    fail("Missing '(' after function name");
+                }
+                NodePtr argument = parseSum();
+                if (!accept(')')) {
+                    fail("Missing ')'");
+                }
+                return makeNode(function.op, std::move(argument));
+            }
+        }
+
+        NodePtr node = std::make_unique<Node>();
+        if (name == "i") {
+            node->value = ComplexNumber(0, 1);
+            return node;
+        }
+
+        auto &names = expression.variableNames;
+        auto found = std::find(names.begin(), names.end(), name);
+        node->op = OpCode::LoadVariable;
+        node->index = static_cast<std::uint32_t>(found - names.begin());
+        if (found == names.end()) {
+            names.push_back(name);
+        }
+        return node;
+    }
+
+    /**
+     * @brief Emits code leaving the value of node in register target.
+     *
+     * The child needing more registers is evaluated first, so the total stays at
+     * registersNeeded(root).
+     */
+    void emit(const Node &node, int target)
+    {
+        Expression::Instruction instruction{node.op, static_cast<std::uint8_t>(target),
+                                            static_cast<std::uint8_t>(target), 0, node.index};
+        if (node.op == OpCode::LoadConstant) {
+            instruction.index = static_cast<std::uint32_t>(expression.constants.size());
+            expression.constants.push_back(node.value);
+        } else if (node.right) {
+            if (registersNeeded(*node.right) > registersNeeded(*node.left)) {
+                emit(*node.right, target);
+                emit(*node.left, target + 1);
+                instruction.a = static_cast<std::uint8_t>(target + 1);
+                instruction.b = static_cast<std::uint8_t>(target);
+            } else {
+                emit(*node.left, target);
+                emit(*node.right, target + 1);
+                instruction.b = static_cast<std::uint8_t>(target + 1);
+            }
+        } else if (node.left) {
+            emit(*node.left, target);
+        }
+        expression.code.push_back(instruction);
+    }
+
+    const std::string &text;
+    Expression &expression;
+    std::size_t position = 0;
+    int nesting = 0;
+};
+
+/**
+ * @brief Compiles an expression.
+ *
+ * @param source expression text (const std::string&).
+ * @throws std::invalid_argument If the text is not a valid expression.
+ */
+Expression::Expression(const std::string &source)
+{
+    ExpressionCompiler(source, *this).compile();
+}
+
+/**
+ * @brief Position of a variable in the binding order.
+ *
+ * @param name variable name (const std::string&).
+ * @return index, or -1 if the expression does not use the variable (int).
+ */
+int Expression::variableIndex(const std::string &name) const
+{
+    auto found = std::find(variableNames.begin(), variableNames.end(), name);
+    return found == variableNames.end() ? -1 : static_cast<int>(found - variableNames.begin());
+}
+
+/**
+ * @brief Evaluates the expression without throwing.
+ *
+ * @param bindings one value per variable (const ComplexNumber*).
+ * @param status set to DivisionByZero if any division hit a zero divisor (ComplexStatus&).
+ * @return result (ComplexNumber).
+ */
+ComplexNumber Expression::evaluate(const ComplexNumber *bindings, ComplexStatus &status) const noexcept
+{
+    // Left uninitialized on purpose: every register is written before it is read.
+    double re[MaxRegisters], im[MaxRegisters];
+    auto load = [&](int r) { return ComplexNumber(re[r], im[r]); };
+    status = ComplexStatus::Ok;
+
+    for (const Instruction &instruction : code) {
+        ComplexNumber value;
+        switch (instruction.op) {
+        case OpCode::LoadConstant:
+            value = constants[instruction.index];
+            break;
+        case OpCode::LoadVariable:
+            value = bindings[instruction.index];
+            break;
+        case OpCode::Add:
+            value = load(instruction.a).add(load(instruction.b));
+            break;
+        case OpCode::Subtract:
+            value = load(instruction.a).subtract(load(instruction.b));
+            break;
+        case OpCode::Multiply:
+            value = load(instruction.a).multiply(load(instruction.b));
+            break;
+        case OpCode::Divide:
+        case OpCode::Power:
+            value = applyOperation(instruction.op, load(instruction.a), load(instruction.b), status);
+            break;
+        case OpCode::IntegerPower: {
+            ComplexStatus powerStatus;
+            value = load(instruction.a).tryPower(static_cast<std::int32_t>(instruction.index), powerStatus);
+            if (powerStatus != ComplexStatus::Ok) {
+                status = powerStatus;
+            }
+            break;
+        }
+        default:
+            value = applyUnary(instruction.op, load(instruction.a), status);
+            break;
+        }
+        re[instruction.target] = value.getReal();
+        im[instruction.target] = value.getImaginary();
+    }
+    return load(0);
+}
+
+/**
+ * @brief Evaluates the expression.
+ *
+ * @param bindings one value per variable (const ComplexNumber*).
+ * @throws std::invalid_argument If a division by zero occurs.
+ * @return result (ComplexNumber).
+ */
+ComplexNumber Expression::evaluate(const ComplexNumber *bindings) const
+{
+    ComplexStatus status;
+    ComplexNumber result = evaluate(bindings, status);
+    if (status != ComplexStatus::Ok) {
+        throw std::invalid_argument("Division by zero!");
+    }
+    return result;
+}
+
+/**
+ * @brief Evaluates the expression for many bindings at once.
+ *
+ * Instructions are dispatched once per block of elements and run through the
+ * SIMD kernels, so interpretation overhead is amortized over the block.
+ *
+ * @param bindings one array per variable (const std::vector<const ComplexArray*>&).
+ * @param result values (ComplexArray&).
+ * @param errors mask of failed elements (ErrorMask&).
+ * @throws std::invalid_argument If the binding count or sizes do not match.
+ */
+void Expression::evaluate(const std::vector<const ComplexArray *> &bindings, ComplexArray &result,
+                          ErrorMask &errors) const
+{
+    if (bindings.size() != variableNames.size()) {
+        throw std::invalid_argument("Wrong number of variable bindings!");
+    }
+    const std::size_t count = bindings.empty() ? result.size() : bindings.front()->size();
+    for (const ComplexArray *binding : bindings) {
+        if (binding->size() != count) {
+            throw std::invalid_argument("Array sizes differ!");
+        }
+    }
+    if (result.size() != count) {
+        result = ComplexArray(count);
+    }
+    errors.reset(count);
+
+    constexpr std::size_t BlockSize = 256;
+    const ComplexKernels &kernels = activeKernels();
+    // One block past the registers is scratch space for instructions that cannot write
+    // their target in place.
+    const int scratch = registerCount;
+    std::vector<double> storage(2 * BlockSize * (registerCount + 1));
+    auto re = [&](int r) { return storage.data() + 2 * BlockSize * r; };
+    auto im = [&](int r) { return storage.data() + 2 * BlockSize * r + BlockSize; };
+
+    for (std::size_t start = 0; start < count; start += BlockSize) {
+        const std::size_t n = std::min(BlockSize, count - start);
+
+        for (const Instruction &instruction : code) {
+            const int t = instruction.target, a = instruction.a, b = instruction.b;
+            switch (instruction.op) {
+            case OpCode::LoadConstant: {
+                const ComplexNumber &value = constants[instruction.index];
+                std::fill(re(t), re(t) + n, value.getReal());
+                std::fill(im(t), im(t) + n, value.getImaginary());
+                break;
+            }
+            case OpCode::LoadVariable: {
+                const ComplexArray &source = *bindings[instruction.index];
+                std::memcpy(re(t), source.real() + start, n * sizeof(double));
+                std::memcpy(im(t), source.imaginary() + start, n * sizeof(double));
+                break;
+            }
+            case OpCode::Add:
+                kernels.add(re(a), im(a), re(b), im(b), re(t), im(t), n);
+                break;
+            case OpCode::Subtract:
+                kernels.subtract(re(a), im(a), re(b), im(b), re(t), im(t), n);
+                break;
+            case OpCode::Multiply:
+                kernels.multiply(re(a), im(a), re(b), im(b), re(t), im(t), n);
+                break;
+            case OpCode::Divide:
+                kernels.divide(re(a), im(a), re(b), im(b), re(t), im(t), n, errors.data(), start);
+                break;
+            case OpCode::Negate:
+                for (std::size_t k = 0; k < n; ++k) {
+                    re(t)[k] = -re(a)[k];
+                    im(t)[k] = -im(a)[k];
+                }
+                break;
+            case OpCode::Root:
+                kernels.root(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::Conjugate:
+                kernels.conjugate(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::Inverse:
+                kernels.inverse(re(a), im(a), re(t), im(t), n, errors.data(), start);
+                break;
+            case OpCode::Absolute:
+                kernels.absoluteValue(re(a), im(a), re(t), n);
+                std::fill(im(t), im(t) + n, 0.0);
+                break;
+            case OpCode::Exponential:
+                kernels.exponential(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::Logarithm:
+                kernels.logarithm(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::Sine:
+                kernels.sine(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::Cosine:
+                kernels.cosine(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::Tangent:
+                kernels.tangent(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::HyperbolicSine:
+                kernels.hyperbolicSine(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::HyperbolicCosine:
+                kernels.hyperbolicCosine(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::HyperbolicTangent:
+                kernels.hyperbolicTangent(re(a), im(a), re(t), im(t), n);
+                break;
+            case OpCode::Power:
+                // Elements with whole exponents are redone as in applyOperation(). The
+                // kernel writes to scratch, as the target may be one of the operands.
+                kernels.power(re(a), im(a), re(b), im(b), re(scratch), im(scratch), n);
+                for (std::size_t k = 0; k < n; ++k) {
+                    const ComplexNumber exponent(re(b)[k], im(b)[k]);
+                    if (isIntegerExponent(exponent)) {
+                        ComplexStatus status;
+                        const ComplexNumber value = ComplexNumber(re(a)[k], im(a)[k]).tryPower(
+                            static_cast<int>(exponent.getReal()), status);
+                        if (status != ComplexStatus::Ok) {
+                            setError(errors, start + k);
+                        }
+                        re(t)[k] = value.getReal();
+                        im(t)[k] = value.getImaginary();
+                    } else {
+                        re(t)[k] = re(scratch)[k];
+                        im(t)[k] = im(scratch)[k];
+                    }
+                }
+                break;
+            case OpCode::IntegerPower:
+                for (std::size_t k = 0; k < n; ++k) {
+                    ComplexStatus status;
+                    const ComplexNumber value = ComplexNumber(re(a)[k], im(a)[k]).tryPower(
+                        static_cast<std::int32_t>(instruction.index), status);
+                    if (status != ComplexStatus::Ok) {
+                        setError(errors, start + k);
+                    }
+                    re(t)[k] = value.getReal();
+                    im(t)[k] = value.getImaginary();
+                }
+                break;
+            case OpCode::None:
+                break;
+            }
+        }
+
+        std::memcpy(result.real() + start, re(0), n * sizeof(double));
+        std::memcpy(result.imaginary() + start, im(0), n * sizeof(double));
+    }
+    errors.recount();
+}
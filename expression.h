@@ -0,0 +1,276 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "complexarray.h"
+#include "complexnumber.h"
+
+/**
+ * @brief Operations understood by the expression VM and the calculator keypad.
+ */
+enum class OpCode : std::uint8_t {
+    None,
+    LoadConstant,
+    LoadVariable,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Negate,
+    Root,
+    Conjugate,
+    Inverse,
+    Absolute,
+    Exponential,
+    Logarithm,
+    Sine,
+    Cosine,
+    Tangent,
+    HyperbolicSine,
+    HyperbolicCosine,
+    HyperbolicTangent,
+    Power,
+    IntegerPower
+};
+
+/**
+ * @brief Whether a number is a whole real number usable as an int exponent.
+ *
+ * @param a number (const BasicComplex<T>&).
+ * @return true for a zero imaginary part and a whole real part of at most 2^30 in magnitude (bool).
+ */
+template<typename T>
+inline bool isIntegerExponent(const BasicComplex<T> &a) noexcept
+{
+    const T real = a.getReal();
+    return a.getImaginary() == 0 && real <= T(0x1p30) && real >= T(-0x1p30)
+           && real == static_cast<T>(static_cast<int>(real));
+}
+
+/**
+ * @brief Applies a binary operation to two numbers.
+ *
+ * Division by zero does not throw; it is reported through status. Power uses binary
+ * exponentiation for integer exponents (see isIntegerExponent()) and e^(b log a)
+ * otherwise.
+ *
+ * @param op Add, Subtract, Multiply, Divide or Power (OpCode).
+ * @param a left operand (const BasicComplex<T>&).
+ * @param b right operand (const BasicComplex<T>&).
+ * @param status set to DivisionByZero on a zero divisor or 0^-n, untouched otherwise (ComplexStatus&).
+ * @return result, zero for any other op (BasicComplex<T>).
+ */
+template<typename T>
+inline BasicComplex<T> applyOperation(OpCode op, const BasicComplex<T> &a, const BasicComplex<T> &b,
+                                      ComplexStatus &status) noexcept
+{
+    switch (op) {
+    case OpCode::Add:
+        return a.add(b);
+    case OpCode::Subtract:
+        return a.subtract(b);
+    case OpCode::Multiply:
+        return a.multiply(b);
+    case OpCode::Divide: {
+        ComplexStatus divisionStatus;
+        BasicComplex<T> result = a.tryDivide(b, divisionStatus);
+        if (divisionStatus != ComplexStatus::Ok) {
+            status = divisionStatus;
+        }
+        return result;
+    }
+    case OpCode::Power: {
+        if (!isIntegerExponent(b)) {
+            return a.power(b);
+        }
+        ComplexStatus powerStatus;
+        BasicComplex<T> result = a.tryPower(static_cast<int>(b.getReal()), powerStatus);
+        if (powerStatus != ComplexStatus::Ok) {
+            status = powerStatus;
+        }
+        return result;
+    }
+    default:
+        return BasicComplex<T>(0, 0);
+    }
+}
+
+/**
+ * @brief Applies a unary operation to a number.
+ *
+ * @param op Negate, Root, Conjugate, Inverse, Absolute or an elementary function (OpCode).
+ * @param a operand (const BasicComplex<T>&).
+ * @param status set to DivisionByZero for the inverse of zero, untouched otherwise (ComplexStatus&).
+ * @return result, the operand for any other op (BasicComplex<T>).
+ */
+template<typename T>
+inline BasicComplex<T> applyUnary(OpCode op, const BasicComplex<T> &a, ComplexStatus &status) noexcept
+{
+    switch (op) {
+    case OpCode::Negate:
+        return -a;
+    case OpCode::Root:
+        return a.root();
+    case OpCode::Conjugate:
+        return a.conjugate();
+    case OpCode::Inverse: {
+        ComplexStatus inverseStatus;
+        BasicComplex<T> result = a.tryInverse(inverseStatus);
+        if (inverseStatus != ComplexStatus::Ok) {
+            status = inverseStatus;
+        }
+        return result;
+    }
+    case OpCode::Absolute:
+        return BasicComplex<T>(a.absoluteValue(), 0);
+    case OpCode::Exponential:
+        return a.exponential();
+    case OpCode::Logarithm:
+        return a.logarithm();
+    case OpCode::Sine:
+        return a.sine();
+    case OpCode::Cosine:
+        return a.cosine();
+    case OpCode::Tangent:
+        return a.tangent();
+    case OpCode::HyperbolicSine:
+        return a.hyperbolicSine();
+    case OpCode::HyperbolicCosine:
+        return a.hyperbolicCosine();
+    case OpCode::HyperbolicTangent:
+        return a.hyperbolicTangent();
+    default:
+        return a;
+    }
+}
+
+/**
+ * @brief Complex expression compiled once to register bytecode.
+ *
+ * Grammar: numbers with an optional imaginary suffix ("2.5", "3i", "i"), variables,
+ * + - * /, ^ (right associative, binding tighter than unary minus), unary minus,
+ * parentheses and the functions sqrt, conj, inv, abs, exp, log, sin, cos, tan, sinh,
+ * cosh and tanh, e.g. "(3+2i)*(1-i)/sqrt(4i) + conj(z)^3". Constant whole exponents
+ * compile to binary exponentiation. Constant sub-expressions are folded while
+ * compiling.
+ *
+ * Evaluation uses a fixed register file on the stack and never allocates, so one
+ * compiled expression can be re-evaluated cheaply for many variable bindings. A
+ * block form runs each instruction over a whole block of bindings at a time.
+ */
+class Expression {
+public:
+    /**
+     * @brief Upper bound on registers, limits the nesting depth of expressions.
+     */
+    static constexpr int MaxRegisters = 64;
+
+    /**
+     * @brief Compiles an expression.
+     *
+     * Nesting is limited to 256 levels and the syntax tree to a depth of 4096, so
+     * hostile input is rejected instead of overflowing the stack.
+     *
+     * @param source expression text (const std::string&).
+     * @throws std::invalid_argument If the text is not a valid expression or exceeds the limits.
+     */
+    explicit Expression(const std::string &source);
+
+    /**
+     * @brief Names of the variables, in binding order.
+     *
+     * @return variable names (const std::vector<std::string>&).
+     */
+    const std::vector<std::string> &variables() const { return variableNames; }
+
+    /**
+     * @brief Position of a variable in the binding order.
+     *
+     * @param name variable name (const std::string&).
+     * @return index, or -1 if the expression does not use the variable (int).
+     */
+    int variableIndex(const std::string &name) const;
+
+    /**
+     * @brief Evaluates the expression without throwing.
+     *
+     * @param bindings one value per variable, in variables() order (const ComplexNumber*).
+     * @param status set to DivisionByZero if any division hit a zero divisor (ComplexStatus&).
+     * @return result (ComplexNumber).
+     */
+    ComplexNumber evaluate(const ComplexNumber *bindings, ComplexStatus &status) const noexcept;
+
+    /**
+     * @brief Evaluates the expression.
+     *
+     * @param bindings one value per variable, in variables() order (const ComplexNumber*).
+     * @throws std::invalid_argument If a division by zero occurs.
+     * @return result (ComplexNumber).
+     */
+    ComplexNumber evaluate(const ComplexNumber *bindings = nullptr) const;
+
+    /**
+     * @brief Evaluates the expression for many bindings at once.
+     *
+     * Element k of every array in bindings forms one binding; element k of result
+     * receives its value and bit k of errors is set if it divided by zero. The
+     * result is resized to the bindings when needed (expressions without variables
+     * keep its size).
+     *
+     * @param bindings one array per variable, in variables() order (const std::vector<const ComplexArray*>&).
+     * @param result values (ComplexArray&).
+     * @param errors mask of failed elements (ErrorMask&).
+     * @throws std::invalid_argument If the binding count or sizes do not match.
+     */
+    void evaluate(const std::vector<const ComplexArray *> &bindings, ComplexArray &result,
+                  ErrorMask &errors) const;
+
+    /**
+     * @brief Number of bytecode instructions.
+     */
+    std::size_t instructionCount() const { return code.size(); }
+
+private:
+    /**
+     * @brief One register-machine instruction.
+     *
+     * Loads use index into the constant or variable table, IntegerPower holds its
+     * exponent there as an int32_t; the others read registers a and b and write
+     * register target.
+     */
+    struct Instruction {
+        OpCode op;
+        std::uint8_t target;
+        std::uint8_t a;
+        std::uint8_t b;
+        std::uint32_t index;
+    };
+
+    friend class ExpressionCompiler;
+
+    /**
+     * @brief Compiled instructions, the result ends up in register 0.
+     */
+    std::vector<Instruction> code;
+
+    /**
+     * @brief Constant table.
+     */
+    std::vector<ComplexNumber> constants;
+
+    /**
+     * @brief Variable names in binding order.
+     */
+    std::vector<std::string> variableNames;
+
+    /**
+     * @brief Number of registers used by the code.
+     */
+    int registerCount = 1;
+};
+
+#endif // EXPRESSION_H
@@ -0,0 +1,336 @@
+#include "fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "reduction.h"
+
+namespace {
+
+/**
+ * @brief Transforms shorter than this run on the calling thread only.
+ */
+constexpr std::size_t ParallelThreshold = 1 << 15;
+
+/**
+ * @brief Butterflies per chunk when a pass is split over threads.
+ */
+constexpr std::size_t ButterfliesPerChunk = 1 << 11;
+
+const double Pi = 3.14159265358979323846;
+
+/**
+ * @brief Whether n has no prime factors other than 2, 3 and 5.
+ */
+bool isSmooth(std::size_t n)
+{
+    for (std::size_t factor : {2, 3, 5}) {
+        while (n % factor == 0) {
+            n /= factor;
+        }
+    }
+    return n == 1;
+}
+
+/**
+ * @brief Plans shared by FftPlan::cached().
+ */
+std::mutex cacheMutex;
+std::unordered_map<std::size_t, std::shared_ptr<const FftPlan>> planCache;
+
+} // namespace
+
+/**
+ * @brief Builds the plan.
+ *
+ * @param size transform length (std::size_t).
+ * @throws std::invalid_argument If size is zero.
+ */
+FftPlan::FftPlan(std::size_t size)
+    : length(size)
+{
+    if (size == 0) {
+        throw std::invalid_argument("FFT size must be positive!");
+    }
+
+    if (!isSmooth(size)) {
+        // Bluestein: X[k] = c[k] * sum_j (x[j] c[j]) conj(c[k - j]) with c[j] = exp(-pi i j^2 / n).
+        std::size_t padded = 2 * size - 1;
+        while (!isSmooth(padded)) {
+            ++padded;
+        }
+        inner.reset(new FftPlan(padded));
+
+        chirp = ComplexArray(size);
+        std::size_t square = 0; // j^2 mod 2n, kept small so the angle stays exact
+        for (std::size_t j = 0; j < size; ++j) {
+            const double angle = -Pi * static_cast<double>(square) / static_cast<double>(size);
+            chirp.set(j, ComplexNumber(std::cos(angle), std::sin(angle)));
+            square = (square + 2 * j + 1) % (2 * size);
+        }
+
+        ComplexArray kernel(padded);
+        for (std::size_t t = 0; t < size; ++t) {
+            const ComplexNumber conjugate = chirp.get(t).conjugate();
+            kernel.set(t, conjugate);
+            if (t != 0) {
+                kernel.set(padded - t, conjugate);
+            }
+        }
+        inner->forward(kernel, filter, 1);
+        const double scale = 1.0 / static_cast<double>(padded);
+        for (std::size_t k = 0; k < padded; ++k) {
+            filter.real()[k] *= scale;
+            filter.imaginary()[k] *= scale;
+        }
+        return;
+    }
+
+    std::vector<std::size_t> radices;
+    std::size_t rest = size;
+    while (rest % 4 == 0) {
+        radices.push_back(4);
+        rest /= 4;
+    }
+    for (std::size_t radix : {2, 3, 5}) {
+        while (rest % radix == 0) {
+            radices.push_back(radix);
+            rest /= radix;
+        }
+    }
+
+    // Pass with radix r on sub-transforms of length l: the twiddle of (p, k) is
+    // exp(-2 pi i p k / l), for p < l / r and 0 < k < r.
+    std::vector<std::size_t> offsets;
+    std::size_t l = size, stride = 1;
+    for (std::size_t radix : radices) {
+        const std::size_t m = l / radix;
+        offsets.push_back(twiddleReal.size());
+        for (std::size_t p = 0; p < m; ++p) {
+            for (std::size_t k = 1; k < radix; ++k) {
+                const double angle = -2 * Pi * static_cast<double>(p * k % l) / static_cast<double>(l);
+                twiddleReal.push_back(std::cos(angle));
+                twiddleImaginary.push_back(std::sin(angle));
+            }
+        }
+        passes.push_back({radix, m, stride, nullptr, nullptr});
+        l = m;
+        stride *= radix;
+    }
+    for (std::size_t k = 0; k < passes.size(); ++k) {
+        passes[k].twiddleReal = twiddleReal.data() + offsets[k];
+        passes[k].twiddleImaginary = twiddleImaginary.data() + offsets[k];
+    }
+}
+
+/**
+ * @brief Shared plan for a size, built on first use.
+ *
+ * @param size transform length (std::size_t).
+ * @throws std::invalid_argument If size is zero.
+ * @return the plan (std::shared_ptr<const FftPlan>).
+ */
+std::shared_ptr<const FftPlan> FftPlan::cached(std::size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        const auto found = planCache.find(size);
+        if (found != planCache.end()) {
+            return found->second;
+        }
+    }
+    // Built outside the lock, so other sizes are not held up; the first plan stored wins.
+    std::shared_ptr<const FftPlan> plan = std::make_shared<const FftPlan>(size);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return planCache.emplace(size, std::move(plan)).first->second;
+}
+
+/**
+ * @brief Drops all cached plans (plans still in use stay alive).
+ */
+void FftPlan::clearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    planCache.clear();
+}
+
+/**
+ * @brief Forward transform, X[k] = sum_j x[j] exp(-2 pi i j k / n).
+ *
+ * @param input time-domain values (const ComplexArray&).
+ * @param output frequency-domain values (ComplexArray&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If input does not have size() elements.
+ */
+void FftPlan::forward(const ComplexArray &input, ComplexArray &output, unsigned threads) const
+{
+    if (input.size() != length) {
+        throw std::invalid_argument("FFT input size does not match the plan!");
+    }
+    if (output.size() != length) {
+        output = ComplexArray(length);
+    }
+    execute(input.real(), input.imaginary(), output.real(), output.imaginary(), threads);
+}
+
+/**
+ * @brief Inverse transform, x[j] = 1/n sum_k X[k] exp(2 pi i j k / n).
+ *
+ * Runs the forward transform with real and imaginary parts swapped on both sides,
+ * which conjugates the roots of unity, and scales by 1/n.
+ *
+ * @param input frequency-domain values (const ComplexArray&).
+ * @param output time-domain values (ComplexArray&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If input does not have size() elements.
+ */
+void FftPlan::inverse(const ComplexArray &input, ComplexArray &output, unsigned threads) const
+{
+    if (input.size() != length) {
+        throw std::invalid_argument("FFT input size does not match the plan!");
+    }
+    if (output.size() != length) {
+        output = ComplexArray(length);
+    }
+    execute(input.imaginary(), input.real(), output.imaginary(), output.real(), threads);
+
+    const double scale = 1.0 / static_cast<double>(length);
+    double *re = output.real(), *im = output.imaginary();
+    for (std::size_t k = 0; k < length; ++k) {
+        re[k] *= scale;
+        im[k] *= scale;
+    }
+}
+
+/**
+ * @brief Unnormalized forward transform between raw buffers, which may be the same.
+ */
+void FftPlan::execute(const double *xr, const double *xi, double *yr, double *yi, unsigned threads) const
+{
+    if (length < ParallelThreshold) {
+        threads = 1;
+    }
+    if (inner) {
+        runBluestein(xr, xi, yr, yi, threads);
+        return;
+    }
+    if (passes.empty()) {
+        yr[0] = xr[0];
+        yi[0] = xi[0];
+        return;
+    }
+
+    // Passes alternate between y and a per-thread scratch buffer, arranged so that
+    // the last one writes y.
+    thread_local std::vector<double> scratch;
+    if (scratch.size() < 2 * length) {
+        scratch.resize(2 * length);
+    }
+    double *sr = scratch.data(), *si = sr + length;
+
+    const std::size_t count = passes.size();
+    if (xr == yr && count % 2 == 1) {
+        // In place with the first pass writing y: move the input out of the way.
+        std::copy(xr, xr + length, sr);
+        std::copy(xi, xi + length, si);
+        xr = sr;
+        xi = si;
+    }
+    for (std::size_t k = 0; k < count; ++k) {
+        const bool toOutput = (count - 1 - k) % 2 == 0;
+        double *dr = toOutput ? yr : sr, *di = toOutput ? yi : si;
+        runPass(passes[k], xr, xi, dr, di, threads);
+        xr = dr;
+        xi = di;
+    }
+}
+
+/**
+ * @brief Runs one radix pass from x to y, split over threads for large sizes.
+ *
+ * Early passes have many sub-transforms and are split over p, late ones have long
+ * strides and are split over q.
+ */
+void FftPlan::runPass(const FftPass &pass, const double *xr, const double *xi, double *yr, double *yi,
+                      unsigned threads) const
+{
+    const ComplexKernels &kernels = activeKernels();
+    if (threads == 1) {
+        kernels.fftPass(pass, xr, xi, yr, yi, 0, pass.m, 0, pass.stride);
+        return;
+    }
+    if (pass.m >= pass.stride) {
+        const std::size_t chunk = std::max<std::size_t>(1, ButterfliesPerChunk / pass.stride);
+        parallelChunks((pass.m + chunk - 1) / chunk, threads, [&](std::size_t index) {
+            kernels.fftPass(pass, xr, xi, yr, yi, index * chunk, std::min(pass.m, (index + 1) * chunk), 0,
+                            pass.stride);
+        });
+    } else {
+        // Multiples of eight keep every chunk on whole vectors.
+        const std::size_t chunk = (std::max<std::size_t>(8, ButterfliesPerChunk / pass.m) + 7) / 8 * 8;
+        parallelChunks((pass.stride + chunk - 1) / chunk, threads, [&](std::size_t index) {
+            kernels.fftPass(pass, xr, xi, yr, yi, 0, pass.m, index * chunk,
+                            std::min(pass.stride, (index + 1) * chunk));
+        });
+    }
+}
+
+/**
+ * @brief Bluestein transform through the inner plan.
+ */
+void FftPlan::runBluestein(const double *xr, const double *xi, double *yr, double *yi,
+                           unsigned threads) const
+{
+    const ComplexKernels &kernels = activeKernels();
+    const std::size_t padded = inner->length;
+
+    // Separate from the scratch of execute(), which the inner plan uses meanwhile.
+    thread_local std::vector<double> work;
+    if (work.size() < 2 * padded) {
+        work.resize(2 * padded);
+    }
+    double *wr = work.data(), *wi = wr + padded;
+
+    kernels.multiply(xr, xi, chirp.real(), chirp.imaginary(), wr, wi, length);
+    std::fill(wr + length, wr + padded, 0.0);
+    std::fill(wi + length, wi + padded, 0.0);
+
+    inner->execute(wr, wi, wr, wi, threads);
+    kernels.multiply(wr, wi, filter.real(), filter.imaginary(), wr, wi, padded);
+    inner->execute(wi, wr, wi, wr, threads); // inverse, already scaled through the filter
+
+    kernels.multiply(wr, wi, chirp.real(), chirp.imaginary(), yr, yi, length);
+}
+
+/**
+ * @brief Forward transform through the cached plan of the input size.
+ *
+ * @param input time-domain values, not empty (const ComplexArray&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If input is empty.
+ * @return frequency-domain values (ComplexArray).
+ */
+ComplexArray fft(const ComplexArray &input, unsigned threads)
+{
+    ComplexArray output(input.size());
+    FftPlan::cached(input.size())->forward(input, output, threads);
+    return output;
+}
+
+/**
+ * @brief Inverse transform through the cached plan of the input size.
+ *
+ * @param input frequency-domain values, not empty (const ComplexArray&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If input is empty.
+ * @return time-domain values (ComplexArray).
+ */
+ComplexArray inverseFft(const ComplexArray &input, unsigned threads)
+{
+    ComplexArray output(input.size());
+    FftPlan::cached(input.size())->inverse(input, output, threads);
+    return output;
+}
@@ -0,0 +1,149 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "complexarray.h"
+#include "complexkernels.h"
+
+/**
+ * @brief Precomputed discrete Fourier transform of one size.
+ *
+ * Sizes whose only prime factors are 2, 3 and 5 run as a mixed-radix Stockham FFT:
+ * one pass per radix 4, 2, 3 or 5, each reading one buffer and writing the other,
+ * so no bit reversal is needed. The passes run on the fftPass kernel of
+ * activeKernels(), vectorized across independent butterflies, and large transforms
+ * split every pass over several threads.
+ *
+ * Any other size goes through Bluestein's algorithm: the DFT is rewritten as a
+ * convolution with a chirp, evaluated with a 2/3/5-smooth FFT of at least twice the
+ * size. The transformed chirp is part of the plan.
+ *
+ * All tables are built by the constructor; transforms only read the plan, so one plan
+ * can be used from several threads at once. cached() keeps one plan per size.
+ */
+class FftPlan {
+public:
+    /**
+     * @brief Builds the plan.
+     *
+     * @param size transform length (std::size_t).
+     * @throws std::invalid_argument If size is zero.
+     */
+    explicit FftPlan(std::size_t size);
+
+    /**
+     * @brief Shared plan for a size, built on first use.
+     *
+     * @param size transform length (std::size_t).
+     * @throws std::invalid_argument If size is zero.
+     * @return the plan (std::shared_ptr<const FftPlan>).
+     */
+    static std::shared_ptr<const FftPlan> cached(std::size_t size);
+
+    /**
+     * @brief Drops all cached plans (plans still in use stay alive).
+     */
+    static void clearCache();
+
+    /** @brief Transform length. */
+    std::size_t size() const { return length; }
+
+    /** @brief Whether the size needs Bluestein's algorithm. */
+    bool usesBluestein() const { return inner != nullptr; }
+
+    /**
+     * @brief Forward transform, X[k] = sum_j x[j] exp(-2 pi i j k / n).
+     *
+     * output may be the same array as input. It is resized when needed.
+     *
+     * @param input time-domain values (const ComplexArray&).
+     * @param output frequency-domain values (ComplexArray&).
+     * @param threads threads to use, 0 for one per hardware thread (unsigned).
+     * @throws std::invalid_argument If input does not have size() elements.
+     */
+    void forward(const ComplexArray &input, ComplexArray &output, unsigned threads = 0) const;
+
+    /**
+     * @brief Inverse transform, x[j] = 1/n sum_k X[k] exp(2 pi i j k / n).
+     *
+     * output may be the same array as input. It is resized when needed.
+     *
+     * @param input frequency-domain values (const ComplexArray&).
+     * @param output time-domain values (ComplexArray&).
+     * @param threads threads to use, 0 for one per hardware thread (unsigned).
+     * @throws std::invalid_argument If input does not have size() elements.
+     */
+    void inverse(const ComplexArray &input, ComplexArray &output, unsigned threads = 0) const;
+
+private:
+    /**
+     * @brief Unnormalized forward transform between raw buffers, which may be the same.
+     */
+    void execute(const double *xr, const double *xi, double *yr, double *yi, unsigned threads) const;
+
+    /**
+     * @brief Runs one radix pass from x to y, split over threads for large sizes.
+     */
+    void runPass(const FftPass &pass, const double *xr, const double *xi, double *yr, double *yi,
+                 unsigned threads) const;
+
+    /**
+     * @brief Bluestein transform through the inner plan.
+     */
+    void runBluestein(const double *xr, const double *xi, double *yr, double *yi, unsigned threads) const;
+
+    /**
+     * @brief Transform length.
+     */
+    std::size_t length;
+
+    /**
+     * @brief Radix passes, in execution order (empty for Bluestein and size 1).
+     */
+    std::vector<FftPass> passes;
+
+    /**
+     * @brief Storage of the twiddle factors the passes point into.
+     */
+    std::vector<double> twiddleReal, twiddleImaginary;
+
+    /**
+     * @brief Smooth plan of at least 2n - 1 points for Bluestein, null otherwise.
+     */
+    std::unique_ptr<FftPlan> inner;
+
+    /**
+     * @brief Chirp exp(-pi i j^2 / n) for j < n (Bluestein only).
+     */
+    ComplexArray chirp;
+
+    /**
+     * @brief Transformed conjugate chirp, pre-divided by the inner size (Bluestein only).
+     */
+    ComplexArray filter;
+};
+
+/**
+ * @brief Forward transform through the cached plan of the input size.
+ *
+ * @param input time-domain values, not empty (const ComplexArray&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If input is empty.
+ * @return frequency-domain values (ComplexArray).
+ */
+ComplexArray fft(const ComplexArray &input, unsigned threads = 0);
+
+/**
+ * @brief Inverse transform through the cached plan of the input size.
+ *
+ * @param input frequency-domain values, not empty (const ComplexArray&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If input is empty.
+ * @return time-domain values (ComplexArray).
+ */
+ComplexArray inverseFft(const ComplexArray &input, unsigned threads = 0);
+
+#endif // FFT_H
@@ -0,0 +1,263 @@
+#include "fixedpoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using Limbs = std::vector<std::uint64_t>;
+
+/**
+ * @brief Compares two magnitudes of the same length: -1, 0 or 1.
+ */
+int compareMagnitudes(const Limbs &a, const Limbs &b)
+{
+    for (std::size_t k = a.size(); k-- > 0;) {
+        if (a[k] != b[k]) {
+            return a[k] < b[k] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief a += b for magnitudes of the same length, the final carry is dropped.
+ */
+void addMagnitude(Limbs &a, const Limbs &b)
+{
+    unsigned carry = 0;
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        const std::uint64_t sum = a[k] + b[k];
+        const unsigned overflow = sum < a[k];
+        a[k] = sum + carry;
+        carry = overflow | (a[k] < sum);
+    }
+}
+
+/**
+ * @brief a -= b for magnitudes of the same length with a >= b.
+ */
+void subtractMagnitude(Limbs &a, const Limbs &b)
+{
+    unsigned borrow = 0;
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        const std::uint64_t difference = a[k] - b[k];
+        const unsigned under = a[k] < b[k];
+        a[k] = difference - borrow;
+        borrow = under | (difference < borrow);
+    }
+}
+
+bool isZero(const Limbs &a)
+{
+    return std::all_of(a.begin(), a.end(), [](std::uint64_t limb) { return limb == 0; });
+}
+
+} // namespace
+
+/**
+ * @brief Zero with one fraction limb.
+ */
+FixedPoint::FixedPoint()
+    : negative(false), limbs(2, 0)
+{
+}
+
+/**
+ * @brief Exact conversion of a double.
+ *
+ * @param value number to be converted (double).
+ * @param fractionLimbs number of 64-bit fraction limbs, at least one (std::size_t).
+ * @throws std::invalid_argument If value is not finite or its magnitude is 2^64 or more.
+ * @return the number (FixedPoint).
+ */
+FixedPoint FixedPoint::fromDouble(double value, std::size_t fractionLimbs)
+{
+    if (!std::isfinite(value) || std::fabs(value) >= 0x1p64) {
+        throw std::invalid_argument("Value out of fixed-point range!");
+    }
+    FixedPoint result;
+    result.limbs.assign(std::max<std::size_t>(fractionLimbs, 1) + 1, 0);
+
+    // Every step scales by a power of two or removes the integer part, so it is exact.
+    double rest = std::fabs(value);
+    for (std::size_t k = result.limbs.size(); k-- > 0 && rest != 0;) {
+        const double limb = std::floor(rest);
+        result.limbs[k] = static_cast<std::uint64_t>(limb);
+        rest = std::ldexp(rest - limb, 64);
+    }
+    result.negative = value < 0 && !isZero(result.limbs);
+    return result;
+}
+
+/**
+ * @brief Fraction limbs needed to resolve a given distance with 64 bits to spare.
+ *
+ * @param resolution smallest distance of interest, positive (double).
+ * @return number of fraction limbs (std::size_t).
+ */
+std::size_t FixedPoint::fractionLimbsFor(double resolution)
+{
+    const double bits = std::max(0.0, -std::log2(resolution)) + 64;
+    return static_cast<std::size_t>(std::ceil(bits / 64));
+}
+
+/**
+ * @brief The same number with more or fewer fraction limbs.
+ *
+ * @param fractionLimbs new number of fraction limbs, at least one (std::size_t).
+ * @return the number (FixedPoint).
+ */
+FixedPoint FixedPoint::withFractionLimbs(std::size_t fractionLimbs) const
+{
+    fractionLimbs = std::max<std::size_t>(fractionLimbs, 1);
+    FixedPoint result;
+    result.limbs.assign(fractionLimbs + 1, 0);
+    const std::size_t kept = std::min(fractionLimbs, this->fractionLimbs());
+    // Align the integer parts; limbs below the new precision are dropped.
+    std::copy(limbs.end() - 1 - kept, limbs.end(), result.limbs.end() - 1 - kept);
+    result.negative = negative && !isZero(result.limbs);
+    return result;
+}
+
+/**
+ * @brief Nearest double.
+ *
+ * @return the number rounded to double (double).
+ */
+double FixedPoint::toDouble() const
+{
+    // Three limbs hold more than the 53 bits of a double.
+    double result = 0;
+    const std::size_t top = limbs.size() - 1;
+    for (std::size_t k = top >= 2 ? top - 2 : 0; k <= top; ++k) {
+        result += std::ldexp(static_cast<double>(limbs[k]), 64 * (static_cast<int>(k) - static_cast<int>(top)));
+    }
+    return negative ? -result : result;
+}
+
+/**
+ * @brief Decimal representation.
+ *
+ * @param digits number of fraction digits, truncated (int).
+ * @return text such as "-0.7436438870" (std::string).
+ */
+std::string FixedPoint::toString(int digits) const
+{
+    std::string text = (negative ? "-" : "") + std::to_string(limbs.back());
+    if (digits <= 0) {
+        return text;
+    }
+    text += '.';
+    Limbs fraction(limbs.begin(), limbs.end() - 1);
+    for (int digit = 0; digit < digits; ++digit) {
+        // Multiplying the fraction by ten pushes the next digit out of the top limb.
+        unsigned __int128 carry = 0;
+        for (std::uint64_t &limb : fraction) {
+            const unsigned __int128 product = static_cast<unsigned __int128>(limb) * 10 + carry;
+            limb = static_cast<std::uint64_t>(product);
+            carry = product >> 64;
+        }
+        text += static_cast<char>('0' + static_cast<int>(carry));
+    }
+    return text;
+}
+
+/**
+ * @brief Sum or difference of signed values of the same length.
+ */
+FixedPoint FixedPoint::combine(FixedPoint a, FixedPoint b, bool negateB)
+{
+    const std::size_t fraction = std::max(a.fractionLimbs(), b.fractionLimbs());
+    if (a.fractionLimbs() != fraction) {
+        a = a.withFractionLimbs(fraction);
+    }
+    if (b.fractionLimbs() != fraction) {
+        b = b.withFractionLimbs(fraction);
+    }
+    const bool bNegative = b.negative != negateB;
+    if (a.negative == bNegative) {
+        addMagnitude(a.limbs, b.limbs);
+    } else if (compareMagnitudes(a.limbs, b.limbs) >= 0) {
+        subtractMagnitude(a.limbs, b.limbs);
+    } else {
+        subtractMagnitude(b.limbs, a.limbs);
+        a.limbs.swap(b.limbs);
+        a.negative = bNegative;
+    }
+    if (isZero(a.limbs)) {
+        a.negative = false;
+    }
+    return a;
+}
+
+/**
+ * @brief Sum, at the larger precision of the operands.
+ *
+ * @param other number to be added (const FixedPoint&).
+ * @return sum (FixedPoint).
+ */
+FixedPoint FixedPoint::add(const FixedPoint &other) const
+{
+    return combine(*this, other, false);
+}
+
+/**
+ * @brief Difference, at the larger precision of the operands.
+ *
+ * @param other number to be subtracted (const FixedPoint&).
+ * @return difference (FixedPoint).
+ */
+FixedPoint FixedPoint::subtract(const FixedPoint &other) const
+{
+    return combine(*this, other, true);
+}
+
+/**
+ * @brief Product, truncated to the larger precision of the operands.
+ *
+ * Schoolbook multiplication of the full magnitudes; the limbs below the precision
+ * and any overflow of the integer part are dropped.
+ *
+ * @param other number to multiply by (const FixedPoint&).
+ * @return product (FixedPoint).
+ */
+FixedPoint FixedPoint::multiply(const FixedPoint &other) const
+{
+    const std::size_t fraction = std::max(fractionLimbs(), other.fractionLimbs());
+    const FixedPoint a = fractionLimbs() == fraction ? *this : withFractionLimbs(fraction);
+    const FixedPoint b = other.fractionLimbs() == fraction ? other : other.withFractionLimbs(fraction);
+    const std::size_t n = fraction + 1;
+
+    Limbs product(2 * n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a.limbs[i] == 0) {
+            continue;
+        }
+        std::uint64_t carry = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            const unsigned __int128 term =
+                static_cast<unsigned __int128>(a.limbs[i]) * b.limbs[j] + product[i + j] + carry;
+            product[i + j] = static_cast<std::uint64_t>(term);
+            carry = static_cast<std::uint64_t>(term >> 64);
+        }
+        product[i + n] = carry;
+    }
+
+    // Limb k of the result has the weight of limb k + fraction of the product.
+    FixedPoint result;
+    result.limbs.assign(product.begin() + fraction, product.begin() + fraction + n);
+    result.negative = (a.negative != b.negative) && !isZero(result.limbs);
+    return result;
+}
+
+/**
+ * @brief Equal values, whatever their precision.
+ */
+bool FixedPoint::operator==(const FixedPoint &other) const
+{
+    const std::size_t fraction = std::max(fractionLimbs(), other.fractionLimbs());
+    const FixedPoint a = withFractionLimbs(fraction), b = other.withFractionLimbs(fraction);
+    return a.negative == b.negative && a.limbs == b.limbs;
+}
@@ -0,0 +1,120 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Signed fixed-point number with a 64-bit integer part and any number of
+ *        64-bit fraction limbs.
+ *
+ * Used where double precision runs out, such as the reference orbit of a deep
+ * fractal zoom. Operations on numbers of different precision work at the larger
+ * one; results are truncated toward zero. The integer part must stay below 2^64 in
+ * magnitude, which is ample for points near the Mandelbrot set.
+ */
+class FixedPoint {
+public:
+    /**
+     * @brief Zero with one fraction limb.
+     */
+    FixedPoint();
+
+    /**
+     * @brief Exact conversion of a double.
+     *
+     * Bits below the last fraction limb are dropped.
+     *
+     * @param value number to be converted (double).
+     * @param fractionLimbs number of 64-bit fraction limbs, at least one (std::size_t).
+     * @throws std::invalid_argument If value is not finite or its magnitude is 2^64 or more.
+     * @return the number (FixedPoint).
+     */
+    static FixedPoint fromDouble(double value, std::size_t fractionLimbs);
+
+    /**
+     * @brief Fraction limbs needed to resolve a given distance with 64 bits to spare.
+     *
+     * @param resolution smallest distance of interest, positive (double).
+     * @return number of fraction limbs (std::size_t).
+     */
+    static std::size_t fractionLimbsFor(double resolution);
+
+    /** @brief Number of 64-bit fraction limbs. */
+    std::size_t fractionLimbs() const { return limbs.size() - 1; }
+
+    /**
+     * @brief The same number with more or fewer fraction limbs.
+     *
+     * @param fractionLimbs new number of fraction limbs, at least one (std::size_t).
+     * @return the number (FixedPoint).
+     */
+    FixedPoint withFractionLimbs(std::size_t fractionLimbs) const;
+
+    /**
+     * @brief Nearest double.
+     *
+     * @return the number rounded to double (double).
+     */
+    double toDouble() const;
+
+    /**
+     * @brief Decimal representation.
+     *
+     * @param digits number of fraction digits, truncated (int).
+     * @return text such as "-0.7436438870" (std::string).
+     */
+    std::string toString(int digits) const;
+
+    /**
+     * @brief Sum, at the larger precision of the operands.
+     *
+     * @param other number to be added (const FixedPoint&).
+     * @return sum (FixedPoint).
+     */
+    FixedPoint add(const FixedPoint &other) const;
+
+    /**
+     * @brief Difference, at the larger precision of the operands.
+     *
+     * @param other number to be subtracted (const FixedPoint&).
+     * @return difference (FixedPoint).
+     */
+    FixedPoint subtract(const FixedPoint &other) const;
+
+    /**
+     * @brief Product, truncated to the larger precision of the operands.
+     *
+     * @param other number to multiply by (const FixedPoint&).
+     * @return product (FixedPoint).
+     */
+    FixedPoint multiply(const FixedPoint &other) const;
+
+    FixedPoint operator+(const FixedPoint &other) const { return add(other); }
+    FixedPoint operator-(const FixedPoint &other) const { return subtract(other); }
+    FixedPoint operator*(const FixedPoint &other) const { return multiply(other); }
+
+    /** @brief Equal values, whatever their precision. */
+    bool operator==(const FixedPoint &other) const;
+    bool operator!=(const FixedPoint &other) const { return !(*this == other); }
+
+private:
+    /**
+     * @brief Sum or difference of signed values of the same length.
+     */
+    static FixedPoint combine(FixedPoint a, FixedPoint b, bool negateB);
+
+    /**
+     * @brief Sign of the number; zero is never negative.
+     */
+    bool negative;
+
+    /**
+     * @brief Magnitude, least significant limb first; the last limb is the integer part.
+     */
+    std::vector<std::uint64_t> limbs;
+};
+
+#endif // FIXEDPOINT_H
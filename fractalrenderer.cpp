@@ -0,0 +1,265 @@
+#include "fractalrenderer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include "complexkernels.h"
+#include "reduction.h"
+
+namespace {
+
+/**
+ * @brief Side of the square tiles, a multiple of CoarsestStep.
+ */
+constexpr int TileSize = 64;
+
+/**
+ * @brief Pixel pitch of the first pass.
+ */
+constexpr int CoarsestStep = 8;
+
+/**
+ * @brief Colour of points that never escaped.
+ */
+constexpr std::uint32_t InsideColor = 0xff000000;
+
+/**
+ * @brief Cyclic colour gradient indexed by the continuous iteration count.
+ */
+const std::array<std::uint32_t, 256> &palette()
+{
+    static const std::array<std::uint32_t, 256> colors = [] {
+        std::array<std::uint32_t, 256> table{};
+        const double pi = 3.14159265358979323846;
+        for (std::size_t k = 0; k < table.size(); ++k) {
+            const double t = 2 * pi * static_cast<double>(k) / static_cast<double>(table.size());
+            const auto channel = [t](double phase) {
+                return static_cast<std::uint32_t>(127.5 + 127.5 * std::cos(t + phase));
+            };
+            table[k] = 0xff000000 | channel(3.6) << 16 | channel(4.2) << 8 | channel(5.0);
+        }
+        return table;
+    }();
+    return colors;
+}
+
+/**
+ * @brief Colour of a point from its iteration count and final squared modulus.
+ *
+ * Escaped points use the continuous count n + 1 - log2(log |z|), which removes the
+ * bands of the integer count.
+ */
+std::uint32_t escapeColor(double iterations, double modulus2, unsigned maxIterations)
+{
+    if (iterations >= maxIterations) {
+        return InsideColor;
+    }
+    double smooth = iterations + 1 - std::log2(0.5 * std::log(modulus2));
+    if (!(smooth >= 0)) {
+        smooth = 0;
+    }
+    const std::array<std::uint32_t, 256> &colors = palette();
+    return colors[static_cast<std::size_t>(smooth * 4) % colors.size()];
+}
+
+} // namespace
+
+/**
+ * @brief Starts the render thread.
+ *
+ * @param frameReady called on the render thread whenever latestFrame() has a new
+ *        image (std::function<void()>).
+ * @param threads threads to render with, 0 for one per hardware thread (unsigned).
+ */
+FractalRenderer::FractalRenderer(std::function<void()> frameReady, unsigned threads)
+    : frameReady(std::move(frameReady)), threads(threads), worker(&FractalRenderer::run, this)
+{
+}
+
+/**
+ * @brief Cancels the current render and stops the render thread.
+ */
+FractalRenderer::~FractalRenderer()
+{
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        stopping = true;
+        ++generation;
+    }
+    requestChanged.notify_one();
+    worker.join();
+}
+
+/**
+ * @brief Starts rendering a view, abandoning the previous one.
+ *
+ * @param view view to be rendered (const FractalView&).
+ * @throws std::invalid_argument If the view has no pixels, a pixel size that is not
+ *         positive and finite, or no iterations.
+ */
+void FractalRenderer::render(const FractalView &view)
+{
+    if (view.width <= 0 || view.height <= 0 || !(view.pixelWidth > 0) || !(view.pixelHeight > 0)
+        || !std::isfinite(view.pixelWidth) || !std::isfinite(view.pixelHeight) || view.maxIterations == 0) {
+        throw std::invalid_argument("Invalid fractal view!");
+    }
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requested = view;
+        pending = true;
+        ++generation;
+    }
+    requestChanged.notify_one();
+}
+
+/**
+ * @brief Abandons the current render; the last published image stays available.
+ */
+void FractalRenderer::cancel()
+{
+    std::lock_guard<std::mutex> lock(requestMutex);
+    pending = false;
+    ++generation;
+}
+
+/**
+ * @brief Copies the last published image.
+ *
+ * @param frame receives the image (FractalFrame&).
+ * @return whether any image was published yet (bool).
+ */
+bool FractalRenderer::latestFrame(FractalFrame &frame) const
+{
+    std::lock_guard<std::mutex> lock(frameMutex);
+    if (published.step == 0) {
+        return false;
+    }
+    frame.view = published.view;
+    frame.step = published.step;
+    frame.pixels = published.pixels;
+    return true;
+}
+
+/**
+ * @brief Body of the render thread: waits for requests and renders them.
+ */
+void FractalRenderer::run()
+{
+    std::unique_lock<std::mutex> lock(requestMutex);
+    for (;;) {
+        requestChanged.wait(lock, [this] { return pending || stopping; });
+        if (stopping) {
+            return;
+        }
+        pending = false;
+        const FractalView view = requested;
+        const std::uint64_t current = generation.load();
+        lock.unlock();
+        renderView(view, current);
+        lock.lock();
+    }
+}
+
+/**
+ * @brief Renders all passes of a view unless a newer request arrives.
+ */
+void FractalRenderer::renderView(const FractalView &view, std::uint64_t current)
+{
+    working.resize(static_cast<std::size_t>(view.width) * view.height);
+
+    if (view.kind == FractalKind::DeepMandelbrot) {
+        const std::size_t limbs = FixedPoint::fractionLimbsFor(std::min(view.pixelWidth, view.pixelHeight));
+        const FixedPoint real = view.centerReal.withFractionLimbs(std::max(limbs, view.centerReal.fractionLimbs()));
+        const FixedPoint imaginary =
+            view.centerImaginary.withFractionLimbs(std::max(limbs, view.centerImaginary.fractionLimbs()));
+        if (orbit.real.empty() || real != orbitReal || imaginary != orbitImaginary
+            || real.fractionLimbs() > orbitReal.fractionLimbs() || view.maxIterations != orbitIterations) {
+            orbit = referenceOrbit(real, imaginary, view.maxIterations);
+            orbitReal = real;
+            orbitImaginary = imaginary;
+            orbitIterations = view.maxIterations;
+        }
+
+        const double left = view.minReal, right = view.minReal + view.width * view.pixelWidth;
+        const double top = view.maxImaginary, bottom = view.maxImaginary - view.height * view.pixelHeight;
+        const std::vector<ComplexNumber> corners = {ComplexNumber(left, top), ComplexNumber(right, top),
+                                                    ComplexNumber(left, bottom), ComplexNumber(right, bottom)};
+        double radius = 0;
+        for (const ComplexNumber &corner : corners) {
+            radius = std::max(radius, std::hypot(corner.getReal(), corner.getImaginary()));
+        }
+        series = seriesApproximation(orbit, radius > 0 ? radius : view.pixelWidth, corners);
+    }
+    const int tilesX = (view.width + TileSize - 1) / TileSize;
+    const int tilesY = (view.height + TileSize - 1) / TileSize;
+
+    for (int step = CoarsestStep; step >= 1; step /= 2) {
+        parallelChunks(static_cast<std::size_t>(tilesX) * tilesY, threads, [&](std::size_t tile) {
+            renderTile(view, current, step, static_cast<int>(tile % tilesX), static_cast<int>(tile / tilesX));
+        });
+        if (generation.load() != current) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            published.view = view;
+            published.step = step;
+            published.pixels = working;
+        }
+        frameReady();
+    }
+}
+
+/**
+ * @brief Renders one tile of one pass into the working image.
+ *
+ * Every computed pixel fills the step x step block it starts, which later passes
+ * overwrite with finer values. After the first pass, rows at multiples of 2 * step
+ * already have their pixels at multiples of 2 * step and only compute the others.
+ */
+void FractalRenderer::renderTile(const FractalView &view, std::uint64_t current, int step, int tileX,
+                                 int tileY)
+{
+    const ComplexKernels &kernels = activeKernels();
+    const int x0 = tileX * TileSize, x1 = std::min(view.width, x0 + TileSize);
+    const int y0 = tileY * TileSize, y1 = std::min(view.height, y0 + TileSize);
+
+    thread_local std::vector<double> iterations, modulus2;
+    iterations.resize(TileSize);
+    modulus2.resize(TileSize);
+
+    for (int y = y0; y < y1; y += step) {
+        if (generation.load(std::memory_order_relaxed) != current) {
+            return;
+        }
+        const bool known = step != CoarsestStep && y % (2 * step) == 0;
+        const int first = known ? x0 + step : x0;
+        const int pitch = known ? 2 * step : step;
+        if (first >= x1) {
+            continue;
+        }
+        const std::size_t count = static_cast<std::size_t>((x1 - first + pitch - 1) / pitch);
+
+        const EscapeRow row = {view.minReal + first * view.pixelWidth, pitch * view.pixelWidth,
+                               view.maxImaginary - y * view.pixelHeight, view.kind == FractalKind::Julia,
+                               view.c.getReal(), view.c.getImaginary(), view.maxIterations};
+        if (view.kind == FractalKind::DeepMandelbrot) {
+            perturbRow(orbit, series, row, count, iterations.data(), modulus2.data());
+        } else {
+            kernels.escapeTime(row, count, iterations.data(), modulus2.data());
+        }
+
+        const int rows = std::min(step, y1 - y);
+        for (std::size_t k = 0; k < count; ++k) {
+            const std::uint32_t color = escapeColor(iterations[k], modulus2[k], view.maxIterations);
+            const int x = first + static_cast<int>(k) * pitch;
+            const int columns = std::min(step, x1 - x);
+            std::uint32_t *pixel = working.data() + static_cast<std::size_t>(y) * view.width + x;
+            for (int dy = 0; dy < rows; ++dy, pixel += view.width) {
+                std::fill(pixel, pixel + columns, color);
+            }
+        }
+    }
+}
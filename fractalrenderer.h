@@ -0,0 +1,192 @@
+#ifndef FRACTALRENDERER_H
+#define FRACTALRENDERER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "complexnumber.h"
+#include "deepzoom.h"
+#include "fixedpoint.h"
+
+/**
+ * @brief Escape-time fractal drawn by FractalRenderer.
+ */
+enum class FractalKind {
+    Mandelbrot,
+    Julia,
+
+    /** @brief Mandelbrot set around a fixed-point centre, iterated by perturbation. */
+    DeepMandelbrot
+};
+
+/**
+ * @brief Part of the complex plane to be rendered and how.
+ *
+ * Pixel (x, y) shows the point (minReal + x * pixelWidth, maxImaginary - y * pixelHeight),
+ * so row 0 is the top of the image. For DeepMandelbrot that point is an offset from
+ * (centerReal, centerImaginary), which can be given to any precision.
+ */
+struct FractalView {
+    FractalKind kind = FractalKind::Mandelbrot;
+
+    /** @brief Constant of the Julia set, unused for the Mandelbrot set. */
+    ComplexNumber c;
+
+    /** @brief Reference point of DeepMandelbrot, unused otherwise. */
+    FixedPoint centerReal;
+    FixedPoint centerImaginary;
+
+    double minReal = -2.5;
+    double maxImaginary = 1.5;
+    double pixelWidth = 1.0 / 256;
+    double pixelHeight = 1.0 / 256;
+    int width = 0;
+    int height = 0;
+    unsigned maxIterations = 256;
+
+    bool operator==(const FractalView &other) const
+    {
+        return kind == other.kind && (kind != FractalKind::Julia || c == other.c)
+               && (kind != FractalKind::DeepMandelbrot
+                   || (centerReal == other.centerReal && centerImaginary == other.centerImaginary))
+               && minReal == other.minReal && maxImaginary == other.maxImaginary
+               && pixelWidth == other.pixelWidth && pixelHeight == other.pixelHeight
+               && width == other.width && height == other.height && maxIterations == other.maxIterations;
+    }
+
+    bool operator!=(const FractalView &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Image produced by FractalRenderer.
+ */
+struct FractalFrame {
+    /** @brief View the image was rendered for. */
+    FractalView view;
+
+    /** @brief Pixel pitch of the pass that produced the image, 1 once it is final. */
+    int step = 0;
+
+    /** @brief Row-major 0xffRRGGBB pixels, view.width * view.height of them. */
+    std::vector<std::uint32_t> pixels;
+};
+
+/**
+ * @brief Renders Mandelbrot and Julia sets progressively on a background thread.
+ *
+ * The image is cut into square tiles that are rendered by parallelChunks() with the
+ * escapeTime kernel of activeKernels(). Every view is rendered in passes of
+ * decreasing pixel pitch: the first pass computes one pixel in 8 x 8 and fills the
+ * block with it, each later pass halves the pitch and computes only the pixels that
+ * are new. After every pass the image is published and the frame callback is called.
+ *
+ * DeepMandelbrot views compute the orbit of the centre in fixed point, at a precision
+ * that resolves the pixels, and iterate the pixels with perturbRow(). The orbit is
+ * kept while the centre and the iteration limit stay the same.
+ *
+ * render() and cancel() return at once. Tiles check for a newer request before every
+ * row, so work for a view that is no longer wanted stops within one row per thread.
+ */
+class FractalRenderer {
+public:
+    /**
+     * @brief Starts the render thread.
+     *
+     * @param frameReady called on the render thread whenever latestFrame() has a new
+     *        image; it must not call back into the renderer (std::function<void()>).
+     * @param threads threads to render with, 0 for one per hardware thread (unsigned).
+     */
+    explicit FractalRenderer(std::function<void()> frameReady, unsigned threads = 0);
+
+    /**
+     * @brief Cancels the current render and stops the render thread.
+     */
+    ~FractalRenderer();
+
+    FractalRenderer(const FractalRenderer &) = delete;
+    FractalRenderer &operator=(const FractalRenderer &) = delete;
+
+    /**
+     * @brief Starts rendering a view, abandoning the previous one.
+     *
+     * @param view view to be rendered (const FractalView&).
+     * @throws std::invalid_argument If the view has no pixels, a pixel size that is not
+     *         positive and finite, or no iterations.
+     */
+    void render(const FractalView &view);
+
+    /**
+     * @brief Abandons the current render; the last published image stays available.
+     */
+    void cancel();
+
+    /**
+     * @brief Copies the last published image.
+     *
+     * @param frame receives the image (FractalFrame&).
+     * @return whether any image was published yet (bool).
+     */
+    bool latestFrame(FractalFrame &frame) const;
+
+private:
+    /**
+     * @brief Body of the render thread: waits for requests and renders them.
+     */
+    void run();
+
+    /**
+     * @brief Renders all passes of a view unless a newer request arrives.
+     */
+    void renderView(const FractalView &view, std::uint64_t generation);
+
+    /**
+     * @brief Renders one tile of one pass into the working image.
+     */
+    void renderTile(const FractalView &view, std::uint64_t generation, int step, int tileX, int tileY);
+
+    std::function<void()> frameReady;
+    unsigned threads;
+
+    /**
+     * @brief Number of the latest request; tiles of older requests stop early.
+     */
+    std::atomic<std::uint64_t> generation{0};
+
+    /**
+     * @brief Guards requested, pending and stopping.
+     */
+    std::mutex requestMutex;
+    std::condition_variable requestChanged;
+    FractalView requested;
+    bool pending = false;
+    bool stopping = false;
+
+    /**
+     * @brief Image being rendered, only touched by the render thread and its helpers.
+     */
+    std::vector<std::uint32_t> working;
+
+    /**
+     * @brief Reference orbit and series of the DeepMandelbrot view being rendered,
+     *        owned like working.
+     */
+    ReferenceOrbit orbit;
+    FixedPoint orbitReal, orbitImaginary;
+    unsigned orbitIterations = 0;
+    SeriesApproximation series;
+
+    /**
+     * @brief Last published image, guarded by frameMutex.
+     */
+    mutable std::mutex frameMutex;
+    FractalFrame published;
+
+    std::thread worker;
+};
+
+#endif // FRACTALRENDERER_H
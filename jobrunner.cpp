@@ -0,0 +1,217 @@
+#include "jobrunner.h"
+#include "telemetry.h"
+
+#include <algorithm>
+#include <exception>
+
+/**
+ * @brief A submitted job; the control lives as long as the work that uses it.
+ */
+struct JobRunner::Job {
+    Job(JobId id, Work work, const std::function<void()> &changed)
+        : id(id), work(std::move(work)), control(changed)
+    {}
+
+    JobId id;
+    Work work;
+    JobControl control;
+    Completion completion;
+    std::exception_ptr error;
+};
+
+/**
+ * @brief Reports how far the job is.
+ *
+ * @param fraction part done, clamped to [0, 1] (double).
+ */
+void JobControl::setProgress(double fraction)
+{
+    const unsigned next = static_cast<unsigned>(std::clamp(fraction, 0.0, 1.0) * 100);
+    if (next > percent.load(std::memory_order_relaxed)) {
+        percent.store(next, std::memory_order_relaxed);
+        changed();
+    }
+}
+
+/**
+ * @brief Starts the pool threads.
+ *
+ * @param changed called on a pool thread when there is something to deliver or show
+ *        (std::function<void()>).
+ * @param threads pool threads, 0 for one per hardware thread (unsigned).
+ */
+JobRunner::JobRunner(std::function<void()> changed, unsigned threads)
+    : changed(std::move(changed))
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(&JobRunner::run, this);
+    }
+}
+
+/**
+ * @brief Cancels every job and stops the pool; waits for running work to return.
+ */
+JobRunner::~JobRunner()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cancelAll();
+    queueChanged.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Queues a job.
+ *
+ * @param work runs on a pool thread and returns the completion (Work).
+ * @return id of the job (JobId).
+ */
+JobRunner::JobId JobRunner::submit(Work work)
+{
+    JobId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = nextId++;
+        queued.push_back(std::make_shared<Job>(id, std::move(work), changed));
+    }
+    queueChanged.notify_one();
+    return id;
+}
+
+/**
+ * @brief Cancels a job.
+ *
+ * @param id job (JobId).
+ */
+void JobRunner::cancel(JobId id)
+{
+    const auto matches = [id](const std::shared_ptr<Job> &job) { return job->id == id; };
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.erase(std::remove_if(queued.begin(), queued.end(), matches), queued.end());
+    finished.erase(std::remove_if(finished.begin(), finished.end(), matches), finished.end());
+    for (const std::shared_ptr<Job> &job : running) {
+        if (job->id == id) {
+            job->control.cancelFlag.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Cancels every job that was not delivered yet.
+ */
+void JobRunner::cancelAll()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.clear();
+    finished.clear();
+    for (const std::shared_ptr<Job> &job : running) {
+        job->control.cancelFlag.store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Runs the completion of the job that finished first, on the calling thread.
+ *
+ * @throws anything the work of that job threw.
+ * @return false if no job was waiting to be delivered (bool).
+ */
+bool JobRunner::deliverNext()
+{
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (finished.empty()) {
+            return false;
+        }
+        job = std::move(finished.front());
+        finished.pop_front();
+    }
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+    if (job->completion) {
+        job->completion();
+    }
+    return true;
+}
+
+/**
+ * @brief Number of jobs submitted and neither delivered nor cancelled.
+ */
+std::size_t JobRunner::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t count = queued.size() + finished.size();
+    for (const std::shared_ptr<Job> &job : running) {
+        count += !job->control.cancelled();
+    }
+    return count;
+}
+
+/**
+ * @brief Progress of the pending jobs together.
+ *
+ * @return mean percent done, 0 without pending jobs (unsigned).
+ */
+unsigned JobRunner::progress() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t count = queued.size() + finished.size();
+    std::size_t total = 100 * finished.size();
+    for (const std::shared_ptr<Job> &job : running) {
+        if (!job->control.cancelled()) {
+            ++count;
+            total += job->control.progress();
+        }
+    }
+    return count == 0 ? 0 : static_cast<unsigned>(total / count);
+}
+
+/**
+ * @brief Body of the pool threads: takes queued jobs until the runner stops.
+ */
+void JobRunner::run()
+{
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueChanged.wait(lock, [this] { return stopping || !queued.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(queued.front());
+            queued.pop_front();
+            running.push_back(job);
+        }
+
+        try {
+            TelemetryScope scope(TelemetryOp::Job);
+            job->completion = job->work(job->control);
+        } catch (...) {
+            job->error = std::current_exception();
+        }
+        // Whatever the work captured is released here, not on the delivering thread.
+        job->work = nullptr;
+
+        bool deliver;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running.erase(std::find(running.begin(), running.end(), job));
+            deliver = !job->control.cancelled() && !stopping;
+            if (deliver) {
+                finished.push_back(std::move(job));
+            }
+        }
+        if (deliver) {
+            changed();
+        }
+    }
+}
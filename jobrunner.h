@@ -0,0 +1,159 @@
+#ifndef JOBRUNNER_H
+#define JOBRUNNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief What a running job sees of its runner: the cancel flag and a progress meter.
+ */
+class JobControl {
+public:
+    JobControl(const JobControl &) = delete;
+    JobControl &operator=(const JobControl &) = delete;
+
+    /**
+     * @brief Whether the job was cancelled; long jobs should check it regularly and return.
+     */
+    bool cancelled() const noexcept { return cancelFlag.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Reports how far the job is.
+     *
+     * The runner is told only when the progress passes a whole percent, so this can be
+     * called as often as convenient.
+     *
+     * @param fraction part done, clamped to [0, 1] (double).
+     */
+    void setProgress(double fraction);
+
+    /**
+     * @brief Progress last reported.
+     *
+     * @return percent done (unsigned).
+     */
+    unsigned progress() const noexcept { return percent.load(std::memory_order_relaxed); }
+
+private:
+    friend class JobRunner;
+
+    explicit JobControl(const std::function<void()> &changed)
+        : changed(changed)
+    {}
+
+    const std::function<void()> &changed;
+    std::atomic<bool> cancelFlag{false};
+    std::atomic<unsigned> percent{0};
+};
+
+/**
+ * @brief Runs jobs on a small pool of threads and hands their results back to one thread.
+ *
+ * A job is split in two: the work runs on a pool thread and returns a completion, which
+ * runs on the thread that calls deliverNext(), typically the GUI thread. The work must
+ * not touch anything the delivering thread owns; the completion is where results are
+ * shown. A cancelled job never has its completion run, even if its work had already
+ * finished.
+ *
+ * The changed callback is called on a pool thread whenever a job finishes or its
+ * progress passes a percent; it must not call back into the runner, only arrange for
+ * deliverNext() to be called (e.g. with a queued call).
+ */
+class JobRunner {
+public:
+    using JobId = std::uint64_t;
+    using Completion = std::function<void()>;
+    using Work = std::function<Completion(JobControl &)>;
+
+    /**
+     * @brief Starts the pool threads.
+     *
+     * @param changed called on a pool thread when there is something to deliver or show
+     *        (std::function<void()>).
+     * @param threads pool threads, 0 for one per hardware thread (unsigned).
+     */
+    explicit JobRunner(std::function<void()> changed, unsigned threads = 0);
+
+    /**
+     * @brief Cancels every job and stops the pool; waits for running work to return.
+     */
+    ~JobRunner();
+
+    JobRunner(const JobRunner &) = delete;
+    JobRunner &operator=(const JobRunner &) = delete;
+
+    /**
+     * @brief Queues a job.
+     *
+     * @param work runs on a pool thread and returns the completion, which may be empty;
+     *        an exception it throws is rethrown by deliverNext() (Work).
+     * @return id of the job (JobId).
+     */
+    JobId submit(Work work);
+
+    /**
+     * @brief Cancels a job: a queued one never starts, a running one is asked to stop and
+     *        a finished one is not delivered. Unknown ids are ignored.
+     *
+     * @param id job (JobId).
+     */
+    void cancel(JobId id);
+
+    /**
+     * @brief Cancels every job that was not delivered yet.
+     */
+    void cancelAll();
+
+    /**
+     * @brief Runs the completion of the job that finished first, on the calling thread.
+     *
+     * @throws anything the work of that job threw.
+     * @return false if no job was waiting to be delivered (bool).
+     */
+    bool deliverNext();
+
+    /**
+     * @brief Number of jobs submitted and neither delivered nor cancelled.
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Progress of the pending jobs together.
+     *
+     * @return mean percent done, 0 without pending jobs (unsigned).
+     */
+    unsigned progress() const;
+
+private:
+    struct Job;
+
+    /**
+     * @brief Body of the pool threads.
+     */
+    void run();
+
+    std::function<void()> changed;
+
+    /**
+     * @brief Guards everything below.
+     */
+    mutable std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::deque<std::shared_ptr<Job>> queued;
+    std::vector<std::shared_ptr<Job>> running;
+    std::deque<std::shared_ptr<Job>> finished;
+    JobId nextId = 1;
+    bool stopping = false;
+
+    std::vector<std::thread> workers;
+};
+
+#endif // JOBRUNNER_H
@@ -0,0 +1,169 @@
+#include "lusolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Columns factored per panel.
+ */
+constexpr std::size_t BlockSize = 64;
+
+/**
+ * @brief x[j] -= f y[j] for j < n, on split parts.
+ */
+void subtractMultiple(double *xr, double *xi, const double *yr, const double *yi, const ComplexNumber &f,
+                      std::size_t n)
+{
+    const double fr = f.getReal(), fi = f.getImaginary();
+    for (std::size_t j = 0; j < n; ++j) {
+        const double productReal = fr * yr[j] - fi * yi[j];
+        const double productImaginary = fr * yi[j] + fi * yr[j];
+        xr[j] -= productReal;
+        xi[j] -= productImaginary;
+    }
+}
+
+/**
+ * @brief Swaps two rows of a matrix.
+ */
+void swapRows(ComplexMatrix &matrix, std::size_t a, std::size_t b)
+{
+    const std::size_t n = matrix.columns();
+    std::swap_ranges(matrix.real() + a * n, matrix.real() + (a + 1) * n, matrix.real() + b * n);
+    std::swap_ranges(matrix.imaginary() + a * n, matrix.imaginary() + (a + 1) * n, matrix.imaginary() + b * n);
+}
+
+} // namespace
+
+/**
+ * @brief Factors a square matrix.
+ *
+ * @param matrix matrix to be factored (const ComplexMatrix&).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @throws std::invalid_argument If the matrix is not square.
+ */
+LuDecomposition::LuDecomposition(const ComplexMatrix &matrix, unsigned threads)
+    : factors(matrix)
+{
+    if (matrix.rows() != matrix.columns()) {
+        throw std::invalid_argument("Only square matrices have an LU decomposition!");
+    }
+    const std::size_t n = matrix.rows();
+    double *re = factors.real(), *im = factors.imaginary();
+    pivotRows.resize(n);
+
+    for (std::size_t start = 0; start < n; start += BlockSize) {
+        const std::size_t end = std::min(n, start + BlockSize);
+
+        // Panel: columns [start, end), all rows below the diagonal.
+        for (std::size_t j = start; j < end; ++j) {
+            std::size_t pivot = j;
+            double largest = -1;
+            for (std::size_t i = j; i < n; ++i) {
+                const double size = std::fabs(re[i * n + j]) + std::fabs(im[i * n + j]);
+                if (size > largest) {
+                    largest = size;
+                    pivot = i;
+                }
+            }
+            pivotRows[j] = pivot;
+            if (pivot != j) {
+                swapRows(factors, j, pivot);
+            }
+
+            const ComplexNumber diagonal = factors.get(j, j);
+            if (diagonal == ComplexNumber(0, 0)) {
+                singular = true;
+                continue;
+            }
+            for (std::size_t i = j + 1; i < n; ++i) {
+                const ComplexNumber l = factors.get(i, j).divideUnchecked(diagonal);
+                factors.set(i, j, l);
+                subtractMultiple(re + i * n + j + 1, im + i * n + j + 1, re + j * n + j + 1, im + j * n + j + 1,
+                                 l, end - j - 1);
+            }
+        }
+        if (end == n) {
+            break;
+        }
+
+        // Block row of U: forward substitution with the unit lower triangle of the panel.
+        for (std::size_t r = start + 1; r < end; ++r) {
+            for (std::size_t q = start; q < r; ++q) {
+                subtractMultiple(re + r * n + end, im + r * n + end, re + q * n + end, im + q * n + end,
+                                 factors.get(r, q), n - end);
+            }
+        }
+
+        // Trailing matrix: A22 -= L21 U12.
+        multiplyAdd(factors.block(end, start, n - end, end - start), factors.block(start, end, end - start, n - end),
+                    re + end * n + end, im + end * n + end, n, true, threads);
+    }
+}
+
+/**
+ * @brief Determinant, the signed product of the diagonal of U.
+ *
+ * @return determinant, safe from overflow (ScaledComplex).
+ */
+ScaledComplex LuDecomposition::determinant() const
+{
+    const std::size_t n = size();
+    ComplexArray diagonal(n);
+    bool odd = false;
+    for (std::size_t k = 0; k < n; ++k) {
+        diagonal.set(k, factors.get(k, k));
+        odd = odd != (pivotRows[k] != k);
+    }
+    ScaledComplex result = reduceProduct(diagonal, 1);
+    if (odd) {
+        result.mantissa = -result.mantissa;
+    }
+    return result;
+}
+
+/**
+ * @brief Solves A X = B.
+ *
+ * @param rhs right-hand sides, one per column (const ComplexMatrix&).
+ * @throws std::invalid_argument If rhs.rows() differs from size() or the matrix is singular.
+ * @return solutions, one per column (ComplexMatrix).
+ */
+ComplexMatrix LuDecomposition::solve(const ComplexMatrix &rhs) const
+{
+    const std::size_t n = size();
+    if (rhs.rows() != n) {
+        throw std::invalid_argument("Matrix dimensions do not match!");
+    }
+    if (singular) {
+        throw std::invalid_argument("Matrix is singular!");
+    }
+
+    ComplexMatrix x = rhs;
+    const std::size_t m = x.columns();
+    double *xr = x.real(), *xi = x.imaginary();
+    for (std::size_t k = 0; k < n; ++k) {
+        if (pivotRows[k] != k) {
+            swapRows(x, k, pivotRows[k]);
+        }
+    }
+    // L y = P b, then U x = y, one row of right-hand sides at a time.
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t q = 0; q < i; ++q) {
+            subtractMultiple(xr + i * m, xi + i * m, xr + q * m, xi + q * m, factors.get(i, q), m);
+        }
+    }
+    for (std::size_t i = n; i-- > 0;) {
+        for (std::size_t q = i + 1; q < n; ++q) {
+            subtractMultiple(xr + i * m, xi + i * m, xr + q * m, xi + q * m, factors.get(i, q), m);
+        }
+        const ComplexNumber diagonal = factors.get(i, i);
+        for (std::size_t j = 0; j < m; ++j) {
+            x.set(i, j, x.get(i, j).divideUnchecked(diagonal));
+        }
+    }
+    return x;
+}
@@ -0,0 +1,87 @@
+#ifndef LUSOLVER_H
+#define LUSOLVER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "complexmatrix.h"
+#include "complexnumber.h"
+#include "reduction.h"
+
+/**
+ * @brief LU factorization with partial pivoting, P A = L U, and solves with it.
+ *
+ * The factorization is blocked and right-looking: a panel of columns is factored
+ * with row pivoting on the largest |re| + |im| of each column, the matching block
+ * row of U is found by forward substitution, and the trailing matrix is updated
+ * with one multiplyAdd() call, which does almost all of the work. The factors do
+ * not depend on the thread count or the instruction set.
+ */
+class LuDecomposition {
+public:
+    /**
+     * @brief Factors a square matrix.
+     *
+     * A zero pivot does not stop the factorization; the matrix is then singular and
+     * solve() refuses to run.
+     *
+     * @param matrix matrix to be factored (const ComplexMatrix&).
+     * @param threads threads to use, 0 for one per hardware thread (unsigned).
+     * @throws std::invalid_argument If the matrix is not square.
+     */
+    explicit LuDecomposition(const ComplexMatrix &matrix, unsigned threads = 0);
+
+    /** @brief Number of rows and columns of the factored matrix. */
+    std::size_t size() const { return factors.rows(); }
+
+    /** @brief Whether a pivot was exactly zero. */
+    bool isSingular() const { return singular; }
+
+    /**
+     * @brief L below the diagonal (with a unit diagonal) and U on and above it.
+     *
+     * @return the factors in one matrix (const ComplexMatrix&).
+     */
+    const ComplexMatrix &combinedFactors() const { return factors; }
+
+    /**
+     * @brief Row interchanges: row k was swapped with row pivots()[k] >= k, in order of k.
+     *
+     * @return pivot rows (const std::vector<std::size_t>&).
+     */
+    const std::vector<std::size_t> &pivots() const { return pivotRows; }
+
+    /**
+     * @brief Determinant, the signed product of the diagonal of U.
+     *
+     * @return determinant, safe from overflow (ScaledComplex).
+     */
+    ScaledComplex determinant() const;
+
+    /**
+     * @brief Solves A X = B.
+     *
+     * @param rhs right-hand sides, one per column (const ComplexMatrix&).
+     * @throws std::invalid_argument If rhs.rows() differs from size() or the matrix is singular.
+     * @return solutions, one per column (ComplexMatrix).
+     */
+    ComplexMatrix solve(const ComplexMatrix &rhs) const;
+
+private:
+    /**
+     * @brief L and U in one matrix.
+     */
+    ComplexMatrix factors;
+
+    /**
+     * @brief Row swapped with row k at step k.
+     */
+    std::vector<std::size_t> pivotRows;
+
+    /**
+     * @brief Whether a pivot was exactly zero.
+     */
+    bool singular = false;
+};
+
+#endif // LUSOLVER_H
@@ -1,12 +1,66 @@
 #include <QApplication>
+#include <QDir>
+#include <QDockWidget>
+#include <QMainWindow>
+#include <QMenuBar>
+#include <QStandardPaths>
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
 
 #include "calculator.h"
+#include "statspanel.h"
+#include "telemetry.h"
+#ifdef COMPLEXCALC_HAS_SERVER
+#include "calcserver.h"
+#endif
 
 int main(int argc, char *argv[])
 {
+#ifdef COMPLEXCALC_HAS_SERVER
+    // Headless server mode, started before any Qt object exists.
+    if (argc > 1 && std::strcmp(argv[1], "--serve") == 0) {
+        try {
+            return serveFromCommandLine(argc - 2, argv + 2);
+        } catch (const std::exception &e) {
+            std::cerr << "error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+#endif
+
     // Starting point of the application
     QApplication app(argc, argv);
-    Calculator calc;
-    calc.show();
-    return app.exec();
+    if (!TelemetryEnabled) {
+        Calculator calc;
+        calc.show();
+        return app.exec();
+    }
+
+    // The statistics panel docks beside the calculator and starts hidden.
+    QMainWindow window;
+    Calculator *calc = new Calculator;
+    window.setCentralWidget(calc);
+    window.setWindowTitle(calc->windowTitle());
+    QDockWidget *statsDock = new QDockWidget(QObject::tr("Statistics"), &window);
+    statsDock->setObjectName("statistics");
+    statsDock->setWidget(new StatsPanel);
+    window.addDockWidget(Qt::RightDockWidgetArea, statsDock);
+    statsDock->hide();
+    window.menuBar()->addMenu(QObject::tr("&View"))->addAction(statsDock->toggleViewAction());
+    window.show();
+    const int status = app.exec();
+
+    // Leave the latencies of the session next to the history journal.
+    const QString dataDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (QDir().mkpath(dataDirectory)) {
+        const TelemetrySnapshot snapshot = telemetrySnapshot();
+        std::ofstream json((dataDirectory + "/telemetry.json").toStdString());
+        writeTelemetryJson(json, snapshot);
+        std::ofstream csv((dataDirectory + "/telemetry.csv").toStdString());
+        writeTelemetryCsv(csv, snapshot);
+    }
+    return status;
 }
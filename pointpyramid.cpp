@@ -0,0 +1,255 @@
+#include "pointpyramid.h"
+
+#include <cmath>
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Whether two rectangles overlap (touching counts).
+ */
+bool intersects(const PointPyramid::Bounds &a, const PointPyramid::Bounds &b)
+{
+    return a.minReal <= b.maxReal && b.minReal <= a.maxReal
+           && a.minImaginary <= b.maxImaginary && b.minImaginary <= a.maxImaginary;
+}
+
+/**
+ * @brief Whether a point lies inside a rectangle.
+ */
+bool contains(const PointPyramid::Bounds &box, double re, double im)
+{
+    return box.minReal <= re && re <= box.maxReal && box.minImaginary <= im && im <= box.maxImaginary;
+}
+
+} // namespace
+
+/**
+ * @brief Adds point index to a node.
+ *
+ * @param node node to be extended (Node&).
+ * @param index index of the point (std::uint64_t).
+ * @return whether the bounding box grew (bool).
+ */
+bool PointPyramid::merge(Node &node, std::uint64_t index) const
+{
+    // Written without branches: along a random walk the comparisons are unpredictable.
+    const double x = re[index], y = im[index];
+    const bool lowReal = x < node.box.minReal, highReal = x > node.box.maxReal;
+    const bool lowImaginary = y < node.box.minImaginary, highImaginary = y > node.box.maxImaginary;
+    node.box.minReal = lowReal ? x : node.box.minReal;
+    node.box.maxReal = highReal ? x : node.box.maxReal;
+    node.box.minImaginary = lowImaginary ? y : node.box.minImaginary;
+    node.box.maxImaginary = highImaginary ? y : node.box.maxImaginary;
+    node.extremes[0] = lowReal ? index : node.extremes[0];
+    node.extremes[1] = highReal ? index : node.extremes[1];
+    node.extremes[2] = lowImaginary ? index : node.extremes[2];
+    node.extremes[3] = highImaginary ? index : node.extremes[3];
+    return lowReal | highReal | lowImaginary | highImaginary;
+}
+
+/**
+ * @brief Adds a child node to a node.
+ *
+ * @param node node to be extended (Node&).
+ * @param child node to be added (const Node&).
+ */
+void PointPyramid::merge(Node &node, const Node &child)
+{
+    if (child.box.minReal < node.box.minReal) {
+        node.box.minReal = child.box.minReal;
+        node.extremes[0] = child.extremes[0];
+    }
+    if (child.box.maxReal > node.box.maxReal) {
+        node.box.maxReal = child.box.maxReal;
+        node.extremes[1] = child.extremes[1];
+    }
+    if (child.box.minImaginary < node.box.minImaginary) {
+        node.box.minImaginary = child.box.minImaginary;
+        node.extremes[2] = child.extremes[2];
+    }
+    if (child.box.maxImaginary > node.box.maxImaginary) {
+        node.box.maxImaginary = child.box.maxImaginary;
+        node.extremes[3] = child.extremes[3];
+    }
+}
+
+/**
+ * @brief Appends one point to the end of the trajectory.
+ *
+ * @param value point to be appended (const ComplexNumber&).
+ * @return false if the point was not finite and was skipped (bool).
+ */
+bool PointPyramid::append(const ComplexNumber &value)
+{
+    if (!std::isfinite(value.getReal()) || !std::isfinite(value.getImaginary())) {
+        return false;
+    }
+    const std::uint64_t index = re.size();
+    re.push_back(value.getReal());
+    im.push_back(value.getImaginary());
+
+    const Node single = {{value.getReal(), value.getReal(), value.getImaginary(), value.getImaginary()},
+                         {index, index, index, index}};
+
+    // The point opens a new node on every level where it starts a new span. Above
+    // the first node it does not extend, it cannot extend any enclosing node either.
+    std::size_t span = Fanout;
+    for (std::vector<Node> &level : levels) {
+        if ((index & (span - 1)) == 0) {
+            level.push_back(single);
+        } else if (!merge(level.back(), index)) {
+            break;
+        }
+        span *= Fanout;
+    }
+
+    // The first level appears with the point that starts its second node.
+    if (levels.empty() && index == Fanout) {
+        Node first = {{re[0], re[0], im[0], im[0]}, {0, 0, 0, 0}};
+        for (std::uint64_t k = 1; k < Fanout; ++k) {
+            merge(first, k);
+        }
+        levels.push_back({first, single});
+    }
+
+    // Keep a single root: once the top level has two nodes, add a level above it.
+    if (!levels.empty() && levels.back().size() > 1) {
+        Node root = levels.back()[0];
+        merge(root, levels.back()[1]);
+        levels.push_back({root});
+    }
+    return true;
+}
+
+/**
+ * @brief Removes all points.
+ */
+void PointPyramid::clear()
+{
+    re.clear();
+    im.clear();
+    levels.clear();
+}
+
+/**
+ * @brief Bounding box of all points, undefined when empty.
+ *
+ * @return bounds (Bounds).
+ */
+PointPyramid::Bounds PointPyramid::bounds() const
+{
+    if (!levels.empty()) {
+        return levels.back().front().box;
+    }
+    Bounds box = {re[0], re[0], im[0], im[0]};
+    for (std::size_t k = 1; k < re.size(); ++k) {
+        box.minReal = std::min(box.minReal, re[k]);
+        box.maxReal = std::max(box.maxReal, re[k]);
+        box.minImaginary = std::min(box.minImaginary, im[k]);
+        box.maxImaginary = std::max(box.maxImaginary, im[k]);
+    }
+    return box;
+}
+
+/**
+ * @brief Recursive part of select(), emits the points standing for one node.
+ *
+ * @param level level of the node (std::size_t).
+ * @param node index of the node in its level (std::size_t).
+ * @param span number of points covered by a node of this level (std::size_t).
+ * @return false if maxPoints was exceeded (bool).
+ */
+bool PointPyramid::visit(std::size_t level, std::size_t node, std::size_t span,
+                         const Bounds &view, double pixelReal, double pixelImaginary,
+                         std::size_t maxPoints, std::vector<ComplexNumber> &out,
+                         std::size_t &covered) const
+{
+    const Node &current = levels[level][node];
+    if (!intersects(current.box, view)) {
+        return true;
+    }
+
+    const std::size_t first = node * span;
+    const std::size_t last = std::min(first + span, re.size());
+
+    if (current.box.maxReal - current.box.minReal <= pixelReal
+        && current.box.maxImaginary - current.box.minImaginary <= pixelImaginary) {
+        // Below pixel size: its extremes in trajectory order, without duplicates.
+        std::uint64_t extremes[4];
+        std::copy(current.extremes, current.extremes + 4, extremes);
+        std::sort(extremes, extremes + 4);
+        const std::uint64_t *end = std::unique(extremes, extremes + 4);
+        for (const std::uint64_t *index = extremes; index != end; ++index) {
+            out.emplace_back(re[*index], im[*index]);
+        }
+        covered += last - first;
+        return out.size() <= maxPoints;
+    }
+
+    if (level == 0) {
+        for (std::size_t k = first; k < last; ++k) {
+            if (contains(view, re[k], im[k])) {
+                out.emplace_back(re[k], im[k]);
+                ++covered;
+            }
+        }
+        return out.size() <= maxPoints;
+    }
+
+    const std::size_t children = std::min(levels[level - 1].size(), (node + 1) * Fanout);
+    for (std::size_t child = node * Fanout; child < children; ++child) {
+        if (!visit(level - 1, child, span / Fanout, view, pixelReal, pixelImaginary, maxPoints,
+                   out, covered)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Points to draw for one view, in trajectory order.
+ *
+ * @param view visible rectangle (const Bounds&).
+ * @param pixelsWide width of the view in pixels (int).
+ * @param pixelsHigh height of the view in pixels (int).
+ * @param maxPoints upper bound on returned points (std::size_t).
+ * @param out receives the points, cleared first (std::vector<ComplexNumber>&).
+ * @return number of raw points the output stands for (std::size_t).
+ */
+std::size_t PointPyramid::select(const Bounds &view, int pixelsWide, int pixelsHigh,
+                                 std::size_t maxPoints, std::vector<ComplexNumber> &out) const
+{
+    out.clear();
+    std::size_t covered = 0;
+    if (levels.empty()) {
+        for (std::size_t k = 0; k < re.size() && out.size() < maxPoints; ++k) {
+            if (contains(view, re[k], im[k])) {
+                out.emplace_back(re[k], im[k]);
+                ++covered;
+            }
+        }
+        return covered;
+    }
+
+    double pixelReal = (view.maxReal - view.minReal) / std::max(pixelsWide, 1);
+    double pixelImaginary = (view.maxImaginary - view.minImaginary) / std::max(pixelsHigh, 1);
+    const std::size_t top = levels.size() - 1;
+    std::size_t span = Fanout;
+    for (std::size_t level = 0; level < top; ++level) {
+        span *= Fanout;
+    }
+
+    // Coarser pixels until the output fits; at the latest the root collapses to its
+    // four extremes, which always fit.
+    const Bounds all = bounds();
+    maxPoints = std::max<std::size_t>(maxPoints, 4);
+    while (!visit(top, 0, span, view, pixelReal, pixelImaginary, maxPoints, out, covered)) {
+        out.clear();
+        covered = 0;
+        pixelReal = std::max(pixelReal * 2, (all.maxReal - all.minReal) / 1024);
+        pixelImaginary = std::max(pixelImaginary * 2, (all.maxImaginary - all.minImaginary) / 1024);
+    }
+    return covered;
+}
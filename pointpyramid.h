@@ -0,0 +1,128 @@
+#ifndef POINTPYRAMID_H
+#define POINTPYRAMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "complexnumber.h"
+
+/**
+ * @brief Trajectory of complex numbers with a multi-resolution index for plotting.
+ *
+ * Points are kept in insertion order. On top of them sits a tree in which every
+ * node covers Fanout consecutive nodes (or points) of the level below and stores
+ * their bounding box plus the four points reaching its minimum and maximum real
+ * and imaginary parts.
+ *
+ * select() walks the tree for one view: nodes outside the view are skipped, nodes
+ * smaller than a pixel are replaced by their extreme points (min/max decimation),
+ * and only the remaining nodes are opened. The work and the number of returned
+ * points therefore depend on the view size in pixels, not on the number of points,
+ * and the outline of the trajectory is preserved at every zoom level.
+ *
+ * append() updates one node per level, so the index is always current.
+ */
+class PointPyramid {
+public:
+    /**
+     * @brief Number of children per node.
+     */
+    static constexpr std::size_t Fanout = 8;
+    static_assert((Fanout & (Fanout - 1)) == 0, "Fanout must be a power of two");
+
+    /**
+     * @brief Axis-aligned rectangle of the complex plane.
+     */
+    struct Bounds {
+        double minReal;
+        double maxReal;
+        double minImaginary;
+        double maxImaginary;
+    };
+
+    /**
+     * @brief Appends one point to the end of the trajectory.
+     *
+     * Points with an infinite or NaN part are skipped: a single one would widen the
+     * boxes of its nodes to infinity or, for NaN, leave them unordered for good.
+     *
+     * @param value point to be appended (const ComplexNumber&).
+     * @return false if the point was not finite and was skipped (bool).
+     */
+    bool append(const ComplexNumber &value);
+
+    /**
+     * @brief Removes all points.
+     */
+    void clear();
+
+    /** @brief Number of points. */
+    std::size_t size() const { return re.size(); }
+
+    /** @brief Whether there are no points. */
+    bool empty() const { return re.empty(); }
+
+    /**
+     * @brief Bounding box of all points, undefined when empty.
+     *
+     * @return bounds (Bounds).
+     */
+    Bounds bounds() const;
+
+    /**
+     * @brief Points to draw for one view, in trajectory order.
+     *
+     * If the result would exceed maxPoints the pixel size is doubled and the walk
+     * repeated, so the output is bounded even for views crossed by a dense trajectory.
+     *
+     * @param view visible rectangle (const Bounds&).
+     * @param pixelsWide width of the view in pixels (int).
+     * @param pixelsHigh height of the view in pixels (int).
+     * @param maxPoints upper bound on returned points (std::size_t).
+     * @param out receives the points, cleared first (std::vector<ComplexNumber>&).
+     * @return number of raw points the output stands for (std::size_t).
+     */
+    std::size_t select(const Bounds &view, int pixelsWide, int pixelsHigh,
+                       std::size_t maxPoints, std::vector<ComplexNumber> &out) const;
+
+private:
+    /**
+     * @brief Summary of Fanout nodes (or points) of the level below.
+     */
+    struct Node {
+        Bounds box;
+
+        /** @brief Indices of the points at minReal, maxReal, minImaginary, maxImaginary. */
+        std::uint64_t extremes[4];
+    };
+
+    /**
+     * @brief Adds point index to a node, returns whether its box grew.
+     */
+    bool merge(Node &node, std::uint64_t index) const;
+
+    /**
+     * @brief Adds a child node to a node.
+     */
+    static void merge(Node &node, const Node &child);
+
+    /**
+     * @brief Recursive part of select().
+     */
+    bool visit(std::size_t level, std::size_t node, std::size_t span, const Bounds &view,
+               double pixelReal, double pixelImaginary, std::size_t maxPoints,
+               std::vector<ComplexNumber> &out, std::size_t &covered) const;
+
+    /**
+     * @brief Real and imaginary parts of the points.
+     */
+    std::vector<double> re, im;
+
+    /**
+     * @brief levels[l] has one node per Fanout^(l+1) points; the last level has one node.
+     */
+    std::vector<std::vector<Node>> levels;
+};
+
+#endif // POINTPYRAMID_H
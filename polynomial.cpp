@@ -0,0 +1,82 @@
+#include "polynomial.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "reduction.h"
+
+namespace {
+
+/**
+ * @brief Points per chunk handed to one thread.
+ */
+constexpr std::size_t ChunkSize = 1 << 12;
+
+/**
+ * @brief Jobs of fewer points times coefficients than this run on the calling thread.
+ */
+constexpr std::size_t ParallelWork = 1 << 17;
+
+} // namespace
+
+/**
+ * @brief Creates the polynomial c[0] + c[1] z + ... + c[n - 1] z^(n - 1).
+ *
+ * @param coefficients coefficients, lowest degree first (const std::vector<ComplexNumber>&).
+ * @throws std::invalid_argument If there are no coefficients.
+ */
+ComplexPolynomial::ComplexPolynomial(const std::vector<ComplexNumber> &coefficients)
+{
+    if (coefficients.empty()) {
+        throw std::invalid_argument("A polynomial needs at least one coefficient!");
+    }
+    real.reserve(coefficients.size());
+    imaginary.reserve(coefficients.size());
+    for (const ComplexNumber &c : coefficients) {
+        real.push_back(c.getReal());
+        imaginary.push_back(c.getImaginary());
+    }
+}
+
+/**
+ * @brief Value at one point.
+ *
+ * @param z point (const ComplexNumber&).
+ * @param scheme evaluation order (PolynomialScheme).
+ * @return value (ComplexNumber).
+ */
+ComplexNumber ComplexPolynomial::evaluate(const ComplexNumber &z, PolynomialScheme scheme) const noexcept
+{
+    const double x = z.getReal(), y = z.getImaginary();
+    double resultReal, resultImaginary;
+    scalarKernels.polynomial(real.data(), imaginary.data(), real.size(), scheme, &x, &y, &resultReal,
+                             &resultImaginary, 1);
+    return ComplexNumber(resultReal, resultImaginary);
+}
+
+/**
+ * @brief Values at many points.
+ *
+ * @param points points (const ComplexArray&).
+ * @param result values (ComplexArray&).
+ * @param scheme evaluation order (PolynomialScheme).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ */
+void ComplexPolynomial::evaluate(const ComplexArray &points, ComplexArray &result, PolynomialScheme scheme,
+                                 unsigned threads) const
+{
+    const std::size_t count = points.size();
+    if (result.size() != count) {
+        result = ComplexArray(count);
+    }
+    const ComplexKernels &kernels = activeKernels();
+    const std::size_t chunks = (count + ChunkSize - 1) / ChunkSize;
+    if (count * real.size() < ParallelWork) {
+        threads = 1;
+    }
+    parallelChunks(chunks, threads, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * ChunkSize, n = std::min(ChunkSize, count - begin);
+        kernels.polynomial(real.data(), imaginary.data(), real.size(), scheme, points.real() + begin,
+                           points.imaginary() + begin, result.real() + begin, result.imaginary() + begin, n);
+    });
+}
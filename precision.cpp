@@ -0,0 +1,96 @@
+#include "precision.h"
+
+#include <stdexcept>
+
+/**
+ * @brief Short name of a precision, as accepted by parsePrecision().
+ *
+ * @param precision precision (Precision).
+ * @return "float", "double", "long" or "quad" (const char*).
+ */
+const char *precisionName(Precision precision) noexcept
+{
+    switch (precision) {
+    case Precision::Float:
+        return "float";
+    case Precision::LongDouble:
+        return "long";
+    case Precision::Quad:
+        return "quad";
+    case Precision::Double:
+        break;
+    }
+    return "double";
+}
+
+/**
+ * @brief Whether this build can compute in a precision.
+ *
+ * @param precision precision (Precision).
+ * @return false only for Quad without COMPLEXCALC_HAS_FLOAT128 (bool).
+ */
+bool precisionAvailable(Precision precision) noexcept
+{
+#ifdef COMPLEXCALC_HAS_FLOAT128
+    (void)precision;
+    return true;
+#else
+    return precision != Precision::Quad;
+#endif
+}
+
+/**
+ * @brief Parses the name of a precision.
+ *
+ * @param name "float", "double", "long" or "quad" (const std::string&).
+ * @throws std::invalid_argument If the name is unknown or the precision is not available.
+ * @return precision (Precision).
+ */
+Precision parsePrecision(const std::string &name)
+{
+    for (Precision precision : {Precision::Float, Precision::Double, Precision::LongDouble, Precision::Quad}) {
+        if (name == precisionName(precision)) {
+            if (!precisionAvailable(precision)) {
+                throw std::invalid_argument("Precision " + name + " is not available in this build");
+            }
+            return precision;
+        }
+    }
+    throw std::invalid_argument("Unknown precision: " + name);
+}
+
+/**
+ * @brief Applies a binary operation in the given precision.
+ *
+ * @param precision precision to compute in (Precision).
+ * @param op Add, Subtract, Multiply, Divide or Power (OpCode).
+ * @param a left operand (const ComplexNumber&).
+ * @param b right operand (const ComplexNumber&).
+ * @param status set to DivisionByZero on a zero divisor or 0^-n, untouched otherwise (ComplexStatus&).
+ * @return result rounded to double (ComplexNumber).
+ */
+ComplexNumber applyOperation(Precision precision, OpCode op, const ComplexNumber &a, const ComplexNumber &b,
+                             ComplexStatus &status) noexcept
+{
+    return withPrecision(precision, [&](auto zero) {
+        using Complex = BasicComplex<decltype(zero)>;
+        return ComplexNumber(applyOperation(op, Complex(a), Complex(b), status));
+    });
+}
+
+/**
+ * @brief Applies a unary operation in the given precision.
+ *
+ * @param precision precision to compute in (Precision).
+ * @param op operation, see applyUnary() (OpCode).
+ * @param a operand (const ComplexNumber&).
+ * @param status set to DivisionByZero for the inverse of zero, untouched otherwise (ComplexStatus&).
+ * @return result rounded to double (ComplexNumber).
+ */
+ComplexNumber applyUnary(Precision precision, OpCode op, const ComplexNumber &a, ComplexStatus &status) noexcept
+{
+    return withPrecision(precision, [&](auto zero) {
+        using Complex = BasicComplex<decltype(zero)>;
+        return ComplexNumber(applyUnary(op, Complex(a), status));
+    });
+}
@@ -0,0 +1,105 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include <string>
+
+#include "complexnumber.h"
+#include "expression.h"
+
+/**
+ * @brief Scalar precision a calculation runs in.
+ *
+ * Values are stored and shown as ComplexNumber everywhere; a calculation in another
+ * precision converts its operands, runs on BasicComplex of that scalar and rounds the
+ * result back to double. Float trades accuracy for throughput, long double and quad
+ * carry 64 and 113 bit significands through ill-conditioned steps such as the
+ * cancellation in the denominator of a division.
+ */
+enum class Precision {
+    Float,
+    Double,
+    LongDouble,
+    Quad
+};
+
+/**
+ * @brief Short name of a precision, as accepted by parsePrecision().
+ *
+ * @param precision precision (Precision).
+ * @return "float", "double", "long" or "quad" (const char*).
+ */
+const char *precisionName(Precision precision) noexcept;
+
+/**
+ * @brief Whether this build can compute in a precision.
+ *
+ * @param precision precision (Precision).
+ * @return false only for Quad without COMPLEXCALC_HAS_FLOAT128 (bool).
+ */
+bool precisionAvailable(Precision precision) noexcept;
+
+/**
+ * @brief Parses the name of a precision.
+ *
+ * @param name "float", "double", "long" or "quad" (const std::string&).
+ * @throws std::invalid_argument If the name is unknown or the precision is not available.
+ * @return precision (Precision).
+ */
+Precision parsePrecision(const std::string &name);
+
+/**
+ * @brief Calls a function with a zero of the scalar type of a precision.
+ *
+ * The function is instantiated for every scalar, e.g.
+ * withPrecision(p, [&](auto zero) { using T = decltype(zero); ... }). Quad falls
+ * back to long double where it is not available.
+ *
+ * @param precision precision (Precision).
+ * @param function generic callable taking one scalar (Function&&).
+ * @return whatever the function returns, which must be the same type for every scalar.
+ */
+template<typename Function>
+decltype(auto) withPrecision(Precision precision, Function &&function)
+{
+    switch (precision) {
+    case Precision::Float:
+        return function(0.0f);
+    case Precision::LongDouble:
+        return function(0.0L);
+    case Precision::Quad:
+#ifdef COMPLEXCALC_HAS_FLOAT128
+        return function(static_cast<__float128>(0));
+#else
+        return function(0.0L);
+#endif
+    case Precision::Double:
+        break;
+    }
+    return function(0.0);
+}
+
+/**
+ * @brief Applies a binary operation in the given precision.
+ *
+ * @param precision precision to compute in (Precision).
+ * @param op Add, Subtract, Multiply, Divide or Power (OpCode).
+ * @param a left operand (const ComplexNumber&).
+ * @param b right operand (const ComplexNumber&).
+ * @param status set to DivisionByZero on a zero divisor or 0^-n, untouched otherwise (ComplexStatus&).
+ * @return result rounded to double (ComplexNumber).
+ */
+ComplexNumber applyOperation(Precision precision, OpCode op, const ComplexNumber &a, const ComplexNumber &b,
+                             ComplexStatus &status) noexcept;
+
+/**
+ * @brief Applies a unary operation in the given precision.
+ *
+ * @param precision precision to compute in (Precision).
+ * @param op operation, see applyUnary() (OpCode).
+ * @param a operand (const ComplexNumber&).
+ * @param status set to DivisionByZero for the inverse of zero, untouched otherwise (ComplexStatus&).
+ * @return result rounded to double (ComplexNumber).
+ */
+ComplexNumber applyUnary(Precision precision, OpCode op, const ComplexNumber &a, ComplexStatus &status) noexcept;
+
+#endif // PRECISION_H
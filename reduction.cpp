@@ -0,0 +1,514 @@
+#include "reduction.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "complexkernels.h"
+
+namespace {
+
+/**
+ * @brief Elements per chunk, fixed so results do not depend on the thread count.
+ */
+constexpr std::size_t ChunkSize = 1 << 14;
+
+/**
+ * @brief Arrays shorter than this are reduced on the calling thread only.
+ */
+constexpr std::size_t ParallelThreshold = 1 << 16;
+
+/**
+ * @brief Running products are rescaled once their larger part leaves [2^-256, 2^256].
+ */
+const double ProductLow = std::ldexp(1.0, -256);
+const double ProductHigh = std::ldexp(1.0, 256);
+
+/**
+ * @brief Elements outside [2^-400, 2^400] are rescaled before they are multiplied in.
+ */
+const double ElementLow = std::ldexp(1.0, -400);
+const double ElementHigh = std::ldexp(1.0, 400);
+
+/**
+ * @brief Independent running products per chunk, for instruction-level parallelism.
+ */
+constexpr std::size_t ProductChains = 4;
+
+/**
+ * @brief Share of chunks [begin, end) of one thread, packed into one atomic word.
+ */
+struct alignas(64) WorkQueue {
+    std::atomic<std::uint64_t> range;
+};
+
+std::uint64_t pack(std::uint64_t begin, std::uint64_t end)
+{
+    return begin << 32 | end;
+}
+
+/**
+ * @brief Takes the first chunk of a queue, called by its owner.
+ */
+bool takeFront(WorkQueue &queue, std::size_t &chunk)
+{
+    std::uint64_t range = queue.range.load(std::memory_order_relaxed);
+    for (;;) {
+        const std::uint64_t begin = range >> 32, end = range & 0xffffffffu;
+        if (begin >= end) {
+            return false;
+        }
+        if (queue.range.compare_exchange_weak(range, pack(begin + 1, end))) {
+            chunk = begin;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Takes the back half of a queue (at least one chunk), called by a thief.
+ */
+bool stealBack(WorkQueue &queue, std::size_t &first, std::size_t &last)
+{
+    std::uint64_t range = queue.range.load(std::memory_order_relaxed);
+    for (;;) {
+        const std::uint64_t begin = range >> 32, end = range & 0xffffffffu;
+        if (begin >= end) {
+            return false;
+        }
+        const std::uint64_t middle = begin + (end - begin) / 2;
+        if (queue.range.compare_exchange_weak(range, pack(begin, middle))) {
+            first = middle;
+            last = end;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Thread count for a reduction over count elements.
+ */
+unsigned threadsFor(unsigned threads, std::size_t count)
+{
+    return count < ParallelThreshold ? 1 : threads;
+}
+
+/**
+ * @brief Number of chunks covering count elements.
+ */
+std::size_t chunksFor(std::size_t count)
+{
+    return (count + ChunkSize - 1) / ChunkSize;
+}
+
+/**
+ * @brief Folds partial results into partial[0] along a fixed binary tree.
+ */
+template<typename T, typename Combine>
+void combinePairwise(std::vector<T> &partial, Combine combine)
+{
+    for (std::size_t width = 1; width < partial.size(); width *= 2) {
+        for (std::size_t k = 0; k + width < partial.size(); k += 2 * width) {
+            combine(partial[k], partial[k + width]);
+        }
+    }
+}
+
+/**
+ * @brief Moves powers of two from value into exponent, leaving the larger part in [0.5, 1).
+ *
+ * Zero and non-finite values are left alone.
+ */
+void normalize(ComplexNumber &value, std::int64_t &exponent)
+{
+    const double largest = std::max(std::fabs(value.getReal()), std::fabs(value.getImaginary()));
+    if (largest == 0 || !std::isfinite(largest)) {
+        return;
+    }
+    int shift;
+    std::frexp(largest, &shift);
+    value = ComplexNumber(std::ldexp(value.getReal(), -shift), std::ldexp(value.getImaginary(), -shift));
+    exponent += shift;
+}
+
+/**
+ * @brief Multiplies two scaled products.
+ */
+void multiplyScaled(ScaledComplex &product, const ScaledComplex &factor)
+{
+    product.mantissa = product.mantissa.multiply(factor.mantissa);
+    product.exponent += factor.exponent;
+    normalize(product.mantissa, product.exponent);
+}
+
+/**
+ * @brief Smallest and largest squared modulus with their first indices, -1 if none.
+ */
+struct ModulusResult {
+    double min, minIndex, max, maxIndex;
+};
+
+/**
+ * @brief Keeps the smaller (larger) modulus of two results, the lower index on ties.
+ */
+void combineModulus(ModulusResult &result, const ModulusResult &other)
+{
+    if (other.minIndex >= 0
+        && (result.minIndex < 0 || other.min < result.min
+            || (other.min == result.min && other.minIndex < result.minIndex))) {
+        result.min = other.min;
+        result.minIndex = other.minIndex;
+    }
+    if (other.maxIndex >= 0
+        && (result.maxIndex < 0 || other.max > result.max
+            || (other.max == result.max && other.maxIndex < result.maxIndex))) {
+        result.max = other.max;
+        result.maxIndex = other.maxIndex;
+    }
+}
+
+/**
+ * @brief Both modulus extremes of an array in one pass.
+ */
+ModulusResult modulusExtremes(const ComplexArray &values, unsigned threads)
+{
+    const std::size_t count = values.size();
+    if (count == 0) {
+        throw std::invalid_argument("No element has a modulus!");
+    }
+    std::vector<ModulusResult> partial(chunksFor(count));
+    const ComplexKernels &kernels = activeKernels();
+    parallelChunks(partial.size(), threadsFor(threads, count), [&](std::size_t chunk) {
+        const std::size_t first = chunk * ChunkSize;
+        ModulusLanes lanes;
+        std::fill_n(lanes.min, ReductionLanes, HUGE_VAL);
+        std::fill_n(lanes.minIndex, ReductionLanes, -1.0);
+        std::fill_n(lanes.max, ReductionLanes, -1.0);
+        std::fill_n(lanes.maxIndex, ReductionLanes, -1.0);
+        kernels.modulusExtremes(values.real() + first, values.imaginary() + first,
+                                std::min(ChunkSize, count - first), static_cast<double>(first), lanes);
+
+        ModulusResult result = {HUGE_VAL, -1, -1, -1};
+        for (std::size_t lane = 0; lane < ReductionLanes; ++lane) {
+            combineModulus(result, {lanes.min[lane], lanes.minIndex[lane], lanes.max[lane],
+                                    lanes.maxIndex[lane]});
+        }
+        partial[chunk] = result;
+    });
+    combinePairwise(partial, combineModulus);
+
+    ModulusResult &result = partial[0];
+    if (result.maxIndex < 0) {
+        throw std::invalid_argument("No element has a modulus!");
+    }
+    // Only moduli overflowing to infinity: the first of them is also the smallest.
+    if (result.minIndex < 0) {
+        result.min = result.max;
+        result.minIndex = result.maxIndex;
+    }
+    return result;
+}
+
+} // namespace
+
+/**
+ * @brief Runs body(chunk) for every chunk in [0, chunks) on several threads.
+ *
+ * @param chunks number of chunks, at most 2^32 - 1 (std::size_t).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @param body work for one chunk, must not throw (const std::function<void(std::size_t)>&).
+ */
+void parallelChunks(std::size_t chunks, unsigned threads,
+                    const std::function<void(std::size_t)> &body)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, chunks));
+    if (threads <= 1) {
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            body(chunk);
+        }
+        return;
+    }
+
+    std::unique_ptr<WorkQueue[]> queues(new WorkQueue[threads]);
+    for (unsigned k = 0; k < threads; ++k) {
+        queues[k].range.store(pack(chunks * k / threads, chunks * (k + 1) / threads));
+    }
+
+    auto work = [&](unsigned self) {
+        for (;;) {
+            std::size_t chunk;
+            while (takeFront(queues[self], chunk)) {
+                body(chunk);
+            }
+            // Look for work once around all other queues; stop when all are empty.
+            bool stole = false;
+            for (unsigned offset = 1; offset < threads && !stole; ++offset) {
+                std::size_t first, last;
+                if (stealBack(queues[(self + offset) % threads], first, last)) {
+                    queues[self].range.store(pack(first + 1, last));
+                    body(first);
+                    stole = true;
+                }
+            }
+            if (!stole) {
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    helpers.reserve(threads - 1);
+    try {
+        for (unsigned k = 1; k < threads; ++k) {
+            helpers.emplace_back(work, k);
+        }
+    } catch (const std::system_error &) {
+        // The shares of threads that could not start are stolen by the others.
+    }
+    work(0);
+    for (std::thread &helper : helpers) {
+        helper.join();
+    }
+}
+
+/**
+ * @brief The product as a plain number, infinite or zero when out of range.
+ *
+ * @return product (ComplexNumber).
+ */
+ComplexNumber ScaledComplex::value() const
+{
+    // Beyond ±4096 every finite mantissa is already out of range.
+    const int shift = static_cast<int>(std::max<std::int64_t>(-4096, std::min<std::int64_t>(4096, exponent)));
+    return ComplexNumber(std::ldexp(mantissa.getReal(), shift), std::ldexp(mantissa.getImaginary(), shift));
+}
+
+/**
+ * @brief Natural logarithm of the modulus of the product.
+ *
+ * @return log |product| (double).
+ */
+double ScaledComplex::logAbs() const
+{
+    return std::log(mantissa.absoluteValue()) + static_cast<double>(exponent) * std::log(2.0);
+}
+
+/**
+ * @brief Compensated sum of a range of numbers.
+ *
+ * @param values first number (const ComplexNumber*).
+ * @param count number of values (std::size_t).
+ * @param threads threads to use (unsigned).
+ * @return sum (CompensatedSum).
+ */
+CompensatedSum reduceSum(const ComplexNumber *values, std::size_t count, unsigned threads)
+{
+    if (count == 0) {
+        return CompensatedSum();
+    }
+    std::vector<CompensatedSum> partial(chunksFor(count));
+    parallelChunks(partial.size(), threadsFor(threads, count), [&](std::size_t chunk) {
+        const ComplexNumber *first = values + chunk * ChunkSize;
+        const ComplexNumber *last = values + std::min(count, (chunk + 1) * ChunkSize);
+        CompensatedSum sum;
+        for (; first != last; ++first) {
+            sum.add(*first);
+        }
+        partial[chunk] = sum;
+    });
+    combinePairwise(partial, [](CompensatedSum &sum, const CompensatedSum &other) { sum.add(other); });
+    return partial[0];
+}
+
+/**
+ * @brief Compensated sum of all elements.
+ *
+ * @param values numbers to be summed (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return sum (CompensatedSum).
+ */
+CompensatedSum reduceSum(const ComplexArray &values, unsigned threads)
+{
+    const std::size_t count = values.size();
+    if (count == 0) {
+        return CompensatedSum();
+    }
+    std::vector<CompensatedSum> partial(chunksFor(count));
+    const ComplexKernels &kernels = activeKernels();
+    parallelChunks(partial.size(), threadsFor(threads, count), [&](std::size_t chunk) {
+        const std::size_t first = chunk * ChunkSize;
+        SumLanes lanes = {};
+        kernels.sum(values.real() + first, values.imaginary() + first,
+                    std::min(ChunkSize, count - first), lanes);
+
+        CompensatedSum sum;
+        for (std::size_t lane = 0; lane < ReductionLanes; ++lane) {
+            sum.add(CompensatedSum(ComplexNumber(lanes.real[lane], lanes.imaginary[lane]),
+                                   ComplexNumber(lanes.realError[lane], lanes.imaginaryError[lane])));
+        }
+        partial[chunk] = sum;
+    });
+    combinePairwise(partial, [](CompensatedSum &sum, const CompensatedSum &other) { sum.add(other); });
+    return partial[0];
+}
+
+/**
+ * @brief Product of all elements, protected against overflow and underflow.
+ *
+ * @param values numbers to be multiplied (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return product (ScaledComplex).
+ */
+ScaledComplex reduceProduct(const ComplexArray &values, unsigned threads)
+{
+    const std::size_t count = values.size();
+    if (count == 0) {
+        return ScaledComplex();
+    }
+    std::vector<ScaledComplex> partial(chunksFor(count));
+    parallelChunks(partial.size(), threadsFor(threads, count), [&](std::size_t chunk) {
+        const std::size_t first = chunk * ChunkSize;
+        const std::size_t last = std::min(count, first + ChunkSize);
+        const double *re = values.real(), *im = values.imaginary();
+
+        // Element k goes to chain k % ProductChains; the chains are independent, so
+        // their multiplications overlap in the pipeline.
+        ScaledComplex chains[ProductChains];
+        for (std::size_t k = first; k < last; ++k) {
+            ScaledComplex &chain = chains[(k - first) % ProductChains];
+            ComplexNumber factor(re[k], im[k]);
+            const double size = std::max(std::fabs(re[k]), std::fabs(im[k]));
+            if (!(size >= ElementLow && size <= ElementHigh)) {
+                normalize(factor, chain.exponent);
+            }
+            chain.mantissa = chain.mantissa.multiply(factor);
+            const double product = std::max(std::fabs(chain.mantissa.getReal()),
+                                            std::fabs(chain.mantissa.getImaginary()));
+            if (!(product >= ProductLow && product <= ProductHigh)) {
+                normalize(chain.mantissa, chain.exponent);
+            }
+        }
+        ScaledComplex product = chains[0];
+        normalize(product.mantissa, product.exponent);
+        for (std::size_t chain = 1; chain < ProductChains; ++chain) {
+            multiplyScaled(product, chains[chain]);
+        }
+        partial[chunk] = product;
+    });
+    combinePairwise(partial, multiplyScaled);
+    return partial[0];
+}
+
+/**
+ * @brief First element of smallest absoluteValue().
+ *
+ * @param values numbers to be searched (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return the element and its index (IndexedComplex).
+ */
+IndexedComplex minModulus(const ComplexArray &values, unsigned threads)
+{
+    const std::size_t index = static_cast<std::size_t>(modulusExtremes(values, threads).minIndex);
+    return {index, values.get(index)};
+}
+
+/**
+ * @brief First element of largest absoluteValue().
+ *
+ * @param values numbers to be searched (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return the element and its index (IndexedComplex).
+ */
+IndexedComplex maxModulus(const ComplexArray &values, unsigned threads)
+{
+    const std::size_t index = static_cast<std::size_t>(modulusExtremes(values, threads).maxIndex);
+    return {index, values.get(index)};
+}
+
+/**
+ * @brief Mean of all elements.
+ *
+ * @param values points (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return centroid (ComplexNumber).
+ */
+ComplexNumber centroid(const ComplexArray &values, unsigned threads)
+{
+    if (values.size() == 0) {
+        throw std::invalid_argument("Centroid of an empty array!");
+    }
+    const ComplexNumber sum = reduceSum(values, threads).value();
+    const double count = static_cast<double>(values.size());
+    return ComplexNumber(sum.getReal() / count, sum.getImaginary() / count);
+}
+
+/**
+ * @brief Smallest rectangle containing all elements, NaN parts are ignored.
+ *
+ * @param values points (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return bounding box, empty for an empty array (BoundingBox).
+ */
+BoundingBox boundingBox(const ComplexArray &values, unsigned threads)
+{
+    const std::size_t count = values.size();
+    if (count == 0) {
+        return BoundingBox();
+    }
+    std::vector<BoundingBox> partial(chunksFor(count));
+    const ComplexKernels &kernels = activeKernels();
+    parallelChunks(partial.size(), threadsFor(threads, count), [&](std::size_t chunk) {
+        const std::size_t first = chunk * ChunkSize;
+        BoundsLanes lanes;
+        std::fill_n(lanes.minReal, ReductionLanes, HUGE_VAL);
+        std::fill_n(lanes.maxReal, ReductionLanes, -HUGE_VAL);
+        std::fill_n(lanes.minImaginary, ReductionLanes, HUGE_VAL);
+        std::fill_n(lanes.maxImaginary, ReductionLanes, -HUGE_VAL);
+        kernels.bounds(values.real() + first, values.imaginary() + first,
+                       std::min(ChunkSize, count - first), lanes);
+
+        BoundingBox box;
+        for (std::size_t lane = 0; lane < ReductionLanes; ++lane) {
+            box.include({lanes.minReal[lane], lanes.maxReal[lane], lanes.minImaginary[lane],
+                         lanes.maxImaginary[lane]});
+        }
+        partial[chunk] = box;
+    });
+    combinePairwise(partial, [](BoundingBox &box, const BoundingBox &other) { box.include(other); });
+    return partial[0];
+}
+
+/**
+ * @brief Smallest rectangle containing a range of numbers, NaN parts are ignored.
+ *
+ * @param values first number (const ComplexNumber*).
+ * @param count number of values (std::size_t).
+ * @param threads threads to use (unsigned).
+ * @return bounding box, empty for an empty range (BoundingBox).
+ */
+BoundingBox boundingBox(const ComplexNumber *values, std::size_t count, unsigned threads)
+{
+    if (count == 0) {
+        return BoundingBox();
+    }
+    std::vector<BoundingBox> partial(chunksFor(count));
+    parallelChunks(partial.size(), threadsFor(threads, count), [&](std::size_t chunk) {
+        const ComplexNumber *first = values + chunk * ChunkSize;
+        const ComplexNumber *last = values + std::min(count, (chunk + 1) * ChunkSize);
+        BoundingBox box;
+        for (; first != last; ++first) {
+            const double re = first->getReal(), im = first->getImaginary();
+            box.include({re, re, im, im});
+        }
+        partial[chunk] = box;
+    });
+    combinePairwise(partial, [](BoundingBox &box, const BoundingBox &other) { box.include(other); });
+    return partial[0];
+}
@@ -0,0 +1,191 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "compensatedsum.h"
+#include "complexarray.h"
+#include "complexnumber.h"
+
+/**
+ * @brief Runs body(chunk) for every chunk in [0, chunks) on several threads.
+ *
+ * Each thread starts with an equal, contiguous share of the chunks and takes them
+ * from the front. A thread that runs out steals the back half of the share of
+ * another thread, so uneven chunks or threads delayed by the OS do not leave the
+ * others idle. Every chunk is run exactly once; which thread runs it is not
+ * specified, so bodies should write their result to a slot of their own.
+ *
+ * @param chunks number of chunks, at most 2^32 - 1 (std::size_t).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @param body work for one chunk, must not throw (const std::function<void(std::size_t)>&).
+ */
+void parallelChunks(std::size_t chunks, unsigned threads,
+                    const std::function<void(std::size_t)> &body);
+
+/**
+ * @brief Product of many complex numbers with an exponent kept apart.
+ *
+ * The value is mantissa * 2^exponent. Products of thousands of large or small
+ * numbers neither overflow nor underflow; logAbs() gives the magnitude in the log
+ * domain even when value() cannot represent it.
+ */
+struct ScaledComplex {
+    /** @brief Mantissa, its larger part is in [0.5, 1) unless it is zero or not finite. */
+    ComplexNumber mantissa = ComplexNumber(1, 0);
+
+    /** @brief Power of two the mantissa is scaled by. */
+    std::int64_t exponent = 0;
+
+    /**
+     * @brief The product as a plain number, infinite or zero when out of range.
+     *
+     * @return product (ComplexNumber).
+     */
+    ComplexNumber value() const;
+
+    /**
+     * @brief Natural logarithm of the modulus of the product.
+     *
+     * @return log |product| (double).
+     */
+    double logAbs() const;
+};
+
+/**
+ * @brief Element found by a modulus reduction.
+ */
+struct IndexedComplex {
+    /** @brief Position of the element. */
+    std::size_t index;
+
+    /** @brief The element. */
+    ComplexNumber value;
+};
+
+/**
+ * @brief Axis-aligned rectangle of the complex plane.
+ *
+ * The default box is empty (min above max), so include() can start from it.
+ */
+struct BoundingBox {
+    double minReal = HUGE_VAL;
+    double maxReal = -HUGE_VAL;
+    double minImaginary = HUGE_VAL;
+    double maxImaginary = -HUGE_VAL;
+
+    /** @brief Whether no point was included. */
+    bool empty() const { return !(minReal <= maxReal); }
+
+    /**
+     * @brief Widens the box to cover another one.
+     *
+     * @param other box to be covered (const BoundingBox&).
+     */
+    void include(const BoundingBox &other)
+    {
+        minReal = other.minReal < minReal ? other.minReal : minReal;
+        maxReal = maxReal < other.maxReal ? other.maxReal : maxReal;
+        minImaginary = other.minImaginary < minImaginary ? other.minImaginary : minImaginary;
+        maxImaginary = maxImaginary < other.maxImaginary ? other.maxImaginary : maxImaginary;
+    }
+};
+
+// Whole-dataset reductions. Arrays are cut into chunks of a fixed size, reduced by
+// parallelChunks() with the SIMD reduction kernels of activeKernels(), and the chunk
+// results are combined in a fixed pairwise tree. The results are therefore the same,
+// bit for bit, for any thread count and any instruction set.
+//
+// Every function takes the number of threads to use, 0 for one per hardware thread;
+// short arrays are always reduced on the calling thread.
+
+/**
+ * @brief Compensated sum of a range of numbers.
+ *
+ * The range is cut into chunks that are summed with scalar CompensatedSum steps.
+ *
+ * @param values first number (const ComplexNumber*).
+ * @param count number of values (std::size_t).
+ * @param threads threads to use (unsigned).
+ * @return sum (CompensatedSum).
+ */
+CompensatedSum reduceSum(const ComplexNumber *values, std::size_t count, unsigned threads = 0);
+
+/**
+ * @brief Compensated sum of all elements.
+ *
+ * @param values numbers to be summed (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return sum (CompensatedSum).
+ */
+CompensatedSum reduceSum(const ComplexArray &values, unsigned threads = 0);
+
+/**
+ * @brief Product of all elements, protected against overflow and underflow.
+ *
+ * Elements are multiplied as by ComplexNumber::multiply, with the running product
+ * rescaled by exact powers of two. The product of an empty array is one.
+ *
+ * @param values numbers to be multiplied (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return product (ScaledComplex).
+ */
+ScaledComplex reduceProduct(const ComplexArray &values, unsigned threads = 0);
+
+/**
+ * @brief First element of smallest absoluteValue().
+ *
+ * Elements with a NaN modulus are skipped.
+ *
+ * @param values numbers to be searched (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @throws std::invalid_argument If no element has a modulus.
+ * @return the element and its index (IndexedComplex).
+ */
+IndexedComplex minModulus(const ComplexArray &values, unsigned threads = 0);
+
+/**
+ * @brief First element of largest absoluteValue().
+ *
+ * Elements with a NaN modulus are skipped.
+ *
+ * @param values numbers to be searched (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @throws std::invalid_argument If no element has a modulus.
+ * @return the element and its index (IndexedComplex).
+ */
+IndexedComplex maxModulus(const ComplexArray &values, unsigned threads = 0);
+
+/**
+ * @brief Mean of all elements.
+ *
+ * @param values points (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @throws std::invalid_argument If the array is empty.
+ * @return centroid (ComplexNumber).
+ */
+ComplexNumber centroid(const ComplexArray &values, unsigned threads = 0);
+
+/**
+ * @brief Smallest rectangle containing all elements, NaN parts are ignored.
+ *
+ * @param values points (const ComplexArray&).
+ * @param threads threads to use (unsigned).
+ * @return bounding box, empty for an empty array (BoundingBox).
+ */
+BoundingBox boundingBox(const ComplexArray &values, unsigned threads = 0);
+
+/**
+ * @brief Smallest rectangle containing a range of numbers, NaN parts are ignored.
+ *
+ * @param values first number (const ComplexNumber*).
+ * @param count number of values (std::size_t).
+ * @param threads threads to use (unsigned).
+ * @return bounding box, empty for an empty range (BoundingBox).
+ */
+BoundingBox boundingBox(const ComplexNumber *values, std::size_t count, unsigned threads = 0);
+
+#endif // REDUCTION_H
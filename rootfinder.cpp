@@ -0,0 +1,347 @@
+#include "rootfinder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+#include "complexkernels.h"
+#include "reduction.h"
+
+namespace {
+
+/**
+ * @brief Roots updated by one chunk of work.
+ */
+constexpr std::size_t ChunkSize = 32;
+
+/**
+ * @brief Angle added to every starting circle, breaks symmetries of the polynomial.
+ */
+constexpr double StartAngle = 0.7;
+
+/**
+ * @brief |z| without the underflow and overflow of squaring the parts.
+ *
+ * absoluteValue() returns 0 for |z| below about 1e-154 and inf above 1e154, which
+ * would drop or swamp coefficients such as 1e-200 that findRoots() keeps.
+ */
+double modulusOf(const ComplexNumber &z)
+{
+    return std::hypot(z.getReal(), z.getImaginary());
+}
+
+/**
+ * @brief Rescales the coefficients so the roots and coefficients are near 1.
+ *
+ * The polynomial is rewritten in u = z / 2^shift, with 2^shift close to the
+ * geometric mean of the root moduli (|c_0| / |c_n|)^(1/n), and divided by a power
+ * of two that brings the largest coefficient near 1. Scaling by powers of two is
+ * exact, so roots like 1e100 or 1e-100 are found without p(z) or |p(z)|^2 leaving
+ * the range of double on the way.
+ *
+ * @param c coefficients, lowest degree first, both ends non-zero; rescaled in place.
+ * @return shift, the roots are 2^shift times those of the rescaled polynomial (int).
+ */
+int rescale(std::vector<ComplexNumber> &c)
+{
+    const std::size_t degree = c.size() - 1;
+    std::vector<double> logModulus(c.size());
+    for (std::size_t k = 0; k <= degree; ++k) {
+        logModulus[k] = std::log2(modulusOf(c[k]));
+    }
+    const int shift = static_cast<int>(
+        std::lround((logModulus.front() - logModulus.back()) / static_cast<double>(degree)));
+    double largest = -HUGE_VAL;
+    for (std::size_t k = 0; k <= degree; ++k) {
+        largest = std::max(largest, logModulus[k] + static_cast<double>(k) * shift);
+    }
+    const int normal = static_cast<int>(std::floor(largest));
+    for (std::size_t k = 0; k <= degree; ++k) {
+        const int exponent = static_cast<int>(k) * shift - normal;
+        c[k] = ComplexNumber(std::ldexp(c[k].getReal(), exponent), std::ldexp(c[k].getImaginary(), exponent));
+    }
+    return shift;
+}
+
+/**
+ * @brief Coefficients of one polynomial split into parts, lowest degree first.
+ */
+struct Coefficients {
+    std::vector<double> real, imaginary;
+
+    std::size_t terms() const { return real.size(); }
+};
+
+/**
+ * @brief The polynomial, its derivative and sum |c_k| x^k, evaluated together.
+ */
+struct Evaluator {
+    Coefficients value, derivative, modulus;
+
+    explicit Evaluator(const std::vector<ComplexNumber> &c)
+    {
+        for (std::size_t k = 0; k < c.size(); ++k) {
+            value.real.push_back(c[k].getReal());
+            value.imaginary.push_back(c[k].getImaginary());
+            modulus.real.push_back(modulusOf(c[k]));
+            modulus.imaginary.push_back(0);
+            if (k > 0) {
+                derivative.real.push_back(static_cast<double>(k) * c[k].getReal());
+                derivative.imaginary.push_back(static_cast<double>(k) * c[k].getImaginary());
+            }
+        }
+    }
+};
+
+/**
+ * @brief Points in split arrays.
+ */
+struct Points {
+    std::vector<double> real, imaginary;
+
+    void resize(std::size_t n)
+    {
+        real.resize(n);
+        imaginary.resize(n);
+    }
+
+    void push(const ComplexNumber &z)
+    {
+        real.push_back(z.getReal());
+        imaginary.push_back(z.getImaginary());
+    }
+
+    ComplexNumber operator[](std::size_t k) const { return ComplexNumber(real[k], imaginary[k]); }
+};
+
+/**
+ * @brief Roots of one chunk on one side of the unit circle, with their evaluations.
+ *
+ * Outside the circle the points are the reciprocals w = 1 / z and the polynomial is
+ * the reversed one.
+ */
+struct Side {
+    std::vector<std::size_t> members;
+    Points points, moduli, value, derivative, bound;
+
+    void evaluate(const ComplexKernels &kernels, const Evaluator &evaluator)
+    {
+        const std::size_t n = members.size();
+        for (Points *p : {&value, &derivative, &bound}) {
+            p->resize(n);
+        }
+        run(kernels, evaluator.value, points, value);
+        run(kernels, evaluator.derivative, points, derivative);
+        run(kernels, evaluator.modulus, moduli, bound);
+    }
+
+private:
+    static void run(const ComplexKernels &kernels, const Coefficients &c, const Points &a, Points &r)
+    {
+        kernels.polynomial(c.real.data(), c.imaginary.data(), c.terms(), PolynomialScheme::Estrin,
+                           a.real.data(), a.imaginary.data(), r.real.data(), r.imaginary.data(),
+                           a.real.size());
+    }
+};
+
+/**
+ * @brief Starting points on the circles of the Newton polygon of log |c_k|.
+ *
+ * Each edge of the upper convex hull from i to j carries j - i roots of modulus
+ * (|c_i| / |c_j|)^(1 / (j - i)).
+ */
+std::vector<ComplexNumber> startingPoints(const std::vector<ComplexNumber> &c)
+{
+    const std::size_t degree = c.size() - 1;
+    std::vector<std::size_t> hull;
+    std::vector<double> logModulus(c.size());
+    for (std::size_t k = 0; k <= degree; ++k) {
+        // Zero exactly when findRoots() would have trimmed the coefficient.
+        const double modulus = modulusOf(c[k]);
+        if (modulus == 0) {
+            continue;
+        }
+        logModulus[k] = std::log(modulus);
+        // Pop points on or below the line from the previous hull point to k.
+        while (hull.size() >= 2) {
+            const std::size_t i = hull[hull.size() - 2], j = hull.back();
+            const double cross = (static_cast<double>(j) - i) * (logModulus[k] - logModulus[i])
+                                 - (logModulus[j] - logModulus[i]) * (static_cast<double>(k) - i);
+            if (cross < 0) {
+                break;
+            }
+            hull.pop_back();
+        }
+        hull.push_back(k);
+    }
+
+    const double twoPi = 2 * M_PI;
+    std::vector<ComplexNumber> points;
+    points.reserve(degree);
+    for (std::size_t e = 1; e < hull.size(); ++e) {
+        const std::size_t i = hull[e - 1], j = hull[e], m = j - i;
+        const double radius = std::exp((logModulus[i] - logModulus[j]) / static_cast<double>(m));
+        for (std::size_t l = 0; l < m; ++l) {
+            const double angle = twoPi * static_cast<double>(l) / static_cast<double>(m)
+                                 + twoPi * static_cast<double>(i) / static_cast<double>(degree) + StartAngle;
+            points.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+        }
+    }
+    return points;
+}
+
+} // namespace
+
+/**
+ * @brief Number of converged roots.
+ *
+ * @return count (std::size_t).
+ */
+std::size_t PolynomialRoots::convergedCount() const
+{
+    return static_cast<std::size_t>(std::count(converged.begin(), converged.end(), true));
+}
+
+/**
+ * @brief All roots of a polynomial by the Aberth-Ehrlich iteration.
+ *
+ * @param polynomial polynomial (const ComplexPolynomial&).
+ * @param maxIterations iteration limit (unsigned).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @param progress called after every iteration with the converged roots and the degree;
+ *        returning false stops early (const std::function<bool(std::size_t, std::size_t)>&).
+ * @throws std::invalid_argument If every coefficient is zero, or the roots spread
+ *         beyond the range of double.
+ * @return the roots, degree many after dropping zero leading coefficients (PolynomialRoots).
+ */
+PolynomialRoots findRoots(const ComplexPolynomial &polynomial, unsigned maxIterations, unsigned threads,
+                          const std::function<bool(std::size_t, std::size_t)> &progress)
+{
+    const ComplexNumber zero(0, 0);
+    std::size_t top = polynomial.degree();
+    while (top > 0 && polynomial.coefficient(top) == zero) {
+        --top;
+    }
+    std::size_t low = 0;
+    while (low <= top && polynomial.coefficient(low) == zero) {
+        ++low;
+    }
+    if (low > top) {
+        throw std::invalid_argument("The zero polynomial has no isolated roots!");
+    }
+
+    PolynomialRoots result;
+    result.roots.assign(low, zero);
+    result.converged.assign(low, true);
+    const std::size_t degree = top - low;
+    if (degree == 0) {
+        return result;
+    }
+
+    std::vector<ComplexNumber> c, reversed;
+    for (std::size_t k = low; k <= top; ++k) {
+        c.push_back(polynomial.coefficient(k));
+    }
+    const int shift = rescale(c);
+    reversed.assign(c.rbegin(), c.rend());
+    const Evaluator inner(c), outer(reversed);
+    const double tolerance = 4 * static_cast<double>(degree) * DBL_EPSILON;
+    const double n = static_cast<double>(degree);
+
+    // Fewer points only if rescaling flushed an end coefficient to zero, i.e. the
+    // roots spread further than double can hold.
+    const std::vector<ComplexNumber> start = startingPoints(c);
+    if (start.size() != degree) {
+        throw std::invalid_argument("The roots differ too much in size to be represented!");
+    }
+    std::vector<double> zr(degree), zi(degree);
+    for (std::size_t k = 0; k < degree; ++k) {
+        zr[k] = start[k].getReal();
+        zi[k] = start[k].getImaginary();
+    }
+    std::vector<bool> converged(degree, false);
+    std::vector<std::size_t> active(degree);
+    for (std::size_t k = 0; k < degree; ++k) {
+        active[k] = k;
+    }
+
+    const ComplexKernels &kernels = activeKernels();
+    std::vector<double> nextReal(degree), nextImaginary(degree);
+    std::vector<char> done(degree);
+    while (!active.empty() && result.iterations < maxIterations) {
+        ++result.iterations;
+        const std::size_t count = active.size();
+        const std::size_t chunks = (count + ChunkSize - 1) / ChunkSize;
+        // Small jobs are not worth waking threads for.
+        const unsigned chunkThreads = count * degree < (1 << 14) ? 1 : threads;
+        parallelChunks(chunks, chunkThreads, [&](std::size_t chunk) {
+            const std::size_t begin = chunk * ChunkSize, size = std::min(ChunkSize, count - begin);
+            Points old;
+            Side sides[2];
+            for (std::size_t k = 0; k < size; ++k) {
+                const ComplexNumber z(zr[active[begin + k]], zi[active[begin + k]]);
+                const double modulus = modulusOf(z);
+                Side &side = sides[modulus <= 1 ? 0 : 1];
+                old.push(z);
+                side.members.push_back(k);
+                side.points.push(modulus <= 1 ? z : z.inverseUnchecked());
+                side.moduli.push(ComplexNumber(modulus <= 1 ? modulus : 1 / modulus, 0));
+            }
+            sides[0].evaluate(kernels, inner);
+            sides[1].evaluate(kernels, outer);
+            Points sum;
+            sum.resize(size);
+            kernels.aberthSum(old.real.data(), old.imaginary.data(), size, zr.data(), zi.data(), degree,
+                              sum.real.data(), sum.imaginary.data());
+
+            for (const Side &side : sides) {
+                const bool inside = &side == &sides[0];
+                for (std::size_t j = 0; j < side.members.size(); ++j) {
+                    const std::size_t k = side.members[j], position = begin + k;
+                    const ComplexNumber z = old[k], p = side.value[j], dp = side.derivative[j];
+                    nextReal[position] = z.getReal();
+                    nextImaginary[position] = z.getImaginary();
+                    done[position] = modulusOf(p) <= tolerance * side.bound.real[j];
+                    if (done[position]) {
+                        continue;
+                    }
+                    // Outside, p / p' = z / (n - w q'(w) / q(w)) for q(w) = w^n p(1 / w).
+                    const ComplexNumber newton = inside ? p.divideUnchecked(dp)
+                                                        : z.divideUnchecked(ComplexNumber(n, 0)
+                                                                            - side.points[j] * dp.divideUnchecked(p));
+                    const ComplexNumber step = newton.divideUnchecked(ComplexNumber(1, 0) - newton * sum[k]);
+                    const ComplexNumber next = z - step;
+                    if (!std::isfinite(next.getReal()) || !std::isfinite(next.getImaginary())) {
+                        continue;
+                    }
+                    nextReal[position] = next.getReal();
+                    nextImaginary[position] = next.getImaginary();
+                    done[position] = next == z;
+                }
+            }
+        });
+
+        std::size_t kept = 0;
+        for (std::size_t position = 0; position < count; ++position) {
+            const std::size_t k = active[position];
+            zr[k] = nextReal[position];
+            zi[k] = nextImaginary[position];
+            if (done[position]) {
+                converged[k] = true;
+            } else {
+                active[kept++] = k;
+            }
+        }
+        active.resize(kept);
+        if (progress && !progress(degree - kept, degree)) {
+            break;
+        }
+    }
+
+    for (std::size_t k = 0; k < degree; ++k) {
+        result.roots.emplace_back(std::ldexp(zr[k], shift), std::ldexp(zi[k], shift));
+        result.converged.push_back(converged[k]);
+    }
+    return result;
+}
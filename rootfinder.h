@@ -0,0 +1,65 @@
+#ifndef ROOTFINDER_H
+#define ROOTFINDER_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "complexnumber.h"
+#include "polynomial.h"
+
+/**
+ * @brief Roots found by findRoots().
+ */
+struct PolynomialRoots {
+    /** @brief All roots with multiplicity, zero roots first. */
+    std::vector<ComplexNumber> roots;
+
+    /** @brief Whether each root met the stopping criterion, same order as roots. */
+    std::vector<bool> converged;
+
+    /** @brief Aberth iterations done. */
+    unsigned iterations = 0;
+
+    /**
+     * @brief Number of converged roots.
+     *
+     * @return count (std::size_t).
+     */
+    std::size_t convergedCount() const;
+};
+
+/**
+ * @brief All roots of a polynomial by the Aberth-Ehrlich iteration.
+ *
+ * Zero leading coefficients are dropped and zero trailing coefficients give exact
+ * zero roots. The polynomial is first rescaled by powers of two so that its roots
+ * are near the unit circle and its coefficients near 1. The starting points lie on circles whose radii come from the Newton
+ * polygon of the coefficient moduli, so roots of very different sizes start near
+ * the right modulus.
+ *
+ * Every iteration updates all roots that have not converged from the previous
+ * approximations (Jacobi style), z -= N / (1 - N S) with the Newton correction
+ * N = p / p' and the Aberth sum S = sum 1 / (z - z_j). Both run on the polynomial and
+ * aberthSum kernels of activeKernels(), vectorized across roots and split over
+ * several threads; roots outside the unit circle are evaluated through the reversed
+ * polynomial so high degrees do not overflow. A root is frozen once |p(z)| is within
+ * the rounding error of Horner's rule, 4 n eps sum |c_k| |z|^k, or once the
+ * correction no longer changes it. The results do not depend on the thread count
+ * or the instruction set.
+ *
+ * @param polynomial polynomial (const ComplexPolynomial&).
+ * @param maxIterations iteration limit (unsigned).
+ * @param threads threads to use, 0 for one per hardware thread (unsigned).
+ * @param progress called after every iteration with the number of converged roots and
+ *        the degree; returning false stops early, leaving the remaining roots marked as
+ *        not converged (const std::function<bool(std::size_t, std::size_t)>&).
+ * @throws std::invalid_argument If every coefficient is zero, or the roots spread
+ *         beyond the range of double.
+ * @return the roots, degree many after dropping zero leading coefficients (PolynomialRoots).
+ */
+PolynomialRoots findRoots(const ComplexPolynomial &polynomial, unsigned maxIterations = 200,
+                          unsigned threads = 0,
+                          const std::function<bool(std::size_t, std::size_t)> &progress = nullptr);
+
+#endif // ROOTFINDER_H
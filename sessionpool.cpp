@@ -0,0 +1,370 @@
+#include "sessionpool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::uint8_t Free = 0, Resident = 1, Evicted = 2;
+
+/**
+ * @brief Marks the end of the free handle list and free slots.
+ */
+constexpr std::uint32_t NoOwner = std::numeric_limits<std::uint32_t>::max();
+
+std::int64_t steadyNow()
+{
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+} // namespace
+
+/**
+ * @brief Reads the value stored in a register.
+ *
+ * @param name register to be read (const std::string&).
+ * @return value of the register, zero if it was never written (ComplexNumber).
+ */
+ComplexNumber SessionState::readMemory(const std::string &name) const
+{
+    const Register *found = findRegister(name);
+    return found == nullptr ? ComplexNumber(0, 0) : found->sum.value();
+}
+
+/**
+ * @brief Sets a register to given value.
+ *
+ * @param read new value (ComplexNumber).
+ * @param name register to be set (const std::string&).
+ * @throws std::invalid_argument If the name is too long or every register is in use.
+ */
+void SessionState::setMemory(ComplexNumber read, const std::string &name)
+{
+    registerFor(name).sum = CompensatedSum(read);
+}
+
+/**
+ * @brief Adds number to number contained in a register.
+ *
+ * @param read to be added (ComplexNumber).
+ * @param name register to be added to (const std::string&).
+ * @throws std::invalid_argument If the name is too long or every register is in use.
+ */
+void SessionState::addToMemory(ComplexNumber read, const std::string &name)
+{
+    registerFor(name).sum.add(read);
+}
+
+/**
+ * @brief Clears a register.
+ *
+ * @param name register to be cleared (const std::string&).
+ */
+void SessionState::clearMemory(const std::string &name)
+{
+    if (const Register *found = findRegister(name)) {
+        registers[found - registers] = Register();
+    }
+}
+
+/**
+ * @brief Names of the registers holding a value, in alphabetical order.
+ *
+ * @return register names (std::vector<std::string>).
+ */
+std::vector<std::string> SessionState::memoryRegisters() const
+{
+    std::vector<std::string> names;
+    for (const Register &slot : registers) {
+        if (slot.name[0] != '\0') {
+            names.emplace_back(slot.name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+/**
+ * @brief Records a finished calculation, stamped with the current time.
+ *
+ * @param a first operand (const ComplexNumber&).
+ * @param op operation (OpCode).
+ * @param b second operand, zero for unary operations (const ComplexNumber&).
+ * @param result result (const ComplexNumber&).
+ */
+void SessionState::record(const ComplexNumber &a, OpCode op, const ComplexNumber &b,
+                          const ComplexNumber &result)
+{
+    HistoryRecord &entry = history[historyNext];
+    entry.a = a;
+    entry.b = b;
+    entry.result = result;
+    entry.op = op;
+    entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+    historyNext = static_cast<std::uint8_t>((historyNext + 1) % HistoryLength);
+    historyCount = static_cast<std::uint8_t>(std::min<std::size_t>(historyCount + 1, HistoryLength));
+}
+
+/**
+ * @brief Slot holding a register, nullptr if there is none.
+ */
+const SessionState::Register *SessionState::findRegister(const std::string &name) const
+{
+    if (name.empty() || name.size() > RegisterNameLength) {
+        return nullptr;
+    }
+    for (const Register &slot : registers) {
+        if (name == slot.name) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Slot holding a register, taking a free one if needed.
+ *
+ * @throws std::invalid_argument If the name is too long or every register is in use.
+ */
+SessionState::Register &SessionState::registerFor(const std::string &name)
+{
+    if (name.empty() || name.size() > RegisterNameLength) {
+        throw std::invalid_argument("Register names have 1 to 7 characters!");
+    }
+    if (const Register *found = findRegister(name)) {
+        return registers[found - registers];
+    }
+    for (Register &slot : registers) {
+        if (slot.name[0] == '\0') {
+            std::memcpy(slot.name, name.c_str(), name.size() + 1);
+            slot.sum = CompensatedSum();
+            return slot;
+        }
+    }
+    throw std::invalid_argument("Every register of the session is in use!");
+}
+
+/**
+ * @brief Creates an empty pool.
+ *
+ * @param spillPath file evicted sessions are written to (const std::string&).
+ * @throws std::runtime_error If the spill file cannot be created.
+ */
+SessionPool::SessionPool(const std::string &spillPath)
+    : freeHandle(NoOwner), spillPath(spillPath)
+{
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+    spillFile = open(spillPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (spillFile < 0) {
+        throw std::runtime_error("Cannot create session spill file " + spillPath);
+    }
+#endif
+}
+
+/**
+ * @brief Destructor, removes the spill file.
+ */
+SessionPool::~SessionPool()
+{
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+    close(spillFile);
+    unlink(spillPath.c_str());
+#endif
+}
+
+/**
+ * @brief Creates a session in its initial state.
+ *
+ * @return id of the new session (SessionId).
+ */
+SessionId SessionPool::create()
+{
+    std::uint32_t index = freeHandle;
+    if (index != NoOwner) {
+        freeHandle = handles[index].location;
+    } else {
+        index = static_cast<std::uint32_t>(handles.size());
+        handles.push_back(Handle{0, 0, 1, Free});
+    }
+    Handle &handle = handles[index];
+    handle.location = allocateSlot(index);
+    slotState(handle.location) = SessionState();
+    handle.state = Resident;
+    handle.lastUse = steadyNow();
+    ++liveSessions;
+    ++residentSessions;
+    return (SessionId(handle.generation) << 32) | index;
+}
+
+/**
+ * @brief Destroys a session, resident or evicted.
+ *
+ * @param id session (SessionId).
+ * @throws std::invalid_argument If the id does not name a live session.
+ */
+void SessionPool::destroy(SessionId id)
+{
+    Handle &handle = handleOf(id);
+    if (handle.state == Resident) {
+        releaseSlot(handle.location);
+        --residentSessions;
+    } else {
+        freeRecords.push_back(handle.location);
+    }
+    handle.state = Free;
+    handle.generation = handle.generation == std::numeric_limits<std::uint32_t>::max() ? 1
+                                                                                        : handle.generation + 1;
+    handle.location = freeHandle;
+    freeHandle = static_cast<std::uint32_t>(id);
+    --liveSessions;
+}
+
+/**
+ * @brief Whether an id names a live session.
+ *
+ * @param id session (SessionId).
+ * @return true for a session that was created and not destroyed (bool).
+ */
+bool SessionPool::contains(SessionId id) const
+{
+    const std::uint32_t index = static_cast<std::uint32_t>(id);
+    return index < handles.size() && handles[index].state != Free
+           && handles[index].generation == static_cast<std::uint32_t>(id >> 32);
+}
+
+/**
+ * @brief Accesses a session, reading it back from disk if it was evicted.
+ *
+ * @param id session (SessionId).
+ * @throws std::invalid_argument If the id does not name a live session.
+ * @throws std::runtime_error If an evicted session cannot be read back.
+ * @return the session (SessionState&).
+ */
+SessionState &SessionPool::session(SessionId id)
+{
+    Handle &handle = handleOf(id);
+#ifdef COMPLEXCALC_HAS_POSIX_IO
+    if (handle.state == Evicted) {
+        const std::uint32_t record = handle.location;
+        const std::uint32_t slot = allocateSlot(static_cast<std::uint32_t>(id));
+        const off_t offset = static_cast<off_t>(record) * static_cast<off_t>(sizeof(SessionState));
+        if (pread(spillFile, &slotState(slot), sizeof(SessionState), offset) != ssize_t(sizeof(SessionState))) {
+            releaseSlot(slot);
+            throw std::runtime_error("Cannot read session from " + spillPath);
+        }
+        freeRecords.push_back(record);
+        handle.location = slot;
+        handle.state = Resident;
+        ++residentSessions;
+    }
+#endif
+    handle.lastUse = steadyNow();
+    return slotState(handle.location);
+}
+
+/**
+ * @brief Writes the sessions unused for at least a given time to the spill file.
+ *
+ * @param idle time since the last session() or create() (std::chrono::steady_clock::duration).
+ * @throws std::runtime_error If the spill file cannot be written.
+ * @return number of sessions evicted (std::size_t).
+ */
+std::size_t SessionPool::evictIdle(std::chrono::steady_clock::duration idle)
+{
+#ifndef COMPLEXCALC_HAS_POSIX_IO
+    static_cast<void>(idle);
+    return 0;
+#else
+    const std::int64_t cutoff = steadyNow() - idle.count();
+    std::size_t evicted = 0;
+    for (std::uint32_t slot = 0; slot < slotOwners.size(); ++slot) {
+        const std::uint32_t owner = slotOwners[slot];
+        if (owner == NoOwner || handles[owner].lastUse > cutoff) {
+            continue;
+        }
+        std::uint32_t record = spillRecords;
+        if (!freeRecords.empty()) {
+            record = freeRecords.back();
+        }
+        const off_t offset = static_cast<off_t>(record) * static_cast<off_t>(sizeof(SessionState));
+        if (pwrite(spillFile, &slotState(slot), sizeof(SessionState), offset) != ssize_t(sizeof(SessionState))) {
+            throw std::runtime_error("Cannot write session to " + spillPath);
+        }
+        if (record == spillRecords) {
+            ++spillRecords;
+        } else {
+            freeRecords.pop_back();
+        }
+        handles[owner].location = record;
+        handles[owner].state = Evicted;
+        releaseSlot(slot);
+        --residentSessions;
+        ++evicted;
+    }
+    return evicted;
+#endif
+}
+
+/**
+ * @brief Bytes of RAM held by the pool: slabs, handles and free lists.
+ *
+ * @return bytes allocated (std::size_t).
+ */
+std::size_t SessionPool::memoryUsage() const
+{
+    return slabs.size() * SlabSessions * sizeof(SessionState) + slabs.capacity() * sizeof(slabs[0])
+           + handles.capacity() * sizeof(Handle)
+           + (slotOwners.capacity() + freeSlots.capacity() + freeRecords.capacity()) * sizeof(std::uint32_t);
+}
+
+/**
+ * @brief Handle of a live session.
+ *
+ * @throws std::invalid_argument If the id does not name a live session.
+ */
+SessionPool::Handle &SessionPool::handleOf(SessionId id)
+{
+    if (!contains(id)) {
+        throw std::invalid_argument("Unknown session!");
+    }
+    return handles[static_cast<std::uint32_t>(id)];
+}
+
+/**
+ * @brief Takes a free slot, allocating a slab if there is none.
+ */
+std::uint32_t SessionPool::allocateSlot(std::uint32_t owner)
+{
+    if (freeSlots.empty()) {
+        const std::uint32_t first = static_cast<std::uint32_t>(slabs.size() * SlabSessions);
+        slabs.emplace_back(new SessionState[SlabSessions]);
+        slotOwners.resize(slotOwners.size() + SlabSessions, NoOwner);
+        freeSlots.reserve(slotOwners.size());
+        // Pushed backwards so the slots are handed out in increasing order.
+        for (std::uint32_t slot = first + SlabSessions; slot-- > first;) {
+            freeSlots.push_back(slot);
+        }
+    }
+    const std::uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    slotOwners[slot] = owner;
+    return slot;
+}
+
+/**
+ * @brief Returns a slot to the free list.
+ */
+void SessionPool::releaseSlot(std::uint32_t slot)
+{
+    slotOwners[slot] = NoOwner;
+    freeSlots.push_back(slot);
+}
@@ -0,0 +1,334 @@
+#ifndef SESSIONPOOL_H
+#define SESSIONPOOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "calchistory.h"
+#include "calcmemory.h"
+#include "compensatedsum.h"
+#include "complexnumber.h"
+#include "expression.h"
+
+/**
+ * @brief Calculator state of one user session, small and of fixed size.
+ *
+ * The counterpart of CalcMemory for a server holding many sessions: a few named
+ * registers with compensated sums, the last value, the pending operation and the
+ * most recent calculations, all stored inline. There are no pointers, so a session
+ * is created without allocating and can be written to disk and read back as bytes.
+ */
+class SessionState {
+public:
+    /**
+     * @brief Number of registers a session can hold.
+     */
+    static constexpr std::size_t RegisterCount = 4;
+
+    /**
+     * @brief Longest register name.
+     */
+    static constexpr std::size_t RegisterNameLength = 7;
+
+    /**
+     * @brief Number of calculations kept in the history.
+     */
+    static constexpr std::size_t HistoryLength = 8;
+
+    /**
+     * @brief Reads the value stored in a register.
+     *
+     * @param name register to be read (const std::string&).
+     * @return value of the register, zero if it was never written (ComplexNumber).
+     */
+    ComplexNumber readMemory(const std::string &name = CalcMemory::DefaultRegister) const;
+
+    /**
+     * @brief Sets a register to given value.
+     *
+     * @param read new value (ComplexNumber).
+     * @param name register to be set (const std::string&).
+     * @throws std::invalid_argument If the name is too long or every register is in use.
+     */
+    void setMemory(ComplexNumber read, const std::string &name = CalcMemory::DefaultRegister);
+
+    /**
+     * @brief Adds number to number contained in a register.
+     *
+     * @param read to be added (ComplexNumber).
+     * @param name register to be added to (const std::string&).
+     * @throws std::invalid_argument If the name is too long or every register is in use.
+     */
+    void addToMemory(ComplexNumber read, const std::string &name = CalcMemory::DefaultRegister);
+
+    /**
+     * @brief Clears a register.
+     *
+     * @param name register to be cleared (const std::string&).
+     */
+    void clearMemory(const std::string &name = CalcMemory::DefaultRegister);
+
+    /**
+     * @brief Names of the registers holding a value, in alphabetical order.
+     *
+     * @return register names (std::vector<std::string>).
+     */
+    std::vector<std::string> memoryRegisters() const;
+
+    /** @brief Gets last used value. */
+    ComplexNumber getLast() const { return lastValue; }
+
+    /**
+     * @brief Updates the last value.
+     *
+     * @param read new value (ComplexNumber).
+     */
+    void updateValue(ComplexNumber read) { lastValue = read; }
+
+    /**
+     * @brief Remembers a binary operation waiting for its second operand.
+     *
+     * @param operand first operand (const ComplexNumber&).
+     * @param op operation, None to clear (OpCode).
+     */
+    void setPending(const ComplexNumber &operand, OpCode op)
+    {
+        pendingOperand = operand;
+        pendingOp = op;
+    }
+
+    /** @brief First operand of the pending operation. */
+    ComplexNumber getPendingOperand() const { return pendingOperand; }
+
+    /** @brief Pending operation, None if there is none. */
+    OpCode getPendingOperation() const { return pendingOp; }
+
+    /**
+     * @brief Records a finished calculation, stamped with the current time.
+     *
+     * Once HistoryLength calculations are kept, the oldest is dropped.
+     *
+     * @param a first operand (const ComplexNumber&).
+     * @param op operation (OpCode).
+     * @param b second operand, zero for unary operations (const ComplexNumber&).
+     * @param result result (const ComplexNumber&).
+     */
+    void record(const ComplexNumber &a, OpCode op, const ComplexNumber &b, const ComplexNumber &result);
+
+    /** @brief Number of calculations in the history. */
+    std::size_t historySize() const { return historyCount; }
+
+    /**
+     * @brief Reads a calculation, oldest first.
+     *
+     * @param index position in [0, historySize()) (std::size_t).
+     * @return the record (const HistoryRecord&).
+     */
+    const HistoryRecord &historyAt(std::size_t index) const
+    {
+        return history[(historyNext + HistoryLength - historyCount + index) % HistoryLength];
+    }
+
+private:
+    /**
+     * @brief Register slot; an empty name marks a free slot.
+     */
+    struct Register {
+        char name[RegisterNameLength + 1] = {};
+        CompensatedSum sum;
+    };
+
+    /**
+     * @brief Slot holding a register, nullptr if there is none.
+     */
+    const Register *findRegister(const std::string &name) const;
+
+    /**
+     * @brief Slot holding a register, taking a free one if needed.
+     */
+    Register &registerFor(const std::string &name);
+
+    Register registers[RegisterCount];
+    ComplexNumber lastValue = ComplexNumber(0, 0);
+    ComplexNumber pendingOperand = ComplexNumber(0, 0);
+    OpCode pendingOp = OpCode::None;
+    std::uint8_t historyCount = 0;
+    std::uint8_t historyNext = 0;
+    HistoryRecord history[HistoryLength] = {};
+};
+
+static_assert(std::is_trivially_copyable<SessionState>::value, "sessions are spilled to disk as bytes");
+
+/**
+ * @brief Identifies a session in a SessionPool; 0 is never a valid id.
+ */
+using SessionId = std::uint64_t;
+
+/**
+ * @brief Pool of SessionState objects for a server with many concurrent sessions.
+ *
+ * Sessions live in slabs of SlabSessions objects that are allocated once and never
+ * moved, with a free list of slots, so creating and destroying a session is O(1)
+ * and does not touch the heap once the pool has grown. An id is the index of a
+ * small handle plus a generation that changes when the session is destroyed, so
+ * lookup is an array access and a stale id is detected rather than reaching a
+ * session that reused the slot.
+ *
+ * evictIdle() writes sessions that were not used for a while to a spill file and
+ * frees their slots; session() reads an evicted session back transparently. Only
+ * the 24-byte handle of an evicted session stays in RAM. The spill file needs POSIX
+ * file I/O (COMPLEXCALC_HAS_POSIX_IO); without it no file is created and every
+ * session stays resident.
+ *
+ * The pool is not thread-safe; it is meant to be owned by one event loop.
+ */
+class SessionPool {
+public:
+    /**
+     * @brief Sessions per slab.
+     */
+    static constexpr std::size_t SlabSessions = 1024;
+
+    /**
+     * @brief Creates an empty pool.
+     *
+     * @param spillPath file evicted sessions are written to, replaced if it exists and
+     *                  removed by the destructor (const std::string&).
+     * @throws std::runtime_error If the spill file cannot be created.
+     */
+    explicit SessionPool(const std::string &spillPath);
+
+    /**
+     * @brief Destructor, removes the spill file.
+     */
+    ~SessionPool();
+
+    SessionPool(const SessionPool &) = delete;
+    SessionPool &operator=(const SessionPool &) = delete;
+
+    /**
+     * @brief Creates a session in its initial state.
+     *
+     * @return id of the new session (SessionId).
+     */
+    SessionId create();
+
+    /**
+     * @brief Destroys a session, resident or evicted.
+     *
+     * @param id session (SessionId).
+     * @throws std::invalid_argument If the id does not name a live session.
+     */
+    void destroy(SessionId id);
+
+    /**
+     * @brief Whether an id names a live session.
+     *
+     * @param id session (SessionId).
+     * @return true for a session that was created and not destroyed (bool).
+     */
+    bool contains(SessionId id) const;
+
+    /**
+     * @brief Accesses a session, reading it back from disk if it was evicted.
+     *
+     * Marks the session as used now. The reference stays valid until the session is
+     * destroyed or evicted.
+     *
+     * @param id session (SessionId).
+     * @throws std::invalid_argument If the id does not name a live session.
+     * @throws std::runtime_error If an evicted session cannot be read back.
+     * @return the session (SessionState&).
+     */
+    SessionState &session(SessionId id);
+
+    /**
+     * @brief Writes the sessions unused for at least a given time to the spill file.
+     *
+     * @param idle time since the last session() or create() (std::chrono::steady_clock::duration).
+     * @throws std::runtime_error If the spill file cannot be written.
+     * @return number of sessions evicted, always 0 without a spill file (std::size_t).
+     */
+    std::size_t evictIdle(std::chrono::steady_clock::duration idle);
+
+    /** @brief Number of live sessions. */
+    std::size_t size() const { return liveSessions; }
+
+    /** @brief Number of sessions in RAM. */
+    std::size_t resident() const { return residentSessions; }
+
+    /**
+     * @brief Bytes of RAM held by the pool: slabs, handles and free lists.
+     *
+     * @return bytes allocated (std::size_t).
+     */
+    std::size_t memoryUsage() const;
+
+private:
+    /**
+     * @brief Where a session is, indexed by the low half of its id.
+     */
+    struct Handle {
+        /** @brief Time of the last use, steady clock ticks. */
+        std::int64_t lastUse;
+
+        /** @brief Slot when resident, spill record when evicted, next free handle when free. */
+        std::uint32_t location;
+
+        /** @brief High half of the id; changes when the session is destroyed. */
+        std::uint32_t generation;
+
+        /** @brief One of Free, Resident, Evicted. */
+        std::uint8_t state;
+    };
+
+    /**
+     * @brief Handle of a live session.
+     *
+     * @throws std::invalid_argument If the id does not name a live session.
+     */
+    Handle &handleOf(SessionId id);
+
+    /**
+     * @brief Takes a free slot, allocating a slab if there is none.
+     */
+    std::uint32_t allocateSlot(std::uint32_t owner);
+
+    /**
+     * @brief Returns a slot to the free list.
+     */
+    void releaseSlot(std::uint32_t slot);
+
+    /**
+     * @brief Session stored in a slot.
+     */
+    SessionState &slotState(std::uint32_t slot)
+    {
+        return slabs[slot / SlabSessions][slot % SlabSessions];
+    }
+
+    std::vector<std::unique_ptr<SessionState[]>> slabs;
+    std::vector<Handle> handles;
+
+    /**
+     * @brief Handle owning each slot, NoOwner for a free slot.
+     */
+    std::vector<std::uint32_t> slotOwners;
+
+    std::vector<std::uint32_t> freeSlots;
+    std::vector<std::uint32_t> freeRecords;
+    std::uint32_t freeHandle;
+    std::uint32_t spillRecords = 0;
+    std::size_t liveSessions = 0;
+    std::size_t residentSessions = 0;
+
+    std::string spillPath;
+    int spillFile = -1;
+};
+
+#endif // SESSIONPOOL_H
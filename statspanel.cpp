@@ -0,0 +1,119 @@
+#include "statspanel.h"
+#include "telemetry.h"
+
+#include <QHeaderView>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+
+/**
+ * @brief Time between refreshes of a visible panel.
+ */
+constexpr int RefreshIntervalMs = 500;
+
+/**
+ * @brief Columns of the table.
+ */
+const char *const Columns[] = {"Count", "Mean", "p50", "p99", "Max"};
+constexpr int ColumnCount = 5;
+
+/**
+ * @brief Formats a latency with a unit that keeps it short.
+ */
+QString formatLatency(double nanoseconds)
+{
+    if (nanoseconds < 1e3) {
+        return QString::number(nanoseconds, 'f', 0) + " ns";
+    }
+    if (nanoseconds < 1e6) {
+        return QString::number(nanoseconds / 1e3, 'f', 1) + " us";
+    }
+    if (nanoseconds < 1e9) {
+        return QString::number(nanoseconds / 1e6, 'f', 1) + " ms";
+    }
+    return QString::number(nanoseconds / 1e9, 'f', 2) + " s";
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for the StatsPanel class.
+ *
+ * @param parent parent widget.
+ */
+StatsPanel::StatsPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    table = new QTableWidget(static_cast<int>(TelemetryOpCount), ColumnCount);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    QStringList columns, rows;
+    for (const char *column : Columns) {
+        columns.append(tr(column));
+    }
+    for (std::size_t op = 0; op < TelemetryOpCount; ++op) {
+        rows.append(QString(telemetryOpName(static_cast<TelemetryOp>(op))));
+        for (int column = 0; column < ColumnCount; ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            table->setItem(static_cast<int>(op), column, item);
+        }
+    }
+    table->setHorizontalHeaderLabels(columns);
+    table->setVerticalHeaderLabels(rows);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(table);
+    setLayout(layout);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(RefreshIntervalMs);
+    connect(refreshTimer, &QTimer::timeout, this, &StatsPanel::refresh);
+}
+
+/**
+ * @brief Refreshes the table as soon as the panel is shown and keeps refreshing it.
+ */
+void StatsPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+/**
+ * @brief Stops the refreshes while the panel is hidden.
+ */
+void StatsPanel::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    refreshTimer->stop();
+}
+
+/**
+ * @brief Fills the table from a fresh telemetry snapshot.
+ */
+void StatsPanel::refresh()
+{
+    if (!isVisible()) {
+        return;
+    }
+    const TelemetrySnapshot snapshot = telemetrySnapshot();
+    for (std::size_t op = 0; op < TelemetryOpCount; ++op) {
+        const LatencyHistogram &histogram = snapshot.ops[op];
+        const int row = static_cast<int>(op);
+        table->item(row, 0)->setText(QString::number(histogram.count));
+        if (histogram.count == 0) {
+            for (int column = 1; column < ColumnCount; ++column) {
+                table->item(row, column)->setText("-");
+            }
+            continue;
+        }
+        table->item(row, 1)->setText(formatLatency(histogram.mean()));
+        table->item(row, 2)->setText(formatLatency(static_cast<double>(histogram.percentile(0.5))));
+        table->item(row, 3)->setText(formatLatency(static_cast<double>(histogram.percentile(0.99))));
+        table->item(row, 4)->setText(formatLatency(static_cast<double>(histogram.maximum())));
+    }
+}
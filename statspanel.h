@@ -0,0 +1,52 @@
+#ifndef STATSPANEL_H
+#define STATSPANEL_H
+
+#include <QWidget>
+
+QT_BEGIN_NAMESPACE
+class QTableWidget;
+class QTimer;
+QT_END_NAMESPACE
+
+/**
+ * @brief Table of the operation latencies recorded by the telemetry.
+ *
+ * One row per operation kind with its count, mean, median, 99th percentile and
+ * maximum. Refreshed twice a second while the panel is visible; a hidden panel
+ * stops its timer and costs nothing.
+ */
+class StatsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor for the StatsPanel class.
+     *
+     * @param parent parent widget.
+     */
+    explicit StatsPanel(QWidget *parent = nullptr);
+
+protected:
+    /**
+     * @brief Refreshes the table as soon as the panel is shown and keeps refreshing it.
+     */
+    void showEvent(QShowEvent *event) override;
+
+    /**
+     * @brief Stops the refreshes while the panel is hidden.
+     */
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief Fills the table from a fresh telemetry snapshot.
+     */
+    void refresh();
+
+private:
+    QTableWidget *table;
+    QTimer *refreshTimer;
+};
+
+#endif // STATSPANEL_H
@@ -0,0 +1,375 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Counters of one operation kind in one thread's block.
+ */
+struct OpCounters {
+    std::atomic<std::uint64_t> totalTicks;
+    std::atomic<std::uint64_t> buckets[LatencyHistogram::BucketCount];
+};
+
+/**
+ * @brief Counters written by one thread at a time.
+ *
+ * Allocated with new ThreadBlock(), which zeroes the atomics. Cache-line aligned so
+ * two threads never write to the same line.
+ */
+struct alignas(64) ThreadBlock {
+    OpCounters ops[TelemetryOpCount];
+};
+
+/**
+ * @brief Every block ever handed out, and the ones whose thread has exited.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadBlock *> blocks;
+    std::vector<ThreadBlock *> idle;
+};
+
+/**
+ * @brief The registry; never destroyed, as threads may still exit after static destruction.
+ */
+Registry &registry()
+{
+    static Registry *instance = new Registry;
+    return *instance;
+}
+
+/**
+ * @brief The block of the current thread; gives it back when the thread exits.
+ */
+struct ThreadSlot {
+    ThreadBlock *block = nullptr;
+
+    ~ThreadSlot()
+    {
+        if (block != nullptr) {
+            Registry &all = registry();
+            std::lock_guard<std::mutex> lock(all.mutex);
+            all.idle.push_back(block);
+        }
+    }
+};
+
+thread_local ThreadSlot currentSlot;
+
+ThreadBlock &threadBlock()
+{
+    if (currentSlot.block == nullptr) {
+        Registry &all = registry();
+        std::lock_guard<std::mutex> lock(all.mutex);
+        if (!all.idle.empty()) {
+            currentSlot.block = all.idle.back();
+            all.idle.pop_back();
+        } else {
+            currentSlot.block = new ThreadBlock();
+            all.blocks.push_back(currentSlot.block);
+        }
+    }
+    return *currentSlot.block;
+}
+
+/**
+ * @brief Adds to a counter only this thread writes, without a read-modify-write instruction.
+ */
+void bump(std::atomic<std::uint64_t> &counter, std::uint64_t amount)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Index of the highest set bit of a non-zero value.
+ */
+unsigned highestBit(std::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Clock readings taken when the program started, to measure the tick length against.
+ */
+struct ClockReference {
+    std::uint64_t ticks = telemetryTicks();
+    std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+};
+
+const ClockReference startReference;
+
+/**
+ * @brief Nanoseconds per telemetryTicks() tick, over the time since the program started.
+ */
+double nanosecondsPerTick()
+{
+#ifdef COMPLEXCALC_TELEMETRY_TSC
+    using Clock = std::chrono::steady_clock;
+    constexpr Clock::duration MinimumSpan = std::chrono::milliseconds(10);
+    const Clock::duration elapsed = Clock::now() - startReference.time;
+    if (elapsed < MinimumSpan) {
+        std::this_thread::sleep_for(MinimumSpan - elapsed);
+    }
+    const std::uint64_t endTicks = telemetryTicks();
+    const double nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - startReference.time).count();
+    const std::uint64_t ticks = endTicks - startReference.ticks;
+    return ticks == 0 ? 1.0 : nanoseconds / static_cast<double>(ticks);
+#else
+    return 1.0;
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Name of an operation kind, as written to the dumps.
+ *
+ * @param op operation kind (TelemetryOp).
+ * @return lower-case name (const char*).
+ */
+const char *telemetryOpName(TelemetryOp op)
+{
+    switch (op) {
+    case TelemetryOp::Parse:
+        return "parse";
+    case TelemetryOp::Compute:
+        return "compute";
+    case TelemetryOp::Memory:
+        return "memory";
+    case TelemetryOp::DisplayUpdate:
+        return "display_update";
+    case TelemetryOp::PlotUpdate:
+        return "plot_update";
+    case TelemetryOp::Job:
+        return "job";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Counts one operation of the calling thread, timed in telemetryTicks().
+ *
+ * @param op operation kind (TelemetryOp).
+ * @param start telemetryTicks() when the operation started (std::uint64_t).
+ * @param end telemetryTicks() when it finished (std::uint64_t).
+ */
+void recordTicks(TelemetryOp op, std::uint64_t start, std::uint64_t end) noexcept
+{
+    // A thread moved to another core may see a counter slightly behind.
+    const std::uint64_t ticks = end > start ? end - start : 0;
+    OpCounters &counters = threadBlock().ops[static_cast<std::size_t>(op)];
+    bump(counters.totalTicks, ticks);
+    bump(counters.buckets[LatencyHistogram::bucketOf(ticks)], 1);
+}
+
+/**
+ * @brief Bucket holding a value.
+ *
+ * @param ticks value (std::uint64_t).
+ * @return bucket index below BucketCount (std::size_t).
+ */
+std::size_t LatencyHistogram::bucketOf(std::uint64_t ticks) noexcept
+{
+    if (ticks < SubBuckets) {
+        return static_cast<std::size_t>(ticks);
+    }
+    const unsigned exponent = highestBit(ticks);
+    if (exponent >= MaxExponent) {
+        return BucketCount - 1;
+    }
+    const unsigned shift = exponent - SubBucketBits;
+    return (shift + 1) * SubBuckets + static_cast<std::size_t>((ticks >> shift) & (SubBuckets - 1));
+}
+
+/**
+ * @brief Smallest value of a bucket.
+ *
+ * @param bucket index below BucketCount (std::size_t).
+ * @return value in ticks (std::uint64_t).
+ */
+std::uint64_t LatencyHistogram::bucketLow(std::size_t bucket) noexcept
+{
+    if (bucket < 2 * SubBuckets) {
+        return bucket;
+    }
+    const unsigned shift = static_cast<unsigned>(bucket / SubBuckets) - 1;
+    return (SubBuckets + bucket % SubBuckets) << shift;
+}
+
+/**
+ * @brief Largest value of a bucket.
+ *
+ * @param bucket index below BucketCount (std::size_t).
+ * @return value in ticks (std::uint64_t).
+ */
+std::uint64_t LatencyHistogram::bucketHigh(std::size_t bucket) noexcept
+{
+    if (bucket + 1 >= BucketCount) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return bucketLow(bucket + 1) - 1;
+}
+
+/**
+ * @brief Converts ticks to nanoseconds.
+ *
+ * @param ticks value (std::uint64_t).
+ * @return nanoseconds (std::uint64_t).
+ */
+std::uint64_t LatencyHistogram::nanoseconds(std::uint64_t ticks) const
+{
+    return static_cast<std::uint64_t>(static_cast<double>(ticks) * nanosecondsPerTick + 0.5);
+}
+
+/**
+ * @brief Time spent in all operations.
+ *
+ * @return nanoseconds (std::uint64_t).
+ */
+std::uint64_t LatencyHistogram::total() const
+{
+    return nanoseconds(totalTicks);
+}
+
+/**
+ * @brief Mean latency.
+ *
+ * @return nanoseconds, 0 if nothing was recorded (double).
+ */
+double LatencyHistogram::mean() const
+{
+    return count == 0 ? 0.0 : static_cast<double>(totalTicks) * nanosecondsPerTick / static_cast<double>(count);
+}
+
+/**
+ * @brief Latency not exceeded by a share of the operations.
+ *
+ * @param fraction share in [0, 1], e.g. 0.99 (double).
+ * @return nanoseconds, 0 if nothing was recorded (std::uint64_t).
+ */
+std::uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    const double clamped = std::clamp(fraction, 0.0, 1.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(clamped * count + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            // The last bucket is open-ended; its lower bound is the best there is.
+            return nanoseconds(bucket + 1 < BucketCount ? bucketHigh(bucket) : bucketLow(bucket));
+        }
+    }
+    return maximum();
+}
+
+/**
+ * @brief Largest latency, to the resolution of its bucket.
+ *
+ * @return nanoseconds, 0 if nothing was recorded (std::uint64_t).
+ */
+std::uint64_t LatencyHistogram::maximum() const
+{
+    for (std::size_t bucket = buckets.size(); bucket-- > 0;) {
+        if (buckets[bucket] != 0) {
+            return nanoseconds(bucket + 1 < BucketCount ? bucketHigh(bucket) : bucketLow(bucket));
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Sums the blocks of all threads.
+ *
+ * @return the snapshot (TelemetrySnapshot).
+ */
+TelemetrySnapshot telemetrySnapshot()
+{
+    TelemetrySnapshot snapshot;
+    const double tickLength = nanosecondsPerTick();
+    Registry &all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    snapshot.threads = all.blocks.size();
+    for (const ThreadBlock *block : all.blocks) {
+        for (std::size_t op = 0; op < TelemetryOpCount; ++op) {
+            const OpCounters &counters = block->ops[op];
+            LatencyHistogram &histogram = snapshot.ops[op];
+            histogram.totalTicks += counters.totalTicks.load(std::memory_order_relaxed);
+            for (std::size_t bucket = 0; bucket < LatencyHistogram::BucketCount; ++bucket) {
+                const std::uint64_t n = counters.buckets[bucket].load(std::memory_order_relaxed);
+                histogram.buckets[bucket] += n;
+                histogram.count += n;
+            }
+        }
+    }
+    for (LatencyHistogram &histogram : snapshot.ops) {
+        histogram.nanosecondsPerTick = tickLength;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Writes a snapshot as JSON: summary figures and the non-empty buckets of each operation.
+ *
+ * A bucket is written as its lower bound in nanoseconds and its count.
+ *
+ * @param out stream written to (std::ostream&).
+ * @param snapshot snapshot to be written (const TelemetrySnapshot&).
+ */
+void writeTelemetryJson(std::ostream &out, const TelemetrySnapshot &snapshot)
+{
+    out << "{\n  \"threads\": " << snapshot.threads << ",\n  \"operations\": [";
+    for (std::size_t op = 0; op < TelemetryOpCount; ++op) {
+        const LatencyHistogram &histogram = snapshot.ops[op];
+        out << (op == 0 ? "\n" : ",\n") << "    {\"name\": \"" << telemetryOpName(static_cast<TelemetryOp>(op))
+            << "\", \"count\": " << histogram.count << ", \"total_ns\": " << histogram.total()
+            << ", \"mean_ns\": " << histogram.mean() << ", \"p50_ns\": " << histogram.percentile(0.5)
+            << ", \"p90_ns\": " << histogram.percentile(0.9) << ", \"p99_ns\": " << histogram.percentile(0.99)
+            << ", \"p999_ns\": " << histogram.percentile(0.999) << ", \"max_ns\": " << histogram.maximum()
+            << ",\n     \"buckets\": [";
+        bool first = true;
+        for (std::size_t bucket = 0; bucket < histogram.buckets.size(); ++bucket) {
+            if (histogram.buckets[bucket] != 0) {
+                out << (first ? "" : ", ") << '[' << histogram.nanoseconds(LatencyHistogram::bucketLow(bucket))
+                    << ", " << histogram.buckets[bucket] << ']';
+                first = false;
+            }
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/**
+ * @brief Writes the summary figures of a snapshot as CSV, one line per operation.
+ *
+ * @param out stream written to (std::ostream&).
+ * @param snapshot snapshot to be written (const TelemetrySnapshot&).
+ */
+void writeTelemetryCsv(std::ostream &out, const TelemetrySnapshot &snapshot)
+{
+    out << "operation,count,total_ns,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+    for (std::size_t op = 0; op < TelemetryOpCount; ++op) {
+        const LatencyHistogram &histogram = snapshot.ops[op];
+        out << telemetryOpName(static_cast<TelemetryOp>(op)) << ',' << histogram.count << ','
+            << histogram.total() << ',' << histogram.mean() << ',' << histogram.percentile(0.5) << ','
+            << histogram.percentile(0.9) << ',' << histogram.percentile(0.99) << ','
+            << histogram.percentile(0.999) << ',' << histogram.maximum() << '\n';
+    }
+}
@@ -0,0 +1,273 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define COMPLEXCALC_TELEMETRY_TSC
+#endif
+
+/**
+ * @brief Kinds of operation timed by the telemetry.
+ */
+enum class TelemetryOp : std::uint8_t {
+    Parse,         ///< Compiling expressions.
+    Compute,       ///< The calculation itself.
+    Memory,        ///< The memory registers.
+    DisplayUpdate, ///< Writing a result to the displays.
+    PlotUpdate,    ///< Moving the chart series and refreshing the history points.
+    Job,           ///< Work of a background job.
+};
+
+/**
+ * @brief Number of TelemetryOp values.
+ */
+constexpr std::size_t TelemetryOpCount = 6;
+
+/**
+ * @brief Whether the telemetry was compiled in (the COMPLEXCALC_TELEMETRY define).
+ */
+#ifdef COMPLEXCALC_TELEMETRY
+constexpr bool TelemetryEnabled = true;
+#else
+constexpr bool TelemetryEnabled = false;
+#endif
+
+/**
+ * @brief Name of an operation kind, as written to the dumps.
+ *
+ * @param op operation kind (TelemetryOp).
+ * @return lower-case name (const char*).
+ */
+const char *telemetryOpName(TelemetryOp op);
+
+/**
+ * @brief Reads the clock the timing scopes use.
+ *
+ * The time stamp counter where there is one, which is about half the price of
+ * steady_clock::now(); steady_clock nanoseconds elsewhere.
+ *
+ * @return clock ticks (std::uint64_t).
+ */
+inline std::uint64_t telemetryTicks() noexcept
+{
+#ifdef COMPLEXCALC_TELEMETRY_TSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch())
+                                          .count());
+#endif
+}
+
+/**
+ * @brief Counts one operation of the calling thread, timed in telemetryTicks().
+ *
+ * Lock-free: every thread writes to a block of its own, which is only registered
+ * (under a lock) the first time the thread records something. When the thread exits
+ * the block is handed to the next new thread, so nothing recorded is lost. Only the
+ * raw ticks are stored; they are converted to nanoseconds when a snapshot is taken.
+ *
+ * @param op operation kind (TelemetryOp).
+ * @param start telemetryTicks() when the operation started (std::uint64_t).
+ * @param end telemetryTicks() when it finished (std::uint64_t).
+ */
+void recordTicks(TelemetryOp op, std::uint64_t start, std::uint64_t end) noexcept;
+
+#ifdef COMPLEXCALC_TELEMETRY
+
+/**
+ * @brief Times the enclosing scope and records it on exit.
+ */
+class TelemetryScope {
+public:
+    explicit TelemetryScope(TelemetryOp op) noexcept
+        : op(op), start(telemetryTicks())
+    {}
+
+    ~TelemetryScope() { recordTicks(op, start, telemetryTicks()); }
+
+    TelemetryScope(const TelemetryScope &) = delete;
+    TelemetryScope &operator=(const TelemetryScope &) = delete;
+
+private:
+    TelemetryOp op;
+    std::uint64_t start;
+};
+
+#else
+
+/**
+ * @brief Compiled-out telemetry: does nothing and takes no space.
+ */
+class TelemetryScope {
+public:
+    explicit TelemetryScope(TelemetryOp) noexcept {}
+
+    TelemetryScope(const TelemetryScope &) = delete;
+    TelemetryScope &operator=(const TelemetryScope &) = delete;
+};
+
+#endif
+
+/**
+ * @brief Calls a function and records how long it took.
+ *
+ * @param op operation kind (TelemetryOp).
+ * @param function called without arguments (F&&).
+ * @return whatever the function returns.
+ */
+template <typename F>
+decltype(auto) timed(TelemetryOp op, F &&function)
+{
+    TelemetryScope scope(op);
+    return std::forward<F>(function)();
+}
+
+/**
+ * @brief Latency distribution of one operation kind, summed over all threads.
+ *
+ * The histogram is log-linear in the manner of HdrHistogram: below 2^SubBucketBits
+ * ticks every value has a bucket of its own, above that each power of two is split
+ * into 2^SubBucketBits buckets, so a bucket is never wider than 1/32 of the values in
+ * it. Values from 2^MaxExponent ticks go to the last bucket. The buckets count clock
+ * ticks; the figures below are in nanoseconds.
+ */
+struct LatencyHistogram {
+    static constexpr unsigned SubBucketBits = 5;
+    static constexpr unsigned MaxExponent = 40;
+    static constexpr std::size_t SubBuckets = std::size_t(1) << SubBucketBits;
+    static constexpr std::size_t BucketCount = (MaxExponent - SubBucketBits + 1) * SubBuckets;
+
+    /**
+     * @brief Bucket holding a value.
+     *
+     * @param ticks value (std::uint64_t).
+     * @return bucket index below BucketCount (std::size_t).
+     */
+    static std::size_t bucketOf(std::uint64_t ticks) noexcept;
+
+    /**
+     * @brief Smallest value of a bucket.
+     *
+     * @param bucket index below BucketCount (std::size_t).
+     * @return value in ticks (std::uint64_t).
+     */
+    static std::uint64_t bucketLow(std::size_t bucket) noexcept;
+
+    /**
+     * @brief Largest value of a bucket.
+     *
+     * @param bucket index below BucketCount (std::size_t).
+     * @return value in ticks (std::uint64_t).
+     */
+    static std::uint64_t bucketHigh(std::size_t bucket) noexcept;
+
+    /**
+     * @brief Converts ticks to nanoseconds.
+     *
+     * @param ticks value (std::uint64_t).
+     * @return nanoseconds (std::uint64_t).
+     */
+    std::uint64_t nanoseconds(std::uint64_t ticks) const;
+
+    /**
+     * @brief Time spent in all operations.
+     *
+     * @return nanoseconds (std::uint64_t).
+     */
+    std::uint64_t total() const;
+
+    /**
+     * @brief Mean latency.
+     *
+     * @return nanoseconds, 0 if nothing was recorded (double).
+     */
+    double mean() const;
+
+    /**
+     * @brief Latency not exceeded by a share of the operations.
+     *
+     * Reported as the largest value of the bucket.
+     *
+     * @param fraction share in [0, 1], e.g. 0.99 (double).
+     * @return nanoseconds, 0 if nothing was recorded (std::uint64_t).
+     */
+    std::uint64_t percentile(double fraction) const;
+
+    /**
+     * @brief Largest latency, to the resolution of its bucket.
+     *
+     * @return nanoseconds, 0 if nothing was recorded (std::uint64_t).
+     */
+    std::uint64_t maximum() const;
+
+    std::uint64_t count = 0;
+    std::uint64_t totalTicks = 0;
+
+    /**
+     * @brief Length of a tick, measured when the snapshot was taken.
+     */
+    double nanosecondsPerTick = 1.0;
+
+    /**
+     * @brief Operations per bucket, BucketCount entries.
+     */
+    std::vector<std::uint64_t> buckets = std::vector<std::uint64_t>(BucketCount);
+};
+
+/**
+ * @brief Everything recorded so far.
+ */
+struct TelemetrySnapshot {
+    /**
+     * @brief Histograms indexed by TelemetryOp.
+     */
+    LatencyHistogram ops[TelemetryOpCount];
+
+    /**
+     * @brief Number of per-thread blocks, i.e. most threads recording at once.
+     */
+    std::size_t threads = 0;
+
+    /** @brief Histogram of one operation kind. */
+    const LatencyHistogram &operator[](TelemetryOp op) const { return ops[static_cast<std::size_t>(op)]; }
+};
+
+/**
+ * @brief Sums the blocks of all threads.
+ *
+ * Can be called from any thread while others record; an operation being recorded
+ * at that moment may be partly counted. The tick length is measured against
+ * steady_clock over the time since the program started, which takes a short sleep
+ * if it started less than 10 ms ago.
+ *
+ * @return the snapshot (TelemetrySnapshot).
+ */
+TelemetrySnapshot telemetrySnapshot();
+
+/**
+ * @brief Writes a snapshot as JSON: summary figures and the non-empty buckets of each operation.
+ *
+ * A bucket is written as its lower bound in nanoseconds and its count.
+ *
+ * @param out stream written to (std::ostream&).
+ * @param snapshot snapshot to be written (const TelemetrySnapshot&).
+ */
+void writeTelemetryJson(std::ostream &out, const TelemetrySnapshot &snapshot);
+
+/**
+ * @brief Writes the summary figures of a snapshot as CSV, one line per operation.
+ *
+ * @param out stream written to (std::ostream&).
+ * @param snapshot snapshot to be written (const TelemetrySnapshot&).
+ */
+void writeTelemetryCsv(std::ostream &out, const TelemetrySnapshot &snapshot);
+
+#endif // TELEMETRY_H